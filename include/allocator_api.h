@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2014-2015, dennis wang
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ALLOCATOR_API_H
+#define ALLOCATOR_API_H
+
+#include "config.h"
+
+/**
+ * ѡڴ
+ *
+ * оcreate()/rcreate()ڴͷ¼˷Դ, лڴԭͷ, ʱʱл
+ * @param type 
+ * @retval error_ok ɹ
+ * @retval error_invalid_parameters δ֪, ѡallocator_type_customǰδԶ亯
+ */
+extern int knet_allocator_set_type(knet_allocator_type_e type);
+
+/**
+ * ȡõǰڴ
+ * @return 
+ */
+extern knet_allocator_type_e knet_allocator_get_type();
+
+/**
+ * Զ亯, allocator_type_customʹ
+ *
+ * Զ亯ڴܸ
+ * @param m 亯
+ * @param r ·亯
+ * @param f ͷź
+ * @retval error_ok ɹ
+ * @retval error_fail Զ亯Ѿڴ
+ * @retval  ʧ
+ */
+extern int knet_allocator_set_custom(knet_malloc_func_t m, knet_realloc_func_t r, knet_free_func_t f);
+
+/**
+ * ȡslabȵȼ
+ *
+ * ͳƽӿڵĵȼΪ[0, ȼ], ȼslabڴ
+ * @return ȵȼ
+ */
+extern int knet_allocator_get_class_count();
+
+/**
+ * ȡóȵȼɷ󳤶
+ * @param index ȼ
+ * @return 󳤶, slabڴ淵0
+ */
+extern uint32_t knet_allocator_get_class_size(int index);
+
+/**
+ * ȡóȵȼǰδͷẉֽ̂߳
+ * @param index ȼ
+ * @return δͷŵֽ
+ */
+extern uint64_t knet_allocator_get_live_bytes(int index);
+
+/**
+ * ȡóȵȼۼƷ̣߳
+ * @param index ȼ
+ * @return ۼƷ
+ */
+extern uint64_t knet_allocator_get_alloc_count(int index);
+
+#endif /* ALLOCATOR_API_H */
@@ -84,6 +84,8 @@
     #include <unistd.h>
     #include <pthread.h>
     #include <sys/epoll.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
     #define socket_len_t socklen_t
     #define thread_id_t pthread_t
     #define socket_t int
@@ -99,28 +101,34 @@
 #define INT_MAX  2147483647 /* maximum (signed) int value */
 #endif /* INT_MAX */
 
-#define create(type)                         (type*)malloc(sizeof(type))
-#define create_raw(size)                     (char*)malloc(size)
-#define create_type(type, size)              (type*)malloc(size)
-#define create_type_ptr_array(type, n)       (type**)malloc((n) * sizeof(type*))
-#define rcreate_raw(ptr, size)               (char*)realloc(ptr, size)
-#define rcreate_type(type, ptr, size)        (type*)realloc(ptr, size)
-#define rcreate_type_ptr_array(type, ptr, n) (type**)realloc(ptr, (n) * sizeof(type*))
+#define create(type)                         (type*)knet_malloc(sizeof(type))
+#define create_raw(size)                     (char*)knet_malloc(size)
+#define create_type(type, size)              (type*)knet_malloc(size)
+#define create_type_ptr_array(type, n)       (type**)knet_malloc((n) * sizeof(type*))
+#define rcreate_raw(ptr, size)               (char*)knet_realloc(ptr, size)
+#define rcreate_type(type, ptr, size)        (type*)knet_realloc(ptr, size)
+#define rcreate_type_ptr_array(type, ptr, n) (type**)knet_realloc(ptr, (n) * sizeof(type*))
+extern void* knet_malloc(size_t size);
+extern void* knet_realloc(void* ptr, size_t size);
 extern void destroy(void* ptr) ;
 
 typedef struct _loop_t kloop_t;
 typedef struct _channel_t kchannel_t;
 typedef struct _channel_ref_t kchannel_ref_t;
+typedef struct _channel_ref_fanout_t kchannel_ref_fanout_t;
 typedef struct _address_t kaddress_t;
 typedef struct _lock_t klock_t;
 typedef struct _loop_balancer_t kloop_balancer_t;
+typedef struct _loop_send_batch_t kloop_send_batch_t;
 typedef struct _thread_runner_t kthread_runner_t;
 typedef struct _stream_t kstream_t;
 typedef struct _dlist_t kdlist_t;
 typedef struct _dlist_node_t kdlist_node_t;
 typedef struct _ringbuffer_t kringbuffer_t;
 typedef struct _buffer_t kbuffer_t;
+typedef struct _shared_buffer_t kshared_buffer_t;
 typedef struct _broadcast_t kbroadcast_t;
+typedef struct _broadcast_partition_t kbroadcast_partition_t;
 typedef struct _ktimer_loop_t ktimer_loop_t;
 typedef struct _ktimer_t ktimer_t;
 typedef struct _logger_t klogger_t;
@@ -131,6 +139,7 @@ typedef struct _krpc_vector_t krpc_vector_t;
 typedef struct _krpc_object_t krpc_object_t;
 typedef struct _krpc_map_t krpc_map_t;
 typedef struct _krpc_value_t krpc_value_t;
+typedef struct _krpc_arena_t krpc_arena_t;
 typedef struct _hash_t khash_t;
 typedef struct _hash_value_t khash_value_t;
 typedef struct _framework_t kframework_t;
@@ -173,12 +182,28 @@ typedef enum _ktimer_type_e {
     ktimer_type_times  = 3, /*!  */
 } ktimer_type_e;
 
+/*! ڴ */
+typedef enum _allocator_type_e {
+    allocator_type_system = 1, /*! ϵͳmalloc/realloc/free */
+    allocator_type_slab,       /*! ȷּslab, ÿ߳ж */
+    allocator_type_custom,     /*! Զ亯 */
+} knet_allocator_type_e;
+
 /*! ؾ */
 typedef enum _loop_balance_option_e {
     loop_balancer_in  = 1, /*! kloop_tĹܵڵǰkloop_t */
     loop_balancer_out = 2, /*! ǰkloop_tĹܵkloop_tڸ */
 } knet_loop_balance_option_e;
 
+/*! ؾ */
+typedef enum _loop_balancer_strategy_e {
+    loop_balancer_strategy_least_channel = 1, /*! ܵ, Ĭ */
+    loop_balancer_strategy_least_bandwidth,   /*! շ, ͬʱȽϹܵ */
+    loop_balancer_strategy_least_busy,        /*! æµ, ͬʱȽϹܵ */
+    loop_balancer_strategy_power_of_two,      /*! ѡȡkloop_t, ȡܵ */
+    loop_balancer_strategy_consistent_hash,   /*! ԶIPһԹϣ, ͬһԶѡȡͬһkloop_t */
+} knet_loop_balancer_strategy_e;
+
 /*  */
 typedef enum _error_e {
     error_ok = 0,
@@ -248,6 +273,10 @@ typedef enum _error_e {
     error_ringbuffer_not_found,
     error_node_argv_invalid,
     error_getaddrinfo_fail,
+    error_reuse_port_fail,
+    error_send_watermark,
+    error_broadcast_joined,
+    error_migrate_fail,
 } knet_error_e;
 
 /*! ܵص¼ */
@@ -259,8 +288,14 @@ typedef enum _channel_cb_event_e {
     channel_cb_event_close = 16,           /*! ܵر */
     channel_cb_event_timeout = 32,         /*! ܵ */
     channel_cb_event_connect_timeout = 64, /*! ӣӳʱ */
+    channel_cb_event_send_drained = 128,   /*! ˮλܾдķ˵ˮλ, Լд */
 } knet_channel_cb_event_e;
 
+/*! ܵ־ */
+typedef enum _channel_flag_e {
+    channel_flag_mirror_recv_buffer = 1, /*! ջӳβ, ɶ(Linux, ƽ̨) */
+} knet_channel_flag_e;
+
 /* ־ȼ */
 typedef enum _logger_level_e {
     logger_level_verbose = 1, /* verbose -  */
@@ -315,6 +350,12 @@ typedef enum _manage_cb_ret_e {
     manage_cb_close = 1, /* رչͻ˹ܵ */
 } manage_cb_ret_e;
 
+/*! ۼдݿ */
+typedef struct _iovec_t {
+    const void* buffer; /*! ָ */
+    int         size;   /*! ݳ */
+} kiovec_t;
+
 /*! ̺߳ */
 typedef void (*knet_thread_func_t)(kthread_runner_t*);
 /*! ܵ¼ص */
@@ -339,6 +380,12 @@ typedef void (*knet_node_cb_t)(knode_proxy_t*, knet_node_cb_event_e);
 typedef int (*knet_node_manage_cb_t)(knode_t*, const char*, char*, int*);
 /*! ڵڵػص */
 typedef void (*knet_node_monitor_cb_t)(knode_t*, kchannel_ref_t*);
+/*! Զڴ亯 */
+typedef void* (*knet_malloc_func_t)(size_t);
+/*! Զڴ·亯 */
+typedef void* (*knet_realloc_func_t)(void*, size_t);
+/*! Զڴͷź */
+typedef void (*knet_free_func_t)(void*);
 
 /* Ҫ ͬѡȡ */
 #if defined(WIN32)
@@ -358,6 +405,98 @@ typedef void (*knet_node_monitor_cb_t)(knode_t*, kchannel_ref_t*);
 #define LOGGER_MODE (logger_mode_file | logger_mode_console | logger_mode_flush | logger_mode_override) /* ־ģʽ */
 #define LOGGER_LEVEL logger_level_verbose /* ־ȼ */
 
+#ifndef ACCEPT_MAX_PER_WAKEUP
+    #define ACCEPT_MAX_PER_WAKEUP 64 /* ܵÿαʱܵ, ֹܵ */
+#endif /* ACCEPT_MAX_PER_WAKEUP */
+
+#ifndef CHANNEL_SEND_IOV_MAX
+    #define CHANNEL_SEND_IOV_MAX 64 /* ÿξۼϲķͻ, ܳϵͳIOV_MAX */
+#endif /* CHANNEL_SEND_IOV_MAX */
+
+#ifndef CHANNEL_SEND_CHUNK_SIZE
+    #define CHANNEL_SEND_CHUNK_SIZE 4096 /* ͿС, СдϲͿ, дʹö */
+#endif /* CHANNEL_SEND_CHUNK_SIZE */
+
+#ifndef CHANNEL_SEND_CHUNK_POOL
+    #define CHANNEL_SEND_CHUNK_POOL 4 /* ÿܵౣĿзͿ */
+#endif /* CHANNEL_SEND_CHUNK_POOL */
+
+#ifndef CACHE_LINE_SIZE
+    #define CACHE_LINE_SIZE 64 /* г, ܵ󰴻ж */
+#endif /* CACHE_LINE_SIZE */
+
+#ifndef LOOP_CHANNEL_FREE_LIST_MAX
+    #define LOOP_CHANNEL_FREE_LIST_MAX 1024 /* ÿkloop_t໺ٹܵ, ¹ܵȴӻȡ */
+#endif /* LOOP_CHANNEL_FREE_LIST_MAX */
+
+#ifndef CHANNEL_RECV_BUFFER_INIT_SIZE
+    #define CHANNEL_RECV_BUFFER_INIT_SIZE 2048 /* ջʼ, ֱܵջ */
+#endif /* CHANNEL_RECV_BUFFER_INIT_SIZE */
+
+#ifndef CHANNEL_RECV_BUFFER_IDLE
+    #define CHANNEL_RECV_BUFFER_IDLE 5000 /* ܵʱ䣨룩δյҽջΪʱ, سʼ */
+#endif /* CHANNEL_RECV_BUFFER_IDLE */
+
+#ifndef RINGBUFFER_ROUND_POW2
+    #define RINGBUFFER_ROUND_POW2 0 /* Ϊ1ʱλȡΪ2, ʹȡģ, ȱΪ2ʱʹ */
+#endif /* RINGBUFFER_ROUND_POW2 */
+
+#ifndef LOOP_EVENT_RING_SIZE
+    #define LOOP_EVENT_RING_SIZE 4096 /* ߳¼ζвλ, Ϊ2, ʱ¼ */
+#endif /* LOOP_EVENT_RING_SIZE */
+
+#ifndef LOOP_TIMEOUT_WHEEL_SLOT
+    #define LOOP_TIMEOUT_WHEEL_SLOT 1024 /* ܵʱʱֲλ, һȦĳʱǰᱻʼ */
+#endif /* LOOP_TIMEOUT_WHEEL_SLOT */
+
+#ifndef LOOP_TIMEOUT_WHEEL_TICK
+    #define LOOP_TIMEOUT_WHEEL_TICK 10 /* ܵʱʱ̶ֿȣ룩, Ҳǳʱľ */
+#endif /* LOOP_TIMEOUT_WHEEL_TICK */
+
+#ifndef LOOP_WAIT_TIMEOUT_MAX
+    #define LOOP_WAIT_TIMEOUT_MAX 1000 /* kloop_tѡȡʱ䣨룩 */
+#endif /* LOOP_WAIT_TIMEOUT_MAX */
+
+#ifndef LOOP_LOAD_SAMPLE_INTERVAL
+    #define LOOP_LOAD_SAMPLE_INTERVAL 500 /* kloop_tأշʼæµͳƿյļ룩, ؾֵѡȡ */
+#endif /* LOOP_LOAD_SAMPLE_INTERVAL */
+
+#ifndef LOOP_BALANCER_VIRTUAL_NODE
+    #define LOOP_BALANCER_VIRTUAL_NODE 64 /* һԹϣÿkloop_tڵ */
+#endif /* LOOP_BALANCER_VIRTUAL_NODE */
+
+#ifndef LOOP_BALANCER_MIGRATE_SKEW
+    #define LOOP_BALANCER_MIGRATE_SKEW 0 /* kloop_tæµǧֱȣkloop_tĲֵ, βʱǨһܵ, 0ΪǨ */
+#endif /* LOOP_BALANCER_MIGRATE_SKEW */
+
+#ifndef ALLOCATOR_TYPE
+    #define ALLOCATOR_TYPE allocator_type_slab /* Ĭڴ, ʱɵknet_allocator_set_type()л */
+#endif /* ALLOCATOR_TYPE */
+
+#ifndef ALLOCATOR_SLAB_SIZE
+    #define ALLOCATOR_SLAB_SIZE 65536 /* slabÿϵͳڴ泤, С󳤶ȵȼ4096 */
+#endif /* ALLOCATOR_SLAB_SIZE */
+
+#ifndef ALLOCATOR_CACHE_BYTES
+    #define ALLOCATOR_CACHE_BYTES 16384 /* ÿ߳ÿȵȼ໺Ŀڴֽ, һ黹ȫֿ */
+#endif /* ALLOCATOR_CACHE_BYTES */
+
+#ifndef HASH_REHASH_STEP
+    #define HASH_REHASH_STEP 64 /* ϣʱÿβǨƵԪ */
+#endif /* HASH_REHASH_STEP */
+
+#ifndef BROADCAST_ARRAY_INIT_SIZE
+    #define BROADCAST_ARRAY_INIT_SIZE 16 /* 㲥Աĳʼ, ʱӱ */
+#endif /* BROADCAST_ARRAY_INIT_SIZE */
+
+#ifndef RPC_ARENA_CHUNK_SIZE
+    #define RPC_ARENA_CHUNK_SIZE 16384 /* RPCڴÿηڴ鳤, ÿkloop_tһڴ */
+#endif /* RPC_ARENA_CHUNK_SIZE */
+
+#ifndef RPC_MARSHAL_STACK_SIZE
+    #define RPC_MARSHAL_STACK_SIZE 1024 /* RPCлʱʹջϻ󳤶, ʱӶѷ */
+#endif /* RPC_MARSHAL_STACK_SIZE */
+
 #if defined(DEBUG) || defined(_DEBUG)
     #define verify(expr) assert(expr)
 #elif defined(NDEBUG)
@@ -54,7 +54,7 @@ extern const char* hash_value_get_string_key(khash_value_t* hash_value);
 
 /**
  * ϣ
- * @param size ϣͰ, 0ʹĬͰ
+ * @param size ԤԪ, 0ʹĬϴС, ԪʱԶ
  * @param dtor ûԶֵٺ
  * @return khash_tʵ
  */
@@ -66,6 +66,12 @@ extern khash_t* hash_create(uint32_t size, knet_hash_dtor_t dtor);
  */
 extern void hash_destroy(khash_t* hash);
 
+/**
+ * չϣ, ѷڴ湩ʹ
+ * @param hash khash_tʵ
+ */
+extern void hash_clear(khash_t* hash);
+
 /**
  * Ԫ
  * @param hash khash_tʵ
@@ -51,6 +51,7 @@
 #include "misc_api.h"
 #include "logger_api.h"
 #include "ringbuffer_api.h"
+#include "allocator_api.h"
 #include "version.h"
 
 #ifdef __cplusplus
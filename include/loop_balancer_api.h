@@ -33,8 +33,14 @@
  *
  * <pre>
  * ؾkloop_tkloop_tڼܵ¹ܵ
- * 븺ؾ⣬ؾĲkloop_tڻԾܵkloop_balancer_tѡ
- * Ծܵٵkloop_t½ܵĹܵ.
+ * 븺ؾ⣬Ĭϲkloop_tڹܵkloop_balancer_tѡܵٵkloop_t
+ * ½ܵĹܵ. knet_loop_balancer_set_strategyлΪշʡæµ
+ * ѡһԶIPһԹϣѡȡ.
+ *
+ * ÿkloop_tԼ߳ڲ, ؾȡֵ, ѡȡʱ.
+ *
+ * knet_loop_balancer_set_migrate_skewǨƺ, æµβ߳kloop_t
+ * ֵkloop_tβ֮շֽĹܵǨƵеkloop_t.
  *
  * knet_loop_balancer_attachkloop_balancer_tkloop_tknet_loop_balancer_detach
  * ȡ.
@@ -72,6 +78,36 @@ extern int knet_loop_balancer_attach(kloop_balancer_t* balancer, kloop_t* loop);
  */
 extern int knet_loop_balancer_detach(kloop_balancer_t* balancer, kloop_t* loop);
 
+/**
+ * øؾ
+ * @param balancer kloop_balancer_tʵ
+ * @param strategy ؾ
+ */
+extern void knet_loop_balancer_set_strategy(kloop_balancer_t* balancer, knet_loop_balancer_strategy_e strategy);
+
+/**
+ * ȡøؾ
+ * @param balancer kloop_balancer_tʵ
+ * @return ؾ
+ */
+extern knet_loop_balancer_strategy_e knet_loop_balancer_get_strategy(kloop_balancer_t* balancer);
+
+/**
+ * ùܵǨֵ
+ *
+ * رloop_balancer_outõkloop_tǨܵ, رloop_balancer_inõkloop_tǨܵ
+ * @param balancer kloop_balancer_tʵ
+ * @param skew æµֵǧֱȣ, 0ΪǨ
+ */
+extern void knet_loop_balancer_set_migrate_skew(kloop_balancer_t* balancer, int skew);
+
+/**
+ * ȡùܵǨֵ
+ * @param balancer kloop_balancer_tʵ
+ * @return æµֵǧֱȣ
+ */
+extern int knet_loop_balancer_get_migrate_skew(kloop_balancer_t* balancer);
+
 /** @} */
 
 #endif /* LOOP_BALANCER_API_H */
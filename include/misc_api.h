@@ -37,6 +37,13 @@ extern uint32_t time_get_milliseconds();
  */
 extern uint64_t time_get_microseconds();
 
+/**
+ * ȡʱӺ, ϵͳʱӰ
+ *
+ * LinuxʹCLOCK_MONOTONIC_COARSE, Ϊںʱӽ(ͨ1-4), ÿС
+ */
+extern uint64_t time_get_monotonic_milliseconds();
+
 /**
  * gettimeofday
  * @sa gettimeofday
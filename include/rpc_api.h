@@ -74,6 +74,9 @@ extern krpc_cb_t krpc_get_cb(krpc_t* rpc, uint16_t rpcid);
 
 /**
  * RPCãлRPCãûص
+ *
+ * ڹܵkloop_tڴڽ, صغһͷ, صڲܱ޸Ķ,
+ * ҲҪkrpc_object_destroy()
  * @param rpc krpc_tʵ
  * @param stream 
  * @retval error_ok ɹ
@@ -83,6 +86,9 @@ extern int krpc_proc(krpc_t* rpc, kstream_t* stream);
 
 /**
  * RPC
+ *
+ * лȲ64KBʱʹԭЭʽ, ʱʹ32λȵĳʽ, շܵĽջ
+ * . ˼ܻصʱΪ64KB
  * @param rpc krpc_tʵ
  * @param stream 
  * @param rpcid صID
@@ -0,0 +1,544 @@
+/*
+ * Copyright (c) 2014-2015, dennis wang
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "allocator.h"
+#include "misc.h"
+#include "logger.h"
+
+#if defined(WIN32)
+    #define ALLOCATOR_TLS __declspec(thread)
+#else
+    #define ALLOCATOR_TLS __thread
+#endif /* defined(WIN32) */
+
+#define ALLOCATOR_KIND_SYSTEM 0x100 /* ϵͳ */
+#define ALLOCATOR_KIND_CUSTOM 0x200 /* Զ庯 */
+#define ALLOCATOR_CACHE_MIN   4     /* ÿȵȼٻĿڴ */
+
+/* ڴͷ, λûڴ֮ǰ, ֤ûڴ16ֽڶ */
+typedef struct _allocator_header_t {
+    uint64_t size;      /* ûĳ */
+    uint32_t kind;      /* slabȵȼALLOCATOR_KIND_* */
+    uint32_t __padding; /*  */
+} allocator_header_t;
+
+/* slabڴ */
+typedef struct _allocator_block_t {
+    allocator_header_t          header; /* ڴͷ, ȼзʱд */
+    struct _allocator_block_t*  next;   /* һڴ, ռûڴ */
+} allocator_block_t;
+
+/* ȵȼȫֿ */
+typedef struct _allocator_class_t {
+    atomic_counter_t   lock;     /*  */
+    allocator_block_t* free;     /* ڴ */
+    char*              slab;     /* ǰslabδзֵʼַ */
+    char*              slab_end; /* ǰslabַ */
+} allocator_class_t;
+
+/* ̻߳ */
+typedef struct _allocator_cache_t {
+    allocator_block_t*         free[ALLOCATOR_CLASS_COUNT];            /* ڴ */
+    uint32_t                   free_count[ALLOCATOR_CLASS_COUNT];      /* ڴ */
+    uint64_t                   alloc_count[ALLOCATOR_CLASS_COUNT + 1]; /* ۼƷ */
+    int64_t                    live_bytes[ALLOCATOR_CLASS_COUNT + 1];  /* ̷߳ͷŵֽ֮, Ϊ */
+    int                        active;                                 /* Ƿ߳ռ */
+    struct _allocator_cache_t* next;                                   /* ȫֻ */
+} allocator_cache_t;
+
+/* ȵȼ, ڴͷ */
+const uint32_t allocator_class_size[ALLOCATOR_CLASS_COUNT] = {
+    32, 64, 128, 256, 512, 1024, 2048, 4096
+};
+
+knet_allocator_type_e            allocator_type        = ALLOCATOR_TYPE; /* ǰ */
+knet_malloc_func_t               allocator_malloc      = 0;              /* Զ亯 */
+knet_realloc_func_t              allocator_realloc     = 0;              /* Զ·亯 */
+knet_free_func_t                 allocator_free        = 0;              /* Զͷź */
+allocator_class_t                allocator_class[ALLOCATOR_CLASS_COUNT];
+allocator_cache_t*               allocator_caches      = 0;              /* ̻߳ */
+atomic_counter_t                 allocator_lock        = 0;              /* ̻߳ */
+ALLOCATOR_TLS allocator_cache_t* allocator_tls         = 0;              /* ǰ̻߳ */
+volatile int                     allocator_custom_used = 0;              /* Զ亯Ƿڴ */
+int                              allocator_key_init    = 0;              /* ߳˳صǷѽ */
+#if defined(WIN32)
+DWORD                            allocator_key;                          /* ߳˳ʱ黹FLS */
+#else
+pthread_key_t                    allocator_key;                          /* ߳˳ʱ黹pthread */
+#endif /* defined(WIN32) */
+
+/**
+ * 
+ */
+void _allocator_spin_lock(atomic_counter_t* lock);
+
+/**
+ * 
+ */
+void _allocator_spin_unlock(atomic_counter_t* lock);
+
+/**
+ * ȡõǰ̻߳, ״εʱ˳̵߳Ļ
+ */
+allocator_cache_t* _allocator_get_cache();
+
+/**
+ * ߳˳ص, 黹̻߳
+ */
+#if defined(WIN32)
+void WINAPI _allocator_thread_exit(void* cache);
+#else
+void _allocator_thread_exit(void* cache);
+#endif /* defined(WIN32) */
+
+/**
+ * ̻߳пڴ黹ȫֿ, ɱ̸֮߳
+ */
+void _allocator_cache_flush(allocator_cache_t* cache);
+
+/**
+ * ȡóȶӦslabȼ, ȼ-1
+ */
+int _allocator_get_class(size_t size);
+
+/**
+ * ȫֿslabȡһڴ̻߳
+ */
+void _allocator_cache_fill(allocator_cache_t* cache, int index);
+
+/**
+ * ̻߳countڴ黹ȫֿ
+ */
+void _allocator_cache_release(allocator_cache_t* cache, int index, uint32_t count);
+
+/**
+ * ̻߳ÿȼౣڴ
+ */
+uint32_t _allocator_cache_max(int index);
+
+/**
+ * ǰͷ, ڴͷ
+ */
+allocator_header_t* _allocator_alloc(allocator_cache_t* cache, size_t size);
+
+/**
+ * ͳ
+ */
+void _allocator_stat(allocator_cache_t* cache, uint32_t kind, int64_t bytes, int alloc);
+
+void _allocator_spin_lock(atomic_counter_t* lock) {
+    while (atomic_counter_cas(lock, 0, 1)) {
+        thread_sleep_ms(0);
+    }
+}
+
+void _allocator_spin_unlock(atomic_counter_t* lock) {
+    atomic_counter_set(lock, 0);
+}
+
+allocator_cache_t* _allocator_get_cache() {
+    allocator_cache_t* cache = allocator_tls;
+    if (cache) {
+        return cache;
+    }
+    _allocator_spin_lock(&allocator_lock);
+    if (!allocator_key_init) {
+        /* δknet_allocator_thread_flush()߳˳ʱɻص黹 */
+#if defined(WIN32)
+        allocator_key = FlsAlloc(&_allocator_thread_exit);
+        allocator_key_init = (allocator_key != FLS_OUT_OF_INDEXES);
+#else
+        allocator_key_init = !pthread_key_create(&allocator_key, &_allocator_thread_exit);
+#endif /* defined(WIN32) */
+    }
+    for (cache = allocator_caches; cache; cache = cache->next) {
+        if (!cache->active) {
+            break;
+        }
+    }
+    if (!cache) {
+        cache = (allocator_cache_t*)malloc(sizeof(allocator_cache_t));
+        if (cache) {
+            memset(cache, 0, sizeof(allocator_cache_t));
+            cache->next      = allocator_caches;
+            allocator_caches = cache;
+        }
+    }
+    if (cache) {
+        cache->active = 1;
+    }
+    _allocator_spin_unlock(&allocator_lock);
+    allocator_tls = cache;
+    if (cache && allocator_key_init) {
+#if defined(WIN32)
+        FlsSetValue(allocator_key, cache);
+#else
+        pthread_setspecific(allocator_key, cache);
+#endif /* defined(WIN32) */
+    }
+    return cache;
+}
+
+#if defined(WIN32)
+void WINAPI _allocator_thread_exit(void* cache) {
+#else
+void _allocator_thread_exit(void* cache) {
+#endif /* defined(WIN32) */
+    if (cache) {
+        _allocator_cache_flush((allocator_cache_t*)cache);
+    }
+}
+
+void _allocator_cache_flush(allocator_cache_t* cache) {
+    int i = 0;
+    for (; i < ALLOCATOR_CLASS_COUNT; i++) {
+        _allocator_cache_release(cache, i, cache->free_count[i]);
+    }
+    if (allocator_tls == cache) {
+        allocator_tls = 0;
+    }
+    _allocator_spin_lock(&allocator_lock);
+    /* ͳݱ, ɸô˻̼߳ۼ */
+    cache->active = 0;
+    _allocator_spin_unlock(&allocator_lock);
+}
+
+int _allocator_get_class(size_t size) {
+    int i = 0;
+    for (; i < ALLOCATOR_CLASS_COUNT; i++) {
+        if (size <= allocator_class_size[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t _allocator_cache_max(int index) {
+    uint32_t count = ALLOCATOR_CACHE_BYTES / allocator_class_size[index];
+    return (count < ALLOCATOR_CACHE_MIN) ? ALLOCATOR_CACHE_MIN : count;
+}
+
+void _allocator_cache_fill(allocator_cache_t* cache, int index) {
+    allocator_class_t* klass = &allocator_class[index];
+    allocator_block_t* block = 0;
+    uint32_t           size  = allocator_class_size[index];
+    uint32_t           count = _allocator_cache_max(index) / 2;
+    uint32_t           i     = 0;
+    _allocator_spin_lock(&klass->lock);
+    for (; (i < count) && klass->free; i++) {
+        block        = klass->free;
+        klass->free  = block->next;
+        block->next  = cache->free[index];
+        cache->free[index] = block;
+    }
+    for (; i < count; i++) {
+        if (!klass->slab || (klass->slab + size > klass->slab_end)) {
+            /* slab黹ϵͳ, зֵڴȫֿ̻߳ת */
+            klass->slab = (char*)malloc(ALLOCATOR_SLAB_SIZE);
+            if (!klass->slab) {
+                klass->slab_end = 0;
+                break;
+            }
+            klass->slab_end = klass->slab + ALLOCATOR_SLAB_SIZE;
+        }
+        block              = (allocator_block_t*)klass->slab;
+        klass->slab       += size;
+        block->header.kind = (uint32_t)index;
+        block->next        = cache->free[index];
+        cache->free[index] = block;
+    }
+    _allocator_spin_unlock(&klass->lock);
+    cache->free_count[index] += i;
+}
+
+void _allocator_cache_release(allocator_cache_t* cache, int index, uint32_t count) {
+    allocator_class_t* klass = &allocator_class[index];
+    allocator_block_t* first = cache->free[index];
+    allocator_block_t* last  = first;
+    uint32_t           i     = 1;
+    if (!first || !count) {
+        return;
+    }
+    for (; (i < count) && last->next; i++) {
+        last = last->next;
+    }
+    cache->free[index]        = last->next;
+    cache->free_count[index] -= i;
+    _allocator_spin_lock(&klass->lock);
+    last->next  = klass->free;
+    klass->free = first;
+    _allocator_spin_unlock(&klass->lock);
+}
+
+void _allocator_stat(allocator_cache_t* cache, uint32_t kind, int64_t bytes, int alloc) {
+    int index = (kind < ALLOCATOR_CLASS_COUNT) ? (int)kind : ALLOCATOR_CLASS_COUNT;
+    if (!cache) {
+        return;
+    }
+    cache->live_bytes[index] += bytes;
+    if (alloc) {
+        cache->alloc_count[index]++;
+    }
+}
+
+allocator_header_t* _allocator_alloc(allocator_cache_t* cache, size_t size) {
+    allocator_header_t* header = 0;
+    allocator_block_t*  block  = 0;
+    int                 index  = -1;
+    if (allocator_type == allocator_type_custom) {
+        if (!allocator_custom_used) {
+            allocator_custom_used = 1;
+        }
+        header = (allocator_header_t*)allocator_malloc(size + sizeof(allocator_header_t));
+        if (header) {
+            header->kind = ALLOCATOR_KIND_CUSTOM;
+        }
+        return header;
+    }
+    if ((allocator_type == allocator_type_slab) && cache) {
+        index = _allocator_get_class(size + sizeof(allocator_header_t));
+    }
+    if (index >= 0) {
+        if (!cache->free[index]) {
+            _allocator_cache_fill(cache, index);
+        }
+        block = cache->free[index];
+        if (block) {
+            cache->free[index] = block->next;
+            cache->free_count[index]--;
+            return &block->header;
+        }
+    }
+    header = (allocator_header_t*)malloc(size + sizeof(allocator_header_t));
+    if (header) {
+        header->kind = ALLOCATOR_KIND_SYSTEM;
+    }
+    return header;
+}
+
+void* knet_malloc(size_t size) {
+    allocator_cache_t*  cache  = _allocator_get_cache();
+    allocator_header_t* header = _allocator_alloc(cache, size);
+    if (!header) {
+        return 0;
+    }
+    header->size = size;
+    _allocator_stat(cache, header->kind, (int64_t)size, 1);
+    return header + 1;
+}
+
+void* knet_realloc(void* ptr, size_t size) {
+    allocator_cache_t*  cache      = 0;
+    allocator_header_t* header     = 0;
+    allocator_header_t* new_header = 0;
+    void*               new_ptr    = 0;
+    uint64_t            old_size   = 0;
+    if (!ptr) {
+        return knet_malloc(size);
+    }
+    if (!size) {
+        knet_free(ptr);
+        return 0;
+    }
+    cache    = _allocator_get_cache();
+    header   = (allocator_header_t*)ptr - 1;
+    old_size = header->size;
+    if (header->kind < ALLOCATOR_CLASS_COUNT) {
+        if (size + sizeof(allocator_header_t) <= allocator_class_size[header->kind]) {
+            /* ԭڴ㹻 */
+            header->size = size;
+            _allocator_stat(cache, header->kind, (int64_t)size - (int64_t)old_size, 0);
+            return ptr;
+        }
+    } else if (((header->kind == ALLOCATOR_KIND_SYSTEM) && (allocator_type == allocator_type_system)) ||
+               ((header->kind == ALLOCATOR_KIND_SYSTEM) && (allocator_type == allocator_type_slab) &&
+                (_allocator_get_class(size + sizeof(allocator_header_t)) < 0)) || /* ڴϵͳ */
+               ((header->kind == ALLOCATOR_KIND_CUSTOM) && (allocator_type == allocator_type_custom))) {
+        if (header->kind == ALLOCATOR_KIND_SYSTEM) {
+            new_header = (allocator_header_t*)realloc(header, size + sizeof(allocator_header_t));
+        } else {
+            new_header = (allocator_header_t*)allocator_realloc(header, size + sizeof(allocator_header_t));
+        }
+        if (!new_header) {
+            return 0;
+        }
+        new_header->size = size;
+        _allocator_stat(cache, new_header->kind, (int64_t)size - (int64_t)old_size, 0);
+        return new_header + 1;
+    }
+    /* Դ뵱ǰͬҪslabȼ, ·䲢 */
+    new_ptr = knet_malloc(size);
+    if (!new_ptr) {
+        return 0;
+    }
+    memcpy(new_ptr, ptr, (size_t)((old_size < size) ? old_size : size));
+    knet_free(ptr);
+    return new_ptr;
+}
+
+void knet_free(void* ptr) {
+    allocator_cache_t*  cache  = 0;
+    allocator_header_t* header = 0;
+    allocator_block_t*  block  = 0;
+    uint32_t            index  = 0;
+    if (!ptr) {
+        return;
+    }
+    cache  = _allocator_get_cache();
+    header = (allocator_header_t*)ptr - 1;
+    index  = header->kind;
+    _allocator_stat(cache, index, -(int64_t)header->size, 0);
+    if (index == ALLOCATOR_KIND_SYSTEM) {
+        free(header);
+    } else if (index == ALLOCATOR_KIND_CUSTOM) {
+        allocator_free(header);
+    } else {
+        block = (allocator_block_t*)header;
+        if (!cache) {
+            _allocator_spin_lock(&allocator_class[index].lock);
+            block->next = allocator_class[index].free;
+            allocator_class[index].free = block;
+            _allocator_spin_unlock(&allocator_class[index].lock);
+            return;
+        }
+        block->next        = cache->free[index];
+        cache->free[index] = block;
+        cache->free_count[index]++;
+        if (cache->free_count[index] > _allocator_cache_max(index)) {
+            _allocator_cache_release(cache, index, cache->free_count[index] / 2);
+        }
+    }
+}
+
+void* knet_malloc_aligned(size_t size, size_t align) {
+    char* ptr     = 0;
+    char* aligned = 0;
+    verify(align && !(align & (align - 1)));
+    /* 볤ȼһָ, ַ֮ǰԭʼַ */
+    ptr = (char*)knet_malloc(size + align + sizeof(void*));
+    if (!ptr) {
+        return 0;
+    }
+    aligned = (char*)(((uintptr_t)(ptr + sizeof(void*)) + align - 1) & ~((uintptr_t)align - 1));
+    *((void**)aligned - 1) = ptr;
+    return aligned;
+}
+
+void knet_free_aligned(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    knet_free(*((void**)ptr - 1));
+}
+
+void knet_allocator_thread_flush() {
+    allocator_cache_t* cache = allocator_tls;
+    if (!cache) {
+        return;
+    }
+    if (allocator_key_init) {
+        /* Ѿ黹, ߳˳ʱٻص */
+#if defined(WIN32)
+        FlsSetValue(allocator_key, 0);
+#else
+        pthread_setspecific(allocator_key, 0);
+#endif /* defined(WIN32) */
+    }
+    _allocator_cache_flush(cache);
+}
+
+int knet_allocator_set_type(knet_allocator_type_e type) {
+    if ((type != allocator_type_system) && (type != allocator_type_slab) &&
+        (type != allocator_type_custom)) {
+        return error_invalid_parameters;
+    }
+    if ((type == allocator_type_custom) && !allocator_malloc) {
+        return error_invalid_parameters;
+    }
+    allocator_type = type;
+    return error_ok;
+}
+
+knet_allocator_type_e knet_allocator_get_type() {
+    return allocator_type;
+}
+
+int knet_allocator_set_custom(knet_malloc_func_t m, knet_realloc_func_t r, knet_free_func_t f) {
+    verify(m);
+    verify(r);
+    verify(f);
+    if (!m || !r || !f) {
+        return error_invalid_parameters;
+    }
+    if (allocator_custom_used) {
+        /* ѷڴԭͷźͷ */
+        return error_fail;
+    }
+    allocator_malloc  = m;
+    allocator_realloc = r;
+    allocator_free    = f;
+    return error_ok;
+}
+
+int knet_allocator_get_class_count() {
+    return ALLOCATOR_CLASS_COUNT;
+}
+
+uint32_t knet_allocator_get_class_size(int index) {
+    verify((index >= 0) && (index <= ALLOCATOR_CLASS_COUNT));
+    if ((index < 0) || (index >= ALLOCATOR_CLASS_COUNT)) {
+        return 0;
+    }
+    return allocator_class_size[index] - sizeof(allocator_header_t);
+}
+
+uint64_t knet_allocator_get_live_bytes(int index) {
+    allocator_cache_t* cache = 0;
+    int64_t            bytes = 0;
+    verify((index >= 0) && (index <= ALLOCATOR_CLASS_COUNT));
+    if ((index < 0) || (index > ALLOCATOR_CLASS_COUNT)) {
+        return 0;
+    }
+    _allocator_spin_lock(&allocator_lock);
+    for (cache = allocator_caches; cache; cache = cache->next) {
+        bytes += cache->live_bytes[index];
+    }
+    _allocator_spin_unlock(&allocator_lock);
+    return (bytes > 0) ? (uint64_t)bytes : 0;
+}
+
+uint64_t knet_allocator_get_alloc_count(int index) {
+    allocator_cache_t* cache = 0;
+    uint64_t           count = 0;
+    verify((index >= 0) && (index <= ALLOCATOR_CLASS_COUNT));
+    if ((index < 0) || (index > ALLOCATOR_CLASS_COUNT)) {
+        return 0;
+    }
+    _allocator_spin_lock(&allocator_lock);
+    for (cache = allocator_caches; cache; cache = cache->next) {
+        count += cache->alloc_count[index];
+    }
+    _allocator_spin_unlock(&allocator_lock);
+    return count;
+}
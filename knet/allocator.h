@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2014-2015, dennis wang
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include "config.h"
+#include "allocator_api.h"
+
+#define ALLOCATOR_CLASS_COUNT 8 /* slabȵȼ */
+
+/**
+ * ͷcreate()/rcreate()ڴ
+ * @param ptr ڴַ
+ */
+void knet_free(void* ptr);
+
+/**
+ * 䰴alignֽڶڴ, knet_malloc()䲢ͳ
+ * @param size 
+ * @param align ֽ, Ϊ2
+ * @retval 0 ʧ
+ * @retval Чڴַ
+ */
+void* knet_malloc_aligned(size_t size, size_t align);
+
+/**
+ * ͷknet_malloc_aligned()ڴ
+ * @param ptr ڴַ
+ */
+void knet_free_aligned(void* ptr);
+
+/**
+ * ǰ̻߳Ŀڴ黹ȫֿ
+ *
+ * ߳˳ǰ, ɱ̸֮߳
+ */
+void knet_allocator_thread_flush();
+
+#endif /* ALLOCATOR_H */
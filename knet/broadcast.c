@@ -22,18 +22,145 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "broadcast_api.h"
+#include "broadcast.h"
 #include "hash.h"
+#include "loop.h"
 #include "channel_ref.h"
+#include "buffer.h"
 #include "misc.h"
 #include "logger.h"
 
+typedef struct _broadcast_array_t broadcast_array_t;
+typedef struct _broadcast_members_t broadcast_members_t;
+
+/*
+ * ԱչĹܵ, ʱڵǰճ֮׷, ѷĿֻȡԼڵԪ,
+ * 뿪ʱ
+ */
+struct _broadcast_array_t {
+    atomic_counter_t ref;             /* ôĿ */
+    int              capacity;        /*  */
+    kchannel_ref_t*  channel_refs[1]; /* ܵ */
+};
+
+/*
+ * 㲥Ա, ޸. loop̱߳ڼղᱻ, ౻滻Ŀ
+ * ʱ
+ */
+struct _broadcast_members_t {
+    broadcast_members_t* next;    /* 滻 */
+    kchannel_ref_t*      retired; /* 滻ʱ뿪Ĺܵ, ջʱü */
+    int                  readers; /* loop߳ڱ˿յĲ, ڷ޸ */
+    int                  count;   /* ܵ */
+    broadcast_array_t*   array;   /* ܵ */
+};
+
+struct _broadcast_partition_t {
+    kbroadcast_t*                    broadcast; /* 㲥 */
+    kloop_t*                         loop;      /* kloop_t */
+    kbroadcast_partition_t* volatile next;      /* һ, ֻӲɾ */
+    broadcast_members_t*             members;   /* ǰԱ */
+    broadcast_members_t*             retired;   /* ڱ滻 */
+    klock_t*                         lock;      /* -Աշ */
+    atomic_counter_t                 count;     /* ܵ */
+};
+
 struct _broadcast_t {
-    uint64_t domain_id; /* ID */
-    khash_t* channels;  /* 㲥ڹܵ */
-    klock_t* lock;      /*  */
+    uint64_t                         domain_id;  /* ID */
+    khash_t*                         channels;   /* ܵUUID */
+    klock_t*                         lock;       /* -/뿪, 㲥ʹ */
+    kbroadcast_partition_t* volatile partitions; /* , 㲥ʱ */
+    kbroadcast_partition_t*          tail;       /* β */
+    atomic_counter_t                 count;      /* ܵ */
+    atomic_counter_t                 ref;        /* ü, δĹ㲥¼һ */
+    kbroadcast_t*                    next;       /* һ㲥 */
 };
 
+kbroadcast_t*    broadcast_list      = 0; /* й㲥, ܵǨʱҹܵڵķ */
+atomic_counter_t broadcast_list_lock = 0; /* 㲥 */
+
+/**
+ * 㲥
+ */
+void _broadcast_list_lock();
+
+/**
+ * 㲥
+ */
+void _broadcast_list_unlock();
+
+/**
+ * ü, Ϊʱٹ㲥
+ */
+void _broadcast_decref(kbroadcast_t* broadcast);
+
+/**
+ * ȡkloop_tӦķ, ʱβ
+ */
+kbroadcast_partition_t* _broadcast_get_partition(kbroadcast_t* broadcast, kloop_t* loop);
+
+/**
+ * ٷ
+ */
+void _broadcast_partition_destroy(kbroadcast_partition_t* partition);
+
+/**
+ * ܵ
+ */
+broadcast_array_t* _broadcast_array_create(int capacity);
+
+/**
+ * ٹܵü, Ϊʱ
+ */
+void _broadcast_array_decref(broadcast_array_t* array);
+
+/**
+ * arrayǰcountܵĳԱ, ʧʱδõarray
+ */
+broadcast_members_t* _broadcast_members_create(broadcast_array_t* array, int count);
+
+/**
+ * ٳԱ, 뿪ܵü
+ */
+void _broadcast_members_destroy(broadcast_members_t* members);
+
+/**
+ * ĩβ׷ӹܵĳԱ, 㹻ʱԭչܵ
+ */
+broadcast_members_t* _broadcast_members_append(broadcast_members_t* members, kchannel_ref_t* channel_ref);
+
+/**
+ * ȥܵĳԱ, ͨretiredرȥĹܵ
+ */
+broadcast_members_t* _broadcast_members_erase(broadcast_members_t* members, uint64_t uuid,
+    kchannel_ref_t** retired);
+
+/**
+ * ѹܵԭƶloopӦķ, ߳й㲥
+ */
+int _broadcast_move(kbroadcast_t* broadcast, kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * µĳԱ, ɿշ滻, ûбʱ
+ */
+void _broadcast_partition_publish(kbroadcast_partition_t* partition, broadcast_members_t* members,
+    kchannel_ref_t* retired);
+
+/**
+ * ûбloop̱߳滻
+ */
+void _broadcast_partition_reclaim(kbroadcast_partition_t* partition);
+
+/**
+ * ڷloop߳ڷ͹йܵ
+ */
+void _broadcast_partition_write(kbroadcast_partition_t* partition, kshared_buffer_t* shared);
+
+/**
+ * 鵱ǰ߳ǷǷloop߳
+ */
+int _broadcast_partition_in_loop(kbroadcast_partition_t* partition);
+
 kbroadcast_t* knet_broadcast_create() {
     kbroadcast_t* broadcast = create(kbroadcast_t);
     verify(broadcast);
@@ -43,20 +170,42 @@ kbroadcast_t* knet_broadcast_create() {
     /* һID */
     broadcast->domain_id = uuid_create();
     broadcast->lock      = lock_create();
+    broadcast->ref       = 1;
+    _broadcast_list_lock();
+    broadcast->next = broadcast_list;
+    broadcast_list  = broadcast;
+    _broadcast_list_unlock();
     return broadcast;
 }
 
 void knet_broadcast_destroy(kbroadcast_t* broadcast) {
-    khash_value_t*  value       = 0;
-    kchannel_ref_t* channel_ref = 0;
+    kbroadcast_t** prev = 0;
     verify(broadcast);
-    /*  */
-    if (broadcast->channels) {
-        hash_for_each_safe(broadcast->channels, value) {
-            channel_ref = (kchannel_ref_t*)hash_value_get_value(value);
-            verify(channel_ref);
-            knet_channel_ref_decref(channel_ref);
+    _broadcast_list_lock();
+    for (prev = &broadcast_list; *prev; prev = &(*prev)->next) {
+        if (*prev == broadcast) {
+            *prev = broadcast->next;
+            break;
         }
+    }
+    _broadcast_list_unlock();
+    /* δĹ㲥¼ */
+    _broadcast_decref(broadcast);
+}
+
+void _broadcast_decref(kbroadcast_t* broadcast) {
+    kbroadcast_partition_t* partition = 0;
+    kbroadcast_partition_t* next      = 0;
+    verify(broadcast);
+    if (atomic_counter_dec(&broadcast->ref) > 0) {
+        return;
+    }
+    /* з, ͬʱлڵĹܵ */
+    for (partition = broadcast->partitions; partition; partition = next) {
+        next = partition->next;
+        _broadcast_partition_destroy(partition);
+    }
+    if (broadcast->channels) {
         hash_destroy(broadcast->channels);
     }
     if (broadcast->lock) {
@@ -65,73 +214,389 @@ void knet_broadcast_destroy(kbroadcast_t* broadcast) {
     destroy(broadcast);
 }
 
+void _broadcast_list_lock() {
+    while (atomic_counter_cas(&broadcast_list_lock, 0, 1)) {
+        thread_sleep_ms(0);
+    }
+}
+
+void _broadcast_list_unlock() {
+    atomic_counter_set(&broadcast_list_lock, 0);
+}
+
+kbroadcast_partition_t* _broadcast_get_partition(kbroadcast_t* broadcast, kloop_t* loop) {
+    kbroadcast_partition_t* partition = 0;
+    for (partition = broadcast->partitions; partition; partition = partition->next) {
+        if (partition->loop == loop) {
+            return partition;
+        }
+    }
+    partition = create(kbroadcast_partition_t);
+    verify(partition);
+    if (!partition) {
+        return 0;
+    }
+    memset(partition, 0, sizeof(kbroadcast_partition_t));
+    partition->broadcast = broadcast;
+    partition->loop      = loop;
+    partition->lock      = lock_create();
+    partition->members   = _broadcast_members_create(_broadcast_array_create(BROADCAST_ARRAY_INIT_SIZE), 0);
+    if (!partition->lock || !partition->members) {
+        _broadcast_partition_destroy(partition);
+        return 0;
+    }
+    /* ʼɺٷ, CASͬʱΪڴ */
+    atomic_counter_cas(&partition->count, 0, 0);
+    if (broadcast->tail) {
+        broadcast->tail->next = partition;
+    } else {
+        broadcast->partitions = partition;
+    }
+    broadcast->tail = partition;
+    return partition;
+}
+
+void _broadcast_partition_destroy(kbroadcast_partition_t* partition) {
+    broadcast_members_t* members = 0;
+    int                  i       = 0;
+    verify(partition);
+    if (partition->members) {
+        for (i = 0; i < partition->members->count; i++) {
+            knet_channel_ref_decrease_broadcast_count(partition->members->array->channel_refs[i]);
+            knet_channel_ref_decref(partition->members->array->channel_refs[i]);
+        }
+        _broadcast_members_destroy(partition->members);
+    }
+    while (partition->retired) {
+        members = partition->retired;
+        partition->retired = members->next;
+        _broadcast_members_destroy(members);
+    }
+    if (partition->lock) {
+        lock_destroy(partition->lock);
+    }
+    destroy(partition);
+}
+
+broadcast_array_t* _broadcast_array_create(int capacity) {
+    broadcast_array_t* array = (broadcast_array_t*)create_raw(
+        sizeof(broadcast_array_t) + sizeof(kchannel_ref_t*) * capacity);
+    verify(array);
+    if (!array) {
+        return 0;
+    }
+    array->ref      = 0;
+    array->capacity = capacity;
+    return array;
+}
+
+void _broadcast_array_decref(broadcast_array_t* array) {
+    /* Ŀտֱܷloop̼̻߳߳ */
+    if (!atomic_counter_dec(&array->ref)) {
+        destroy(array);
+    }
+}
+
+broadcast_members_t* _broadcast_members_create(broadcast_array_t* array, int count) {
+    broadcast_members_t* members = 0;
+    if (!array) {
+        return 0;
+    }
+    members = create(broadcast_members_t);
+    verify(members);
+    if (!members) {
+        if (atomic_counter_zero(&array->ref)) {
+            destroy(array);
+        }
+        return 0;
+    }
+    members->next    = 0;
+    members->retired = 0;
+    members->readers = 0;
+    members->count   = count;
+    members->array   = array;
+    atomic_counter_inc(&array->ref);
+    return members;
+}
+
+void _broadcast_members_destroy(broadcast_members_t* members) {
+    verify(members);
+    if (members->retired) {
+        knet_channel_ref_decref(members->retired);
+    }
+    _broadcast_array_decref(members->array);
+    destroy(members);
+}
+
+broadcast_members_t* _broadcast_members_append(broadcast_members_t* members, kchannel_ref_t* channel_ref) {
+    broadcast_array_t* array = members->array;
+    if (members->count >= array->capacity) {
+        /* ӱ, NܵĸΪO(N) */
+        array = _broadcast_array_create(array->capacity * 2);
+        if (!array) {
+            return 0;
+        }
+        memcpy(array->channel_refs, members->array->channel_refs, sizeof(kchannel_ref_t*) * members->count);
+    }
+    /* ֻڵǰ֮׷, λѷյĳ֮ */
+    array->channel_refs[members->count] = channel_ref;
+    return _broadcast_members_create(array, members->count + 1);
+}
+
+broadcast_members_t* _broadcast_members_erase(broadcast_members_t* members, uint64_t uuid,
+    kchannel_ref_t** retired) {
+    int                i     = 0;
+    int                j     = 0;
+    broadcast_array_t* array = _broadcast_array_create(members->array->capacity);
+    if (!array) {
+        return 0;
+    }
+    *retired = 0;
+    for (i = 0; i < members->count; i++) {
+        if (!*retired && (knet_channel_ref_get_uuid(members->array->channel_refs[i]) == uuid)) {
+            *retired = members->array->channel_refs[i];
+        } else if (j < members->count - 1) {
+            array->channel_refs[j++] = members->array->channel_refs[i];
+        }
+    }
+    verify(*retired);
+    return _broadcast_members_create(array, members->count - 1);
+}
+
+int _broadcast_partition_in_loop(kbroadcast_partition_t* partition) {
+    return (knet_loop_get_thread_id(partition->loop) == thread_get_self_id());
+}
+
+void _broadcast_partition_publish(kbroadcast_partition_t* partition, broadcast_members_t* members,
+    kchannel_ref_t* retired) {
+    broadcast_members_t* old = 0;
+    lock_lock(partition->lock);
+    old = partition->members;
+    old->retired = retired;
+    old->next = partition->retired;
+    partition->retired = old;
+    partition->members = members;
+    lock_unlock(partition->lock);
+    /* ڱloop̱߳Ŀڱ */
+    _broadcast_partition_reclaim(partition);
+}
+
+void _broadcast_partition_reclaim(kbroadcast_partition_t* partition) {
+    broadcast_members_t*  members = 0;
+    broadcast_members_t*  next    = 0;
+    broadcast_members_t*  free    = 0;
+    broadcast_members_t** prev    = 0;
+    lock_lock(partition->lock);
+    for (prev = &partition->retired; *prev;) {
+        members = *prev;
+        if (members->readers) {
+            prev = &members->next;
+        } else {
+            *prev = members->next;
+            members->next = free;
+            free = members;
+        }
+    }
+    lock_unlock(partition->lock);
+    /* , ܼ뿪ܵü */
+    for (members = free; members; members = next) {
+        next = members->next;
+        _broadcast_members_destroy(members);
+    }
+}
+
+void _broadcast_partition_write(kbroadcast_partition_t* partition, kshared_buffer_t* shared) {
+    broadcast_members_t* members = 0;
+    int                  retired = 0;
+    lock_lock(partition->lock);
+    members = partition->members;
+    /* ڼձ滻Ҳ, ܵصڿٴι㲥,  */
+    members->readers++;
+    lock_unlock(partition->lock);
+    knet_channel_ref_update_send_batch_in_loop(partition->loop, members->array->channel_refs, members->count, shared);
+    lock_lock(partition->lock);
+    members->readers--;
+    retired = (partition->retired != 0);
+    lock_unlock(partition->lock);
+    if (retired) {
+        _broadcast_partition_reclaim(partition);
+    }
+}
+
+void knet_broadcast_update_partition_in_loop(kloop_t* loop, kbroadcast_partition_t* partition,
+    kshared_buffer_t* shared) {
+    verify(loop);
+    verify(partition);
+    verify(shared);
+    verify(partition->loop == loop);
+    _broadcast_partition_write(partition, shared);
+    knet_shared_buffer_decref(shared);
+    _broadcast_decref(partition->broadcast);
+}
+
+void knet_broadcast_partition_event_discard(kbroadcast_partition_t* partition, kshared_buffer_t* shared) {
+    verify(partition);
+    if (shared) {
+        knet_shared_buffer_decref(shared);
+    }
+    _broadcast_decref(partition->broadcast);
+}
+
 int knet_broadcast_join(kbroadcast_t* broadcast, kchannel_ref_t* channel_ref) {
-    uint64_t uuid  = 0;
-    int      error = error_ok;
+    uint64_t                uuid      = 0;
+    int                     error     = error_ok;
+    kbroadcast_partition_t* partition = 0;
+    broadcast_members_t*    members   = 0;
     verify(broadcast);
     verify(channel_ref);
-    lock_lock(broadcast->lock);
-    /* ü */
-    knet_channel_ref_incref(channel_ref);
     uuid = knet_channel_ref_get_uuid(channel_ref);
-    /* ӵ㲥ڵ */
-    error = hash_add(broadcast->channels, uuid_get_high32(uuid), channel_ref);
+    lock_lock(broadcast->lock);
+    if (hash_get(broadcast->channels, uuid_get_high32(uuid))) {
+        lock_unlock(broadcast->lock);
+        return error_broadcast_joined;
+    }
+    /* Ӽٶȡkloop_t, ͬʱǨkloop_t߿, Ǩkloop_t */
+    knet_channel_ref_increase_broadcast_count(channel_ref);
+    partition = _broadcast_get_partition(broadcast, knet_channel_ref_get_loop(channel_ref));
+    if (!partition) {
+        knet_channel_ref_decrease_broadcast_count(channel_ref);
+        lock_unlock(broadcast->lock);
+        return error_no_memory;
+    }
+    /* ׷ӺĿ, ɿȻڱloop̱߳ */
+    members = _broadcast_members_append(partition->members, channel_ref);
+    if (!members) {
+        knet_channel_ref_decrease_broadcast_count(channel_ref);
+        lock_unlock(broadcast->lock);
+        return error_no_memory;
+    }
+    error = hash_add(broadcast->channels, uuid_get_high32(uuid), partition);
     if (error_ok != error) {
+        knet_channel_ref_decrease_broadcast_count(channel_ref);
         lock_unlock(broadcast->lock);
+        _broadcast_members_destroy(members);
         return error;
     }
+    /* ü */
+    knet_channel_ref_incref(channel_ref);
+    _broadcast_partition_publish(partition, members, 0);
+    atomic_counter_inc(&partition->count);
+    atomic_counter_inc(&broadcast->count);
     lock_unlock(broadcast->lock);
     return error_ok;
 }
 
 int knet_broadcast_leave(kbroadcast_t* broadcast, kchannel_ref_t* channel_ref) {
-    uint64_t uuid  = 0;
+    uint64_t                uuid      = 0;
+    kbroadcast_partition_t* partition = 0;
+    broadcast_members_t*    members   = 0;
+    kchannel_ref_t*         retired   = 0;
     verify(broadcast);
     verify(channel_ref);
     verify(knet_channel_ref_check_share(channel_ref));
     uuid = knet_channel_ref_get_uuid(channel_ref);
     lock_lock(broadcast->lock);
-    if (!hash_get(broadcast->channels, uuid_get_high32(uuid))) {
+    partition = (kbroadcast_partition_t*)hash_get(broadcast->channels, uuid_get_high32(uuid));
+    if (!partition) {
         lock_unlock(broadcast->lock);
         return error_broadcast_not_found;
     }
-    /* ü */
-    knet_channel_ref_decref(channel_ref);
+    /* ȥ뿪ܵĿ */
+    members = _broadcast_members_erase(partition->members, uuid, &retired);
+    if (!members) {
+        lock_unlock(broadcast->lock);
+        return error_no_memory;
+    }
     hash_delete(broadcast->channels, uuid_get_high32(uuid));
+    knet_channel_ref_decrease_broadcast_count(channel_ref);
+    /* ɿջʱü */
+    _broadcast_partition_publish(partition, members, retired);
+    atomic_counter_dec(&partition->count);
+    atomic_counter_dec(&broadcast->count);
     lock_unlock(broadcast->lock);
     return error_ok;
 }
 
+int _broadcast_move(kbroadcast_t* broadcast, kloop_t* loop, kchannel_ref_t* channel_ref) {
+    uint64_t                uuid      = 0;
+    kbroadcast_partition_t* partition = 0;
+    kbroadcast_partition_t* target    = 0;
+    broadcast_members_t*    joined    = 0;
+    broadcast_members_t*    left      = 0;
+    kchannel_ref_t*         retired   = 0;
+    uuid = knet_channel_ref_get_uuid(channel_ref);
+    partition = (kbroadcast_partition_t*)hash_get(broadcast->channels, uuid_get_high32(uuid));
+    if (!partition || (partition->loop == loop)) {
+        /* ڹ㲥ڻѾڶӦ */
+        return error_ok;
+    }
+    target = _broadcast_get_partition(broadcast, loop);
+    if (!target) {
+        return error_no_memory;
+    }
+    /* նɹٷ, ʧʱܵԭ, 㲥ԭkloop_tת */
+    joined = _broadcast_members_append(target->members, channel_ref);
+    left   = joined ? _broadcast_members_erase(partition->members, uuid, &retired) : 0;
+    if (!left) {
+        if (joined) {
+            _broadcast_members_destroy(joined);
+        }
+        return error_no_memory;
+    }
+    hash_replace(broadcast->channels, uuid_get_high32(uuid), target);
+    /* ·һ, ԭԭջʱ, ԭkloop_tڱԭ */
+    knet_channel_ref_incref(channel_ref);
+    _broadcast_partition_publish(target, joined, 0);
+    _broadcast_partition_publish(partition, left, retired);
+    atomic_counter_inc(&target->count);
+    atomic_counter_dec(&partition->count);
+    return error_ok;
+}
+
+void knet_broadcast_update_channel_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    kbroadcast_t* broadcast = 0;
+    verify(loop);
+    verify(channel_ref);
+    _broadcast_list_lock();
+    for (broadcast = broadcast_list; broadcast; broadcast = broadcast->next) {
+        lock_lock(broadcast->lock);
+        _broadcast_move(broadcast, loop, channel_ref);
+        lock_unlock(broadcast->lock);
+    }
+    _broadcast_list_unlock();
+}
+
 int knet_broadcast_get_count(kbroadcast_t* broadcast) {
-    int count = 0;
     verify(broadcast);
-    verify(broadcast->channels);
-    verify(broadcast->lock);
-    lock_lock(broadcast->lock);
-    count = hash_get_size(broadcast->channels);
-    lock_unlock(broadcast->lock);
-    return count;
+    return (int)broadcast->count;
 }
 
 int knet_broadcast_write(kbroadcast_t* broadcast, char* buffer, uint32_t size) {
-    khash_value_t*  value       = 0;
-    kchannel_ref_t* channel_ref = 0;
-    int             error       = 0;
-    int             count       = 0;
+    kbroadcast_partition_t* partition = 0;
+    kshared_buffer_t*       shared    = 0;
+    int                     count     = 0;
     verify(broadcast);
     verify(buffer);
     verify(size);
-    verify(broadcast->channels);
-    verify(broadcast->lock);
-    lock_lock(broadcast->lock);
-    hash_for_each_safe(broadcast->channels, value) {
-        channel_ref = (kchannel_ref_t*)hash_value_get_value(value);
-        verify(channel_ref);
-        error = knet_channel_ref_write(channel_ref, buffer, size);
-        if (error == error_ok) {
-            count++;
+    /* ֻһ, йܵͬһ */
+    shared = knet_shared_buffer_create(buffer, size);
+    if (!shared) {
+        return 0;
+    }
+    /* , ÿkloop_tֻͶһ¼, kloop_ṯ߳ڹܵ */
+    for (partition = broadcast->partitions; partition; partition = partition->next) {
+        if (!partition->count) {
+            continue;
+        }
+        count += (int)partition->count;
+        if (_broadcast_partition_in_loop(partition)) {
+            _broadcast_partition_write(partition, shared);
+        } else {
+            atomic_counter_inc(&broadcast->ref);
+            knet_shared_buffer_incref(shared);
+            knet_loop_notify_broadcast(partition->loop, partition, shared);
         }
     }
-    lock_unlock(broadcast->lock);
+    knet_shared_buffer_decref(shared);
     return count;
 }
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2014-2015, dennis wang
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include "config.h"
+#include "broadcast_api.h"
+
+/**
+ * ڷloop߳ڷ͹йܵ
+ *
+ * ͷ¼еĹ㲥ü
+ * @param loop kloop_tʵ
+ * @param partition kbroadcast_partition_tʵ
+ * @param shared 
+ */
+void knet_broadcast_update_partition_in_loop(kloop_t* loop, kbroadcast_partition_t* partition,
+    kshared_buffer_t* shared);
+
+/**
+ * δĹ㲥¼, ͷ¼еĹ㲥ü
+ * @param partition kbroadcast_partition_tʵ
+ * @param shared , Ϊ0
+ */
+void knet_broadcast_partition_event_discard(kbroadcast_partition_t* partition, kshared_buffer_t* shared);
+
+/**
+ * ܵǨkloop_tӺ, ѹܵƶkloop_tĹ㲥
+ *
+ * й㲥, ڹܵkloop_t߳ڵ
+ * @param loop ܵkloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_broadcast_update_channel_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+#endif /* BROADCAST_H */
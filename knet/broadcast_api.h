@@ -40,6 +40,9 @@
  *
  * knet_broadcast_get_countԵ֪㲥ڵĹܵknet_broadcast_writeһ
  * 㲥ڹܵյ㲥.
+ *
+ * ڹܵkloop_t, /뿪ʱƷĳԱղ¿, ɿɷ
+ * kloop_t̻߳. 㲥, ÿֻͶһ¼, ɷkloop_ṯ߳ڹܵ.
  * </pre>
  * @{
  */
@@ -65,6 +68,7 @@ extern void knet_broadcast_destroy(kbroadcast_t* broadcast);
  * @param broadcast kbroadcast_tʵ
  * @param channel_ref kchannel_ref_t
  * @retval error_ok ɹ
+ * @retval error_broadcast_joined ܵѾڹ㲥
  * @retval  ʧ
  */
 extern int knet_broadcast_join(kbroadcast_t* broadcast, kchannel_ref_t* channel_ref);
@@ -72,7 +76,7 @@ extern int knet_broadcast_join(kbroadcast_t* broadcast, kchannel_ref_t* channel_
 /**
  * 뿪㲥
  *
- * غܵѾ٣Ҫٴη
+ * غҪٴη, ڹܵkloop_t̻߳վɳԱʱ
  * @param broadcast kbroadcast_tʵ
  * @param channel_ref kchannel_ref_tʵknet_broadcast_join()
  * @retval error_ok ɹ
@@ -89,10 +93,13 @@ extern int knet_broadcast_get_count(kbroadcast_t* broadcast);
 
 /**
  * 㲥
+ *
+ * ֻһε, йܵķͬһ. ǰ߳kloop_tķֱ
+ * , ÿֻͶһ߳¼, /뿪
  * @param broadcast kbroadcast_tʵ
  * @param buffer ָ
  * @param size 
- * @return ͳɹܵ
+ * @return 㲥ʱڹܵ
  */
 extern int knet_broadcast_write(kbroadcast_t* broadcast, char* buffer, uint32_t size);
 
@@ -23,13 +23,24 @@
  */
 
 #include "buffer.h"
+#include "list.h"
+#include "misc.h"
 #include "logger.h"
 
 
 struct _buffer_t {
-    char*    ptr; /* ʼַ */
-    uint32_t len; /*  */
-    uint32_t pos; /* ǰλ */
+    char*             ptr;    /* ʼַ */
+    uint32_t          len;    /*  */
+    uint32_t          pos;    /* ǰλ */
+    uint32_t          off;    /* Ѿ()ֽ */
+    kshared_buffer_t* shared; /* õĹ, Ϊ0ʱptrָ */
+    kdlist_node_t     node;   /* Ƕڵ, ڴ */
+};
+
+struct _shared_buffer_t {
+    atomic_counter_t ref;  /* ü */
+    uint32_t         len;  /* ݳ */
+    char*            ptr;  /* ݵַ, 뱾ṹһη */
 };
 
 kbuffer_t* knet_buffer_create(uint32_t size) {
@@ -38,13 +49,17 @@ kbuffer_t* knet_buffer_create(uint32_t size) {
     if (!sb) {
         return 0;
     }
+    /* ռ, ù */
+    sb->shared = 0;
     sb->ptr = create_raw(size);
     verify(sb->ptr);
     if (!sb->ptr) {
         knet_buffer_destroy(sb);
     }
     sb->pos = 0;
+    sb->off = 0;
     sb->len = size;
+    dlist_node_set_data(dlist_node_init(&sb->node), sb);
     return sb;
 }
 
@@ -53,7 +68,9 @@ void knet_buffer_destroy(kbuffer_t* sb) {
     if (!sb) {
         return;
     }
-    if (sb->ptr) {
+    if (sb->shared) {
+        knet_shared_buffer_decref(sb->shared);
+    } else if (sb->ptr) {
         destroy(sb->ptr);
     }
     if (sb) {
@@ -81,7 +98,7 @@ uint32_t knet_buffer_get_length(kbuffer_t* sb) {
     if (!sb) {
         return 0;
     }
-    return sb->pos;
+    return sb->pos - sb->off;
 }
 
 uint32_t knet_buffer_get_max_size(kbuffer_t* sb) {
@@ -97,7 +114,15 @@ int knet_buffer_enough(kbuffer_t* sb, uint32_t size) {
     if (!sb) {
         return 0;
     }
-    return (sb->pos + size > sb->len);
+    return (sb->pos + size <= sb->len);
+}
+
+uint32_t knet_buffer_get_free_size(kbuffer_t* sb) {
+    verify(sb);
+    if (!sb) {
+        return 0;
+    }
+    return sb->len - sb->pos;
 }
 
 char* knet_buffer_get_ptr(kbuffer_t* sb) {
@@ -105,7 +130,7 @@ char* knet_buffer_get_ptr(kbuffer_t* sb) {
     if (!sb) {
         return 0;
     }
-    return sb->ptr;
+    return sb->ptr + sb->off;
 }
 
 void knet_buffer_adjust(kbuffer_t* sb, uint32_t gap) {
@@ -113,7 +138,11 @@ void knet_buffer_adjust(kbuffer_t* sb, uint32_t gap) {
     if (!sb) {
         return;
     }
-    sb->ptr += gap;
+    /* ƶʼַ, ʱҪԭʼַ */
+    if (gap > sb->pos - sb->off) {
+        gap = sb->pos - sb->off;
+    }
+    sb->off += gap;
 }
 
 void knet_buffer_clear(kbuffer_t* sb) {
@@ -121,9 +150,97 @@ void knet_buffer_clear(kbuffer_t* sb) {
     if (!sb) {
         return;
     }
-    if (!sb->ptr) {
+    if (!sb->ptr || sb->shared) {
+        /* ֻ */
         return;
     }
-    sb->ptr = sb->ptr - sb->pos;
     sb->pos = 0;
+    sb->off = 0;
+}
+
+kdlist_node_t* knet_buffer_get_list_node(kbuffer_t* sb) {
+    verify(sb);
+    return &sb->node;
+}
+
+kbuffer_t* knet_buffer_create_shared(kshared_buffer_t* shared) {
+    kbuffer_t* sb = 0;
+    verify(shared);
+    sb = create(kbuffer_t);
+    verify(sb);
+    if (!sb) {
+        return 0;
+    }
+    knet_shared_buffer_incref(shared);
+    /* Ѿд, д */
+    sb->shared = shared;
+    sb->ptr    = shared->ptr;
+    sb->len    = shared->len;
+    sb->pos    = shared->len;
+    sb->off    = 0;
+    dlist_node_set_data(dlist_node_init(&sb->node), sb);
+    return sb;
+}
+
+int knet_buffer_check_shared(kbuffer_t* sb) {
+    verify(sb);
+    return (sb->shared != 0);
+}
+
+kshared_buffer_t* knet_shared_buffer_create(const char* data, uint32_t size) {
+    kiovec_t iov;
+    verify(data);
+    verify(size);
+    iov.buffer = data;
+    iov.size   = (int)size;
+    return knet_shared_buffer_createv(&iov, 1);
+}
+
+kshared_buffer_t* knet_shared_buffer_createv(const kiovec_t* iov, int count) {
+    kshared_buffer_t* shared = 0;
+    uint32_t          size   = 0;
+    int               i      = 0;
+    verify(iov);
+    verify(count);
+    for (; i < count; i++) {
+        size += (uint32_t)iov[i].size;
+    }
+    /* ṹһη */
+    shared = (kshared_buffer_t*)create_raw(sizeof(kshared_buffer_t) + size);
+    verify(shared);
+    if (!shared) {
+        return 0;
+    }
+    shared->ref = 1;
+    shared->len = 0;
+    shared->ptr = (char*)shared + sizeof(kshared_buffer_t);
+    for (i = 0; i < count; i++) {
+        if (iov[i].size) {
+            memcpy(shared->ptr + shared->len, iov[i].buffer, iov[i].size);
+            shared->len += (uint32_t)iov[i].size;
+        }
+    }
+    return shared;
+}
+
+void knet_shared_buffer_incref(kshared_buffer_t* shared) {
+    verify(shared);
+    atomic_counter_inc(&shared->ref);
+}
+
+void knet_shared_buffer_decref(kshared_buffer_t* shared) {
+    verify(shared);
+    if (!atomic_counter_dec(&shared->ref)) {
+        destroy(shared);
+    }
+}
+
+const char* knet_shared_buffer_get_ptr(kshared_buffer_t* shared) {
+    verify(shared);
+    return shared->ptr;
+}
+
+uint32_t knet_shared_buffer_get_length(kshared_buffer_t* shared) {
+    verify(shared);
+    return shared->len;
 }
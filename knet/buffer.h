@@ -73,6 +73,13 @@ uint32_t knet_buffer_get_max_size(kbuffer_t* sb);
  */
 int knet_buffer_enough(kbuffer_t* sb, uint32_t size);
 
+/**
+ * ȡûʣд볤
+ * @param sb kbuffer_tʵ
+ * @return ʣд볤
+ */
+uint32_t knet_buffer_get_free_size(kbuffer_t* sb);
+
 /**
  * ȡûʼַ
  * @param sb kbuffer_tʵ
@@ -93,4 +100,70 @@ void knet_buffer_adjust(kbuffer_t* sb, uint32_t gap);
  */
 void knet_buffer_clear(kbuffer_t* sb);
 
+/**
+ * ȡûǶڵ, ڵԶΪ
+ * @param sb kbuffer_tʵ
+ * @return kdlist_node_tʵ
+ */
+kdlist_node_t* knet_buffer_get_list_node(kbuffer_t* sb);
+
+/**
+ * ùķͻ, 
+ *
+ * ͻйһ, ʱͷ, д
+ * @param shared kshared_buffer_tʵ
+ * @return kbuffer_tʵ
+ */
+kbuffer_t* knet_buffer_create_shared(kshared_buffer_t* shared);
+
+/**
+ * Ƿù
+ * @param sb kbuffer_tʵ
+ * @retval 0 
+ * @retval  
+ */
+int knet_buffer_check_shared(kbuffer_t* sb);
+
+/**
+ * , ݿһ, ֻ֮, üΪ1
+ * @param data ָ
+ * @param size ݳ
+ * @return kshared_buffer_tʵ
+ */
+kshared_buffer_t* knet_shared_buffer_create(const char* data, uint32_t size);
+
+/**
+ * , οݿ
+ * @param iov ݿ
+ * @param count ݿ
+ * @return kshared_buffer_tʵ
+ */
+kshared_buffer_t* knet_shared_buffer_createv(const kiovec_t* iov, int count);
+
+/**
+ * ӹü, ̵߳
+ * @param shared kshared_buffer_tʵ
+ */
+void knet_shared_buffer_incref(kshared_buffer_t* shared);
+
+/**
+ * ٹü, Ϊ0ʱ
+ * @param shared kshared_buffer_tʵ
+ */
+void knet_shared_buffer_decref(kshared_buffer_t* shared);
+
+/**
+ * ȡùݵַ
+ * @param shared kshared_buffer_tʵ
+ * @return ݵַ
+ */
+const char* knet_shared_buffer_get_ptr(kshared_buffer_t* shared);
+
+/**
+ * ȡùݳ
+ * @param shared kshared_buffer_tʵ
+ * @return ݳ
+ */
+uint32_t knet_shared_buffer_get_length(kshared_buffer_t* shared);
+
 #endif /* BUFFER_H */
@@ -32,35 +32,89 @@
 
 
 struct _channel_t {
-    kdlist_t*      send_buffer_list;  /* , ʧܵݻᷨȴ´η */
-    uint32_t       max_send_list_len; /* 󳤶 */
-    kringbuffer_t* recv_ringbuffer;   /* λ, ͨsocketȡݻ */
-    socket_t       socket_fd;         /* ׽ */
-    uint64_t       uuid;              /* ܵUUID */
+    kdlist_t         send_buffer_list;    /* , ʧܵݻᷨȴ´η, ڵǶڷͻ */
+    kdlist_t         send_chunk_pool;     /* ѷϵĿзͿ, д븴 */
+    uint32_t         max_send_list_len;   /* 󳤶 */
+    uint32_t         send_list_bytes;     /* ڵȴ͵ֽ */
+    uint32_t         send_high_watermark; /* ˮλ(ֽ), ܾд, 0Ϊ */
+    uint32_t         send_low_watermark;  /* ˮλ(ֽ), ܾдҽˮλʱ֪ͨ */
+    atomic_counter_t send_pending_bytes;  /* ߳Ͷݵkloop_tδķֽ */
+    atomic_counter_t send_blocked;        /* ˮλ󱻾ܾдı־ */
+    int              flag;                /* ܵ־ */
+    kringbuffer_t*   recv_ringbuffer;     /* λ, ͨsocketȡݻ */
+    uint32_t         max_recv_buffer_len; /* λ󳤶, ӳʼȱ */
+    uint32_t         min_recv_buffer_len; /* λʼ, ʱ */
+    socket_t         socket_fd;           /* ׽ */
+    uint64_t         uuid;                /* ܵUUID */
 };
 
-kchannel_t* knet_channel_create(uint32_t max_send_list_len, uint32_t recv_ring_len) {
-    socket_t socket_fd = socket_create();
-    verify(socket_fd > 0);
-    if (socket_fd <= 0) {
-        return 0;
-    }
-    return knet_channel_create_exist_socket_fd(socket_fd, max_send_list_len, recv_ring_len);
+atomic_counter_t recv_buffer_total_kb  = 0; /* йܵջռãKB */
+atomic_counter_t recv_buffer_budget_kb = 0; /* йܵջԤ㣨KB, 0Ϊ */
+
+/**
+ * ռýջԤ, forceΪʱԤ
+ * @retval error_ok ɹ
+ * @retval error_fail Ԥ
+ */
+int _channel_recv_budget_acquire(uint32_t size, int force);
+
+/**
+ * 黹ջԤ
+ */
+void _channel_recv_budget_release(uint32_t size);
+
+/**
+ * ջʱ, 󳤶ȺͽԤ
+ * @retval error_ok ɹ
+ * @retval  Ѵﵽ󳤶Ȼ򳬹Ԥ
+ */
+int _channel_recv_buffer_grow(kchannel_t* channel);
+
+/**
+ * ȡһзͿ, ȴӿзͿȡ
+ */
+kbuffer_t* _channel_chunk_get(kchannel_t* channel);
+
+/**
+ * ѷϵķͻ, ̶СķͿŻؿ
+ */
+void _channel_chunk_put(kchannel_t* channel, kbuffer_t* send_buffer);
+
+/**
+ * ׷ӵβ, СݺϲһͿ
+ */
+void _channel_send_list_append(kchannel_t* channel, const char* data, uint32_t size);
+
+uint32_t knet_channel_get_object_size() {
+    return sizeof(kchannel_t);
 }
 
-kchannel_t* knet_channel_create_exist_socket_fd(socket_t socket_fd, uint32_t max_send_list_len, uint32_t recv_ring_len) {
-    kchannel_t* channel = create(kchannel_t);
+kchannel_t* knet_channel_init(void* ptr, socket_t socket_fd, uint32_t max_send_list_len, uint32_t recv_ring_len, int flag) {
+    kchannel_t* channel = (kchannel_t*)ptr;
+    uint32_t    len     = recv_ring_len;
     verify(channel);
     memset(channel, 0, sizeof(kchannel_t));
     channel->uuid = uuid_create();
-    channel->send_buffer_list = dlist_create();
-    verify(channel->send_buffer_list);
-    channel->recv_ringbuffer = ringbuffer_create(recv_ring_len);
+    dlist_init(&channel->send_buffer_list);
+    dlist_init(&channel->send_chunk_pool);
+    if (len > CHANNEL_RECV_BUFFER_INIT_SIZE) {
+        /* ӳʼȿʼ, 豶 */
+        len = CHANNEL_RECV_BUFFER_INIT_SIZE;
+    }
+    if (flag & channel_flag_mirror_recv_buffer) {
+        /* ӳ䳤ȡΪҳС */
+        channel->recv_ringbuffer = ringbuffer_create_mirror(len);
+    } else {
+        channel->recv_ringbuffer = ringbuffer_create(len);
+    }
     verify(channel->recv_ringbuffer);
+    channel->max_recv_buffer_len = recv_ring_len;
+    channel->min_recv_buffer_len = ringbuffer_get_max_size(channel->recv_ringbuffer);
+    /* ʼǷ, Ԥ */
+    _channel_recv_budget_acquire(channel->min_recv_buffer_len, 1);
+    channel->flag = flag;
     channel->max_send_list_len = max_send_list_len;
     channel->socket_fd = socket_fd;
-    /* Ϊ */
-    socket_set_non_blocking_on(channel->socket_fd);
     /* رӳٷ */
     socket_set_nagle_off(channel->socket_fd);
     /* رTIME_WAIT */
@@ -70,24 +124,27 @@ kchannel_t* knet_channel_create_exist_socket_fd(socket_t socket_fd, uint32_t max
     return channel;
 }
 
-void knet_channel_destroy(kchannel_t* channel) {
+void knet_channel_fini(kchannel_t* channel) {
     kdlist_node_t* node        = 0;
     kdlist_node_t* temp        = 0;
     kbuffer_t*     send_buffer = 0;
     verify(channel);
-    /* δ͵ */
-    if (channel->send_buffer_list) {
-        dlist_for_each_safe(channel->send_buffer_list, node, temp) {
-            send_buffer = (kbuffer_t*)dlist_node_get_data(node);
-            knet_buffer_destroy(send_buffer);
-        }
-        dlist_destroy(channel->send_buffer_list);
+    /* δ͵, ڵǶڻ, Ƴ */
+    dlist_for_each_safe(&channel->send_buffer_list, node, temp) {
+        send_buffer = (kbuffer_t*)dlist_node_get_data(node);
+        dlist_remove(&channel->send_buffer_list, node);
+        knet_buffer_destroy(send_buffer);
+    }
+    dlist_for_each_safe(&channel->send_chunk_pool, node, temp) {
+        send_buffer = (kbuffer_t*)dlist_node_get_data(node);
+        dlist_remove(&channel->send_chunk_pool, node);
+        knet_buffer_destroy(send_buffer);
     }
     /* ٽջ */
     if (channel->recv_ringbuffer) {
+        _channel_recv_budget_release(ringbuffer_get_max_size(channel->recv_ringbuffer));
         ringbuffer_destroy(channel->recv_ringbuffer);
     }
-    destroy(channel);
 }
 
 int knet_channel_connect(kchannel_t* channel, const char* ip, int port) {
@@ -110,32 +167,79 @@ int knet_channel_accept(kchannel_t* channel, const char* ip, int port, int backl
 }
 
 int knet_channel_send_buffer(kchannel_t* channel, kbuffer_t* send_buffer) {
+    kdlist_node_t* tail = 0;
     verify(channel);
     verify(send_buffer);
-    verify(channel->send_buffer_list);
     /* ʼ޷ */
     if (knet_channel_send_list_reach_max(channel)) {
         knet_buffer_destroy(send_buffer);
         return error_send_fail;
     }
-    /* ͻӵβ */
-    dlist_add_tail_node(channel->send_buffer_list, send_buffer);
+    tail = dlist_get_back(&channel->send_buffer_list);
+    if (tail && knet_buffer_enough((kbuffer_t*)dlist_node_get_data(tail), knet_buffer_get_length(send_buffer))) {
+        /* ϲһͿ */
+        _channel_send_list_append(channel, knet_buffer_get_ptr(send_buffer), knet_buffer_get_length(send_buffer));
+        knet_buffer_destroy(send_buffer);
+    } else {
+        /* ͻӵβ */
+        channel->send_list_bytes += knet_buffer_get_length(send_buffer);
+        dlist_add_tail(&channel->send_buffer_list, knet_buffer_get_list_node(send_buffer));
+    }
     /* õд¼ */
     return error_send_patial;
 }
 
+int knet_channel_send_shared(kchannel_t* channel, kshared_buffer_t* shared) {
+    kdlist_node_t* tail        = 0;
+    kbuffer_t*     send_buffer = 0;
+    int            bytes       = 0;
+    uint32_t       size        = 0;
+    verify(channel);
+    verify(shared);
+    /* ʼ޷ */
+    if (knet_channel_send_list_reach_max(channel)) {
+        return error_send_fail;
+    }
+    size = knet_shared_buffer_get_length(shared);
+    if (dlist_empty(&channel->send_buffer_list)) {
+        /* ֱӷ */
+        bytes = socket_send(channel->socket_fd, knet_shared_buffer_get_ptr(shared), (int)size);
+    }
+    if (bytes < 0) {
+        return error_send_fail;
+    }
+    if (size == (uint32_t)bytes) {
+        return error_ok;
+    }
+    tail = dlist_get_back(&channel->send_buffer_list);
+    if (tail && knet_buffer_enough((kbuffer_t*)dlist_node_get_data(tail), size - (uint32_t)bytes)) {
+        /* ϲһͿ */
+        _channel_send_list_append(channel, knet_shared_buffer_get_ptr(shared) + bytes, size - (uint32_t)bytes);
+    } else {
+        /* ù, ѷͲ */
+        send_buffer = knet_buffer_create_shared(shared);
+        verify(send_buffer);
+        if (!send_buffer) {
+            return error_send_fail;
+        }
+        knet_buffer_adjust(send_buffer, (uint32_t)bytes);
+        channel->send_list_bytes += knet_buffer_get_length(send_buffer);
+        dlist_add_tail(&channel->send_buffer_list, knet_buffer_get_list_node(send_buffer));
+    }
+    /* ҪԺ */
+    return error_send_patial;
+}
+
 int knet_channel_send(kchannel_t* channel, const char* data, int size) {
-    int        bytes       = 0;
-    kbuffer_t* send_buffer = 0;
+    int bytes = 0;
     verify(channel);
     verify(data);
     verify(size);
-    verify(channel->send_buffer_list);
     /* ʼ޷ */
     if (knet_channel_send_list_reach_max(channel)) {
         return error_send_fail;
     }
-    if (dlist_empty(channel->send_buffer_list)) {
+    if (dlist_empty(&channel->send_buffer_list)) {
         /* ֱӷ */
         bytes = socket_send(channel->socket_fd, data, size);
     }
@@ -144,39 +248,103 @@ int knet_channel_send(kchannel_t* channel, const char* data, int size) {
     }
     /* ֱӷʧܣûзϵֽڷ뷢ȴ´η */
     if (size > bytes) {
-        send_buffer = knet_buffer_create(size - bytes);
-        verify(send_buffer);
-        knet_buffer_put(send_buffer, data + bytes, size - bytes);
-        dlist_add_tail_node(channel->send_buffer_list, send_buffer);
+        _channel_send_list_append(channel, data + bytes, (uint32_t)(size - bytes));
         /* ҪԺ */
         return error_send_patial;
     }
     return error_ok;
 }
 
+int knet_channel_sendv(kchannel_t* channel, const kiovec_t* iov, int count) {
+    int      i     = 0;
+    int      bytes = 0;
+    uint32_t size  = 0;
+    uint32_t skip  = 0;
+    verify(channel);
+    verify(iov);
+    verify(count);
+    /* ʼ޷ */
+    if (knet_channel_send_list_reach_max(channel)) {
+        return error_send_fail;
+    }
+    for (i = 0; i < count; i++) {
+        size += (uint32_t)iov[i].size;
+    }
+    if (!size) {
+        return error_ok;
+    }
+    if (dlist_empty(&channel->send_buffer_list)) {
+        /* ֱӷ */
+        bytes = socket_sendv(channel->socket_fd, iov, count);
+    }
+    if (bytes < 0) {
+        return error_send_fail;
+    }
+    if (size == (uint32_t)bytes) {
+        return error_ok;
+    }
+    /* ûзϵֽڷ뷢ȴ´η */
+    for (i = 0, skip = (uint32_t)bytes; i < count; i++) {
+        if (skip >= (uint32_t)iov[i].size) {
+            skip -= (uint32_t)iov[i].size;
+            continue;
+        }
+        _channel_send_list_append(channel, (const char*)iov[i].buffer + skip, iov[i].size - skip);
+        skip = 0;
+    }
+    /* ҪԺ */
+    return error_send_patial;
+}
+
 int knet_channel_update_send(kchannel_t* channel) {
     kdlist_node_t* node        = 0;
     kdlist_node_t* temp        = 0;
     kbuffer_t*     send_buffer = 0;
-    int           bytes       = 0;
+    int            count       = 0;
+    int            bytes       = 0;
+    uint32_t       size        = 0;
+    uint32_t       left        = 0;
+    kiovec_t       iov[CHANNEL_SEND_IOV_MAX];
     verify(channel);
-    verify(channel->send_buffer_list);
-    /*  */
-    dlist_for_each_safe(channel->send_buffer_list, node, temp) {
-        send_buffer = (kbuffer_t*)dlist_node_get_data(node);
-        bytes = socket_send(channel->socket_fd, knet_buffer_get_ptr(send_buffer), knet_buffer_get_length(send_buffer));
+    while (!dlist_empty(&channel->send_buffer_list)) {
+        /* ÿϲCHANNEL_SEND_IOV_MAXͻ */
+        count = 0;
+        size  = 0;
+        dlist_for_each(&channel->send_buffer_list, node) {
+            if (count == CHANNEL_SEND_IOV_MAX) {
+                dlist_for_each_break();
+            }
+            send_buffer = (kbuffer_t*)dlist_node_get_data(node);
+            iov[count].buffer = knet_buffer_get_ptr(send_buffer);
+            iov[count].size   = (int)knet_buffer_get_length(send_buffer);
+            size += (uint32_t)iov[count].size;
+            count++;
+        }
+        bytes = socket_sendv(channel->socket_fd, iov, count);
         if (bytes < 0) {
             return error_send_fail;
         }
-        if (knet_buffer_get_length(send_buffer) > (uint32_t)bytes) {
-            /* δϣbufferȣȴ´η */
-            knet_buffer_adjust(send_buffer, bytes);
-            /* ַ */
+        /* ѷϵĽڵ, ַ͵Ļ */
+        left = (uint32_t)bytes;
+        dlist_for_each_safe(&channel->send_buffer_list, node, temp) {
+            if (!left) {
+                dlist_for_each_break();
+            }
+            send_buffer = (kbuffer_t*)dlist_node_get_data(node);
+            if (knet_buffer_get_length(send_buffer) > left) {
+                knet_buffer_adjust(send_buffer, left);
+                channel->send_list_bytes -= left;
+                left = 0;
+            } else {
+                left -= knet_buffer_get_length(send_buffer);
+                channel->send_list_bytes -= knet_buffer_get_length(send_buffer);
+                dlist_remove(&channel->send_buffer_list, node);
+                _channel_chunk_put(channel, send_buffer);
+            }
+        }
+        if ((uint32_t)bytes < size) {
+            /* ַ, ȴ´η */
             return error_send_patial;
-        } else {
-            /* ѷͽڵ */
-            knet_buffer_destroy(send_buffer);
-            dlist_delete(channel->send_buffer_list, node);
         }
     }
     /* ȫ */
@@ -190,11 +358,19 @@ int knet_channel_update_recv(kchannel_t* channel) {
     char*    ptr        = 0;
     verify(channel);
     verify(channel->recv_ringbuffer);
-    if (ringbuffer_full(channel->recv_ringbuffer)) {
-        /* ر, , ɸС */
+    if (ringbuffer_full(channel->recv_ringbuffer) && (error_ok != _channel_recv_buffer_grow(channel))) {
+        /* Ҳ󣬹ر, , ɸС */
         return error_recv_buffer_full;
     }
-    for (; (size = ringbuffer_write_lock_size(channel->recv_ringbuffer));) {
+    for (;;) {
+        size = ringbuffer_write_lock_size(channel->recv_ringbuffer);
+        if (!size) {
+            /* ,  */
+            if (error_ok != _channel_recv_buffer_grow(channel)) {
+                break;
+            }
+            continue;
+        }
         ptr = ringbuffer_write_lock_ptr(channel->recv_ringbuffer);
         bytes = socket_recv(channel->socket_fd, ptr, size);
         if (bytes < 0) {
@@ -238,10 +414,106 @@ uint32_t knet_channel_get_max_send_list_len(kchannel_t* channel) {
 }
 
 uint32_t knet_channel_get_max_recv_buffer_len(kchannel_t* channel) {
+    verify(channel);
+    return channel->max_recv_buffer_len;
+}
+
+uint32_t knet_channel_get_recv_buffer_len(kchannel_t* channel) {
     verify(channel);
     return ringbuffer_get_max_size(channel->recv_ringbuffer);
 }
 
+int knet_channel_check_recv_buffer_grown(kchannel_t* channel) {
+    verify(channel);
+    return (ringbuffer_get_max_size(channel->recv_ringbuffer) > channel->min_recv_buffer_len);
+}
+
+int knet_channel_shrink_recv_buffer(kchannel_t* channel) {
+    uint32_t size = 0;
+    verify(channel);
+    size = ringbuffer_get_max_size(channel->recv_ringbuffer);
+    if ((size <= channel->min_recv_buffer_len) || !ringbuffer_empty(channel->recv_ringbuffer)) {
+        return error_fail;
+    }
+    if (error_ok != ringbuffer_resize(channel->recv_ringbuffer, channel->min_recv_buffer_len)) {
+        return error_fail;
+    }
+    _channel_recv_budget_release(size);
+    _channel_recv_budget_acquire(channel->min_recv_buffer_len, 1);
+    return error_ok;
+}
+
+void knet_channel_set_recv_buffer_budget(uint64_t budget) {
+    /* ȡΪKB */
+    budget = (budget + 1023) / 1024;
+    if (budget > INT_MAX) {
+        budget = INT_MAX;
+    }
+    atomic_counter_set(&recv_buffer_budget_kb, (atomic_counter_t)budget);
+}
+
+uint64_t knet_channel_get_recv_buffer_total() {
+    return (uint64_t)recv_buffer_total_kb * 1024;
+}
+
+int _channel_recv_budget_acquire(uint32_t size, int force) {
+    atomic_counter_t total  = 0;
+    atomic_counter_t budget = recv_buffer_budget_kb;
+    atomic_counter_t kb     = (atomic_counter_t)((size + 1023) / 1024);
+    for (;;) {
+        total = recv_buffer_total_kb;
+        if (!force && budget && (total + kb > budget)) {
+            return error_fail;
+        }
+        if (total == atomic_counter_cas(&recv_buffer_total_kb, total, total + kb)) {
+            return error_ok;
+        }
+    }
+}
+
+void _channel_recv_budget_release(uint32_t size) {
+    atomic_counter_t total = 0;
+    atomic_counter_t kb    = (atomic_counter_t)((size + 1023) / 1024);
+    for (;;) {
+        total = recv_buffer_total_kb;
+        if (total == atomic_counter_cas(&recv_buffer_total_kb, total, total - kb)) {
+            return;
+        }
+    }
+}
+
+int _channel_recv_buffer_grow(kchannel_t* channel) {
+    uint32_t size     = ringbuffer_get_max_size(channel->recv_ringbuffer);
+    uint32_t new_size = size;
+    if (size >= channel->max_recv_buffer_len) {
+        return error_recv_buffer_full;
+    }
+    new_size = size * 2;
+    if ((new_size < size) || (new_size > channel->max_recv_buffer_len)) {
+        new_size = channel->max_recv_buffer_len;
+    }
+    /* Ȱ³ռԤ, ɹ黹ԭ */
+    if (error_ok != _channel_recv_budget_acquire(new_size, 0)) {
+        return error_recv_buffer_full;
+    }
+    if (error_ok != ringbuffer_resize(channel->recv_ringbuffer, new_size)) {
+        _channel_recv_budget_release(new_size);
+        return error_recv_buffer_full;
+    }
+    _channel_recv_budget_release(size);
+    if (ringbuffer_get_max_size(channel->recv_ringbuffer) != new_size) {
+        /* ӳεĻȡΪҳС, ʵʳռԤ */
+        _channel_recv_budget_release(new_size);
+        _channel_recv_budget_acquire(ringbuffer_get_max_size(channel->recv_ringbuffer), 1);
+    }
+    return error_ok;
+}
+
+int knet_channel_get_flag(kchannel_t* channel) {
+    verify(channel);
+    return channel->flag;
+}
+
 uint64_t knet_channel_get_uuid(kchannel_t* channel) {
     verify(channel);
     return channel->uuid;
@@ -249,5 +521,126 @@ uint64_t knet_channel_get_uuid(kchannel_t* channel) {
 
 int knet_channel_send_list_reach_max(kchannel_t* channel) {
     verify(channel);
-    return (dlist_get_count(channel->send_buffer_list) > (int)channel->max_send_list_len);
+    return (dlist_get_count(&channel->send_buffer_list) > (int)channel->max_send_list_len);
+}
+
+void knet_channel_set_send_watermark(kchannel_t* channel, uint32_t high, uint32_t low) {
+    verify(channel);
+    if (low > high) {
+        low = high;
+    }
+    channel->send_high_watermark = high;
+    channel->send_low_watermark  = low;
+}
+
+uint32_t knet_channel_get_send_list_bytes(kchannel_t* channel) {
+    verify(channel);
+    return channel->send_list_bytes;
+}
+
+int knet_channel_check_send_watermark(kchannel_t* channel, uint32_t size) {
+    verify(channel);
+    if (!channel->send_high_watermark) {
+        return error_ok;
+    }
+    if (channel->send_list_bytes + (uint32_t)channel->send_pending_bytes + size > channel->send_high_watermark) {
+        return error_send_watermark;
+    }
+    return error_ok;
+}
+
+int knet_channel_set_send_blocked(kchannel_t* channel) {
+    verify(channel);
+    return (0 == atomic_counter_cas(&channel->send_blocked, 0, 1));
+}
+
+void knet_channel_add_send_pending(kchannel_t* channel, uint32_t size) {
+    atomic_counter_t pending = 0;
+    verify(channel);
+    for (;;) {
+        pending = channel->send_pending_bytes;
+        if (pending == atomic_counter_cas(&channel->send_pending_bytes, pending, pending + (atomic_counter_t)size)) {
+            return;
+        }
+    }
+}
+
+void knet_channel_sub_send_pending(kchannel_t* channel, uint32_t size) {
+    atomic_counter_t pending = 0;
+    verify(channel);
+    for (;;) {
+        pending = channel->send_pending_bytes;
+        if (pending == atomic_counter_cas(&channel->send_pending_bytes, pending, pending - (atomic_counter_t)size)) {
+            return;
+        }
+    }
+}
+
+int knet_channel_check_send_drained(kchannel_t* channel) {
+    verify(channel);
+    if (atomic_counter_zero(&channel->send_blocked)) {
+        return 0;
+    }
+    if (channel->send_list_bytes + (uint32_t)channel->send_pending_bytes > channel->send_low_watermark) {
+        return 0;
+    }
+    /* ֻ־ɹһ֪ͨ */
+    return (1 == atomic_counter_cas(&channel->send_blocked, 1, 0));
+}
+
+kbuffer_t* _channel_chunk_get(kchannel_t* channel) {
+    kdlist_node_t* node        = 0;
+    kbuffer_t*     send_buffer = 0;
+    node = dlist_get_front(&channel->send_chunk_pool);
+    if (node) {
+        send_buffer = (kbuffer_t*)dlist_node_get_data(node);
+        dlist_remove(&channel->send_chunk_pool, node);
+        return send_buffer;
+    }
+    return knet_buffer_create(CHANNEL_SEND_CHUNK_SIZE);
+}
+
+void _channel_chunk_put(kchannel_t* channel, kbuffer_t* send_buffer) {
+    if (knet_buffer_check_shared(send_buffer) ||
+        (knet_buffer_get_max_size(send_buffer) != CHANNEL_SEND_CHUNK_SIZE) ||
+        (dlist_get_count(&channel->send_chunk_pool) >= CHANNEL_SEND_CHUNK_POOL)) {
+        /* , дĶĿпֱ */
+        knet_buffer_destroy(send_buffer);
+        return;
+    }
+    knet_buffer_clear(send_buffer);
+    dlist_add_tail(&channel->send_chunk_pool, knet_buffer_get_list_node(send_buffer));
+}
+
+void _channel_send_list_append(kchannel_t* channel, const char* data, uint32_t size) {
+    kdlist_node_t* tail        = 0;
+    kbuffer_t*     send_buffer = 0;
+    uint32_t       bytes       = 0;
+    channel->send_list_bytes += size;
+    tail = dlist_get_back(&channel->send_buffer_list);
+    if (tail) {
+        /* һͿʣռ */
+        send_buffer = (kbuffer_t*)dlist_node_get_data(tail);
+        bytes = knet_buffer_get_free_size(send_buffer);
+        if (bytes > size) {
+            bytes = size;
+        }
+        if (bytes) {
+            knet_buffer_put(send_buffer, data, bytes);
+            data += bytes;
+            size -= bytes;
+        }
+    }
+    if (!size) {
+        return;
+    }
+    if (size >= CHANNEL_SEND_CHUNK_SIZE) {
+        /* дʹöĻ,  */
+        send_buffer = knet_buffer_create(size);
+    } else {
+        send_buffer = _channel_chunk_get(channel);
+    }
+    verify(send_buffer);
+    knet_buffer_put(send_buffer, data, size);
+    dlist_add_tail(&channel->send_buffer_list, knet_buffer_get_list_node(send_buffer));
 }
@@ -28,27 +28,29 @@
 #include "config.h"
 
 /**
- * һkchannel_tʵ
- * @param max_send_list_len 󳤶
- * @param recv_ring_len ܻ󳤶
- * @return kchannel_tʵ
+ * ȡkchannel_tʵ, Ƕ
+ * @return kchannel_tʵ
  */
-kchannel_t* knet_channel_create(uint32_t max_send_list_len, uint32_t recv_ring_len);
+uint32_t knet_channel_get_object_size();
 
 /**
- * һkchannel_tʵ
+ * ڵṩڴڽkchannel_tʵ
+ *
+ * ׽ֱѾǷ
+ * @param ptr ڴַ, Ϊknet_channel_get_object_size()
  * @param socket_fd ѽ׽
  * @param max_send_list_len 󳤶
  * @param recv_ring_len ܻ󳤶
+ * @param flag ܵ־, knet_channel_flag_e
  * @return kchannel_tʵ
  */
-kchannel_t* knet_channel_create_exist_socket_fd(socket_t socket_fd, uint32_t max_send_list_len, uint32_t recv_ring_len);
+kchannel_t* knet_channel_init(void* ptr, socket_t socket_fd, uint32_t max_send_list_len, uint32_t recv_ring_len, int flag);
 
 /**
- * kchannel_tʵ
+ * kchannel_tʵеԴ, ͷʵڴ
  * @param channel kchannel_tʵ
  */
-void knet_channel_destroy(kchannel_t* channel);
+void knet_channel_fini(kchannel_t* channel);
 
 /**
  * Ӽ
@@ -89,6 +91,18 @@ void knet_channel_close(kchannel_t* channel);
  */
 int knet_channel_send(kchannel_t* channel, const char* data, int size);
 
+/**
+ * ۼ
+ * Ϊյʱ򣬻ȳһϵͳ÷ݿ飬δ͵ĲֺϲΪһͻ
+ * ŵĩβȴʵʱ.
+ * @param channel kchannel_tʵ
+ * @param iov ݿ
+ * @param count ݿ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_channel_sendv(kchannel_t* channel, const kiovec_t* iov, int count);
+
 /**
  * 
  * ŵĩβȴʵʱ.
@@ -99,6 +113,17 @@ int knet_channel_send(kchannel_t* channel, const char* data, int size);
  */
 int knet_channel_send_buffer(kchannel_t* channel, kbuffer_t* send_buffer);
 
+/**
+ * ͹
+ * Ϊյʱ򣬻ȳһϵͳ÷ͣδ͵Ĳ÷ʽŵĩβ,
+ * . ʣಿܺϲһͿʱֱӿ
+ * @param channel kchannel_tʵ
+ * @param shared kshared_buffer_tʵ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_channel_send_shared(kchannel_t* channel, kshared_buffer_t* shared);
+
 /**
  * д¼֪ͨ
  * @param channel kchannel_tʵ
@@ -143,6 +168,48 @@ uint32_t knet_channel_get_max_send_list_len(kchannel_t* channel);
  */
 uint32_t knet_channel_get_max_recv_buffer_len(kchannel_t* channel);
 
+/**
+ * ȡýջǰ
+ * @param channel kchannel_tʵ
+ * @return ջǰ
+ */
+uint32_t knet_channel_get_recv_buffer_len(kchannel_t* channel);
+
+/**
+ * ջǷѾʼ
+ * @param channel kchannel_tʵ
+ * @retval 0 δ
+ * @retval  ѱ, ʱ
+ */
+int knet_channel_check_recv_buffer_grown(kchannel_t* channel);
+
+/**
+ * ջΪʱسʼ
+ * @param channel kchannel_tʵ
+ * @retval error_ok ɹ
+ * @retval  Ҫ߻ڻ
+ */
+int knet_channel_shrink_recv_buffer(kchannel_t* channel);
+
+/**
+ * ýйܵջԤ, Ԥջ
+ * @param budget Ԥ㣨ֽڣ, 0Ϊ
+ */
+void knet_channel_set_recv_buffer_budget(uint64_t budget);
+
+/**
+ * ȡýйܵջռõڴ
+ * @return ռõڴ棨ֽڣ
+ */
+uint64_t knet_channel_get_recv_buffer_total();
+
+/**
+ * ȡùܵ־
+ * @param channel kchannel_tʵ
+ * @return ܵ־
+ */
+int knet_channel_get_flag(kchannel_t* channel);
+
 /**
  * ȡܵUUID
  * @param channel kchannel_tʵ
@@ -158,4 +225,59 @@ uint64_t knet_channel_get_uuid(kchannel_t* channel);
  */
 int knet_channel_send_list_reach_max(kchannel_t* channel);
 
+/**
+ * ÷ߵˮλ
+ * @param channel kchannel_tʵ
+ * @param high ˮλ(ֽ), 0Ϊ
+ * @param low ˮλ(ֽ), ڸˮλʱڸˮλ
+ */
+void knet_channel_set_send_watermark(kchannel_t* channel, uint32_t high, uint32_t low);
+
+/**
+ * ȡ÷ڵȴ͵ֽ
+ * @param channel kchannel_tʵ
+ * @return ȴ͵ֽ
+ */
+uint32_t knet_channel_get_send_list_bytes(kchannel_t* channel);
+
+/**
+ * дͶδֽǷ񳬹ˮλ
+ * @param channel kchannel_tʵ
+ * @param size д볤
+ * @retval error_ok δ
+ * @retval error_send_watermark ˮλ
+ */
+int knet_channel_check_send_watermark(kchannel_t* channel, uint32_t size);
+
+/**
+ * ¼ܾд־, ̵߳
+ * @param channel kchannel_tʵ
+ * @retval 0 ־Ѿ
+ * @retval  ε˱־
+ */
+int knet_channel_set_send_blocked(kchannel_t* channel);
+
+/**
+ * ߳Ͷݵkloop_tδķֽ
+ * @param channel kchannel_tʵ
+ * @param size Ͷݳ
+ */
+void knet_channel_add_send_pending(kchannel_t* channel, uint32_t size);
+
+/**
+ * kloop_tͶݵķͺδķֽ
+ * @param channel kchannel_tʵ
+ * @param size Ͷݳ
+ */
+void knet_channel_sub_send_pending(kchannel_t* channel, uint32_t size);
+
+/**
+ * ⱻܾдķǷѾˮλ, طʱܾ־
+ * ֻkloop_tе߳ڵ
+ * @param channel kchannel_tʵ
+ * @retval 0 
+ * @retval  
+ */
+int knet_channel_check_send_drained(kchannel_t* channel);
+
 #endif /* CHANNEL_H */
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "channel_ref.h"
 #include "channel.h"
 #include "loop.h"
+#include "list.h"
 #include "misc.h"
 #include "stream.h"
 #include "loop_balancer.h"
@@ -32,54 +33,172 @@
 #include "ringbuffer.h"
 #include "address.h"
 #include "loop_profile.h"
+#include "broadcast.h"
 #include "logger.h"
 
+/**
+ * һѽܵĿͻ׽
+ */
+void _channel_ref_accept_client(kchannel_ref_t* channel_ref, socket_t client_fd);
+
+/**
+ * kloop_tе߳ڷ͹
+ */
+int _channel_ref_send_shared_in_loop(kchannel_ref_t* channel_ref, kshared_buffer_t* shared);
+
+/**
+ * ǰ߳ǷΪܵkloop_t߳, Ǩ;еĹܵκ߳
+ */
+int _channel_ref_check_in_loop(kchannel_ref_t* channel_ref);
+
+/**
+ * Ǩ״̬delta, ֵ
+ */
+atomic_counter_t _channel_ref_add_migrate_state(kchannel_ref_t* channel_ref, atomic_counter_t delta);
+
+/**
+ * ߳Ͷݷ/ر¼ǰ, δ¼ͶݵĿkloop_t
+ */
+kloop_t* _channel_ref_post_acquire(kchannel_ref_t* channel_ref);
+
+/**
+ * Ŀkloop_tѾǨûδķ/ر¼ʱǨƱ־
+ */
+void _channel_ref_check_migrate_done(kchannel_ref_t* channel_ref);
+
+/**
+ * ߳ͷһʱkloop_t, ٹرڵȴͷŵĹܵ
+ */
+void _channel_ref_check_release(kloop_t* loop, int ref);
+
+/**
+ * дǷ񳬹ˮλ, ܾ߳̾дʱתkloop_t߳ٴμˮλ
+ */
+int _channel_ref_check_send_watermark(kchannel_ref_t* channel_ref, uint32_t size);
+
+/**
+ * ջȱ仯ʱkloop_tͳ
+ * @retval 0 δ仯
+ * @retval  ѱ仯
+ */
+int _channel_ref_update_recv_buffer_len(kchannel_ref_t* channel_ref);
+
+/**
+ * յݻ뿪kloop_tʱб־
+ */
+void _channel_ref_clear_recv_idle(kchannel_ref_t* channel_ref);
+
+/**
+ * ܾдķˮλʱ֪ͨ
+ */
+void _channel_ref_check_send_drained(kchannel_ref_t* channel_ref);
+
+typedef struct _channel_ref_fanout_loop_t {
+    kloop_t*            loop;  /* Ŀkloop_t */
+    kloop_send_batch_t* batch; /*  */
+} channel_ref_fanout_loop_t;
+
+struct _channel_ref_fanout_t {
+    kshared_buffer_t*          shared;    /*  */
+    channel_ref_fanout_loop_t* loops;     /* ÿĿkloop_t */
+    int                        count;     /* Ŀkloop_t */
+    int                        max_count; /* 鳤 */
+    int                        last;      /* ϴʹõλ, ڹܵͨͬһkloop_t */
+};
 
 typedef struct _channel_ref_info_t {
+    /* ݳԱ, ܵһλڹܵĵһ */
+    volatile knet_channel_state_e state;                /* ܵ״̬ */
+    knet_channel_event_e          event;                /* ܵͶ¼ */
+    knet_channel_ref_cb_t         cb;                   /* ص */
+    time_t                        last_recv_ts;         /* һζʱʱӺ룩 */
+    socket_t                      socket_fd;            /* ׽ */
+    int                           flag;                 /* ѡȡʹԶ־λ */
     /* ݳԱ */
-    int                           balance;              /* Ƿ񱻸ؾ־ */
     kchannel_t*                   channel;              /* ڲܵ */
-    kdlist_node_t*                loop_node;            /* ܵڵ */
     kstream_t*                    stream;               /* ܵ(/д) */
     kloop_t*                      loop;                 /* ܵkloop_t */
+    void*                         data;                 /* ѡȡʹԶ */
+    kdlist_node_t                 loop_node;            /* ܵڵ, Ƕ */
+    kdlist_node_t                 timeout_node;         /* ʱʱڵ, Ƕ */
+    kdlist_t*                     timeout_list;         /* ڵʱֲλ */
     kaddress_t*                   peer_address;         /* Զ˵ַ */
     kaddress_t*                   local_address;        /* صַ */
-    knet_channel_event_e          event;                /* ܵͶ¼ */
-    volatile knet_channel_state_e state;                /* ܵ״̬ */
     atomic_counter_t              ref_count;            /* ü */
-    knet_channel_ref_cb_t         cb;                   /* ص */
-    time_t                        last_recv_ts;         /* һζʱ룩 */
-    time_t                        timeout;              /* гʱ룩 */
-    time_t                        last_connect_timeout; /* һconnect()ʱ룩 */
-    time_t                        connect_timeout;      /* connect()ʱ룩 */
+    int                           balance;              /* Ƿ񱻸ؾ־ */
+    time_t                        timeout;              /* гʱ룩 */
+    time_t                        last_connect_timeout; /* һconnect()ʱʱӺ룩 */
+    time_t                        connect_timeout;      /* connect()ʱ룩 */
     int                           auto_reconnect;       /* Զ־ */
-    int                           flag;                 /* ѡȡʹԶ־λ */
-    void*                         data;                 /* ѡȡʹԶ */
+    int                           reuse_port;           /* ˿ü־, Ӳ븺ؾ */
     void*                         user_data;            /* ûָ - ڲʹ */
     void*                         user_ptr;             /* ¶ⲿʹõָ - ⲿʹ */
     /* չݳԱ */
+    kloop_t*                      migrate_loop;         /* ǨĿkloop_t, kloop_tͬʱеȴǨ */
+    kloop_t*                      migrate_from;         /* Ǩԭkloop_t, ǨƱ־ǰ߳¼Ͷݵ */
+    atomic_counter_t              migrate_state;        /* λΪǨƱ־, λΪ߳Ͷݻδķ/ر¼ */
+    uint32_t                      load_bytes;           /* ϴθɨշֽ, ǨʱѡȡæĹܵ */
+    uint32_t                      recv_buffer_len;      /* Ѽkloop_tͳƵĽջ */
+    int                           recv_idle;            /* ջб־, Ѽkloop_tйܵͳ */
+    time_t                        recv_shrink_ts;       /* ջмʼʱʱӺ룩, յݻʧʱ */
+    atomic_counter_t              broadcast_count;      /* Ĺ㲥, ΪʱǨڵĹ㲥 */
 } channel_ref_info_t;
 
 struct _channel_ref_t {
-    int                 share;     /* Ƿͨknet_channel_ref_share() */
+    channel_ref_info_t* ref_info;  /* ܵϢ */
     uint64_t            domain_id; /* ID */
     kdlist_node_t*      list_node; /* ڵ */
-    channel_ref_info_t* ref_info;  /* ܵϢ */
+    int                 share;     /* Ƿͨknet_channel_ref_share() */
 };
 
-kchannel_ref_t* knet_channel_ref_create(kloop_t* loop, kchannel_t* channel) {
-    kchannel_ref_t* channel_ref = create(kchannel_ref_t);
-    verify(channel_ref);
-    memset(channel_ref, 0, sizeof(kchannel_ref_t));
-    channel_ref->ref_info = create(channel_ref_info_t);
-    verify(channel_ref->ref_info);
-    memset(channel_ref->ref_info, 0, sizeof(channel_ref_info_t));
-    channel_ref->ref_info->stream = stream_create(channel_ref);
-    verify(channel_ref->ref_info->stream);
-    channel_ref->ref_info->channel      = channel;
+/*
+ * ܵ, ܵ/ܵϢ//ڲܵһη, ж.
+ * kstream_tkchannel_tchannel_ref_object_t֮, ʱȡ
+ */
+typedef struct _channel_ref_object_t {
+    struct _channel_ref_t ref;  /* ܵ */
+    channel_ref_info_t    info; /* ܵϢ */
+} channel_ref_object_t;
+
+/**
+ * ָ볤ȶ
+ */
+#define CHANNEL_REF_ALIGN(size) (((size) + sizeof(void*) - 1) & ~(sizeof(void*) - 1))
+
+/**
+ * ȡùܵ󳤶, гȡ
+ */
+uint32_t _channel_ref_object_size();
+
+uint32_t _channel_ref_object_size() {
+    uint32_t size = CHANNEL_REF_ALIGN(sizeof(channel_ref_object_t)) +
+        CHANNEL_REF_ALIGN(stream_get_object_size()) + knet_channel_get_object_size();
+    return (size + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+}
+
+kchannel_ref_t* knet_channel_ref_create(kloop_t* loop, socket_t socket_fd, uint32_t max_send_list_len, uint32_t recv_ring_len, int flag) {
+    channel_ref_object_t* object      = 0;
+    kchannel_ref_t*       channel_ref = 0;
+    char*                 ptr         = 0;
+    verify(loop);
+    object = (channel_ref_object_t*)knet_loop_alloc_channel_object(loop, _channel_ref_object_size());
+    verify(object);
+    memset(object, 0, sizeof(channel_ref_object_t));
+    channel_ref = &object->ref;
+    channel_ref->ref_info = &object->info;
+    /* ܵʱֲٷڵ */
+    dlist_node_set_data(dlist_node_init(&channel_ref->ref_info->loop_node), channel_ref);
+    dlist_node_set_data(dlist_node_init(&channel_ref->ref_info->timeout_node), channel_ref);
+    /* ڲܵ */
+    ptr = (char*)object + CHANNEL_REF_ALIGN(sizeof(channel_ref_object_t));
+    channel_ref->ref_info->stream = stream_init(ptr, channel_ref);
+    ptr += CHANNEL_REF_ALIGN(stream_get_object_size());
+    channel_ref->ref_info->channel = knet_channel_init(ptr, socket_fd, max_send_list_len, recv_ring_len, flag);
+    channel_ref->ref_info->socket_fd    = socket_fd;
     channel_ref->ref_info->ref_count    = 0;
     channel_ref->ref_info->loop         = loop;
-    channel_ref->ref_info->last_recv_ts = time(0);
+    channel_ref->ref_info->last_recv_ts = (time_t)time_get_monotonic_milliseconds();
+    channel_ref->ref_info->recv_shrink_ts = channel_ref->ref_info->last_recv_ts;
     channel_ref->ref_info->state        = channel_state_init;
     knet_loop_profile_increase_active_channel_count(knet_loop_get_profile(loop));
     return channel_ref;
@@ -87,31 +206,42 @@ kchannel_ref_t* knet_channel_ref_create(kloop_t* loop, kchannel_t* channel) {
 
 int knet_channel_ref_destroy(kchannel_ref_t* channel_ref) {
     verify(channel_ref);
-    if (channel_ref->ref_info) {
-        /* ü */
-        if (!atomic_counter_zero(&channel_ref->ref_info->ref_count)) {
-            return error_ref_nonzero;
-        }
-        if (channel_ref->ref_info->peer_address) {
-            knet_address_destroy(channel_ref->ref_info->peer_address);
-        }
-        if (channel_ref->ref_info->local_address) {
-            knet_address_destroy(channel_ref->ref_info->local_address);
-        }
-        /* ֪ͨѡȡɾܵԴ */
-        if ((channel_ref->ref_info->state != channel_state_init) && /* Ѿ뵽loopܵ */
-            channel_ref->ref_info->loop) {
-            knet_impl_remove_channel_ref(channel_ref->ref_info->loop, channel_ref);
-        }
-        if (channel_ref->ref_info->channel) {
-            knet_channel_destroy(channel_ref->ref_info->channel);
-        }
-        if (channel_ref->ref_info->stream) {
-            stream_destroy(channel_ref->ref_info->stream);
+    verify(!channel_ref->share);
+    /* ü */
+    if (!atomic_counter_zero(&channel_ref->ref_info->ref_count)) {
+        return error_ref_nonzero;
+    }
+    if (channel_ref->ref_info->peer_address) {
+        knet_address_destroy(channel_ref->ref_info->peer_address);
+    }
+    if (channel_ref->ref_info->local_address) {
+        knet_address_destroy(channel_ref->ref_info->local_address);
+    }
+    /* ֪ͨѡȡɾܵԴ */
+    if ((channel_ref->ref_info->state != channel_state_init) && /* Ѿ뵽loopܵ */
+        channel_ref->ref_info->loop) {
+        knet_impl_remove_channel_ref(channel_ref->ref_info->loop, channel_ref);
+    }
+    if (channel_ref->ref_info->state == channel_state_init) {
+        /* δر, ׽ر */
+        knet_channel_close(channel_ref->ref_info->channel);
+    }
+    /* Ƕڵܵͷ, 뿪 */
+    if (channel_ref->ref_info->timeout_list) {
+        /* رʱѾʱȡ */
+        dlist_remove(channel_ref->ref_info->timeout_list, &channel_ref->ref_info->timeout_node);
+    }
+    if (dlist_node_check_linked(&channel_ref->ref_info->loop_node)) {
+        if (channel_ref->ref_info->state == channel_state_close) {
+            dlist_remove(knet_loop_get_close_list(channel_ref->ref_info->loop), &channel_ref->ref_info->loop_node);
+        } else {
+            /* kloop_tδʱֱӹرյĹܵ */
+            dlist_remove(knet_loop_get_active_list(channel_ref->ref_info->loop), &channel_ref->ref_info->loop_node);
         }
-        destroy(channel_ref->ref_info);
     }
-    destroy(channel_ref);
+    knet_channel_fini(channel_ref->ref_info->channel);
+    /* ܵǹܵĵһԱ */
+    knet_loop_free_channel_object(channel_ref->ref_info->loop, channel_ref);
     return error_ok;
 }
 
@@ -132,9 +262,12 @@ int knet_channel_ref_connect(kchannel_ref_t* channel_ref, const char* ip, int po
     }
     knet_address_set(channel_ref->ref_info->peer_address, ip, port);
     if (timeout > 0) {
-        channel_ref->ref_info->connect_timeout = timeout;
+        channel_ref->ref_info->connect_timeout = (time_t)timeout * 1000;
+    }
+    if (channel_ref->ref_info->connect_timeout) {
         /* óʱʱ */
-        channel_ref->ref_info->last_connect_timeout = time(0) + timeout;
+        channel_ref->ref_info->last_connect_timeout =
+            (time_t)time_get_monotonic_milliseconds() + channel_ref->ref_info->connect_timeout;
     }
     /* Ŀܾʧ */
     error = knet_channel_connect(channel_ref->ref_info->channel, ip, port);
@@ -143,7 +276,7 @@ int knet_channel_ref_connect(kchannel_ref_t* channel_ref, const char* ip, int po
     }
     log_info("start connect to IP[%s], port[%d]", ip, port);
     /* ؾ */
-    loop = knet_channel_ref_choose_loop(channel_ref);
+    loop = knet_channel_ref_choose_loop(channel_ref, ip);
     if (loop) {
         /* ԭloopactiveܵ */
         knet_loop_profile_decrease_active_channel_count(
@@ -171,6 +304,7 @@ int knet_channel_ref_reconnect(kchannel_ref_t* channel_ref, int timeout) {
     kloop_t*              loop                = 0;
     uint32_t              max_send_list_len   = 0;
     uint32_t              max_recv_buffer_len = 0;
+    int                   flag                = 0;
     int                   auto_reconnect      = 0;
     void*                 user_data           = 0;
     void*                 ptr                 = 0;
@@ -185,6 +319,7 @@ int knet_channel_ref_reconnect(kchannel_ref_t* channel_ref, int timeout) {
     loop                = knet_channel_ref_get_loop(channel_ref);
     max_send_list_len   = knet_channel_get_max_send_list_len(channel_ref->ref_info->channel);
     max_recv_buffer_len = knet_channel_get_max_recv_buffer_len(channel_ref->ref_info->channel);
+    flag                = knet_channel_get_flag(channel_ref->ref_info->channel);
     cb                  = knet_channel_ref_get_cb(channel_ref);
     user_data           = knet_channel_ref_get_user_data(channel_ref);
     ptr                 = knet_channel_ref_get_ptr(channel_ref);
@@ -194,11 +329,11 @@ int knet_channel_ref_reconnect(kchannel_ref_t* channel_ref, int timeout) {
     strcpy(ip, address_get_ip(peer_address));
     port = address_get_port(peer_address);
     /* ¹ܵ */
-    new_channel = knet_loop_create_channel(loop, max_send_list_len, max_recv_buffer_len);
+    new_channel = knet_loop_create_channel_with_flag(loop, max_send_list_len, max_recv_buffer_len, flag);
     verify(new_channel);
     if (timeout > 0) {
         /* µĳʱʱ */
-        connect_timeout = timeout;
+        connect_timeout = (time_t)timeout * 1000;
     } else {
         /* ʹԭеĳʱʱ */
         if (channel_ref->ref_info->connect_timeout) {
@@ -213,8 +348,10 @@ int knet_channel_ref_reconnect(kchannel_ref_t* channel_ref, int timeout) {
     knet_channel_ref_set_ptr(new_channel, ptr);
     /* Զ־ */
     knet_channel_ref_set_auto_reconnect(new_channel, auto_reconnect);
+    /* ӳʱ룩 */
+    knet_channel_ref_set_connect_timeout_ms(new_channel, (int)connect_timeout);
     /* µ */
-    error = knet_channel_ref_connect(new_channel, ip, port, (int)connect_timeout);
+    error = knet_channel_ref_connect(new_channel, ip, port, 0);
     if (error_ok != error) {
         return error;
     }
@@ -267,6 +404,22 @@ int knet_channel_ref_accept(kchannel_ref_t* channel_ref, const char* ip, int por
     return error;
 }
 
+int knet_channel_ref_accept_reuse_port(kchannel_ref_t* channel_ref, const char* ip, int port, int backlog) {
+    verify(channel_ref);
+    verify(port);
+    if (knet_channel_ref_check_state(channel_ref, channel_state_accept)) {
+        /* Ѿڼ״̬ */
+        return error_accept_in_progress;
+    }
+    /* bind()֮ǰ */
+    if (socket_set_reuse_port_on(knet_channel_get_socket_fd(channel_ref->ref_info->channel))) {
+        log_error("SO_REUSEPORT failed, system error: %d", sys_get_errno());
+        return error_reuse_port_fail;
+    }
+    channel_ref->ref_info->reuse_port = 1;
+    return knet_channel_ref_accept(channel_ref, ip, port, backlog);
+}
+
 kchannel_ref_t* knet_channel_ref_share(kchannel_ref_t* channel_ref) {
     kchannel_ref_t* channel_ref_shared = 0;
     verify(channel_ref);
@@ -282,9 +435,14 @@ kchannel_ref_t* knet_channel_ref_share(kchannel_ref_t* channel_ref) {
 }
 
 void knet_channel_ref_leave(kchannel_ref_t* channel_ref) {
+    kloop_t* loop = 0;
+    int      ref  = 0;
     verify(channel_ref);
+    /* üΪ0ܵϢѾkloop_t, ȡkloop_t */
+    loop = channel_ref->ref_info->loop;
     /* ݼü */
-    atomic_counter_dec(&channel_ref->ref_info->ref_count);
+    ref = (int)atomic_counter_dec(&channel_ref->ref_info->ref_count);
+    _channel_ref_check_release(loop, ref);
     /* ܵϢkloop_t */
     destroy(channel_ref);
 }
@@ -298,9 +456,7 @@ void knet_channel_ref_update_close_in_loop(kloop_t* loop, kchannel_ref_t* channe
     knet_channel_ref_set_state(channel_ref, channel_state_close);
     knet_channel_ref_clear_event(channel_ref, channel_event_recv | channel_event_send);
     /* ȵûص֤ڲԻõַϢ */
-    if (channel_ref->ref_info->cb) {
-        channel_ref->ref_info->cb(channel_ref, channel_cb_event_close);
-    }
+    knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_close);
     knet_channel_close(channel_ref->ref_info->channel);
     knet_loop_close_channel_ref(channel_ref->ref_info->loop, channel_ref);
 }
@@ -332,8 +488,9 @@ void knet_channel_ref_close(kchannel_ref_t* channel_ref) {
         /* Ѿڹر */
         return;
     }
-    if (knet_loop_get_thread_id(loop) != thread_get_self_id()) {
-        /* ֪ͨܵ߳ */
+    if (!_channel_ref_check_in_loop(channel_ref)) {
+        /* ֪ͨܵ߳, Ǩ;ԭkloop_tת */
+        loop = _channel_ref_post_acquire(channel_ref);
         log_info("close channel cross thread, notify thread[id:%ld]", knet_loop_get_thread_id(loop));
         knet_loop_notify_close(loop, channel_ref);
     } else {
@@ -348,12 +505,189 @@ int knet_channel_ref_check_close(kchannel_ref_t* channel_ref) {
     return knet_channel_ref_check_state(channel_ref, channel_state_close);
 }
 
+int _channel_ref_check_in_loop(kchannel_ref_t* channel_ref) {
+    /* ȶȡǨƱ־, Ŀkloop_t־ǰѾ޸kloop_t */
+    if (channel_ref->ref_info->migrate_state & 1) {
+        return 0;
+    }
+    return (knet_loop_get_thread_id(channel_ref->ref_info->loop) == thread_get_self_id());
+}
+
+atomic_counter_t _channel_ref_add_migrate_state(kchannel_ref_t* channel_ref, atomic_counter_t delta) {
+    atomic_counter_t state = 0;
+    for (;;) {
+        state = channel_ref->ref_info->migrate_state;
+        if (atomic_counter_cas(&channel_ref->ref_info->migrate_state, state, state + delta) == state) {
+            return state + delta;
+        }
+    }
+}
+
+kloop_t* _channel_ref_post_acquire(kchannel_ref_t* channel_ref) {
+    kloop_t* loop = 0;
+    /* мڼǨƱ־ᱻ */
+    _channel_ref_add_migrate_state(channel_ref, 2);
+    /* ȶȡkloop_tٶȡǨƱ־, Ǩkloop_tʱһҲǨƱ־ */
+    loop = channel_ref->ref_info->loop;
+    if (atomic_counter_cas(&channel_ref->ref_info->migrate_state, 0, 0) & 1) {
+        /* Ǩ;Ͷݵԭkloop_t, ֮ǰͶݵ¼һ˳ת */
+        return channel_ref->ref_info->migrate_from;
+    }
+    return loop;
+}
+
+void knet_channel_ref_post_hold(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    _channel_ref_add_migrate_state(channel_ref, 2);
+}
+
+void knet_channel_ref_post_release(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    if (_channel_ref_add_migrate_state(channel_ref, -2) == 1) {
+        _channel_ref_check_migrate_done(channel_ref);
+    }
+}
+
+void _channel_ref_check_migrate_done(kchannel_ref_t* channel_ref) {
+    /* Ŀkloop_t޸kloop_tٳ, ԭkloop_tתһ¼ʱҲ */
+    if (channel_ref->ref_info->loop == channel_ref->ref_info->migrate_loop) {
+        atomic_counter_cas(&channel_ref->ref_info->migrate_state, 1, 0);
+    }
+}
+
+void knet_channel_ref_invoke_cb(kchannel_ref_t* channel_ref, knet_channel_cb_event_e e) {
+    uint64_t         start   = 0;
+    uint64_t         end     = 0;
+    uint64_t         uuid    = 0;
+    kloop_profile_t* profile = 0;
+    verify(channel_ref);
+    if (!channel_ref->ref_info->cb) {
+        return;
+    }
+    /* صڿܹرչܵǨ, ȡͳ */
+    profile = knet_loop_get_profile(channel_ref->ref_info->loop);
+    if (!knet_loop_profile_check_latency(profile)) {
+        channel_ref->ref_info->cb(channel_ref, e);
+        return;
+    }
+    uuid    = knet_channel_ref_get_uuid(channel_ref);
+    start   = time_get_microseconds();
+    channel_ref->ref_info->cb(channel_ref, e);
+    end     = time_get_microseconds();
+    knet_loop_profile_add_callback(profile, (end > start) ? (end - start) : 0, uuid);
+}
+
+int knet_channel_ref_migrate(kchannel_ref_t* channel_ref, kloop_t* loop) {
+    verify(channel_ref);
+    verify(loop);
+    if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
+        return error_not_connected;
+    }
+#if LOOP_IOCP
+    /* ׽ֲ¹ɶ˿ */
+    return error_migrate_fail;
+#else
+    if ((channel_ref->ref_info->loop == loop) || !_channel_ref_check_in_loop(channel_ref)) {
+        return error_migrate_fail;
+    }
+    /* Ǩɺmigrate_loopkloop_tͬ */
+    if (channel_ref->ref_info->migrate_loop &&
+        (channel_ref->ref_info->migrate_loop != channel_ref->ref_info->loop)) {
+        return error_migrate_fail;
+    }
+    channel_ref->ref_info->migrate_loop = loop;
+    /* Ǩǰܵᱻ */
+    knet_channel_ref_incref(channel_ref);
+    knet_loop_add_migrate(channel_ref->ref_info->loop, channel_ref);
+    return error_ok;
+#endif /* LOOP_IOCP */
+}
+
+void knet_channel_ref_update_migrate_out(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    kloop_t* target = 0;
+    verify(loop);
+    verify(channel_ref);
+    target = channel_ref->ref_info->migrate_loop;
+    knet_channel_ref_decref(channel_ref);
+    if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
+        /* ǨƺѾر */
+        channel_ref->ref_info->migrate_loop = 0;
+        return;
+    }
+    /* ֮Ͷݵǰkloop_t¼Ǩ¼֮תĿkloop_t */
+    channel_ref->ref_info->migrate_from = loop;
+    _channel_ref_add_migrate_state(channel_ref, 1);
+    knet_loop_migrate_out_channel_ref(loop, channel_ref);
+    log_info("migrate channel[%llu] from thread[id:%ld]", knet_channel_ref_get_uuid(channel_ref),
+        knet_loop_get_thread_id(loop));
+    knet_loop_notify_migrate(target, channel_ref);
+}
+
+void knet_channel_ref_update_migrate_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    channel_ref->ref_info->loop = loop;
+    /* ޸kloop_tǨƱ־, ԭkloop_tδתķ/ر¼ʱԭkloop_tת */
+    _channel_ref_check_migrate_done(channel_ref);
+    knet_loop_migrate_in_channel_ref(loop, channel_ref);
+    if (channel_ref->ref_info->broadcast_count) {
+        /* ƶǰkloop_tĹ㲥, 㲥پԭkloop_tת */
+        knet_broadcast_update_channel_in_loop(loop, channel_ref);
+    }
+    /* ע, Ǩ;еݼδɵķע󴥷, д¼־ܵ */
+    knet_channel_ref_set_event(channel_ref, channel_event_recv);
+    log_info("channel[%llu] migrated to thread[id:%ld]", knet_channel_ref_get_uuid(channel_ref),
+        knet_loop_get_thread_id(loop));
+}
+
+kloop_t* knet_channel_ref_get_forward_loop(kchannel_ref_t* channel_ref, kloop_t* loop) {
+    verify(channel_ref);
+    verify(loop);
+    if (channel_ref->ref_info->migrate_state & 1) {
+        if (channel_ref->ref_info->migrate_from == loop) {
+            /* ӵǰkloop_tǨ, Ǩ¼ѾͶ */
+            return channel_ref->ref_info->migrate_loop;
+        }
+        if (channel_ref->ref_info->loop == loop) {
+            /* ѾǨ뵱ǰkloop_t, ԭkloop_tת¼ */
+            return 0;
+        }
+        return channel_ref->ref_info->migrate_from;
+    }
+    if (channel_ref->ref_info->loop != loop) {
+        /* ѾǨƵkloop_t */
+        return channel_ref->ref_info->loop;
+    }
+    return 0;
+}
+
+void knet_channel_ref_increase_broadcast_count(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    atomic_counter_inc(&channel_ref->ref_info->broadcast_count);
+}
+
+void knet_channel_ref_decrease_broadcast_count(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    atomic_counter_dec(&channel_ref->ref_info->broadcast_count);
+}
+
+uint32_t knet_channel_ref_swap_load_bytes(kchannel_ref_t* channel_ref) {
+    uint32_t bytes = 0;
+    verify(channel_ref);
+    bytes = channel_ref->ref_info->load_bytes;
+    channel_ref->ref_info->load_bytes = 0;
+    return bytes;
+}
+
 void knet_channel_ref_update_send_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref, kbuffer_t* send_buffer) {
     int error = 0;
     verify(loop);
     verify(channel_ref);
     verify(send_buffer);
+    /* ߳ͶʱѾδķֽ */
+    knet_channel_sub_send_pending(channel_ref->ref_info->channel, knet_buffer_get_length(send_buffer));
     knet_loop_profile_add_send_bytes(knet_loop_get_profile(loop), knet_buffer_get_length(send_buffer));
+    channel_ref->ref_info->load_bytes += knet_buffer_get_length(send_buffer);
     error = knet_channel_send_buffer(channel_ref->ref_info->channel, send_buffer);
     switch (error) {
     case error_send_patial:
@@ -365,6 +699,170 @@ void knet_channel_ref_update_send_in_loop(kloop_t* loop, kchannel_ref_t* channel
     default:
         break;
     }
+    _channel_ref_check_send_drained(channel_ref);
+}
+
+void knet_channel_ref_update_send_batch_in_loop(kloop_t* loop, kchannel_ref_t** channel_refs, int count,
+    kshared_buffer_t* shared) {
+    int      i       = 0;
+    kloop_t* forward = 0;
+    verify(loop);
+    verify(channel_refs);
+    verify(shared);
+    for (; i < count; i++) {
+        forward = knet_channel_ref_get_forward_loop(channel_refs[i], loop);
+        if (forward && knet_channel_ref_check_state(channel_refs[i], channel_state_active)) {
+            /* ͶݺܵѾǨƵkloop_t, δķֽת¼ת */
+            knet_channel_ref_post_hold(channel_refs[i]);
+            knet_loop_notify_send(forward, channel_refs[i], knet_buffer_create_shared(shared));
+            continue;
+        }
+        knet_channel_sub_send_pending(channel_refs[i]->ref_info->channel, knet_shared_buffer_get_length(shared));
+        if (!forward && knet_channel_ref_check_state(channel_refs[i], channel_state_active)) {
+            _channel_ref_send_shared_in_loop(channel_refs[i], shared);
+            _channel_ref_check_send_drained(channel_refs[i]);
+        }
+    }
+}
+
+int _channel_ref_send_shared_in_loop(kchannel_ref_t* channel_ref, kshared_buffer_t* shared) {
+    int error = error_ok;
+    knet_loop_profile_add_send_bytes(knet_loop_get_profile(channel_ref->ref_info->loop),
+        knet_shared_buffer_get_length(shared));
+    channel_ref->ref_info->load_bytes += knet_shared_buffer_get_length(shared);
+    error = knet_channel_send_shared(channel_ref->ref_info->channel, shared);
+    switch (error) {
+    case error_send_patial:
+        knet_channel_ref_set_event(channel_ref, channel_event_send);
+        /* ڵ߲Ǵ */
+        error = error_ok;
+        break;
+    case error_send_fail:
+        knet_channel_ref_close_check_reconnect(channel_ref);
+        break;
+    default:
+        break;
+    }
+    return error;
+}
+
+int knet_channel_ref_write_shared(kchannel_ref_t* channel_ref, kshared_buffer_t* shared) {
+    kloop_t*   loop        = 0;
+    kbuffer_t* send_buffer = 0;
+    verify(channel_ref);
+    verify(shared);
+    if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
+        return error_not_connected;
+    }
+    if (error_ok != _channel_ref_check_send_watermark(channel_ref, knet_shared_buffer_get_length(shared))) {
+        return error_send_watermark;
+    }
+    if (!_channel_ref_check_in_loop(channel_ref)) {
+        /* תloop̷߳, ͻù */
+        send_buffer = knet_buffer_create_shared(shared);
+        verify(send_buffer);
+        if (!send_buffer) {
+            return error_no_memory;
+        }
+        knet_channel_add_send_pending(channel_ref->ref_info->channel, knet_shared_buffer_get_length(shared));
+        loop = _channel_ref_post_acquire(channel_ref);
+        knet_loop_notify_send(loop, channel_ref, send_buffer);
+        return error_ok;
+    }
+    /* ǰ̷߳ */
+    return _channel_ref_send_shared_in_loop(channel_ref, shared);
+}
+
+kchannel_ref_fanout_t* knet_channel_ref_fanout_create(kshared_buffer_t* shared) {
+    kchannel_ref_fanout_t* fanout = 0;
+    verify(shared);
+    fanout = create(kchannel_ref_fanout_t);
+    verify(fanout);
+    if (!fanout) {
+        return 0;
+    }
+    memset(fanout, 0, sizeof(kchannel_ref_fanout_t));
+    knet_shared_buffer_incref(shared);
+    fanout->shared = shared;
+    return fanout;
+}
+
+int knet_channel_ref_fanout_write(kchannel_ref_fanout_t* fanout, kchannel_ref_t* channel_ref) {
+    kloop_t*                   loop      = 0;
+    channel_ref_fanout_loop_t* loops     = 0;
+    int                        max_count = 0;
+    int                        i         = 0;
+    verify(fanout);
+    verify(channel_ref);
+    if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
+        return error_not_connected;
+    }
+    if (error_ok != _channel_ref_check_send_watermark(channel_ref, knet_shared_buffer_get_length(fanout->shared))) {
+        return error_send_watermark;
+    }
+    if (_channel_ref_check_in_loop(channel_ref)) {
+        /* ǰ̷߳ */
+        return _channel_ref_send_shared_in_loop(channel_ref, fanout->shared);
+    }
+    /* ¼ͷ */
+    loop = _channel_ref_post_acquire(channel_ref);
+    /* Ŀkloop_t, kloop_t, ˳ */
+    if ((fanout->last < fanout->count) && (fanout->loops[fanout->last].loop == loop)) {
+        i = fanout->last;
+    } else {
+        for (i = 0; i < fanout->count; i++) {
+            if (fanout->loops[i].loop == loop) {
+                break;
+            }
+        }
+    }
+    if (i == fanout->count) {
+        if (fanout->count == fanout->max_count) {
+            max_count = fanout->max_count ? fanout->max_count * 2 : 8;
+            if (fanout->loops) {
+                loops = (channel_ref_fanout_loop_t*)rcreate_raw(fanout->loops,
+                    sizeof(channel_ref_fanout_loop_t) * max_count);
+            } else {
+                loops = (channel_ref_fanout_loop_t*)create_raw(sizeof(channel_ref_fanout_loop_t) * max_count);
+            }
+            if (!loops) {
+                knet_channel_ref_post_release(channel_ref);
+                return error_no_memory;
+            }
+            fanout->loops     = loops;
+            fanout->max_count = max_count;
+        }
+        fanout->loops[i].loop  = loop;
+        fanout->loops[i].batch = knet_loop_send_batch_create(fanout->shared);
+        if (!fanout->loops[i].batch) {
+            knet_channel_ref_post_release(channel_ref);
+            return error_no_memory;
+        }
+        fanout->count++;
+    }
+    fanout->last = i;
+    /* kloop_tеĹܵ, ߳еĹÿ¼ǰ */
+    if (error_ok != knet_loop_send_batch_add(fanout->loops[i].batch,
+        (kchannel_ref_t*)dlist_node_get_data(&channel_ref->ref_info->loop_node))) {
+        knet_channel_ref_post_release(channel_ref);
+        return error_no_memory;
+    }
+    knet_channel_add_send_pending(channel_ref->ref_info->channel, knet_shared_buffer_get_length(fanout->shared));
+    return error_ok;
+}
+
+void knet_channel_ref_fanout_finish(kchannel_ref_fanout_t* fanout) {
+    int i = 0;
+    verify(fanout);
+    for (; i < fanout->count; i++) {
+        /* ÿkloop_tһ¼ */
+        knet_loop_notify_send_batch(fanout->loops[i].loop, fanout->loops[i].batch);
+    }
+    if (fanout->loops) {
+        destroy(fanout->loops);
+    }
+    knet_shared_buffer_decref(fanout->shared);
+    destroy(fanout);
 }
 
 int knet_channel_ref_write(kchannel_ref_t* channel_ref, const char* data, int size) {
@@ -377,19 +875,24 @@ int knet_channel_ref_write(kchannel_ref_t* channel_ref, const char* data, int si
     if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
         return error_not_connected;
     }
+    if (error_ok != _channel_ref_check_send_watermark(channel_ref, (uint32_t)size)) {
+        return error_send_watermark;
+    }
     loop = channel_ref->ref_info->loop;
-    if (knet_loop_get_thread_id(loop) != thread_get_self_id()) {
+    if (!_channel_ref_check_in_loop(channel_ref)) {
         /* תloop̷߳ */
-        log_info("send cross thread, notify thread[id:%ld]", knet_loop_get_thread_id(loop));
         send_buffer = knet_buffer_create(size);
         verify(send_buffer);
         if (!send_buffer) {
             return error_no_memory;
         }
         knet_buffer_put(send_buffer, data, size);
+        knet_channel_add_send_pending(channel_ref->ref_info->channel, (uint32_t)size);
+        loop = _channel_ref_post_acquire(channel_ref);
         knet_loop_notify_send(loop, channel_ref, send_buffer);
     } else {
         knet_loop_profile_add_send_bytes(knet_loop_get_profile(channel_ref->ref_info->loop), size);
+        channel_ref->ref_info->load_bytes += size;
         /* ǰ̷߳ */
         error = knet_channel_send(channel_ref->ref_info->channel, data, size);
         switch (error) {
@@ -408,9 +911,67 @@ int knet_channel_ref_write(kchannel_ref_t* channel_ref, const char* data, int si
     return error;
 }
 
+int knet_channel_ref_writev(kchannel_ref_t* channel_ref, const kiovec_t* iov, int count) {
+    kloop_t*   loop        = 0;
+    kbuffer_t* send_buffer = 0;
+    int        error       = error_ok;
+    int        size        = 0;
+    int        i           = 0;
+    verify(channel_ref);
+    verify(iov);
+    verify(count);
+    if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
+        return error_not_connected;
+    }
+    for (; i < count; i++) {
+        size += iov[i].size;
+    }
+    if (!size) {
+        return error_ok;
+    }
+    if (error_ok != _channel_ref_check_send_watermark(channel_ref, (uint32_t)size)) {
+        return error_send_watermark;
+    }
+    loop = channel_ref->ref_info->loop;
+    if (!_channel_ref_check_in_loop(channel_ref)) {
+        /* תloop̷߳, ϲΪһͻ */
+        send_buffer = knet_buffer_create(size);
+        verify(send_buffer);
+        if (!send_buffer) {
+            return error_no_memory;
+        }
+        for (i = 0; i < count; i++) {
+            if (iov[i].size) {
+                knet_buffer_put(send_buffer, (const char*)iov[i].buffer, iov[i].size);
+            }
+        }
+        knet_channel_add_send_pending(channel_ref->ref_info->channel, (uint32_t)size);
+        loop = _channel_ref_post_acquire(channel_ref);
+        knet_loop_notify_send(loop, channel_ref, send_buffer);
+    } else {
+        knet_loop_profile_add_send_bytes(knet_loop_get_profile(channel_ref->ref_info->loop), size);
+        channel_ref->ref_info->load_bytes += size;
+        /* ǰ̷߳ */
+        error = knet_channel_sendv(channel_ref->ref_info->channel, iov, count);
+        switch (error) {
+        case error_send_patial:
+            knet_channel_ref_set_event(channel_ref, channel_event_send);
+            /* ڵ߲Ǵ */
+            error = error_ok;
+            break;
+        case error_send_fail:
+            knet_channel_ref_close_check_reconnect(channel_ref);
+            break;
+        default:
+            break;
+        }
+    }
+    return error;
+}
+
 socket_t knet_channel_ref_get_socket_fd(kchannel_ref_t* channel_ref) {
     verify(channel_ref);
-    return knet_channel_get_socket_fd(channel_ref->ref_info->channel);
+    return channel_ref->ref_info->socket_fd;
 }
 
 kstream_t* knet_channel_ref_get_stream(kchannel_ref_t* channel_ref) {
@@ -423,14 +984,24 @@ kloop_t* knet_channel_ref_get_loop(kchannel_ref_t* channel_ref) {
     return channel_ref->ref_info->loop;
 }
 
-void knet_channel_ref_set_loop_node(kchannel_ref_t* channel_ref, kdlist_node_t* node) {
-    verify(channel_ref); /* nodeΪ0 */
-    channel_ref->ref_info->loop_node = node;
+kdlist_node_t* knet_channel_ref_get_loop_node(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    return &channel_ref->ref_info->loop_node;
 }
 
-kdlist_node_t* knet_channel_ref_get_loop_node(kchannel_ref_t* channel_ref) {
+kdlist_node_t* knet_channel_ref_get_timeout_node(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    return &channel_ref->ref_info->timeout_node;
+}
+
+void knet_channel_ref_set_timeout_list(kchannel_ref_t* channel_ref, kdlist_t* list) {
+    verify(channel_ref); /* listΪ0 */
+    channel_ref->ref_info->timeout_list = list;
+}
+
+kdlist_t* knet_channel_ref_get_timeout_list(kchannel_ref_t* channel_ref) {
     verify(channel_ref);
-    return channel_ref->ref_info->loop_node;
+    return channel_ref->ref_info->timeout_list;
 }
 
 void knet_channel_ref_set_event(kchannel_ref_t* channel_ref, knet_channel_event_e e) {
@@ -469,7 +1040,6 @@ kchannel_ref_t* knet_channel_ref_accept_from_socket_fd(kchannel_ref_t* channel_r
     kchannel_t*     acceptor_channel    = 0;
     uint32_t        max_send_list_len   = 0;
     uint32_t        max_ringbuffer_size = 0;
-    kchannel_t*     client_channel      = 0;
     kchannel_ref_t* client_ref          = 0;
     verify(channel_ref);
     verify(channel_ref->ref_info);
@@ -480,13 +1050,12 @@ kchannel_ref_t* knet_channel_ref_accept_from_socket_fd(kchannel_ref_t* channel_r
     if (!max_send_list_len) {
         max_send_list_len = INT_MAX;
     }
-    max_ringbuffer_size = ringbuffer_get_max_size(knet_channel_get_ringbuffer(acceptor_channel));
+    max_ringbuffer_size = knet_channel_get_max_recv_buffer_len(acceptor_channel);
     if (!max_ringbuffer_size) {
         max_ringbuffer_size = 16 * 1024; /* Ĭ16K */
     }
-    client_channel = knet_channel_create_exist_socket_fd(client_fd, max_send_list_len, max_ringbuffer_size);
-    verify(client_channel);
-    client_ref = knet_channel_ref_create(loop, client_channel);
+    client_ref = knet_channel_ref_create(loop, client_fd, max_send_list_len, max_ringbuffer_size,
+        knet_channel_get_flag(acceptor_channel));
     verify(client_ref);
     if (event) {
         /* ӵǰ߳loop */
@@ -499,46 +1068,71 @@ kchannel_ref_t* knet_channel_ref_accept_from_socket_fd(kchannel_ref_t* channel_r
 }
 
 void knet_channel_ref_update_accept(kchannel_ref_t* channel_ref) {
-    kchannel_ref_t* client_ref = 0;
-    kloop_t*        loop       = 0;
-    socket_t       client_fd  = 0;
+    int      count     = 0;
+    socket_t client_fd = 0;
     verify(channel_ref);
+    knet_channel_ref_set_state(channel_ref, channel_state_accept);
     /* 鿴ѡȡǷԶʵ */
     client_fd = knet_impl_channel_accept(channel_ref);
-    if (!client_fd) {
-        /* Ĭʵ */
+    if (client_fd) {
+        /* ѡȡÿһ */
+        knet_channel_ref_set_event(channel_ref, channel_event_recv);
+        _channel_ref_accept_client(channel_ref, client_fd);
+        return;
+    }
+    /* Ĭʵ, شҪһֱacceptֱûеȴܵ */
+    for (count = 0; count < ACCEPT_MAX_PER_WAKEUP; count++) {
         client_fd = socket_accept(knet_channel_get_socket_fd(channel_ref->ref_info->channel));
+        if (!client_fd) {
+            break;
+        }
+        _channel_ref_accept_client(channel_ref, client_fd);
     }
-    verify(client_fd > 0);
-    knet_channel_ref_set_state(channel_ref, channel_state_accept);
     knet_channel_ref_set_event(channel_ref, channel_event_recv);
-    if (client_fd) {
-        loop = knet_channel_ref_choose_loop(channel_ref);
-        if (loop) {
-            client_ref = knet_channel_ref_accept_from_socket_fd(channel_ref, loop, client_fd, 0);
-            verify(client_ref);
-            knet_channel_ref_set_user_data(client_ref, channel_ref->ref_info->user_data);
-            knet_channel_ref_set_ptr(client_ref, channel_ref->ref_info->user_ptr);
-            /* ûص */
-            knet_channel_ref_set_cb(client_ref, channel_ref->ref_info->cb);
-            /* öгʱ */
-            knet_channel_ref_set_timeout(client_ref, (int)channel_ref->ref_info->timeout);
-            /* ӵloop */
-            knet_loop_notify_accept(loop, client_ref);
-        } else {
-            client_ref = knet_channel_ref_accept_from_socket_fd(channel_ref, channel_ref->ref_info->loop, client_fd, 1);
-            verify(client_ref);
-            knet_channel_ref_set_user_data(client_ref, channel_ref->ref_info->user_data);
-            knet_channel_ref_set_ptr(client_ref, channel_ref->ref_info->user_ptr);
-            /* ûص */
-            knet_channel_ref_set_cb(client_ref, channel_ref->ref_info->cb);
-            /* öгʱ */
-            knet_channel_ref_set_timeout(client_ref, (int)channel_ref->ref_info->timeout);
-            /* ûص */
-            if (channel_ref->ref_info->cb) {
-                channel_ref->ref_info->cb(client_ref, channel_cb_event_accept);
-            }
+    if (count == ACCEPT_MAX_PER_WAKEUP) {
+        /* ﵽ, ʣ´λʱ */
+        knet_impl_event_rearm(channel_ref, channel_event_recv);
+    }
+}
+
+void _channel_ref_accept_client(kchannel_ref_t* channel_ref, socket_t client_fd) {
+    kchannel_ref_t*   client_ref = 0;
+    kloop_t*          loop       = 0;
+    kloop_balancer_t* balancer   = 0;
+    char              ip[32]     = {0};
+    verify(channel_ref);
+    verify(client_fd > 0);
+    if (!channel_ref->ref_info->reuse_port) {
+        /* ˿õļܵں˷, Ҫٴθؾ */
+        balancer = knet_loop_get_balancer(channel_ref->ref_info->loop);
+        if (balancer && (loop_balancer_strategy_consistent_hash == knet_loop_balancer_get_strategy(balancer))) {
+            /* ֻһԹϣҪԶIP */
+            socket_get_peer_ip(client_fd, ip, sizeof(ip));
         }
+        loop = knet_channel_ref_choose_loop(channel_ref, ip);
+    }
+    if (loop) {
+        client_ref = knet_channel_ref_accept_from_socket_fd(channel_ref, loop, client_fd, 0);
+        verify(client_ref);
+        knet_channel_ref_set_user_data(client_ref, channel_ref->ref_info->user_data);
+        knet_channel_ref_set_ptr(client_ref, channel_ref->ref_info->user_ptr);
+        /* ûص */
+        knet_channel_ref_set_cb(client_ref, channel_ref->ref_info->cb);
+        /* öгʱ */
+        knet_channel_ref_set_timeout(client_ref, (int)channel_ref->ref_info->timeout);
+        /* ӵloop */
+        knet_loop_notify_accept(loop, client_ref);
+    } else {
+        client_ref = knet_channel_ref_accept_from_socket_fd(channel_ref, channel_ref->ref_info->loop, client_fd, 1);
+        verify(client_ref);
+        knet_channel_ref_set_user_data(client_ref, channel_ref->ref_info->user_data);
+        knet_channel_ref_set_ptr(client_ref, channel_ref->ref_info->user_ptr);
+        /* ûص */
+        knet_channel_ref_set_cb(client_ref, channel_ref->ref_info->cb);
+        /* öгʱ */
+        knet_channel_ref_set_timeout(client_ref, (int)channel_ref->ref_info->timeout);
+        /* ûص */
+        knet_channel_ref_invoke_cb(client_ref, channel_cb_event_accept);
     }
 }
 
@@ -550,28 +1144,33 @@ void knet_channel_ref_update_accept_in_loop(kloop_t* loop, kchannel_ref_t* chann
     knet_channel_ref_set_state(channel_ref, channel_state_active);
     knet_channel_ref_set_event(channel_ref, channel_event_recv);
     /* ûص */
-    if (channel_ref->ref_info->cb) {
-        channel_ref->ref_info->cb(channel_ref, channel_cb_event_accept);
-    }
+    knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_accept);
 }
 
 void knet_channel_ref_update_connect(kchannel_ref_t* channel_ref) {
     verify(channel_ref);
+    /* ɺֻڷʱͶд¼ */
+    knet_channel_ref_clear_event(channel_ref, channel_event_send);
     knet_channel_ref_set_event(channel_ref, channel_event_recv);
     knet_channel_ref_set_state(channel_ref, channel_state_active);
     /* ûص */
     if (channel_ref->ref_info->cb) {
         log_verb("connected, invoke cb");
-        channel_ref->ref_info->cb(channel_ref, channel_cb_event_connect);
+        knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_connect);
     }
 }
 
 void knet_channel_ref_update_recv(kchannel_ref_t* channel_ref) {
     int error = 0;
+    int full  = 0;
+    int grown = 0;
     uint32_t bytes = 0;
     verify(channel_ref);
     bytes = knet_stream_available(channel_ref->ref_info->stream);
     error = knet_channel_update_recv(channel_ref->ref_info->channel);
+    grown = _channel_ref_update_recv_buffer_len(channel_ref);
+    /* ʱ׽ڿܻ */
+    full = ringbuffer_full(knet_channel_get_ringbuffer(channel_ref->ref_info->channel));
     switch (error) {
         case error_recv_fail:
             knet_channel_ref_close_check_reconnect(channel_ref);
@@ -583,12 +1182,19 @@ void knet_channel_ref_update_recv(kchannel_ref_t* channel_ref) {
             break;
     }
     if (error == error_ok) {
-        knet_loop_profile_add_recv_bytes(knet_loop_get_profile(channel_ref->ref_info->loop),
-            knet_stream_available(channel_ref->ref_info->stream) - bytes);
-        if (channel_ref->ref_info->cb) {
-            channel_ref->ref_info->cb(channel_ref, channel_cb_event_recv);
-        }
+        bytes = knet_stream_available(channel_ref->ref_info->stream) - bytes;
+        knet_loop_profile_add_recv_bytes(knet_loop_get_profile(channel_ref->ref_info->loop), bytes);
+        channel_ref->ref_info->load_bytes += bytes;
+        knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_recv);
         knet_channel_ref_set_event(channel_ref, channel_event_recv);
+        if (full && !knet_channel_ref_check_state(channel_ref, channel_state_close)) {
+            /* δȡ, Ҫٴδ */
+            knet_impl_event_rearm(channel_ref, channel_event_recv);
+        }
+    }
+    if (grown && !knet_channel_ref_check_state(channel_ref, channel_state_close)) {
+        /* ջѱ, һ̶¼ʱ, к */
+        knet_loop_add_timeout(channel_ref->ref_info->loop, channel_ref, 0);
     }
 }
 
@@ -599,20 +1205,51 @@ void knet_channel_ref_update_send(kchannel_ref_t* channel_ref) {
     switch (error) {
         case error_send_fail:
             knet_channel_ref_close_check_reconnect(channel_ref);
-            break;
+            return;
         case error_send_patial:
             knet_channel_ref_set_event(channel_ref, channel_event_send);
             break;
         default:
+            /* ȫ, ȡд¼, ٴβַʱͶ */
+            knet_channel_ref_clear_event(channel_ref, channel_event_send);
+            knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_send);
             break;
     }
-    if (error == error_ok) {
-        if (channel_ref->ref_info->cb) {
-            channel_ref->ref_info->cb(channel_ref, channel_cb_event_send);
-        }
+    _channel_ref_check_send_drained(channel_ref);
+}
+
+int _channel_ref_check_send_watermark(kchannel_ref_t* channel_ref, uint32_t size) {
+    kchannel_t* channel = channel_ref->ref_info->channel;
+    if (error_ok == knet_channel_check_send_watermark(channel, size)) {
+        return error_ok;
+    }
+    if (knet_channel_set_send_blocked(channel) && !_channel_ref_check_in_loop(channel_ref)) {
+        /* ñ־ǰkloop_tѾˮλ, תloop߳ٴμ, ⶪʧ֪ͨ */
+        knet_loop_notify_send_drained(channel_ref->ref_info->loop, channel_ref);
+    }
+    return error_send_watermark;
+}
+
+void _channel_ref_check_send_drained(kchannel_ref_t* channel_ref) {
+    if (knet_channel_ref_check_state(channel_ref, channel_state_close)) {
+        return;
+    }
+    if (knet_channel_check_send_drained(channel_ref->ref_info->channel)) {
+        /* ܾдķѾˮλ */
+        knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_send_drained);
     }
 }
 
+void knet_channel_ref_update_send_drained_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    knet_channel_ref_decref(channel_ref);
+    if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
+        return;
+    }
+    _channel_ref_check_send_drained(channel_ref);
+}
+
 void knet_channel_ref_update(kchannel_ref_t* channel_ref, knet_channel_event_e e, time_t ts) {
     verify(channel_ref);
     if (knet_channel_ref_check_state(channel_ref, channel_state_close)) {
@@ -623,8 +1260,11 @@ void knet_channel_ref_update(kchannel_ref_t* channel_ref, knet_channel_event_e e
             /*  */
             knet_channel_ref_update_accept(channel_ref);
         } else {
-            /* һζȡݵʱ룩 */
+            /* һζȡݵʱ룩 */
             channel_ref->ref_info->last_recv_ts = ts;
+            /* ¿ʼջм */
+            channel_ref->ref_info->recv_shrink_ts = ts;
+            _channel_ref_clear_recv_idle(channel_ref);
             /*  */
             knet_channel_ref_update_recv(channel_ref);
         }
@@ -645,7 +1285,7 @@ kringbuffer_t* knet_channel_ref_get_ringbuffer(kchannel_ref_t* channel_ref) {
     return knet_channel_get_ringbuffer(channel_ref->ref_info->channel);
 }
 
-kloop_t* knet_channel_ref_choose_loop(kchannel_ref_t* channel_ref) {
+kloop_t* knet_channel_ref_choose_loop(kchannel_ref_t* channel_ref, const char* ip) {
     kloop_t*          loop         = 0;
     kloop_t*          current_loop = 0;
     kloop_balancer_t* balancer     = 0;
@@ -657,7 +1297,7 @@ kloop_t* knet_channel_ref_choose_loop(kchannel_ref_t* channel_ref) {
     }
     /* Ƿloop_balancer_out */
     if (knet_loop_check_balance_options(channel_ref->ref_info->loop, loop_balancer_out)) {
-        loop = knet_loop_balancer_choose(balancer);
+        loop = knet_loop_balancer_choose(balancer, ip);
         if (loop == channel_ref->ref_info->loop) {
             return 0;
         }
@@ -696,8 +1336,135 @@ int knet_channel_ref_check_balance(kchannel_ref_t* channel_ref) {
 }
 
 void knet_channel_ref_set_timeout(kchannel_ref_t* channel_ref, int timeout) {
+    verify(channel_ref); /* timeoutΪ0 */
+    knet_channel_ref_set_timeout_ms(channel_ref, timeout * 1000);
+}
+
+void knet_channel_ref_set_send_watermark(kchannel_ref_t* channel_ref, int high, int low) {
+    verify(channel_ref);
+    verify(high >= 0);
+    verify(low >= 0);
+    knet_channel_set_send_watermark(channel_ref->ref_info->channel, (uint32_t)high, (uint32_t)low);
+}
+
+int knet_channel_ref_get_send_list_bytes(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    return (int)knet_channel_get_send_list_bytes(channel_ref->ref_info->channel);
+}
+
+int knet_channel_ref_get_recv_buffer_len(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    return (int)knet_channel_get_recv_buffer_len(channel_ref->ref_info->channel);
+}
+
+void knet_channel_ref_set_recv_buffer_budget(uint64_t budget) {
+    knet_channel_set_recv_buffer_budget(budget);
+}
+
+uint64_t knet_channel_ref_get_recv_buffer_total() {
+    return knet_channel_get_recv_buffer_total();
+}
+
+int _channel_ref_update_recv_buffer_len(kchannel_ref_t* channel_ref) {
+    channel_ref_info_t* info = channel_ref->ref_info;
+    uint32_t            len  = knet_channel_get_recv_buffer_len(info->channel);
+    if (len == info->recv_buffer_len) {
+        return 0;
+    }
+    knet_loop_profile_update_recv_buffer(knet_loop_get_profile(info->loop), info->recv_buffer_len, len, info->recv_idle);
+    info->recv_buffer_len = len;
+    return 1;
+}
+
+void _channel_ref_clear_recv_idle(kchannel_ref_t* channel_ref) {
+    channel_ref_info_t* info = channel_ref->ref_info;
+    if (info->recv_idle) {
+        info->recv_idle = 0;
+        knet_loop_profile_decrease_idle_channel_count(knet_loop_get_profile(info->loop), info->recv_buffer_len);
+    }
+}
+
+void knet_channel_ref_attach_recv_buffer(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    _channel_ref_update_recv_buffer_len(channel_ref);
+}
+
+void knet_channel_ref_detach_recv_buffer(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    _channel_ref_clear_recv_idle(channel_ref);
+    knet_loop_profile_update_recv_buffer(knet_loop_get_profile(channel_ref->ref_info->loop),
+        channel_ref->ref_info->recv_buffer_len, 0, 0);
+    channel_ref->ref_info->recv_buffer_len = 0;
+}
+
+void knet_channel_ref_check_recv_shrink(kchannel_ref_t* channel_ref, time_t ts) {
+    channel_ref_info_t* info = 0;
+    verify(channel_ref);
+    info = channel_ref->ref_info;
+    if (!knet_channel_ref_check_state(channel_ref, channel_state_active) ||
+        !knet_channel_check_recv_buffer_grown(info->channel) ||
+        ((ts - info->recv_shrink_ts) <= CHANNEL_RECV_BUFFER_IDLE)) {
+        return;
+    }
+    if (!info->recv_idle) {
+        info->recv_idle = 1;
+        knet_loop_profile_increase_idle_channel_count(knet_loop_get_profile(info->loop), info->recv_buffer_len);
+    }
+    if (error_ok != knet_channel_ref_shrink_recv_buffer(channel_ref)) {
+        /* ڻδȡ, CHANNEL_RECV_BUFFER_IDLEٴμ */
+        info->recv_shrink_ts = ts;
+    }
+}
+
+int knet_channel_ref_shrink_recv_buffer(kchannel_ref_t* channel_ref) {
+    verify(channel_ref);
+    if (knet_channel_ref_check_state(channel_ref, channel_state_close)) {
+        return error_fail;
+    }
+    if (error_ok != knet_channel_shrink_recv_buffer(channel_ref->ref_info->channel)) {
+        return error_fail;
+    }
+    _channel_ref_update_recv_buffer_len(channel_ref);
+    return error_ok;
+}
+
+void knet_channel_ref_set_connect_timeout_ms(kchannel_ref_t* channel_ref, int timeout) {
+    verify(channel_ref); /* timeoutΪ0 */
+    channel_ref->ref_info->connect_timeout = (time_t)timeout;
+}
+
+void knet_channel_ref_set_timeout_ms(kchannel_ref_t* channel_ref, int timeout) {
+    thread_id_t thread_id = 0;
     verify(channel_ref); /* timeoutΪ0 */
     channel_ref->ref_info->timeout = (time_t)timeout;
+    if ((channel_ref->ref_info->state == channel_state_init) ||
+        (channel_ref->ref_info->state == channel_state_close)) {
+        /* δ뵽loopĹܵڼʱʱ */
+        return;
+    }
+    if (channel_ref->ref_info->migrate_state & 1) {
+        /* Ŀkloop_tʱ½ʱ */
+        return;
+    }
+    thread_id = knet_loop_get_thread_id(channel_ref->ref_info->loop);
+    if (!thread_id || (thread_id == thread_get_self_id())) {
+        /* ¼´μʱ */
+        knet_loop_add_timeout(channel_ref->ref_info->loop, channel_ref, 0);
+    } else {
+        /* ʱֻkloop_t߳޸, תloop̼߳ */
+        knet_loop_notify_timeout(channel_ref->ref_info->loop, channel_ref);
+    }
+}
+
+void knet_channel_ref_update_timeout_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    knet_channel_ref_decref(channel_ref);
+    if ((channel_ref->ref_info->state == channel_state_init) ||
+        (channel_ref->ref_info->state == channel_state_close)) {
+        return;
+    }
+    knet_loop_add_timeout(loop, channel_ref, 0);
 }
 
 int knet_channel_ref_check_connect_timeout(kchannel_ref_t* channel_ref, time_t ts) {
@@ -728,6 +1495,33 @@ int knet_channel_ref_check_timeout(kchannel_ref_t* channel_ref, time_t ts) {
     return 0;
 }
 
+time_t knet_channel_ref_get_timeout_deadline(kchannel_ref_t* channel_ref, time_t ts) {
+    time_t deadline = 0;
+    time_t shrink   = 0;
+    verify(channel_ref);
+    switch (channel_ref->ref_info->state) {
+    case channel_state_connect:
+        /* еĹܵÿ̶ȶҪ */
+        return ts;
+    case channel_state_accept:
+    case channel_state_close:
+        return 0;
+    default:
+        break;
+    }
+    if (channel_ref->ref_info->timeout) {
+        deadline = channel_ref->ref_info->last_recv_ts + channel_ref->ref_info->timeout + 1;
+    }
+    if (knet_channel_check_recv_buffer_grown(channel_ref->ref_info->channel)) {
+        /* Ľջк */
+        shrink = channel_ref->ref_info->recv_shrink_ts + CHANNEL_RECV_BUFFER_IDLE + 1;
+        if (!deadline || (shrink < deadline)) {
+            deadline = shrink;
+        }
+    }
+    return deadline;
+}
+
 void knet_channel_ref_set_cb(kchannel_ref_t* channel_ref, knet_channel_ref_cb_t cb) {
     verify(channel_ref);
     channel_ref->ref_info->cb = cb;
@@ -741,6 +1535,10 @@ knet_channel_ref_cb_t knet_channel_ref_get_cb(kchannel_ref_t* channel_ref) {
 int knet_channel_ref_connect_in_loop(kchannel_ref_t* channel_ref) {
     verify(channel_ref);
     knet_loop_add_channel_ref(channel_ref->ref_info->loop, channel_ref);
+    if (channel_ref->ref_info->broadcast_count) {
+        /* ؾʱǰĹ㲥ԭkloop_t */
+        knet_broadcast_update_channel_in_loop(channel_ref->ref_info->loop, channel_ref);
+    }
     knet_channel_ref_set_state(channel_ref, channel_state_connect);
     knet_channel_ref_set_event(channel_ref, channel_event_send);
     return error_ok;
@@ -797,8 +1595,23 @@ int knet_channel_ref_incref(kchannel_ref_t* channel_ref) {
 }
 
 int knet_channel_ref_decref(kchannel_ref_t* channel_ref) {
+    kloop_t* loop = 0;
+    int      ref  = 0;
     verify(channel_ref);
-    return (int)atomic_counter_dec(&channel_ref->ref_info->ref_count);
+    loop = channel_ref->ref_info->loop;
+    ref  = (int)atomic_counter_dec(&channel_ref->ref_info->ref_count);
+    _channel_ref_check_release(loop, ref);
+    return ref;
+}
+
+void _channel_ref_check_release(kloop_t* loop, int ref) {
+    if (ref || !loop) {
+        return;
+    }
+    /* kloop_t߳ͷʱ, ѭǰر */
+    if (knet_loop_get_thread_id(loop) != thread_get_self_id()) {
+        knet_loop_notify(loop);
+    }
 }
 
 int knet_channel_ref_check_ref_zero(kchannel_ref_t* channel_ref) {
@@ -30,11 +30,16 @@
 
 /**
  * ܵ
+ *
+ * ܵ, ܵϢ, ڲܵͬһܵ, loop
  * @param loop kloop_tʵ
- * @param channel kchannel_tʵ
+ * @param socket_fd ѽķ׽
+ * @param max_send_list_len 󳤶
+ * @param recv_ring_len ܻ󳤶
+ * @param flag ܵ־, knet_channel_flag_e
  * @return kchannel_ref_tʵ
  */
-kchannel_ref_t* knet_channel_ref_create(kloop_t* loop, kchannel_t* channel);
+kchannel_ref_t* knet_channel_ref_create(kloop_t* loop, socket_t socket_fd, uint32_t max_send_list_len, uint32_t recv_ring_len, int flag);
 
 /**
  * ٹܵ
@@ -62,6 +67,52 @@ void knet_channel_ref_close_check_reconnect(kchannel_ref_t* channel_ref);
  */
 int knet_channel_ref_write(kchannel_ref_t* channel_ref, const char* data, int size);
 
+/**
+ * ۼд, ݿΪһд
+ * @param channel_ref kchannel_ref_tʵ
+ * @param iov ݿ
+ * @param count ݿ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_channel_ref_writev(kchannel_ref_t* channel_ref, const kiovec_t* iov, int count);
+
+/**
+ * д빲, 
+ *
+ * ߳дʱֻһùݵķͻ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param shared kshared_buffer_tʵ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_channel_ref_write_shared(kchannel_ref_t* channel_ref, kshared_buffer_t* shared);
+
+/**
+ * ȳд, ͬһдܵ
+ *
+ * ǰ̵߳Ĺֱܵӷ, ̵߳Ĺܵkloop_tϲ, knet_channel_ref_fanout_finish()ʱ
+ * ÿkloop_tֻͶһ¼
+ * @param shared kshared_buffer_tʵ, һ
+ * @return kchannel_ref_fanout_tʵ
+ */
+kchannel_ref_fanout_t* knet_channel_ref_fanout_create(kshared_buffer_t* shared);
+
+/**
+ * ȳдһܵ
+ * @param fanout kchannel_ref_fanout_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_channel_ref_fanout_write(kchannel_ref_fanout_t* fanout, kchannel_ref_t* channel_ref);
+
+/**
+ * ͶкϲĿ߳д벢ȳд
+ * @param fanout kchannel_ref_fanout_tʵ
+ */
+void knet_channel_ref_fanout_finish(kchannel_ref_fanout_t* fanout);
+
 /**
  * Ϊͨaccept()ص׽ִܵ
  * @param channel_ref kchannel_ref_tʵ
@@ -73,25 +124,41 @@ int knet_channel_ref_write(kchannel_ref_t* channel_ref, const char* data, int si
 kchannel_ref_t* knet_channel_ref_accept_from_socket_fd(kchannel_ref_t* channel_ref, kloop_t* loop, socket_t client_fd, int event);
 
 /**
- * ȡùܵkloop_tʵ
+ * ؾ - ѡȡܵҪkloop_tʵ
  * @param channel_ref kchannel_ref_tʵ
- * @return kloop_tʵ
+ * @param ip ԶIP, һԹϣʹ, Ϊ0
+ * @retval 0 Ҫؾ
+ * @retval kloop_tʵ
  */
-kloop_t* knet_channel_ref_choose_loop(kchannel_ref_t* channel_ref);
+kloop_t* knet_channel_ref_choose_loop(kchannel_ref_t* channel_ref, const char* ip);
 
 /**
- * ùܵڵ
+ * ȡùܵǶĹܵڵ
  * @param channel_ref kchannel_ref_tʵ
- * @param node ڵ
+ * @return kdlist_node_tʵ
  */
-void knet_channel_ref_set_loop_node(kchannel_ref_t* channel_ref, kdlist_node_t* node);
+kdlist_node_t* knet_channel_ref_get_loop_node(kchannel_ref_t* channel_ref);
 
 /**
- * ȡùܵڵ
+ * ȡùܵǶĳʱʱڵ
  * @param channel_ref kchannel_ref_tʵ
  * @return kdlist_node_tʵ
  */
-kdlist_node_t* knet_channel_ref_get_loop_node(kchannel_ref_t* channel_ref);
+kdlist_node_t* knet_channel_ref_get_timeout_node(kchannel_ref_t* channel_ref);
+
+/**
+ * ùܵǰڵʱֲλ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param list λ, 0ʾʱ
+ */
+void knet_channel_ref_set_timeout_list(kchannel_ref_t* channel_ref, kdlist_t* list);
+
+/**
+ * ȡùܵǰڵʱֲλ
+ * @param channel_ref kchannel_ref_tʵ
+ * @return kdlist_tʵ, 0ʾʱ
+ */
+kdlist_t* knet_channel_ref_get_timeout_list(kchannel_ref_t* channel_ref);
 
 /**
  * kloop_tе߳
@@ -140,6 +207,96 @@ void knet_channel_ref_update_close_in_loop(kloop_t* loop, kchannel_ref_t* channe
  */
 void knet_channel_ref_update_send_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref, kbuffer_t* send_buffer);
 
+/**
+ * kloop_tе߳ڰǰгʱ¼ʱ
+ * ͨ߳óʱ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_update_timeout_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * kloop_tе߳ڼⱻܾдķǷѾˮλ
+ * ܾ߳̾дʱ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_update_send_drained_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * kloop_tе߳ڷ͹ܵ
+ * ͨ߳ʹ
+ * @param loop kloop_tʵ
+ * @param channel_refs kchannel_ref_tʵ
+ * @param count ܵ
+ * @param shared kshared_buffer_tʵ
+ */
+void knet_channel_ref_update_send_batch_in_loop(kloop_t* loop, kchannel_ref_t** channel_refs, int count,
+    kshared_buffer_t* shared);
+
+/**
+ * ԭkloop_t߳Ǩܵ, 뿪ѡȡ/ܵ/ʱֺͶݸĿkloop_t
+ * knet_channel_ref_migrate, ѭʱ
+ * @param loop ԭkloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_update_migrate_out(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * Ŀkloop_tе߳Ǩ, עᵽѡȡ
+ * ͨ߳Ǩƴ
+ * @param loop Ŀkloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_update_migrate_in_loop(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * һ߳Ͷݻδķ/ر¼, ǨƱ־ڼΪǰ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_post_hold(kchannel_ref_t* channel_ref);
+
+/**
+ * /ر¼ٺͷż, ǨҼΪʱǨƱ־
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_post_release(kchannel_ref_t* channel_ref);
+
+/**
+ * ȡ¼Ҫתkloop_t
+ * @param channel_ref kchannel_ref_tʵ
+ * @param loop ǰkloop_tʵ
+ * @retval 0 ܵڵǰkloop_t
+ * @retval kloop_tʵ ܵǨѾǨƵkloop_t
+ */
+kloop_t* knet_channel_ref_get_forward_loop(kchannel_ref_t* channel_ref, kloop_t* loop);
+
+/**
+ * ӹܵĹ㲥, ڶȡܵkloop_t֮ǰ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_increase_broadcast_count(kchannel_ref_t* channel_ref);
+
+/**
+ * ٹܵĹ㲥
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_decrease_broadcast_count(kchannel_ref_t* channel_ref);
+
+/**
+ * ȡϴεշֽ
+ * @param channel_ref kchannel_ref_tʵ
+ * @return շֽ
+ */
+uint32_t knet_channel_ref_swap_load_bytes(kchannel_ref_t* channel_ref);
+
+/**
+ * ùܵص, ʱkloop_tͳ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param e ص¼
+ */
+void knet_channel_ref_invoke_cb(kchannel_ref_t* channel_ref, knet_channel_cb_event_e e);
+
 /**
  * ùܵԶ־
  * @param channel_ref kchannel_ref_tʵ
@@ -216,7 +373,7 @@ void knet_channel_ref_set_state(kchannel_ref_t* channel_ref, knet_channel_state_
  * ܵ¼֪ͨ
  * @param channel_ref kchannel_ref_tʵ
  * @param e ܵ¼
- * @param ts ǰʱ룩
+ * @param ts ǰʱ룩
  */
 void knet_channel_ref_update(kchannel_ref_t* channel_ref, knet_channel_event_e e, time_t ts);
 
@@ -247,7 +404,7 @@ void knet_channel_ref_update_send(kchannel_ref_t* channel_ref);
 /**
  * ܵӲǷʱ
  * @param channel_ref kchannel_ref_tʵ
- * @param ts ǰʱ룩
+ * @param ts ǰʱ룩
  * @retval 0 ûгʱ
  * @retval  ʱ
  */
@@ -256,12 +413,50 @@ int knet_channel_ref_check_connect_timeout(kchannel_ref_t* channel_ref, time_t t
 /**
  * ܵǷгʱ
  * @param channel_ref kchannel_ref_tʵ
- * @param ts ǰʱ룩
+ * @param ts ǰʱ룩
  * @retval 0 ûгʱ
  * @retval  ʱ
  */
 int knet_channel_ref_check_timeout(kchannel_ref_t* channel_ref, time_t ts);
 
+/**
+ * ܵkloop_tʱջȼͳ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_attach_recv_buffer(kchannel_ref_t* channel_ref);
+
+/**
+ * ܵ뿪kloop_tʱͳڿ۳ջȼ״̬
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_channel_ref_detach_recv_buffer(kchannel_ref_t* channel_ref);
+
+/**
+ * ĽջCHANNEL_RECV_BUFFER_IDLEδյʱǿв,
+ * ڻʱCHANNEL_RECV_BUFFER_IDLEٴμ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param ts ǰʱ룩
+ */
+void knet_channel_ref_check_recv_shrink(kchannel_ref_t* channel_ref, time_t ts);
+
+/**
+ * йܵĽջسʼ
+ * @param channel_ref kchannel_ref_tʵ
+ * @retval error_ok ɹ
+ * @retval  Ҫ
+ */
+int knet_channel_ref_shrink_recv_buffer(kchannel_ref_t* channel_ref);
+
+/**
+ * ܵһҪⳬʱʱ
+ *
+ * ӵĹܵÿ̶ȶҪ, ܵһζʱгʱ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param ts ǰʱ룩
+ * @return Ҫʱ, 0ʾҪ
+ */
+time_t knet_channel_ref_get_timeout_deadline(kchannel_ref_t* channel_ref, time_t ts);
+
 /**
  * ȡùܵ
  * @param channel_ref kchannel_ref_tʵ
@@ -60,6 +60,7 @@
  * 
  * ͨknet_channel_ref_set_timeoutùܵĶгʱ룩Ĵ
  * knet_channel_ref_connectʱһһֵӳʱ룩.
+ * Ҫ뼶ʱʹknet_channel_ref_set_timeout_msknet_channel_ref_set_connect_timeout_ms룩.
  * knet_channel_ref_get_socket_fdõܵ׽֣knet_channel_ref_get_uuidĵܵUUID.
  * </pre>
  * @{
@@ -94,6 +95,21 @@ extern void knet_channel_ref_leave(kchannel_ref_t* channel_ref);
  */
 extern int knet_channel_ref_accept(kchannel_ref_t* channel_ref, const char* ip, int port, int backlog);
 
+/**
+ * Զ˿(SO_REUSEPORT)ʽܵתΪܵ
+ *
+ * kloop_tԸԽͬһIP:˿ڵļܵ, ں˽ӷ䵽ܵ,
+ * ʼڼܵڵkloop_t, ᱻؾ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param ip IP
+ * @param port ˿
+ * @param backlog ȴޣlisten())
+ * @retval error_ok ɹ
+ * @retval error_reuse_port_fail ϵͳ֧SO_REUSEPORT
+ * @retval  ʧ
+ */
+extern int knet_channel_ref_accept_reuse_port(kchannel_ref_t* channel_ref, const char* ip, int port, int backlog);
+
 /**
  * 
  *
@@ -171,6 +187,23 @@ extern void knet_channel_ref_close(kchannel_ref_t* channel_ref);
  */
 extern int knet_channel_ref_check_close(kchannel_ref_t* channel_ref);
 
+/**
+ * ѽĹܵǨƵkloop_t
+ *
+ * <pre>
+ * ֻڹܵkloop_t߳ڵ, ѭʱܵ뿪ǰkloop_tѡȡ, ջ
+ * ܵת, Ŀkloop_tע, ֮ĻصĿkloop_t߳ڵ. Ǩ;Ͷݸܵ
+ * ߳¼ԭkloop_tת, ᶪʧ. ǨƺҪԭkloop_t߳ڼҪڹܵ߳
+ * õĺ. IOCP֧Ǩ
+ * </pre>
+ * @param channel_ref kchannel_ref_tʵ
+ * @param loop Ŀkloop_tʵ
+ * @retval error_ok ɹ
+ * @retval error_not_connected ܵδ
+ * @retval error_migrate_fail ڹܵ߳ڵ, Ŀ뵱ǰkloop_tͬ, ѾǨƻѡȡ֧
+ */
+extern int knet_channel_ref_migrate(kchannel_ref_t* channel_ref, kloop_t* loop);
+
 /**
  * ȡùܵ׽
  * @param channel_ref kchannel_ref_tʵ
@@ -210,6 +243,66 @@ extern void knet_channel_ref_set_cb(kchannel_ref_t* channel_ref, knet_channel_re
  */
 extern void knet_channel_ref_set_timeout(kchannel_ref_t* channel_ref, int timeout);
 
+/**
+ * ùܵгʱ룩
+ *
+ * ʱľΪLOOP_TIMEOUT_WHEEL_TICK
+ * @param channel_ref kchannel_ref_tʵ
+ * @param timeout ʱ룩
+ */
+extern void knet_channel_ref_set_timeout_ms(kchannel_ref_t* channel_ref, int timeout);
+
+/**
+ * ӳʱ룩
+ *
+ * knet_channel_ref_connect֮ǰ, knet_channel_ref_connecttimeoutʱḲ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param timeout ӳʱ룩
+ */
+extern void knet_channel_ref_set_connect_timeout_ms(kchannel_ref_t* channel_ref, int timeout);
+
+/**
+ * ÷ߵˮλֽڣ
+ *
+ * ڵȴ͵ֽϱд볬ˮλʱ, д뷵error_send_watermarkҹܵᱻر,
+ * ֮ˮλʱصchannel_cb_event_send_drained, ߿Լд.
+ * ߳дʱļǽƵ, Ͷݵδд.
+ * @param channel_ref kchannel_ref_tʵ
+ * @param high ˮλ, 0Ϊ(Ĭ)
+ * @param low ˮλ
+ */
+extern void knet_channel_ref_set_send_watermark(kchannel_ref_t* channel_ref, int high, int low);
+
+/**
+ * ȡ÷ڵȴ͵ֽ
+ * @param channel_ref kchannel_ref_tʵ
+ * @return ȴ͵ֽ
+ */
+extern int knet_channel_ref_get_send_list_bytes(kchannel_ref_t* channel_ref);
+
+/**
+ * ȡýջǰȣֽڣ
+ *
+ * ջӳʼȿʼ, ֱܵʱָ󳤶, кسʼ
+ * @param channel_ref kchannel_ref_tʵ
+ * @return ջǰ
+ */
+extern int knet_channel_ref_get_recv_buffer_len(kchannel_ref_t* channel_ref);
+
+/**
+ * ýйܵջԤ㣨ֽڣ
+ *
+ * Ԥջ, Ĺܵԭйر
+ * @param budget Ԥ, 0Ϊ(Ĭ)
+ */
+extern void knet_channel_ref_set_recv_buffer_budget(uint64_t budget);
+
+/**
+ * ȡýйܵջռõڴ棨ֽڣ
+ * @return ռõڴ
+ */
+extern uint64_t knet_channel_ref_get_recv_buffer_total();
+
 /**
  * ȡöԶ˵ַ
  * @param channel_ref kchannel_ref_tʵ
@@ -40,6 +40,7 @@ struct _framework_t {
     kframework_worker_t** workers;     /* ߳ */
     kloop_balancer_t*     balancer;    /* ؾ */
     volatile int          start;       /* ־ */
+    volatile int          stop;        /* ֹͣ־ */
 };
 
 /**
@@ -124,16 +125,21 @@ int knet_framework_start(kframework_t* f) {
     }
     /* ־Ƿ߳ */
     f->start = 1;
-    /* / */
-    error = _start_raiser_thread(f);
+    f->stop  = 0;
+    /* ߳, ˿õļҪǰ */
+    error = _start_worker_threads(f);
     if (error_ok != error) {
         goto error_return;
     }
-    /* ߳ */
-    error = _start_worker_threads(f);
+    /* / */
+    error = _start_raiser_thread(f);
     if (error_ok != error) {
         goto error_return;
     }
+    /* ߳(ص)Ѿֹͣ, ʱŽ߳Ҫٴֹͣ */
+    if (f->stop) {
+        knet_framework_stop(f);
+    }
     return error_ok;
 error_return:
     /* ټ */
@@ -188,6 +194,7 @@ int knet_framework_stop(kframework_t* f) {
     if (!f->start) {
         return error_ok;
     }
+    f->stop = 1;
     /* ȹرռ/ */
     if (f->raiser) {
         knet_framework_raiser_stop(f->raiser);
@@ -31,9 +31,10 @@ struct _framework_acceptor_config_t {
     char                  ip[32];                 /* IP */
     int                   port;                   /* ˿ */
     int                   backlog;                /* listen() backlog */
-    int                   idle_timeout;           /* 룩 */
+    int                   idle_timeout;           /* 룩 */
     int                   max_send_list_count;    /* 󳤶 */
     int                   max_recv_buffer_length; /* ջ󳤶 */
+    int                   reuse_port;             /* ÿ߳̽˿õļܵ */
     knet_channel_ref_cb_t cb;                     /* ص */
     void*                 user_data;              /* ûָ */
 };
@@ -41,7 +42,7 @@ struct _framework_acceptor_config_t {
 struct _framework_connector_config_t {
     char                  ip[32];                 /* IP */
     int                   port;                   /* ˿ */
-    int                   idle_timeout;           /* 룩 */
+    int                   idle_timeout;           /* 룩 */
     int                   connect_timeout;        /* ӳʱ */
     int                   max_send_list_count;    /* 󳤶 */
     int                   max_recv_buffer_length; /* ջ󳤶 */
@@ -168,6 +169,11 @@ void knet_framework_acceptor_config_set_backlog(kframework_acceptor_config_t* c,
 }
 
 void knet_framework_acceptor_config_set_client_heartbeat_timeout(kframework_acceptor_config_t* c, int timeout) {
+    verify(c);
+    c->idle_timeout = timeout * 1000;
+}
+
+void knet_framework_acceptor_config_set_client_heartbeat_timeout_ms(kframework_acceptor_config_t* c, int timeout) {
     verify(c);
     c->idle_timeout = timeout;
 }
@@ -187,6 +193,11 @@ void knet_framework_acceptor_config_set_client_max_recv_buffer_length(kframework
     c->max_recv_buffer_length = max_recv_buffer_length;
 }
 
+void knet_framework_acceptor_config_set_reuse_port(kframework_acceptor_config_t* c, int reuse_port) {
+    verify(c);
+    c->reuse_port = reuse_port;
+}
+
 void knet_framework_connector_config_set_remote_address(kframework_connector_config_t* c, const char* ip, int port) {
     verify(c);
     verify(port);
@@ -199,6 +210,11 @@ void knet_framework_connector_config_set_remote_address(kframework_connector_con
 }
 
 void knet_framework_connector_config_set_heartbeat_timeout(kframework_connector_config_t* c, int timeout) {
+    verify(c);
+    c->idle_timeout = timeout * 1000;
+}
+
+void knet_framework_connector_config_set_heartbeat_timeout_ms(kframework_connector_config_t* c, int timeout) {
     verify(c);
     c->idle_timeout = timeout;
 }
@@ -288,6 +304,11 @@ int framework_acceptor_config_get_client_max_recv_buffer_length(kframework_accep
     return c->max_recv_buffer_length;
 }
 
+int framework_acceptor_config_get_reuse_port(kframework_acceptor_config_t* c) {
+    verify(c);
+    return c->reuse_port;
+}
+
 const char* framework_connector_config_get_remote_ip(kframework_connector_config_t* c) {
     verify(c);
     return c->ip;
@@ -97,9 +97,9 @@ int framework_acceptor_config_get_port(kframework_acceptor_config_t* c);
 int framework_acceptor_config_get_backlog(kframework_acceptor_config_t* c);
 
 /**
- * ȡüͻ()
+ * ȡüͻ()
  * @param c kframework_acceptor_config_tʵ
- * @return ͻ()
+ * @return ͻ()
  */
 int framework_acceptor_config_get_client_heartbeat_timeout(kframework_acceptor_config_t* c);
 
@@ -124,6 +124,14 @@ int framework_acceptor_config_get_client_max_send_list_count(kframework_acceptor
  */
 int framework_acceptor_config_get_client_max_recv_buffer_length(kframework_acceptor_config_t* c);
 
+/**
+ * Ƿÿ߳ڽ˿õļܵ
+ * @param c kframework_acceptor_config_tʵ
+ * @retval 0 
+ * @retval  
+ */
+int framework_acceptor_config_get_reuse_port(kframework_acceptor_config_t* c);
+
 /**
  * ȡԶIP
  * @param c kframework_connector_config_tʵ
@@ -139,9 +147,9 @@ const char* framework_connector_config_get_remote_ip(kframework_connector_config
 int framework_connector_config_get_remote_port(kframework_connector_config_t* c);
 
 /**
- * ȡʱ()
+ * ȡʱ()
  * @param c kframework_connector_config_tʵ
- * @return ʱ()
+ * @return ʱ()
  */
 int framework_connector_config_get_heartbeat_timeout(kframework_connector_config_t* c);
 
@@ -150,6 +150,14 @@ extern void knet_framework_acceptor_config_set_backlog(
 extern void knet_framework_acceptor_config_set_client_heartbeat_timeout(
     kframework_acceptor_config_t* c, int timeout);
 
+/**
+ * ÿͻʱ()
+ * @param c kframework_acceptor_config_tʵ
+ * @param timeout ͻʱ()
+ */
+extern void knet_framework_acceptor_config_set_client_heartbeat_timeout_ms(
+    kframework_acceptor_config_t* c, int timeout);
+
 /**
  * ÿͻ˻ص
  * @param c kframework_acceptor_config_tʵ
@@ -174,6 +182,17 @@ extern void knet_framework_acceptor_config_set_client_max_send_list_count(
 extern void knet_framework_acceptor_config_set_client_max_recv_buffer_length(
     kframework_acceptor_config_t* c, int max_recv_buffer_length);
 
+/**
+ * üǷÿ߳ڽ˿(SO_REUSEPORT)ļܵ
+ *
+ * ÿ̶߳ӵһͬһIP:˿ڵļܵ, ں˷䲢ֱڹ߳ڴ,
+ * ֻknet_framework_start֮ǰõļЧ
+ * @param c kframework_acceptor_config_tʵ
+ * @param reuse_port 㿪, ر(Ĭ)
+ */
+extern void knet_framework_acceptor_config_set_reuse_port(
+    kframework_acceptor_config_t* c, int reuse_port);
+
 /**
  * Ҫӵĵַ
  * @param c kframework_connector_config_tʵ
@@ -191,6 +210,14 @@ extern void knet_framework_connector_config_set_remote_address(
 extern void knet_framework_connector_config_set_heartbeat_timeout(
     kframework_connector_config_t* c, int timeout);
 
+/**
+ * ʱ()
+ * @param c kframework_connector_config_tʵ
+ * @param timeout ʱ()
+ */
+extern void knet_framework_connector_config_set_heartbeat_timeout_ms(
+    kframework_connector_config_t* c, int timeout);
+
 /**
  * ӳʱ
  * @param c kframework_connector_config_tʵ
@@ -32,11 +32,6 @@
 #include "misc.h"
 #include "logger.h"
 
-/**
- * 
- */
-int _create_acceptor_channel(kframework_acceptor_config_t* ac, kloop_t* loop);
-
 /**
  * 
  */
@@ -73,18 +68,25 @@ void knet_framework_raiser_destroy(kframework_raiser_t* raiser) {
     destroy(raiser);
 }
 
-int _create_acceptor_channel(kframework_acceptor_config_t* ac, kloop_t* loop) {
-    int            error   = error_ok;
+int knet_framework_create_acceptor_channel(kframework_acceptor_config_t* ac, kloop_t* loop, int reuse_port) {
+    int             error   = error_ok;
     kchannel_ref_t* channel = 0;
+    verify(ac);
+    verify(loop);
     /* ܵ */
     channel = knet_loop_create_channel(loop, framework_acceptor_config_get_client_max_send_list_count(ac),
         framework_acceptor_config_get_client_max_recv_buffer_length(ac));
     verify(channel);
     knet_channel_ref_set_cb(channel, acceptor_cb);
     knet_channel_ref_set_user_data(channel, ac);
-    /*  */
-    error = knet_channel_ref_accept(channel, framework_acceptor_config_get_ip(ac),
-        framework_acceptor_config_get_port(ac), framework_acceptor_config_get_backlog(ac));
+    /* , ˿ʱں˷䵽߳ */
+    if (reuse_port) {
+        error = knet_channel_ref_accept_reuse_port(channel, framework_acceptor_config_get_ip(ac),
+            framework_acceptor_config_get_port(ac), framework_acceptor_config_get_backlog(ac));
+    } else {
+        error = knet_channel_ref_accept(channel, framework_acceptor_config_get_ip(ac),
+            framework_acceptor_config_get_port(ac), framework_acceptor_config_get_backlog(ac));
+    }
     if (error != error_ok) {
         knet_channel_ref_destroy(channel);
     }
@@ -128,7 +130,11 @@ int knet_framework_raiser_start(kframework_raiser_t* raiser) {
     acceptor_config = framework_config_get_acceptor_config(config);
     dlist_for_each_safe(acceptor_config, node, temp) {
         ac = (kframework_acceptor_config_t*)dlist_node_get_data(node);
-        error = _create_acceptor_channel(ac, raiser->loop);
+        if (framework_acceptor_config_get_reuse_port(ac)) {
+            /* ɹ̸߳Խ */
+            continue;
+        }
+        error = knet_framework_create_acceptor_channel(ac, raiser->loop, 0);
         if (error_ok != error) {
             return error;
         }
@@ -171,7 +177,7 @@ int knet_framework_raiser_new_acceptor(kframework_raiser_t* raiser, kframework_a
     channel = knet_loop_create_channel(raiser->loop, framework_acceptor_config_get_client_max_send_list_count(c),
         framework_acceptor_config_get_client_max_recv_buffer_length(c));
     verify(channel);
-    knet_channel_ref_set_timeout(channel, framework_acceptor_config_get_client_heartbeat_timeout(c));
+    knet_channel_ref_set_timeout_ms(channel, framework_acceptor_config_get_client_heartbeat_timeout(c));
     knet_channel_ref_set_cb(channel, acceptor_cb);
     knet_channel_ref_set_user_data(channel, c);
     return knet_channel_ref_accept(channel, framework_acceptor_config_get_ip(c),
@@ -186,7 +192,7 @@ int knet_framework_raiser_new_connector(kframework_raiser_t* raiser, kframework_
         framework_connector_config_get_max_recv_buffer_length(c));
     verify(channel);
     knet_channel_ref_set_cb(channel, framework_connector_config_get_cb(c));
-    knet_channel_ref_set_timeout(channel, framework_connector_config_get_heartbeat_timeout(c));
+    knet_channel_ref_set_timeout_ms(channel, framework_connector_config_get_heartbeat_timeout(c));
     knet_channel_ref_set_user_data(channel, framework_connector_config_get_user_data(c));
     return knet_channel_ref_connect(channel, framework_connector_config_get_remote_ip(c),
         framework_connector_config_get_remote_port(c), framework_connector_config_get_connect_timeout(c));
@@ -199,7 +205,7 @@ void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
         /* ûص */
         knet_channel_ref_set_cb(channel, cb);
         /*  */
-        knet_channel_ref_set_timeout(channel,
+        knet_channel_ref_set_timeout_ms(channel,
             framework_acceptor_config_get_client_heartbeat_timeout(ac));
         knet_channel_ref_set_user_data(channel, framework_acceptor_config_get_user_data(ac));
         if (cb) {
@@ -81,4 +81,14 @@ int knet_framework_raiser_new_acceptor(kframework_raiser_t* raiser,
 int knet_framework_raiser_new_connector(kframework_raiser_t* raiser,
     kframework_connector_config_t* c);
 
+/**
+ * kloop_tڽ
+ * @param ac kframework_acceptor_config_tʵ
+ * @param loop kloop_tʵ
+ * @param reuse_port ʱʹö˿ü
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_framework_create_acceptor_channel(kframework_acceptor_config_t* ac, kloop_t* loop, int reuse_port);
+
 #endif /* FRAMEWORK_RAISER_H */
@@ -24,9 +24,12 @@
 
 #include "framework_worker.h"
 #include "framework.h"
+#include "framework_raiser.h"
 #include "loop.h"
 #include "timer.h"
 #include "loop_balancer.h"
+#include "channel_ref.h"
+#include "list.h"
 #include "misc.h"
 #include "logger.h"
 
@@ -69,7 +72,24 @@ void knet_framework_worker_destroy(kframework_worker_t* worker) {
 }
 
 int knet_framework_worker_start(kframework_worker_t* worker) {
+    int                           error           = error_ok;
+    kframework_acceptor_config_t* ac              = 0;
+    kdlist_node_t*                node            = 0;
+    kdlist_node_t*                temp            = 0;
+    kdlist_t*                     acceptor_config = 0;
     verify(worker);
+    /* ߳ǰ˿õļܵ */
+    acceptor_config = framework_config_get_acceptor_config(knet_framework_get_config(worker->f));
+    dlist_for_each_safe(acceptor_config, node, temp) {
+        ac = (kframework_acceptor_config_t*)dlist_node_get_data(node);
+        if (!framework_acceptor_config_get_reuse_port(ac)) {
+            continue;
+        }
+        error = knet_framework_create_acceptor_channel(ac, worker->loop, 1);
+        if (error_ok != error) {
+            return error;
+        }
+    }
     worker->runner = thread_runner_create(0, 0);
     verify(worker->runner);
     /* һ̣߳һkloop_tһktimer_loop_t */
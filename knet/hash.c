@@ -21,93 +21,183 @@
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
-
 #include "hash.h"
-#include "list.h"
 #include "logger.h"
 #include "misc.h"
 
+/*
+ * Ѱַϣ:
+ * Ԫش洢ڰԪؿ, ֻ׷¿, Ԫصַɾǰֲ, Ԫزʹ
+ * ȡõkhash_value_tָʧЧ. ʹRobin Hood̽, λֻϣֵԪ,
+ * ɾʱƽƶĹ. Ԫ3/4ʱС,
+ * ֮ÿ޸ĲǨHASH_REHASH_STEPԪ, ǨڼȲ±ٲɱ.
+ * Ԫ˳, ɾԪزƶԪ, ˿ڱɾǰԪ.
+ * һԪرɾʱ黹׿Ԫؿ鼰.
+ */
 
-struct _hash_t {
-    uint32_t          size;         /* Ͱ */
-    uint32_t          count;        /* ǰԪظ */
-    kdlist_t**        buckets;      /* Ͱ */
-    knet_hash_dtor_t  dtor;         /* Զֵٺ */
-    uint32_t          it_index;     /*  - ǰͰ */
-    kdlist_node_t*    it_node_safe; /*  - ǰͰڽڵ */
-    kdlist_node_t*    it_node_next; /*  - ǰͰڽڵһڵ */
-};
+#define HASH_INLINE_KEY_SIZE 23 /* ַ󳤶(β0) */
+#define HASH_DEFAULT_SLOTS   8  /* Ĭ */
+
+typedef enum _hash_key_type_e {
+    hash_key_type_none = 0, /* Ԫ */
+    hash_key_type_number,   /* ּ */
+    hash_key_type_string,   /* ַ, ڶϷ */
+    hash_key_type_inline,   /* ַ, Ԫ */
+} hash_key_type_e;
+
+typedef struct _hash_slot_t {
+    uint32_t hash;  /* Ĺϣֵ */
+    uint32_t index; /* Ԫ+1, 0Ϊղλ */
+} hash_slot_t;
 
 struct _hash_value_t {
-    uint32_t key;        /* ּ */
-    char*    string_key; /* ַ */
-    void*    value;      /* ֵ */
+    uint32_t hash;                             /* Ĺϣֵ */
+    uint32_t key;                              /* ּ, ԪΪһԪ+1 */
+    void*    value;                            /* ֵ */
+    char*    string_key;                       /* ַ() */
+    uint8_t  type;                             /*  */
+    char     inline_key[HASH_INLINE_KEY_SIZE]; /* ַ(̼) */
+};
+
+struct _hash_t {
+    hash_slot_t*      slots;       /*  */
+    uint32_t          mask;        /* -1 */
+    uint32_t          init_slots;  /* ״ν */
+    hash_slot_t*      old_slots;   /* ڼľ */
+    uint32_t          old_mask;    /* -1 */
+    uint32_t          rehash_pos;  /* һҪǨƵԪ */
+    uint32_t          rehash_end;  /* ݿʼʱԪ鳤 */
+    khash_value_t**   chunks;      /* Ԫؿ, k鳤Ϊ׿鳤<<k */
+    uint32_t          chunk_shift; /* ׿鳤ȵĶ */
+    uint32_t          chunk_count; /* Ԫؿ */
+    uint32_t          max_values;  /* Ԫؿ */
+    uint32_t          used;        /* ʹõԪ(Ԫ) */
+    uint32_t          free_index;  /* Ԫͷ, +1 */
+    uint32_t          count;       /* ǰԪظ */
+    knet_hash_dtor_t  dtor;        /* Զֵٺ */
+    uint32_t          it_index;    /*  - һԪ */
 };
 
 /**
- * ֵ
- * @param key ּ
- * @param string_key ַ
- * @param value ֵ
- * @return khash_value_tʵ
+ * ֵַ
+ * @param key ַ
+ * @return ֵ
  */
-khash_value_t* hash_value_create(uint32_t key, const char* string_key, void* value);
+uint32_t hash_string(const char* key);
 
 /**
- * ֵ
- * @param hash_value khash_value_tʵ
+ * ĸλ, ּھۼ
  */
-void hash_value_destroy(khash_value_t* hash_value);
+uint32_t _hash_mix(uint32_t key);
 
 /**
- * ּǷ
- * @param hash_value khash_value_tʵ
- * @param key 
- * @retval 0 
- * @retval  
+ * ȡԪصַ
  */
-int hash_value_equal(khash_value_t* hash_value, uint32_t key);
+const char* _hash_value_string_key(khash_value_t* hash_value);
 
 /**
- * ַǷ
- * @param hash_value khash_value_tʵ
- * @param key ַ
- * @retval 0 
- * @retval  
+ * ԪصļǷ, string_keyΪ0ʱȽּ
  */
-int hash_value_equal_string_key(khash_value_t* hash_value, const char* key);
+int _hash_value_equal(khash_value_t* hash_value, uint32_t key, const char* string_key);
 
 /**
- * ֵַ
- * @param key ַ
- * @return ֵ
+ * ڲԪ
  */
-uint32_t hash_string(const char* key);
+void _hash_slots_insert(hash_slot_t* slots, uint32_t mask, uint32_t hash_key, uint32_t index);
 
-khash_value_t* hash_value_create(uint32_t key, const char* string_key, void* value) {
-    khash_value_t* hash_value = create(khash_value_t);
-    verify(hash_value);
-    memset(hash_value, 0, sizeof(khash_value_t));    
-    if (string_key) { /* ַ */
-        hash_value->string_key = create_type(char, strlen(string_key) + 1);
-        if (!hash_value->string_key) {
-            destroy(hash_value);
-            return 0;
-        }
-        strcpy(hash_value->string_key, string_key);
-    } else { /* ּ */
-        hash_value->key = key;
+/**
+ * ڲԪ
+ */
+khash_value_t* _hash_slots_find(khash_t* hash, hash_slot_t* slots, uint32_t mask, uint32_t hash_key,
+    uint32_t key, const char* string_key);
+
+/**
+ * ɾԪ, λǰƽ
+ */
+void _hash_slots_remove(hash_slot_t* slots, uint32_t mask, uint32_t hash_key, uint32_t index);
+
+/**
+ * 
+ */
+hash_slot_t* _hash_slots_create(uint32_t size);
+
+/**
+ * ǨcountԪص, ȫǨϺپ
+ */
+void _hash_rehash_step(khash_t* hash, uint32_t count);
+
+/**
+ * ֤һԪ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int _hash_reserve(khash_t* hash);
+
+/**
+ * ȡӦԪ
+ */
+khash_value_t* _hash_value_at(khash_t* hash, uint32_t index);
+
+/**
+ * ȡԪص
+ */
+uint32_t _hash_value_index(khash_t* hash, khash_value_t* hash_value);
+
+/**
+ * ȡһԪ, Ԫؿ鲻ʱ׷¿
+ * @retval 0 ʧ
+ * @retval khash_value_tʵ
+ */
+khash_value_t* _hash_value_alloc(khash_t* hash);
+
+/**
+ * Ϊʱ黹׿Ԫؿ鼰
+ */
+void _hash_shrink(khash_t* hash);
+
+/**
+ * Ԫ
+ */
+khash_value_t* _hash_find(khash_t* hash, uint32_t hash_key, uint32_t key, const char* string_key);
+
+/**
+ * Ԫ
+ */
+int _hash_insert(khash_t* hash, uint32_t hash_key, uint32_t key, const char* string_key, void* value);
+
+/**
+ * ɾԪزֵ
+ */
+void* _hash_erase(khash_t* hash, khash_value_t* hash_value);
+
+uint32_t _hash_mix(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6b;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35;
+    key ^= key >> 16;
+    return key;
+}
+
+const char* _hash_value_string_key(khash_value_t* hash_value) {
+    if (hash_value->type == hash_key_type_inline) {
+        return hash_value->inline_key;
+    } else if (hash_value->type == hash_key_type_string) {
+        return hash_value->string_key;
     }
-    hash_value->value = value;
-    return hash_value;
+    return 0;
 }
 
-void hash_value_destroy(khash_value_t* hash_value) {
-    verify(hash_value);
-    if (hash_value->string_key) {
-        destroy(hash_value->string_key);
+int _hash_value_equal(khash_value_t* hash_value, uint32_t key, const char* string_key) {
+    if (string_key) {
+        if (hash_value->type == hash_key_type_inline) {
+            return (0 == strcmp(string_key, hash_value->inline_key));
+        } else if (hash_value->type == hash_key_type_string) {
+            return (0 == strcmp(string_key, hash_value->string_key));
+        }
+        return 0;
     }
-    destroy(hash_value);
+    return ((hash_value->type == hash_key_type_number) && (hash_value->key == key));
 }
 
 void* hash_value_get_value(khash_value_t* hash_value) {
@@ -117,173 +207,416 @@ void* hash_value_get_value(khash_value_t* hash_value) {
 
 uint32_t hash_value_get_key(khash_value_t* hash_value) {
     verify(hash_value);
+    if (hash_value->type != hash_key_type_number) {
+        return 0;
+    }
     return hash_value->key;
 }
 
 const char* hash_value_get_string_key(khash_value_t* hash_value) {
     verify(hash_value);
-    return hash_value->string_key;
+    return _hash_value_string_key(hash_value);
 }
 
-int hash_value_equal(khash_value_t* hash_value, uint32_t key) {
-    verify(hash_value);
-    return (key == hash_value->key);
+void _hash_slots_insert(hash_slot_t* slots, uint32_t mask, uint32_t hash_key, uint32_t index) {
+    hash_slot_t slot     = {0, 0};
+    hash_slot_t temp     = {0, 0};
+    uint32_t    pos      = hash_key & mask;
+    uint32_t    distance = 0;
+    uint32_t    other    = 0;
+    slot.hash  = hash_key;
+    slot.index = index + 1;
+    for (;;) {
+        if (!slots[pos].index) {
+            slots[pos] = slot;
+            return;
+        }
+        other = (pos - (slots[pos].hash & mask)) & mask;
+        if (other < distance) {
+            /* λøԪóλ */
+            temp        = slots[pos];
+            slots[pos]  = slot;
+            slot        = temp;
+            distance    = other;
+        }
+        pos = (pos + 1) & mask;
+        distance++;
+    }
 }
 
-int hash_value_equal_string_key(khash_value_t* hash_value, const char* key) {
-    verify(hash_value);
-    verify(key);
-    if (!hash_value->string_key) {
-        /* ⲿĵ */
-        verify(0);
+khash_value_t* _hash_slots_find(khash_t* hash, hash_slot_t* slots, uint32_t mask, uint32_t hash_key,
+    uint32_t key, const char* string_key) {
+    uint32_t       pos        = hash_key & mask;
+    uint32_t       distance   = 0;
+    khash_value_t* hash_value = 0;
+    for (;;) {
+        if (!slots[pos].index) {
+            return 0;
+        }
+        if (((pos - (slots[pos].hash & mask)) & mask) < distance) {
+            /* , ӦѾ֮ǰĲλ */
+            return 0;
+        }
+        if (slots[pos].hash == hash_key) {
+            hash_value = _hash_value_at(hash, slots[pos].index - 1);
+            if (_hash_value_equal(hash_value, key, string_key)) {
+                return hash_value;
+            }
+        }
+        pos = (pos + 1) & mask;
+        distance++;
+    }
+}
+
+void _hash_slots_remove(hash_slot_t* slots, uint32_t mask, uint32_t hash_key, uint32_t index) {
+    uint32_t pos  = hash_key & mask;
+    uint32_t next = 0;
+    uint32_t i    = 0;
+    for (; slots[pos].index != index + 1; pos = (pos + 1) & mask, i++) {
+        if (!slots[pos].index || (i > mask)) {
+            return; /* ڴ */
+        }
+    }
+    /* λõĲλǰƽ */
+    next = (pos + 1) & mask;
+    while (slots[next].index && ((next - (slots[next].hash & mask)) & mask)) {
+        slots[pos] = slots[next];
+        pos        = next;
+        next       = (next + 1) & mask;
+    }
+    slots[pos].hash  = 0;
+    slots[pos].index = 0;
+}
+
+hash_slot_t* _hash_slots_create(uint32_t size) {
+    hash_slot_t* slots = create_type(hash_slot_t, sizeof(hash_slot_t) * size);
+    if (!slots) {
         return 0;
     }
-    return (0 == strcmp(key, hash_value->string_key));
+    memset(slots, 0, sizeof(hash_slot_t) * size);
+    return slots;
 }
 
-khash_t* hash_create(uint32_t size, knet_hash_dtor_t dtor) {
+void _hash_rehash_step(khash_t* hash, uint32_t count) {
+    khash_value_t* hash_value = 0;
+    if (!hash->old_slots) {
+        return;
+    }
+    for (; count && (hash->rehash_pos < hash->rehash_end); count--, hash->rehash_pos++) {
+        hash_value = _hash_value_at(hash, hash->rehash_pos);
+        if (hash_value->type != hash_key_type_none) {
+            _hash_slots_insert(hash->slots, hash->mask, hash_value->hash, hash->rehash_pos);
+        }
+    }
+    if (hash->rehash_pos >= hash->rehash_end) {
+        /* Ǩ */
+        destroy(hash->old_slots);
+        hash->old_slots = 0;
+        hash->old_mask  = 0;
+    }
+}
+
+int _hash_reserve(khash_t* hash) {
+    hash_slot_t* slots = 0;
+    uint32_t     size  = 0;
+    if (!hash->slots) {
+        hash->slots = _hash_slots_create(hash->init_slots);
+        if (!hash->slots) {
+            return error_no_memory;
+        }
+        hash->mask = hash->init_slots - 1;
+        return error_ok;
+    }
+    size = hash->mask + 1;
+    if (hash->count + 1 <= size - (size >> 2)) {
+        return error_ok;
+    }
+    if (hash->old_slots) {
+        /* һݻδ, ȫǨ */
+        _hash_rehash_step(hash, hash->rehash_end);
+    }
+    slots = _hash_slots_create(size << 1);
+    if (!slots) {
+        return error_no_memory;
+    }
+    hash->old_slots  = hash->slots;
+    hash->old_mask   = hash->mask;
+    hash->slots      = slots;
+    hash->mask       = (size << 1) - 1;
+    hash->rehash_pos = 0;
+    hash->rehash_end = hash->used;
+    _hash_rehash_step(hash, HASH_REHASH_STEP);
+    return error_ok;
+}
+
+khash_value_t* _hash_value_at(khash_t* hash, uint32_t index) {
+    uint32_t chunk = (index >> hash->chunk_shift) + 1;
+    /* kʼΪ((1<<k)-1)<<chunk_shift, Ϊchunkλ */
+#if defined(WIN32)
+    unsigned long bit = 0;
+    _BitScanReverse(&bit, chunk);
+    chunk = (uint32_t)bit;
+#else
+    chunk = 31 - (uint32_t)__builtin_clz(chunk);
+#endif /* defined(WIN32) */
+    return hash->chunks[chunk] + (index - (((1u << chunk) - 1) << hash->chunk_shift));
+}
+
+uint32_t _hash_value_index(khash_t* hash, khash_value_t* hash_value) {
     uint32_t i = 0;
-    khash_t* hash = create(khash_t);
+    for (; i < hash->chunk_count; i++) {
+        if ((hash_value >= hash->chunks[i]) &&
+            (hash_value < hash->chunks[i] + (1u << (hash->chunk_shift + i)))) {
+            return (((1u << i) - 1) << hash->chunk_shift) + (uint32_t)(hash_value - hash->chunks[i]);
+        }
+    }
+    verify(0);
+    return 0;
+}
+
+khash_value_t* _hash_value_alloc(khash_t* hash) {
+    khash_value_t** chunks     = 0;
+    khash_value_t*  chunk      = 0;
+    khash_value_t*  hash_value = 0;
+    uint32_t        size       = 0;
+    if (hash->free_index && !hash->old_slots) {
+        /* ڼ䲻ÿԪ, δǨƵظ */
+        hash_value       = _hash_value_at(hash, hash->free_index - 1);
+        hash->free_index = hash_value->key;
+        return hash_value;
+    }
+    if (hash->used >= hash->max_values) {
+        /* ׷¿, Ԫزƶ */
+        size  = 1u << (hash->chunk_shift + hash->chunk_count);
+        chunk = create_type(khash_value_t, sizeof(khash_value_t) * size);
+        if (!chunk) {
+            return 0;
+        }
+        chunks = rcreate_type_ptr_array(khash_value_t, hash->chunks, hash->chunk_count + 1);
+        if (!chunks) {
+            destroy(chunk);
+            return 0;
+        }
+        chunks[hash->chunk_count++] = chunk;
+        hash->chunks      = chunks;
+        hash->max_values += size;
+    }
+    return _hash_value_at(hash, hash->used++);
+}
+
+void _hash_shrink(khash_t* hash) {
+    if (hash->count) {
+        return;
+    }
+    for (; hash->chunk_count > 1; hash->chunk_count--) {
+        destroy(hash->chunks[hash->chunk_count - 1]);
+    }
+    hash->max_values = hash->chunk_count ? (1u << hash->chunk_shift) : 0;
+    hash->used       = 0;
+    hash->free_index = 0;
+    if (hash->old_slots) {
+        destroy(hash->old_slots);
+        hash->old_slots = 0;
+        hash->old_mask  = 0;
+    }
+    if (hash->slots && (hash->mask + 1 > hash->init_slots)) {
+        /* ´ʱʼ½ */
+        destroy(hash->slots);
+        hash->slots = 0;
+        hash->mask  = 0;
+    }
+}
+
+khash_value_t* _hash_find(khash_t* hash, uint32_t hash_key, uint32_t key, const char* string_key) {
+    khash_value_t* hash_value = 0;
+    if (!hash->slots) {
+        return 0;
+    }
+    hash_value = _hash_slots_find(hash, hash->slots, hash->mask, hash_key, key, string_key);
+    if (!hash_value && hash->old_slots) {
+        /* δǨ */
+        hash_value = _hash_slots_find(hash, hash->old_slots, hash->old_mask, hash_key, key, string_key);
+    }
+    return hash_value;
+}
+
+int _hash_insert(khash_t* hash, uint32_t hash_key, uint32_t key, const char* string_key, void* value) {
+    khash_value_t* hash_value = 0;
+    size_t         length     = 0;
+    int            error      = error_ok;
+    error = _hash_reserve(hash);
+    if (error_ok != error) {
+        return error;
+    }
+    _hash_rehash_step(hash, HASH_REHASH_STEP);
+    hash_value = _hash_value_alloc(hash);
+    if (!hash_value) {
+        return error_no_memory;
+    }
+    memset(hash_value, 0, sizeof(khash_value_t));
+    if (string_key) { /* ַ */
+        length = strlen(string_key) + 1;
+        if (length <= HASH_INLINE_KEY_SIZE) {
+            memcpy(hash_value->inline_key, string_key, length);
+            hash_value->type = hash_key_type_inline;
+        } else {
+            hash_value->string_key = create_type(char, length);
+            if (!hash_value->string_key) {
+                /* 黹 */
+                hash_value->key  = hash->free_index;
+                hash->free_index = _hash_value_index(hash, hash_value) + 1;
+                return error_no_memory;
+            }
+            memcpy(hash_value->string_key, string_key, length);
+            hash_value->type = hash_key_type_string;
+        }
+    } else { /* ּ */
+        hash_value->key  = key;
+        hash_value->type = hash_key_type_number;
+    }
+    hash_value->hash  = hash_key;
+    hash_value->value = value;
+    _hash_slots_insert(hash->slots, hash->mask, hash_key, _hash_value_index(hash, hash_value));
+    hash->count++;
+    return error_ok;
+}
+
+void* _hash_erase(khash_t* hash, khash_value_t* hash_value) {
+    void*    value = hash_value->value;
+    uint32_t index = _hash_value_index(hash, hash_value);
+    _hash_slots_remove(hash->slots, hash->mask, hash_value->hash, index);
+    if (hash->old_slots) {
+        _hash_slots_remove(hash->old_slots, hash->old_mask, hash_value->hash, index);
+    }
+    if (hash_value->type == hash_key_type_string) {
+        destroy(hash_value->string_key);
+    }
+    /*  */
+    memset(hash_value, 0, sizeof(khash_value_t));
+    hash_value->key  = hash->free_index;
+    hash->free_index = index + 1;
+    hash->count--;
+    _hash_rehash_step(hash, HASH_REHASH_STEP);
+    _hash_shrink(hash);
+    return value;
+}
+
+khash_t* hash_create(uint32_t size, knet_hash_dtor_t dtor) {
+    uint32_t slots = HASH_DEFAULT_SLOTS;
+    khash_t* hash  = create(khash_t);
     verify(hash);
-    memset(hash, 0, sizeof(khash_t));
-    if (!size) {
-        size = 64; /* Ĭbucket */
-    }
-    hash->dtor = dtor;
-    hash->size = size;
-    hash->buckets = (kdlist_t**)create_type(kdlist_t*, sizeof(kdlist_t*) * size);
-    verify(hash->buckets);
-    if (!hash->buckets) {
-        destroy(hash);
+    if (!hash) {
         return 0;
     }
-    memset(hash->buckets, 0, size * sizeof(kdlist_t*));
-    /* bucket */
-    for (; i < size; i++) {
-        hash->buckets[i] = dlist_create();
+    memset(hash, 0, sizeof(khash_t));
+    /* ȡСsize2, ״Ԫʱ */
+    while (slots < size) {
+        slots <<= 1;
+    }
+    hash->init_slots = slots;
+    hash->dtor       = dtor;
+    /* ׿鳤Ϊʼȵһ */
+    while ((1u << (hash->chunk_shift + 1)) < slots) {
+        hash->chunk_shift++;
     }
     return hash;
 }
 
 void hash_destroy(khash_t* hash) {
-    uint32_t      i     = 0;
-    kdlist_node_t* node  = 0;
-    kdlist_node_t* temp  = 0;
-    khash_value_t* value = 0;
+    uint32_t       i          = 0;
+    khash_value_t* hash_value = 0;
     verify(hash);
-    /* bucket */
-    for (; i < hash->size; i++) {
-        if (hash->buckets[i]) {
-            dlist_for_each_safe(hash->buckets[i], node, temp) {
-                value = (khash_value_t*)dlist_node_get_data(node);
-                if (hash->dtor) {
-                    /* Զ */
-                    hash->dtor(value->value);
-                }
-                /* ֵ */
-                hash_value_destroy(value);
-            }
-            /*  */
-            dlist_destroy(hash->buckets[i]);
-            hash->buckets[i] = 0;
+    for (; i < hash->used; i++) {
+        hash_value = _hash_value_at(hash, i);
+        if (hash_value->type == hash_key_type_none) {
+            continue;
+        }
+        if (hash->dtor) {
+            /* Զ */
+            hash->dtor(hash_value->value);
+        }
+        if (hash_value->type == hash_key_type_string) {
+            destroy(hash_value->string_key);
         }
     }
-    /* bucket */
-    destroy(hash->buckets);
+    for (i = 0; i < hash->chunk_count; i++) {
+        destroy(hash->chunks[i]);
+    }
+    if (hash->chunks) {
+        destroy(hash->chunks);
+    }
+    if (hash->slots) {
+        destroy(hash->slots);
+    }
+    if (hash->old_slots) {
+        destroy(hash->old_slots);
+    }
     destroy(hash);
 }
 
-int hash_add(khash_t* hash, uint32_t key, void* value) {
-    uint32_t      hash_key   = 0;
+void hash_clear(khash_t* hash) {
+    uint32_t       i          = 0;
     khash_value_t* hash_value = 0;
     verify(hash);
-    verify(value);
-    hash_key = key % hash->size;
-    /* ֵ */
-    hash_value = hash_value_create(key, 0, value);
-    verify(hash_value);
-    if (!hash_value) {
-        return error_no_memory;
+    for (; i < hash->used; i++) {
+        hash_value = _hash_value_at(hash, i);
+        if (hash_value->type == hash_key_type_none) {
+            continue;
+        }
+        if (hash->dtor) {
+            hash->dtor(hash_value->value);
+        }
+        if (hash_value->type == hash_key_type_string) {
+            destroy(hash_value->string_key);
+        }
     }
-    /* ӵβ */
-    if (!dlist_add_tail_node(hash->buckets[hash_key], hash_value)) {
-        return error_no_memory;
+    if (hash->old_slots) {
+        destroy(hash->old_slots);
+        hash->old_slots = 0;
+        hash->old_mask  = 0;
     }
-    hash->count++;
-    return error_ok;
+    if (hash->slots) {
+        memset(hash->slots, 0, sizeof(hash_slot_t) * (hash->mask + 1));
+    }
+    /* Ԫ, ´ʱҪ· */
+    hash->used       = 0;
+    hash->free_index = 0;
+    hash->count      = 0;
+    hash->it_index   = 0;
+}
+
+int hash_add(khash_t* hash, uint32_t key, void* value) {
+    verify(hash);
+    verify(value);
+    return _hash_insert(hash, _hash_mix(key), key, 0, value);
 }
 
 int hash_add_string_key(khash_t* hash, const char* key, void* value) {
-    uint32_t      hash_key   = 0;
-    khash_value_t* hash_value = 0;
     verify(hash);
+    verify(key);
     verify(value);
-    hash_key = hash_string(key) % hash->size;
-    /* ֵ */
-    hash_value = hash_value_create(0, key, value);
-    if (!hash_value) {
-        return error_no_memory;
-    }
-    /* ӵβ */
-    if (!dlist_add_tail_node(hash->buckets[hash_key], hash_value)) {
-        return error_no_memory;
-    }
-    hash->count++;
-    return error_ok;
+    return _hash_insert(hash, _hash_mix(hash_string(key)), 0, key, value);
 }
 
 void* hash_remove(khash_t* hash, uint32_t key) {
-    uint32_t      hash_key   = 0;
-    kdlist_node_t* node       = 0;
-    kdlist_node_t* temp       = 0;
     khash_value_t* hash_value = 0;
-    void*         value      = 0;
     verify(hash);
-    hash_key = key % hash->size;
-    /*  */
-    dlist_for_each_safe(hash->buckets[hash_key], node, temp) {
-        if (node == hash->it_node_next) { /* ɾڱڵĺڵ */
-            hash->it_node_next = dlist_next(hash->buckets[hash_key], hash->it_node_next);
-        }
-        hash_value = (khash_value_t*)dlist_node_get_data(node);
-        if (hash_value_equal(hash_value, key)) {
-            hash->count--;
-            value = hash_value_get_value(hash_value);
-            /* ٽڵ */
-            dlist_delete(hash->buckets[hash_key], node);
-            /* ֵ */
-            hash_value_destroy(hash_value);
-            return value; /* ظ */
-        }
+    hash_value = _hash_find(hash, _hash_mix(key), key, 0);
+    if (!hash_value) {
+        return 0; /* ûҵ */
     }
-    return 0; /* ûҵ */
+    return _hash_erase(hash, hash_value);
 }
 
 void* hash_remove_string_key(khash_t* hash, const char* key) {
-    uint32_t      hash_key   = 0;
-    kdlist_node_t* node       = 0;
-    kdlist_node_t* temp       = 0;
     khash_value_t* hash_value = 0;
-    void*         value      = 0;
     verify(hash);
-    hash_key = hash_string(key) % hash->size;
-    /*  */
-    dlist_for_each_safe(hash->buckets[hash_key], node, temp) {
-        if (node == hash->it_node_next) { /* ɾڱڵĺڵ */
-            hash->it_node_next = dlist_next(hash->buckets[hash_key], hash->it_node_next);
-        }
-        hash_value = (khash_value_t*)dlist_node_get_data(node);
-        if (hash_value_equal_string_key(hash_value, key)) {
-            hash->count--;
-            value = hash_value_get_value(hash_value);
-            /* ٽڵ */
-            dlist_delete(hash->buckets[hash_key], node);
-            /* ֵ */
-            hash_value_destroy(hash_value);
-            return value; /* ظ */
-        }
+    verify(key);
+    hash_value = _hash_find(hash, _hash_mix(hash_string(key)), 0, key);
+    if (!hash_value) {
+        return 0; /* ûҵ */
     }
-    return 0; /* ûҵ */
+    return _hash_erase(hash, hash_value);
 }
 
 int hash_delete(khash_t* hash, uint32_t key) {
@@ -302,46 +635,38 @@ int hash_delete(khash_t* hash, uint32_t key) {
 }
 
 int hash_replace(khash_t* hash, uint32_t key, void* value) {
-    uint32_t      hash_key   = 0;
-    kdlist_node_t* node       = 0;
+    uint32_t       hash_key   = 0;
     khash_value_t* hash_value = 0;
     verify(hash);
     verify(value);
-    hash_key = key % hash->size;
-    /*  */
-    dlist_for_each(hash->buckets[hash_key], node) {
-        hash_value = (khash_value_t*)dlist_node_get_data(node);
-        if (hash_value_equal(hash_value, key)) {
-            if (hash->dtor) {
-                hash->dtor(hash_value->value);
-            }
-            hash_value->value = value;
-            return error_ok;
+    hash_key   = _hash_mix(key);
+    hash_value = _hash_find(hash, hash_key, key, 0);
+    if (hash_value) {
+        if (hash->dtor) {
+            hash->dtor(hash_value->value);
         }
+        hash_value->value = value;
+        return error_ok;
     }
-    return hash_add(hash, key, value);
+    return _hash_insert(hash, hash_key, key, 0, value);
 }
 
 int hash_replace_string_key(khash_t* hash, const char* key, void* value) {
-    uint32_t      hash_key   = 0;
-    kdlist_node_t* node       = 0;
+    uint32_t       hash_key   = 0;
     khash_value_t* hash_value = 0;
     verify(hash);
     verify(key);
     verify(value);
-    hash_key = hash_string(key) % hash->size;
-    /*  */
-    dlist_for_each(hash->buckets[hash_key], node) {
-        hash_value = (khash_value_t*)dlist_node_get_data(node);
-        if (hash_value_equal_string_key(hash_value, key)) {
-            if (hash->dtor) {
-                hash->dtor(hash_value->value);
-            }
-            hash_value->value = value;
-            return error_ok;
+    hash_key   = _hash_mix(hash_string(key));
+    hash_value = _hash_find(hash, hash_key, 0, key);
+    if (hash_value) {
+        if (hash->dtor) {
+            hash->dtor(hash_value->value);
         }
+        hash_value->value = value;
+        return error_ok;
     }
-    return hash_add_string_key(hash, key, value);
+    return _hash_insert(hash, hash_key, 0, key, value);
 }
 
 int hash_delete_string_key(khash_t* hash, const char* key) {
@@ -360,36 +685,24 @@ int hash_delete_string_key(khash_t* hash, const char* key) {
 }
 
 void* hash_get(khash_t* hash, uint32_t key) {
-    uint32_t      hash_key   = 0;
-    kdlist_node_t* node       = 0;
     khash_value_t* hash_value = 0;
     verify(hash);
-    hash_key = key % hash->size;
-    /*  */
-    dlist_for_each(hash->buckets[hash_key], node) {
-        hash_value = (khash_value_t*)dlist_node_get_data(node);
-        if (hash_value_equal(hash_value, key)) {
-            return hash_value_get_value(hash_value);
-        }
+    hash_value = _hash_find(hash, _hash_mix(key), key, 0);
+    if (!hash_value) {
+        return 0; /* ûҵ */
     }
-    return 0; /* ûҵ */
+    return hash_value->value;
 }
 
 void* hash_get_string_key(khash_t* hash, const char* key) {
-    uint32_t      hash_key   = 0;
-    kdlist_node_t* node       = 0;
     khash_value_t* hash_value = 0;
     verify(hash);
     verify(key);
-    hash_key = hash_string(key) % hash->size;
-    /*  */
-    dlist_for_each(hash->buckets[hash_key], node) {
-        hash_value = (khash_value_t*)dlist_node_get_data(node);
-        if (hash_value_equal_string_key(hash_value, key)) {
-            return hash_value_get_value(hash_value);
-        }
+    hash_value = _hash_find(hash, _hash_mix(hash_string(key)), 0, key);
+    if (!hash_value) {
+        return 0; /* ûҵ */
     }
-    return 0; /* ûҵ */
+    return hash_value->value;
 }
 
 uint32_t hash_get_size(khash_t* hash) {
@@ -407,73 +720,20 @@ uint32_t hash_string(const char* key) {
 }
 
 khash_value_t* hash_get_first(khash_t* hash) {
-    uint32_t       i          = 0;
-    kdlist_t*      list       = 0;
-    khash_value_t* hash_value = 0;
     verify(hash);
-    hash->it_index     = 0;
-    hash->it_node_safe = 0;
-    hash->it_node_next = 0;
-    if (!hash->count) { /* ûԪ */
-        return 0;
-    }
-    /* ҵһԪصͰ */
-    for (; i < hash->size; i++) {
-        list = hash->buckets[i];
-        verify(list);
-        if (!dlist_empty(list)) {
-            hash->it_index = i;
-            break;
-        }
-    }
-    verify(list);
-    if (!list) {
-        return 0;
-    }
-    hash->it_node_safe = dlist_get_front(list);
-    verify(hash->it_node_safe);
-    /* ԤȡһԪأǷԪ */
-    hash->it_node_next = dlist_next(list, hash->it_node_safe);
-    hash_value = (khash_value_t*)dlist_node_get_data(hash->it_node_safe);
-    verify(hash_value);
-    return hash_value;
+    hash->it_index = 0;
+    return hash_next(hash);
 }
 
 khash_value_t* hash_next(khash_t* hash) {
-    uint32_t      i          = 0;
-    kdlist_t*      list       = 0;
     khash_value_t* hash_value = 0;
     verify(hash);
-    if (!hash->it_node_safe) { /* δhash_get_first() */
-        hash_get_first(hash);
-    }
-    if (hash->it_node_next) { /* ǰͰһԪ */
-        hash->it_node_safe = hash->it_node_next; /*  */
-    } else { /* һԪصͰ */
-        hash->it_node_safe = 0;
-        if (hash->it_index >= hash->size) {
-            return 0;
-        }
-        /* δβ */
-        hash->it_index++;
-        /* Ͱ */
-        for (i = hash->it_index; i < hash->size; i++) {
-            list = hash->buckets[i];
-            verify(list);
-            if (!dlist_empty(list)) {
-                hash->it_node_safe = dlist_get_front(list);
-                verify(hash->it_node_safe);
-                hash->it_index = i;
-                break;
-            }
-        }
-        if (!hash->it_node_safe) { /* ͰΪ */
-            return 0;
+    /* Ԫ, ǰԪرɾӰ */
+    while (hash->it_index < hash->used) {
+        hash_value = _hash_value_at(hash, hash->it_index++);
+        if (hash_value->type != hash_key_type_none) {
+            return hash_value;
         }
     }
-    /* ԤȡһԪأǷԪ */
-    hash->it_node_next = dlist_next(list, hash->it_node_safe);
-    hash_value = (khash_value_t*)dlist_node_get_data(hash->it_node_safe);
-    verify(hash_value);
-    return hash_value;
+    return 0;
 }
@@ -28,21 +28,6 @@
 #include "logger.h"
 
 
-/* ڵ */
-struct _dlist_node_t {
-    struct _dlist_node_t* prev;
-    struct _dlist_node_t* next;
-    void*                 data;
-    int                   init;
-};
-
-/* ˫ѭ */
-struct _dlist_t {
-    kdlist_node_t*   head;
-    atomic_counter_t count;
-    int              init;
-};
-
 kdlist_node_t* dlist_node_create() {
     kdlist_node_t* node = create(kdlist_node_t);
     verify(node);
@@ -84,13 +69,10 @@ void* dlist_node_get_data(kdlist_node_t* node) {
 kdlist_t* dlist_create() {
     kdlist_t* dlist = create(kdlist_t);
     verify(dlist);
-    dlist->head = dlist_node_create();
-    verify(dlist->head);
-    if (!dlist->head) {
-        destroy(dlist);
+    if (!dlist) {
         return 0;
     }
-    dlist->head->data = 0;
+    dlist->head = dlist_node_init(&dlist->head_node);
     dlist->head->next = dlist->head;
     dlist->head->prev = dlist->head;
     dlist->count = 0;
@@ -100,9 +82,7 @@ kdlist_t* dlist_create() {
 
 kdlist_t* dlist_init(kdlist_t* dlist) {
     verify(dlist);
-    dlist->head = dlist_node_create();
-    verify(dlist->head);
-    dlist->head->data = 0;
+    dlist->head = dlist_node_init(&dlist->head_node);
     dlist->head->next = dlist->head;
     dlist->head->prev = dlist->head;
     dlist->count = 0;
@@ -117,7 +97,6 @@ void dlist_destroy(kdlist_t* dlist) {
     dlist_for_each_safe(dlist, node, temp) {
         dlist_delete(dlist, node);
     }
-    destroy(dlist->head);
     if (!dlist->init) {
         destroy(dlist);
     }
@@ -187,6 +166,9 @@ kdlist_node_t* dlist_remove(kdlist_t* dlist, kdlist_node_t* node) {
     }
     node->prev->next = node->next;
     node->next->prev = node->prev;
+    /* ƳĽڵٴƳ, ǶڵжǷ */
+    node->prev = 0;
+    node->next = 0;
     atomic_counter_dec(&dlist->count);
     return node;
 }
@@ -194,7 +176,10 @@ kdlist_node_t* dlist_remove(kdlist_t* dlist, kdlist_node_t* node) {
 void dlist_delete(kdlist_t* dlist, kdlist_node_t* node) {
     verify(dlist);
     verify(node);
-    dlist_node_destroy(dlist_remove(dlist, node));
+    /* ѾڵĽڵƳ߸ */
+    if (dlist_remove(dlist, node)) {
+        dlist_node_destroy(node);
+    }
 }
 
 kdlist_node_t* dlist_next(kdlist_t* dlist, kdlist_node_t* node) {
@@ -216,6 +201,11 @@ kdlist_node_t* dlist_get_front(kdlist_t* dlist) {
     return dlist->head->next;
 }
 
+int dlist_node_check_linked(kdlist_node_t* node) {
+    verify(node);
+    return (node->prev && node->next);
+}
+
 kdlist_node_t* dlist_get_back(kdlist_t* dlist) {
     verify(dlist);
     if (dlist->head->prev == dlist->head) {
@@ -27,6 +27,28 @@
 
 #include "config.h"
 
+/*
+ * ڵ
+ *
+ * ڵǶṹ, ʹdlist_node_init()ʼԶΪ,
+ * ֮ͨdlist_add_front()/dlist_add_tail()/dlist_remove(), ڴ.
+ * Ƕڵ㲻ᱻdlist_delete()/dlist_destroy(), ǰȴƳ
+ */
+struct _dlist_node_t {
+    struct _dlist_node_t* prev; /* ǰһڵ, ʱΪ0 */
+    struct _dlist_node_t* next; /* һڵ, ʱΪ0 */
+    void*                 data; /* Զ */
+    int                   init; /* Ƿͨdlist_node_init()ʼ */
+};
+
+/* ˫ѭ, Ƕṹ, ʹdlist_init()ʼ */
+struct _dlist_t {
+    kdlist_node_t    head_node; /* ͷڵ */
+    kdlist_node_t*   head;      /* ָͷڵ */
+    atomic_counter_t count;     /* ڵ */
+    int              init;      /* Ƿͨdlist_init()ʼ */
+};
+
 /**
  * ڵ
  * @return kdlist_node_tʵ
@@ -34,7 +56,7 @@
 kdlist_node_t* dlist_node_create();
 
 /**
- * ʼڵ
+ * ʼǶڵ
  * @param node kdlist_node_tʵ
  * @return kdlist_node_tʵ
  */
@@ -134,7 +156,7 @@ int dlist_empty(kdlist_t* dlist);
 kdlist_node_t* dlist_remove(kdlist_t* dlist, kdlist_node_t* node);
 
 /**
- * ڵ
+ * ڵ, ڵѾʱκβ
  * @param dlist kdlist_tʵ
  * @param node ǰڵ
  */
@@ -157,6 +179,14 @@ kdlist_node_t* dlist_next(kdlist_t* dlist, kdlist_node_t* node);
  */
 kdlist_node_t* dlist_get_front(kdlist_t* dlist);
 
+/**
+ * ڵǷ
+ * @param node kdlist_node_tʵ
+ * @retval 0 
+ * @retval  
+ */
+int dlist_node_check_linked(kdlist_node_t* node);
+
 /**
  * ȡβڵ
  * @param dlist kdlist_tʵ
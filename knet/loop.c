@@ -30,48 +30,140 @@
 #include "misc.h"
 #include "loop_balancer.h"
 #include "loop_profile.h"
-#include "stream.h"
+#include "rpc_object.h"
+#include "buffer.h"
+#include "allocator.h"
+#include "broadcast.h"
 #include "logger.h"
 
 
+typedef enum _loop_event_e {
+    loop_event_accept = 1,    /* ¼ */
+    loop_event_connect,       /* ¼ */
+    loop_event_send,          /* ¼ */
+    loop_event_close,         /* ر¼ */
+    loop_event_accept_async,  /* 첽 */
+    loop_event_timeout,       /* ܵ¼ʱ¼ */
+    loop_event_send_drained,  /* ܵⷢˮλ¼ */
+    loop_event_send_batch,    /* ¼ */
+    loop_event_broadcast,     /* 㲥¼ */
+    loop_event_migrate,       /* ܵǨ¼ */
+} loop_event_e;
+
+typedef struct _loop_event_t {
+    kchannel_ref_t*         channel_ref; /* ¼عܵ */
+    kbuffer_t*              send_buffer; /* ͻָ */
+    kloop_send_batch_t*     batch;       /*  */
+    kbroadcast_partition_t* partition;   /* 㲥 */
+    kshared_buffer_t*       shared;      /* 㲥͵Ĺ */
+    loop_event_e            event;       /* ¼ */
+    uint64_t                post_us;     /* Ͷʱ΢룩, ͳŶӳ */
+} loop_event_t;
+
+struct _loop_send_batch_t {
+    kshared_buffer_t* shared;       /*  */
+    kchannel_ref_t**  channel_refs; /* Ŀܵ */
+    int               count;        /* Ŀܵ */
+    int               max_count;    /* 鳤 */
+};
+
+typedef struct _loop_event_slot_t {
+    atomic_counter_t seq;   /* λ, дλʱд, дλ+1ʱɶ */
+    loop_event_t     event; /* ¼ */
+} loop_event_slot_t;
+
 struct _loop_t {
     kdlist_t*              active_channel_list; /* Ծܵ */
     kdlist_t*              close_channel_list;  /* ѹرչܵ */
-    kdlist_t*              event_list;          /* ¼ */
-    klock_t*               lock;                /* -¼*/
-    kchannel_ref_t*        notify_channel;      /* ¼֪ͨдܵ */
-    kchannel_ref_t*        read_channel;        /* ¼֪ͨܵ */
+    loop_event_slot_t*     event_ring;          /* ¼ζ(/), Ԥλ */
+    atomic_counter_t       event_ring_head;     /* ¼ζдλ() */
+    uint32_t               event_ring_tail;     /* ¼ζжȡλ(, loop߳) */
+    atomic_counter_t       event_overflow;      /* ¼ */
+    kdlist_t*              event_list;          /* ¼, ζʱʹ */
+    kdlist_t*              event_list_swap;     /* ʱ, ûص */
+    klock_t*               lock;                /* -¼*/
+    atomic_counter_t       notify_pending;      /* Ѿѵδı־ */
+    kdlist_t**             timeout_wheel;       /* ܵʱʱ, ֻҪⳬʱĹܵ */
+    kdlist_t*              timeout_list_swap;   /* ̶ȵڵĲλڹܵ */
+    time_t                 timeout_tick;        /* ʱѾĿ̶ */
+    int                    timeout_count;       /* ʱڹܵ */
+    time_t                 timeout_next_tick;   /* ʱǿղλ̶ȵ, ֮ǰĲλΪ */
+    int                    wait_limit;          /* ͬ߳ѭҪȴʱ䣨룩, -1Ϊ */
+    time_t                 clock_ms;            /* ĵʱӣ룩, ÿѭ */
+    uint64_t               select_us;           /* νѡȡȴʱ΢룩 */
+    uint64_t               wakeup_us;           /* ѡȡλѵʱ΢룩, Ϊ0ʱδ */
+    atomic_counter_t       accept_pending;      /* ͶݻδĽ¼, ؾʱܵ */
+    kdlist_t*              migrate_list;        /* ȴǨĹܵ, ѭʱ */
+    int                    migrate_skew_count;  /* æµǨֵĲ */
+    void*                  channel_free_list;   /* ٹܵĻ, ͷһĵַ */
+    int                    channel_free_count;  /* Ĺܵ */
     kloop_balancer_t*      balancer;            /* ؾ */
     void*                 impl;                /* ¼ѡȡʵ */
     volatile int          running;             /* ¼ѭб־ */
     thread_id_t           thread_id;           /* ¼ѡȡǰ߳ID */
     knet_loop_balance_option_e balance_options;     /* ؾ */
     kloop_profile_t*       profile;             /* ͳ */
+    krpc_arena_t*          rpc_arena;           /* RPCڴ, ״νʱ */
     void*                 data;                /* ûָ */
 };
 
-typedef enum _loop_event_e {
-    loop_event_accept = 1,    /* ¼ */
-    loop_event_connect,       /* ¼ */
-    loop_event_send,          /* ¼ */
-    loop_event_close,         /* ر¼ */
-    loop_event_accept_async,  /* 첽 */
-} loop_event_e;
+/**
+ * д¼ζ
+ * @retval error_ok ɹ
+ * @retval error_fail 
+ */
+int _loop_event_ring_push(kloop_t* loop, loop_event_t* loop_event);
 
-typedef struct _loop_event_t {
-    kchannel_ref_t* channel_ref; /* ¼عܵ */
-    kbuffer_t*      send_buffer; /* ͻָ */
-    loop_event_e   event;       /* ¼ */
-} loop_event_t;
+/**
+ * ¼ζȡһ¼
+ * @retval error_ok ɹ
+ * @retval error_fail Ϊ
+ */
+int _loop_event_ring_pop(kloop_t* loop, loop_event_t* loop_event);
+
+/**
+ * loop߳ڴ¼
+ */
+void _loop_event_dispatch(kloop_t* loop, loop_event_t* loop_event);
+
+/**
+ * δ¼, ͷ¼еԴ
+ */
+void _loop_event_discard(kloop_t* loop, loop_event_t* loop_event);
+
+/**
+ * Ͷ¼
+ */
+void _loop_add_event(kloop_t* loop, loop_event_t* loop_event);
+
+/**
+ * ⵽ڹܵӳʱгʱ
+ */
+void _loop_check_channel_timeout(kloop_t* loop, kchannel_ref_t* channel_ref, time_t ts);
+
+/**
+ * ǨȴǨƵĹܵ, discardʱǨ
+ */
+void _loop_migrate_out(kloop_t* loop, int discard);
+
+/**
+ * æµkloop_tʱ, ǨæĹܵ
+ */
+void _loop_balance_migrate(kloop_t* loop);
+
+/**
+ * ʱһǿղλĿ̶
+ * @retval 0 ʱΪ
+ * @retval  ̶
+ */
+time_t _loop_timeout_next_tick(kloop_t* loop);
 
-loop_event_t* loop_event_create(kchannel_ref_t* channel_ref, kbuffer_t* send_buffer, loop_event_e e) {
+loop_event_t* loop_event_create(loop_event_t* loop_event) {
     loop_event_t* ev = 0;
-    verify(channel_ref); /* send_bufferΪ0 */
+    verify(loop_event);
     ev = create(loop_event_t);
     verify(ev);
-    ev->channel_ref = channel_ref;
-    ev->send_buffer = send_buffer;
-    ev->event = e;
+    *ev = *loop_event;
     return ev;
 }
 
@@ -96,8 +188,8 @@ loop_event_e loop_event_get_event(loop_event_t* loop_event) {
 }
 
 kloop_t* knet_loop_create() {
-    socket_t pair[2] = {0}; /* ¼д */
-    kloop_t*  loop    = create(kloop_t);
+    uint32_t i    = 0;
+    kloop_t* loop = create(kloop_t);
     verify(loop);
     memset(loop, 0, sizeof(kloop_t));
     /* ѡȡʵ */
@@ -106,30 +198,27 @@ kloop_t* knet_loop_create() {
         log_fatal("knet_loop_create() failed, reason: knet_impl_create()");
         return 0;
     }
-    /* д */
-    if (socket_pair(pair)) {
-        destroy(loop);
-        log_fatal("knet_loop_create() failed, reason: socket_pair()");
-        return 0;
-    }
     loop->profile = knet_loop_profile_create(loop);
     loop->active_channel_list = dlist_create();
     loop->close_channel_list = dlist_create();
     loop->event_list = dlist_create();
+    loop->event_list_swap = dlist_create();
+    loop->event_ring = create_type(loop_event_slot_t, sizeof(loop_event_slot_t) * LOOP_EVENT_RING_SIZE);
+    verify(loop->event_ring);
+    for (i = 0; i < LOOP_EVENT_RING_SIZE; i++) {
+        loop->event_ring[i].seq = (atomic_counter_t)i;
+    }
+    loop->timeout_wheel = create_type(kdlist_t*, sizeof(kdlist_t*) * LOOP_TIMEOUT_WHEEL_SLOT);
+    verify(loop->timeout_wheel);
+    for (i = 0; i < LOOP_TIMEOUT_WHEEL_SLOT; i++) {
+        loop->timeout_wheel[i] = dlist_create();
+    }
+    loop->timeout_list_swap = dlist_create();
+    loop->migrate_list = dlist_create();
+    loop->timeout_tick = knet_loop_update_clock_ms(loop) / LOOP_TIMEOUT_WHEEL_TICK;
+    loop->wait_limit = -1;
     loop->lock = lock_create();
     loop->balance_options = loop_balancer_in | loop_balancer_out;
-    loop->notify_channel = knet_loop_create_channel_exist_socket_fd(loop, pair[0], 0, 0);
-    verify(loop->notify_channel);
-    loop->read_channel = knet_loop_create_channel_exist_socket_fd(loop, pair[1], 0, 1024 * 64);
-    verify(loop->read_channel);
-    knet_loop_add_channel_ref(loop, loop->notify_channel);
-    knet_loop_add_channel_ref(loop, loop->read_channel);
-    knet_channel_ref_set_state(loop->notify_channel, channel_state_active);
-    knet_channel_ref_set_state(loop->read_channel, channel_state_active);
-    /* ע¼ */
-    knet_channel_ref_set_event(loop->read_channel, channel_event_recv);
-    /* ö¼ص */
-    knet_channel_ref_set_cb(loop->read_channel, knet_loop_queue_cb);
     return loop;
 }
 
@@ -137,8 +226,23 @@ void knet_loop_destroy(kloop_t* loop) {
     kdlist_node_t*  node        = 0;
     kdlist_node_t*  temp        = 0;
     kchannel_ref_t* channel_ref = 0;
-    loop_event_t*  event       = 0;
+    loop_event_t*   event       = 0;
+    void*           object      = 0;
+    int             i           = 0;
+    loop_event_t    ring_event;
     verify(loop);
+    /* δ¼, ͷ¼еĹܵ */
+    while (error_ok == _loop_event_ring_pop(loop, &ring_event)) {
+        _loop_event_discard(loop, &ring_event);
+    }
+    dlist_for_each_safe(loop->event_list, node, temp) {
+        event = (loop_event_t*)dlist_node_get_data(node);
+        _loop_event_discard(loop, event);
+        loop_event_destroy(event);
+        dlist_delete(loop->event_list, node);
+    }
+    /* δǨ, ܵkloop_tر */
+    _loop_migrate_out(loop, 1);
     /* رչܵ */
     dlist_for_each_safe(loop->active_channel_list, node, temp) {
         channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
@@ -153,122 +257,422 @@ void knet_loop_destroy(kloop_t* loop) {
     knet_impl_destroy(loop);
     dlist_destroy(loop->close_channel_list);
     dlist_destroy(loop->active_channel_list);
-    /* δ¼ */
-    dlist_for_each_safe(loop->event_list, node, temp) {
-        event = (loop_event_t*)dlist_node_get_data(node);
-        destroy(event);
+    /* ܵرʱѾʱȡ */
+    for (i = 0; i < LOOP_TIMEOUT_WHEEL_SLOT; i++) {
+        dlist_destroy(loop->timeout_wheel[i]);
+    }
+    destroy(loop->timeout_wheel);
+    dlist_destroy(loop->timeout_list_swap);
+    dlist_destroy(loop->migrate_list);
+    /* ٻĹܵ */
+    while (loop->channel_free_list) {
+        object = loop->channel_free_list;
+        loop->channel_free_list = *(void**)object;
+        knet_free_aligned(object);
+    }
+    if (loop->rpc_arena) {
+        krpc_arena_destroy(loop->rpc_arena);
     }
     knet_loop_profile_destroy(loop->profile);
     dlist_destroy(loop->event_list);
+    dlist_destroy(loop->event_list_swap);
+    destroy(loop->event_ring);
     lock_destroy(loop->lock);
     destroy(loop);
 }
 
-void loop_add_event(kloop_t* loop, loop_event_t* loop_event) {
+int _loop_event_ring_push(kloop_t* loop, loop_event_t* loop_event) {
+    uint32_t           pos  = 0;
+    uint32_t           seq  = 0;
+    loop_event_slot_t* slot = 0;
+    pos = (uint32_t)loop->event_ring_head;
+    for (;;) {
+        slot = loop->event_ring + (pos & (LOOP_EVENT_RING_SIZE - 1));
+        seq  = (uint32_t)slot->seq;
+        if (seq == pos) {
+            /* λд, дλ */
+            seq = (uint32_t)atomic_counter_cas(&loop->event_ring_head,
+                (atomic_counter_t)pos, (atomic_counter_t)(pos + 1));
+            if (seq == pos) {
+                break;
+            }
+            pos = seq;
+        } else if ((int32_t)(seq - pos) < 0) {
+            /* ߻ûдλ,  */
+            return error_fail;
+        } else {
+            /* Ѿռ, ¶ȡдλ */
+            pos = (uint32_t)loop->event_ring_head;
+        }
+    }
+    slot->event = *loop_event;
+    /* ¼, CASͬʱΪڴ */
+    atomic_counter_cas(&slot->seq, (atomic_counter_t)pos, (atomic_counter_t)(pos + 1));
+    return error_ok;
+}
+
+int _loop_event_ring_pop(kloop_t* loop, loop_event_t* loop_event) {
+    uint32_t           pos  = loop->event_ring_tail;
+    loop_event_slot_t* slot = loop->event_ring + (pos & (LOOP_EVENT_RING_SIZE - 1));
+    /* ȡλ, CASͬʱΪڴ */
+    if ((uint32_t)atomic_counter_cas(&slot->seq, (atomic_counter_t)(pos + 1),
+        (atomic_counter_t)(pos + 1)) != pos + 1) {
+        /* Ϊջ߻δ */
+        return error_fail;
+    }
+    *loop_event = slot->event;
+    /* ͷŲλһ */
+    atomic_counter_cas(&slot->seq, (atomic_counter_t)(pos + 1),
+        (atomic_counter_t)(pos + LOOP_EVENT_RING_SIZE));
+    loop->event_ring_tail = pos + 1;
+    return error_ok;
+}
+
+void loop_add_event(kloop_t* loop, kchannel_ref_t* channel_ref, kbuffer_t* send_buffer, loop_event_e e) {
+    loop_event_t loop_event;
+    verify(channel_ref); /* send_bufferΪ0 */
+    memset(&loop_event, 0, sizeof(loop_event_t));
+    loop_event.channel_ref = channel_ref;
+    loop_event.send_buffer = send_buffer;
+    loop_event.event       = e;
+    _loop_add_event(loop, &loop_event);
+}
+
+void _loop_add_event(kloop_t* loop, loop_event_t* loop_event) {
     verify(loop);
-    verify(loop_event);
-    lock_lock(loop->lock);
-    log_info("invoke loop_add_event(), event[type:%d]", loop_event->event);
-    /* ¼ӵβ */
-    dlist_add_tail_node(loop->event_list, loop_event);
-    lock_unlock(loop->lock);
+    /* δӳͳʱȡʱ */
+    loop_event->post_us = knet_loop_profile_check_latency(loop->profile) ? time_get_microseconds() : 0;
+    /* ΪʱҲд, ֤ͬһ߳Ͷݵ¼˳ */
+    if (!atomic_counter_zero(&loop->event_overflow) ||
+        (error_ok != _loop_event_ring_push(loop, loop_event))) {
+        lock_lock(loop->lock);
+        /* ¼ӵβ */
+        dlist_add_tail_node(loop->event_list, loop_event_create(loop_event));
+        atomic_counter_inc(&loop->event_overflow);
+        lock_unlock(loop->lock);
+    }
     knet_loop_notify(loop);
 }
 
 void knet_loop_notify_accept(kloop_t* loop, kchannel_ref_t* channel_ref) {
     verify(loop);
     verify(channel_ref);
-    loop_add_event(loop, loop_event_create(channel_ref, 0, loop_event_accept));
+    /* ¼ǰܵ, ܵĹܵѡȡͬһkloop_t */
+    atomic_counter_inc(&loop->accept_pending);
+    loop_add_event(loop, channel_ref, 0, loop_event_accept);
 }
 
 void knet_loop_notify_accept_async(kloop_t* loop, kchannel_ref_t* channel_ref) {
     verify(loop);
     verify(channel_ref);
-    loop_add_event(loop, loop_event_create(channel_ref, 0, loop_event_accept_async));
+    loop_add_event(loop, channel_ref, 0, loop_event_accept_async);
 }
 
 void knet_loop_notify_connect(kloop_t* loop, kchannel_ref_t* channel_ref) {
     verify(loop);
     verify(channel_ref);
-    loop_add_event(loop, loop_event_create(channel_ref, 0, loop_event_connect));
+    loop_add_event(loop, channel_ref, 0, loop_event_connect);
 }
 
 void knet_loop_notify_send(kloop_t* loop, kchannel_ref_t* channel_ref, kbuffer_t* send_buffer) {
     verify(loop);
     verify(channel_ref);
     verify(send_buffer);
-    loop_add_event(loop, loop_event_create(channel_ref, send_buffer, loop_event_send));
+    loop_add_event(loop, channel_ref, send_buffer, loop_event_send);
 }
 
-void knet_loop_notify_close(kloop_t* loop, kchannel_ref_t* channel_ref) {
+void knet_loop_notify_timeout(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    /* ¼ǰܵᱻ */
+    knet_channel_ref_incref(channel_ref);
+    loop_add_event(loop, channel_ref, 0, loop_event_timeout);
+}
+
+void knet_loop_notify_send_drained(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    /* ¼ǰܵᱻ */
+    knet_channel_ref_incref(channel_ref);
+    loop_add_event(loop, channel_ref, 0, loop_event_send_drained);
+}
+
+void knet_loop_notify_send_batch(kloop_t* loop, kloop_send_batch_t* batch) {
+    loop_event_t loop_event;
     verify(loop);
+    verify(batch);
+    memset(&loop_event, 0, sizeof(loop_event_t));
+    loop_event.batch = batch;
+    loop_event.event = loop_event_send_batch;
+    _loop_add_event(loop, &loop_event);
+}
+
+void knet_loop_notify_broadcast(kloop_t* loop, kbroadcast_partition_t* partition, kshared_buffer_t* shared) {
+    loop_event_t loop_event;
+    verify(loop);
+    verify(partition); /* sharedΪ0 */
+    memset(&loop_event, 0, sizeof(loop_event_t));
+    loop_event.partition = partition;
+    loop_event.shared    = shared;
+    loop_event.event     = loop_event_broadcast;
+    _loop_add_event(loop, &loop_event);
+}
+
+kloop_send_batch_t* knet_loop_send_batch_create(kshared_buffer_t* shared) {
+    kloop_send_batch_t* batch = 0;
+    verify(shared);
+    batch = create(kloop_send_batch_t);
+    verify(batch);
+    if (!batch) {
+        return 0;
+    }
+    memset(batch, 0, sizeof(kloop_send_batch_t));
+    knet_shared_buffer_incref(shared);
+    batch->shared = shared;
+    return batch;
+}
+
+void knet_loop_send_batch_destroy(kloop_send_batch_t* batch) {
+    int i = 0;
+    verify(batch);
+    for (; i < batch->count; i++) {
+        knet_channel_ref_post_release(batch->channel_refs[i]);
+        knet_channel_ref_decref(batch->channel_refs[i]);
+    }
+    if (batch->channel_refs) {
+        destroy(batch->channel_refs);
+    }
+    knet_shared_buffer_decref(batch->shared);
+    destroy(batch);
+}
+
+int knet_loop_send_batch_add(kloop_send_batch_t* batch, kchannel_ref_t* channel_ref) {
+    kchannel_ref_t** channel_refs = 0;
+    int              max_count    = 0;
+    verify(batch);
     verify(channel_ref);
-    loop_add_event(loop, loop_event_create(channel_ref, 0, loop_event_close));
-}
-
-void knet_loop_queue_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
-    verify(channel);
-    if (e & channel_cb_event_recv) {
-        /* ж */
-        knet_stream_eat_all(knet_channel_ref_get_stream(channel));
-        knet_loop_event_process(knet_channel_ref_get_loop(channel));
-    } else if (e & channel_cb_event_close) {
-        if (knet_loop_check_running(knet_channel_ref_get_loop(channel))) {
-            /* ӶϿ,  */
-            verify(0);
+    if (batch->count == batch->max_count) {
+        /* չ */
+        max_count = batch->max_count ? batch->max_count * 2 : 16;
+        if (batch->channel_refs) {
+            channel_refs = (kchannel_ref_t**)rcreate_raw(batch->channel_refs, sizeof(kchannel_ref_t*) * max_count);
+        } else {
+            channel_refs = (kchannel_ref_t**)create_raw(sizeof(kchannel_ref_t*) * max_count);
+        }
+        if (!channel_refs) {
+            return error_no_memory;
         }
+        batch->channel_refs = channel_refs;
+        batch->max_count    = max_count;
     }
+    /* ¼ǰܵᱻ */
+    knet_channel_ref_incref(channel_ref);
+    batch->channel_refs[batch->count++] = channel_ref;
+    return error_ok;
+}
+
+void knet_loop_notify_migrate(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    loop_add_event(loop, channel_ref, 0, loop_event_migrate);
+}
+
+void knet_loop_notify_close(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    loop_add_event(loop, channel_ref, 0, loop_event_close);
 }
 
 void knet_loop_notify(kloop_t* loop) {
-    char c = 1;
     verify(loop);
-    /* һֽڴص  */
-    socket_send(knet_channel_ref_get_socket_fd(loop->notify_channel), &c, sizeof(c));
+    /* ѾδʱҪٴλ */
+    if (0 == atomic_counter_cas(&loop->notify_pending, 0, 1)) {
+        knet_impl_notify(loop);
+    }
+}
+
+void knet_loop_notify_process(kloop_t* loop) {
+    verify(loop);
+    /* ־, ֮Ͷݵ¼ٴλ */
+    atomic_counter_set(&loop->notify_pending, 0);
+    knet_loop_event_process(loop);
+}
+
+void _loop_event_dispatch(kloop_t* loop, loop_event_t* loop_event) {
+    kloop_t* forward = 0;
+    if ((loop_event->event == loop_event_send) || (loop_event->event == loop_event_close) ||
+        (loop_event->event == loop_event_timeout) || (loop_event->event == loop_event_send_drained)) {
+        forward = knet_channel_ref_get_forward_loop(loop_event->channel_ref, loop);
+        if (forward) {
+            /* ܵѾǨ, ת¼, ¼еԴ¼ת */
+            _loop_add_event(forward, loop_event);
+            return;
+        }
+    }
+    switch(loop_event->event) {
+        case loop_event_accept: /*  */
+            atomic_counter_dec(&loop->accept_pending);
+            knet_channel_ref_update_accept_in_loop(loop, loop_event->channel_ref);
+            break;
+        case loop_event_accept_async: /* ǰloopaccept() */
+            knet_channel_ref_accept_async(loop_event->channel_ref);
+            break;
+        case loop_event_connect: /* ǰloopconnect */
+            knet_channel_ref_connect_in_loop(loop_event->channel_ref);
+            break;
+        case loop_event_send: /* ǰloopsend */
+            knet_channel_ref_update_send_in_loop(loop, loop_event->channel_ref, loop_event->send_buffer);
+            knet_channel_ref_post_release(loop_event->channel_ref);
+            break;
+        case loop_event_close: /* ǰloopclose */
+            knet_channel_ref_update_close_in_loop(loop, loop_event->channel_ref);
+            knet_channel_ref_post_release(loop_event->channel_ref);
+            break;
+        case loop_event_timeout: /* ǰloopڼʱ */
+            knet_channel_ref_update_timeout_in_loop(loop, loop_event->channel_ref);
+            break;
+        case loop_event_send_drained: /* ǰloopڼⷢˮλ */
+            knet_channel_ref_update_send_drained_in_loop(loop, loop_event->channel_ref);
+            break;
+        case loop_event_send_batch: /* ǰloopsend */
+            knet_channel_ref_update_send_batch_in_loop(loop, loop_event->batch->channel_refs,
+                loop_event->batch->count, loop_event->batch->shared);
+            knet_loop_send_batch_destroy(loop_event->batch);
+            break;
+        case loop_event_broadcast: /* ǰloopڹ㲥send */
+            knet_broadcast_update_partition_in_loop(loop, loop_event->partition, loop_event->shared);
+            break;
+        case loop_event_migrate: /* ܵǨ뵱ǰloop */
+            knet_channel_ref_update_migrate_in_loop(loop, loop_event->channel_ref);
+            break;
+        default:
+            break;
+    }
+}
+
+void _loop_event_discard(kloop_t* loop, loop_event_t* loop_event) {
+    if ((loop_event->event == loop_event_timeout) || (loop_event->event == loop_event_send_drained)) {
+        knet_channel_ref_decref(loop_event->channel_ref);
+    }
+    if ((loop_event->event == loop_event_send) || (loop_event->event == loop_event_close)) {
+        knet_channel_ref_post_release(loop_event->channel_ref);
+    }
+    if (loop_event->event == loop_event_migrate) {
+        /* Ѿ뿪ԭkloop_t, Ǩ浱ǰkloop_tĹܵһر */
+        knet_channel_ref_update_migrate_in_loop(loop, loop_event->channel_ref);
+    }
+    if ((loop_event->event == loop_event_accept) || (loop_event->event == loop_event_accept_async) ||
+        (loop_event->event == loop_event_connect)) {
+        /* ܵδ뵱ǰloop, ᱻĹر̴ */
+        knet_channel_ref_destroy(loop_event->channel_ref);
+    }
+    if (loop_event->send_buffer) {
+        knet_buffer_destroy(loop_event->send_buffer);
+    }
+    if (loop_event->batch) {
+        knet_loop_send_batch_destroy(loop_event->batch);
+    }
+    if (loop_event->partition) {
+        knet_broadcast_partition_event_discard(loop_event->partition, loop_event->shared);
+    }
 }
 
 void knet_loop_event_process(kloop_t* loop) {
     kdlist_node_t* node       = 0;
     kdlist_node_t* temp       = 0;
-    loop_event_t* loop_event = 0;
+    kdlist_t*      list       = 0;
+    loop_event_t*  loop_event = 0;
+    int            depth      = 0;
+    uint64_t       ts         = 0;
+    loop_event_t   ring_event;
     verify(loop);
+    if (knet_loop_profile_check_latency(loop->profile)) {
+        ts = time_get_microseconds();
+    }
+    /* ζ¼, صκڵ */
+    while (error_ok == _loop_event_ring_pop(loop, &ring_event)) {
+        depth++;
+        /* ͶʱδӳͳƵ¼¼ */
+        if ((ts > ring_event.post_us) && ring_event.post_us) {
+            knet_loop_profile_add_queue_wait(loop->profile, ts - ring_event.post_us);
+        }
+        _loop_event_dispatch(loop, &ring_event);
+    }
+    if (atomic_counter_zero(&loop->event_overflow) ||
+        ((uint32_t)loop->event_ring_head != loop->event_ring_tail)) {
+        /* дλ֮ǰռõδĲλʱ, ڵ¼ͬһ߸Ͷݵ,
+           ȴòλٴλʱ, ֤ͬһߵ¼˳ */
+        knet_loop_profile_add_queue(loop->profile, depth);
+        return;
+    }
+    /* ȡ, ֻ */
     lock_lock(loop->lock);
-    /* ÿζ¼صڴ¼ */
-    dlist_for_each_safe(loop->event_list, node, temp) {
+    list                  = loop->event_list;
+    loop->event_list      = loop->event_list_swap;
+    loop->event_list_swap = list;
+    atomic_counter_set(&loop->event_overflow, 0);
+    lock_unlock(loop->lock);
+    dlist_for_each_safe(list, node, temp) {
         loop_event = (loop_event_t*)dlist_node_get_data(node);
-        switch(loop_event->event) {
-            case loop_event_accept: /*  */
-                knet_channel_ref_update_accept_in_loop(loop, loop_event->channel_ref);
-                break;
-            case loop_event_accept_async: /* ǰloopaccept() */
-                knet_channel_ref_accept_async(loop_event->channel_ref);
-                break;
-            case loop_event_connect: /* ǰloopconnect */
-                knet_channel_ref_connect_in_loop(loop_event->channel_ref);
-                break;
-            case loop_event_send: /* ǰloopsend */
-                knet_channel_ref_update_send_in_loop(loop, loop_event->channel_ref, loop_event->send_buffer);
-                break;
-            case loop_event_close: /* ǰloopclose */
-                knet_channel_ref_update_close_in_loop(loop, loop_event->channel_ref);
-                break;
-            default:
-                break;
+        depth++;
+        if ((ts > loop_event->post_us) && loop_event->post_us) {
+            knet_loop_profile_add_queue_wait(loop->profile, ts - loop_event->post_us);
         }
+        _loop_event_dispatch(loop, loop_event);
         loop_event_destroy(loop_event);
-        dlist_delete(loop->event_list, node);
+        dlist_delete(list, node);
     }
-    lock_unlock(loop->lock);
+    knet_loop_profile_add_queue(loop->profile, depth);
 }
 
 kchannel_ref_t* knet_loop_create_channel_exist_socket_fd(kloop_t* loop, socket_t socket_fd, uint32_t max_send_list_len, uint32_t recv_ring_len) {
     verify(loop);
-    return knet_channel_ref_create(loop, knet_channel_create_exist_socket_fd(socket_fd, max_send_list_len, recv_ring_len));
+    /* Ϊ */
+    socket_set_non_blocking_on(socket_fd);
+    return knet_channel_ref_create(loop, socket_fd, max_send_list_len, recv_ring_len, 0);
 }
 
 kchannel_ref_t* knet_loop_create_channel(kloop_t* loop, uint32_t max_send_list_len, uint32_t recv_ring_len) {
+    return knet_loop_create_channel_with_flag(loop, max_send_list_len, recv_ring_len, 0);
+}
+
+kchannel_ref_t* knet_loop_create_channel_with_flag(kloop_t* loop, uint32_t max_send_list_len, uint32_t recv_ring_len, int flag) {
+    socket_t socket_fd = 0;
+    verify(loop);
+    socket_fd = socket_create();
+    verify(socket_fd > 0);
+    if (socket_fd <= 0) {
+        return 0;
+    }
+    /* Ϊ */
+    socket_set_non_blocking_on(socket_fd);
+    return knet_channel_ref_create(loop, socket_fd, max_send_list_len, recv_ring_len, flag);
+}
+
+void* knet_loop_alloc_channel_object(kloop_t* loop, uint32_t size) {
+    void* object = 0;
+    verify(loop);
+    /* ֻloop߳ʹ, Ҫ */
+    if (loop->channel_free_list && (knet_loop_get_thread_id(loop) == thread_get_self_id())) {
+        object = loop->channel_free_list;
+        loop->channel_free_list = *(void**)object;
+        loop->channel_free_count--;
+        return object;
+    }
+    return knet_malloc_aligned(size, CACHE_LINE_SIZE);
+}
+
+void knet_loop_free_channel_object(kloop_t* loop, void* object) {
     verify(loop);
-    return knet_channel_ref_create(loop, knet_channel_create(max_send_list_len, recv_ring_len));
+    verify(object);
+    if ((loop->channel_free_count < LOOP_CHANNEL_FREE_LIST_MAX) &&
+        (knet_loop_get_thread_id(loop) == thread_get_self_id())) {
+        *(void**)object = loop->channel_free_list;
+        loop->channel_free_list = object;
+        loop->channel_free_count++;
+        return;
+    }
+    knet_free_aligned(object);
 }
 
 thread_id_t knet_loop_get_thread_id(kloop_t* loop) {
@@ -277,9 +681,26 @@ thread_id_t knet_loop_get_thread_id(kloop_t* loop) {
 }
 
 int knet_loop_run_once(kloop_t* loop) {
+    int      error = error_ok;
+    uint64_t ts    = 0;
     verify(loop);
     loop->thread_id = thread_get_self_id();
-    return knet_impl_run_once(loop);
+    loop->select_us = time_get_microseconds();
+    error = knet_impl_run_once(loop);
+    ts = time_get_microseconds();
+    /* Ѻ¼ĺʱæµʱ */
+    if (loop->wakeup_us && (ts > loop->wakeup_us)) {
+        knet_loop_profile_add_busy_time(loop->profile, ts - loop->wakeup_us);
+    }
+    loop->wakeup_us = 0;
+    if (knet_loop_profile_sample_load(loop->profile, ts) && loop->balancer) {
+        _loop_balance_migrate(loop);
+    }
+    /* ѭڵ¼Ѿ, ԰ȫ뿪ѡȡ */
+    if (!dlist_empty(loop->migrate_list)) {
+        _loop_migrate_out(loop, 0);
+    }
+    return error;
 }
 
 int knet_loop_run(kloop_t* loop) {
@@ -292,12 +713,16 @@ int knet_loop_run(kloop_t* loop) {
             loop->running = 0;
         }
     }
+    /* ͳ, ˳߳ԿԶȡ */
+    knet_loop_profile_publish(loop->profile);
     return error;
 }
 
 void knet_loop_exit(kloop_t* loop) {
     verify(loop);
     loop->running = 0;
+    /* ̵߳, ѡȡ */
+    knet_loop_notify(loop);
 }
 
 kdlist_t* knet_loop_get_active_list(kloop_t* loop) {
@@ -305,29 +730,31 @@ kdlist_t* knet_loop_get_active_list(kloop_t* loop) {
     return loop->active_channel_list;
 }
 
+krpc_arena_t* knet_loop_get_rpc_arena(kloop_t* loop) {
+    verify(loop);
+    if (!loop->rpc_arena) {
+        loop->rpc_arena = krpc_arena_create();
+    }
+    return loop->rpc_arena;
+}
+
 kdlist_t* knet_loop_get_close_list(kloop_t* loop) {
     verify(loop);
     return loop->close_channel_list;
 }
 
 void knet_loop_add_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
-    kdlist_node_t* node = 0;
     verify(channel_ref);
     verify(loop);
-    node = knet_channel_ref_get_loop_node(channel_ref);
-    if (node) {
-        /* ѾҪڵ */
-        dlist_add_front(loop->active_channel_list, node);
-    } else {
-        /* ڵ */
-        dlist_add_front_node(loop->active_channel_list, channel_ref);
-    }
+    /* ڵǶڹܵ */
+    dlist_add_front(loop->active_channel_list, knet_channel_ref_get_loop_node(channel_ref));
     knet_loop_profile_decrease_active_channel_count(loop->profile);
     knet_loop_profile_increase_established_channel_count(loop->profile);
-    /* ýڵ */
-    knet_channel_ref_set_loop_node(channel_ref, dlist_get_front(loop->active_channel_list));
+    knet_channel_ref_attach_recv_buffer(channel_ref);
     /* ֪ͨѡȡӹܵ */
     knet_impl_add_channel_ref(loop, channel_ref);
+    /* һ̶ȼ, ֮󰴹ܵ״̬ */
+    knet_loop_add_timeout(loop, channel_ref, 0);
 }
 
 void knet_loop_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
@@ -335,10 +762,91 @@ void knet_loop_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
     verify(channel_ref);
     /* 뵱ǰٽڵ */
     dlist_remove(loop->active_channel_list, knet_channel_ref_get_loop_node(channel_ref));
+    knet_loop_remove_timeout(loop, channel_ref);
+    knet_channel_ref_detach_recv_buffer(channel_ref);
     knet_loop_profile_decrease_established_channel_count(loop->profile);
     knet_loop_profile_increase_close_channel_count(loop->profile);
 }
 
+void knet_loop_migrate_out_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    knet_impl_migrate_channel_ref(loop, channel_ref);
+    dlist_remove(loop->active_channel_list, knet_channel_ref_get_loop_node(channel_ref));
+    knet_loop_remove_timeout(loop, channel_ref);
+    knet_channel_ref_detach_recv_buffer(channel_ref);
+    knet_loop_profile_decrease_established_channel_count(loop->profile);
+}
+
+void knet_loop_migrate_in_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    dlist_add_front(loop->active_channel_list, knet_channel_ref_get_loop_node(channel_ref));
+    knet_loop_profile_increase_established_channel_count(loop->profile);
+    knet_channel_ref_attach_recv_buffer(channel_ref);
+    knet_impl_add_channel_ref(loop, channel_ref);
+    knet_loop_add_timeout(loop, channel_ref, 0);
+}
+
+void knet_loop_add_migrate(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    dlist_add_tail_node(loop->migrate_list, channel_ref);
+}
+
+void _loop_migrate_out(kloop_t* loop, int discard) {
+    kdlist_node_t*  node        = 0;
+    kdlist_node_t*  temp        = 0;
+    kchannel_ref_t* channel_ref = 0;
+    dlist_for_each_safe(loop->migrate_list, node, temp) {
+        channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
+        dlist_delete(loop->migrate_list, node);
+        if (discard) {
+            knet_channel_ref_decref(channel_ref);
+        } else {
+            knet_channel_ref_update_migrate_out(loop, channel_ref);
+        }
+    }
+}
+
+void _loop_balance_migrate(kloop_t* loop) {
+    kdlist_node_t*  node        = 0;
+    kdlist_node_t*  temp        = 0;
+    kchannel_ref_t* channel_ref = 0;
+    kchannel_ref_t* hottest     = 0;
+    kloop_t*        target      = 0;
+    uint32_t        bytes       = 0;
+    uint32_t        max_bytes   = 0;
+    int             count       = 0;
+    target = knet_loop_balancer_choose_migrate(loop->balancer, loop);
+    if (!target) {
+        loop->migrate_skew_count = 0;
+        return;
+    }
+    /* һγֵʱܵշֽ, ڶΰβ֮շֽѡȡ */
+    loop->migrate_skew_count++;
+    dlist_for_each_safe(loop->active_channel_list, node, temp) {
+        channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
+        bytes = knet_channel_ref_swap_load_bytes(channel_ref);
+        if (!knet_channel_ref_check_state(channel_ref, channel_state_active)) {
+            continue;
+        }
+        count++;
+        if (bytes > max_bytes) {
+            hottest   = channel_ref;
+            max_bytes = bytes;
+        }
+    }
+    if (loop->migrate_skew_count < 2) {
+        return;
+    }
+    loop->migrate_skew_count = 0;
+    if (hottest && (count > 1)) {
+        /* ֻһܵʱǨֻתȵ */
+        knet_channel_ref_migrate(hottest, target);
+    }
+}
+
 void knet_loop_set_impl(kloop_t* loop, void* impl) {
     verify(loop);
     verify(impl);
@@ -370,35 +878,171 @@ kloop_balancer_t* knet_loop_get_balancer(kloop_t* loop) {
     return loop->balancer;
 }
 
+void knet_loop_add_timeout(kloop_t* loop, kchannel_ref_t* channel_ref, time_t deadline) {
+    kdlist_t*      slot = 0;
+    time_t         tick = 0;
+    verify(loop);
+    verify(channel_ref);
+    knet_loop_remove_timeout(loop, channel_ref);
+    /* ȡ, ǰ */
+    tick = (deadline + LOOP_TIMEOUT_WHEEL_TICK - 1) / LOOP_TIMEOUT_WHEEL_TICK;
+    if (tick <= loop->timeout_tick) {
+        /* Ѿ, һ̶ȴ */
+        tick = loop->timeout_tick + 1;
+    }
+    slot = loop->timeout_wheel[tick % LOOP_TIMEOUT_WHEEL_SLOT];
+    dlist_add_tail(slot, knet_channel_ref_get_timeout_node(channel_ref));
+    knet_channel_ref_set_timeout_list(channel_ref, slot);
+    loop->timeout_count++;
+    /* һȦĿ̶ڱȦͬһλ */
+    if (tick > loop->timeout_tick + LOOP_TIMEOUT_WHEEL_SLOT) {
+        tick = loop->timeout_tick + 1 + (tick - loop->timeout_tick - 1) % LOOP_TIMEOUT_WHEEL_SLOT;
+    }
+    if (tick < loop->timeout_next_tick) {
+        loop->timeout_next_tick = tick;
+    }
+}
+
+void knet_loop_remove_timeout(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    kdlist_t* list = 0;
+    verify(loop);
+    verify(channel_ref);
+    list = knet_channel_ref_get_timeout_list(channel_ref);
+    if (list) {
+        /* λٽڵ */
+        dlist_remove(list, knet_channel_ref_get_timeout_node(channel_ref));
+        knet_channel_ref_set_timeout_list(channel_ref, 0);
+        loop->timeout_count--;
+    }
+}
+
+time_t _loop_timeout_next_tick(kloop_t* loop) {
+    time_t tick = 0;
+    verify(loop);
+    if (!loop->timeout_count) {
+        return 0;
+    }
+    /* ӻ޿ʼ, Ŀղλٴβ, ̯ÿ̶һ */
+    tick = loop->timeout_next_tick;
+    if (tick <= loop->timeout_tick) {
+        tick = loop->timeout_tick + 1;
+    }
+    for (; tick <= loop->timeout_tick + LOOP_TIMEOUT_WHEEL_SLOT; tick++) {
+        if (!dlist_empty(loop->timeout_wheel[tick % LOOP_TIMEOUT_WHEEL_SLOT])) {
+            loop->timeout_next_tick = tick;
+            return tick;
+        }
+    }
+    loop->timeout_next_tick = tick;
+    return 0;
+}
+
+int knet_loop_get_wait_timeout(kloop_t* loop) {
+    int    wait = LOOP_WAIT_TIMEOUT_MAX;
+    time_t tick = 0;
+    time_t ms   = 0;
+    verify(loop);
+    /* رڵĹܵ߳ͷһʱ, Ҫѯ */
+    tick = _loop_timeout_next_tick(loop);
+    if (tick) {
+        ms = tick * LOOP_TIMEOUT_WHEEL_TICK - knet_loop_update_clock_ms(loop);
+        if (ms < (time_t)wait) {
+            wait = (ms > 0) ? (int)ms : 0;
+        }
+    }
+    if ((loop->wait_limit >= 0) && (loop->wait_limit < wait)) {
+        wait = loop->wait_limit;
+    }
+    return wait;
+}
+
+void knet_loop_set_wait_limit(kloop_t* loop, int ms) {
+    verify(loop);
+    loop->wait_limit = ms;
+}
+
+void _loop_check_channel_timeout(kloop_t* loop, kchannel_ref_t* channel_ref, time_t ts) {
+    verify(loop);
+    verify(channel_ref);
+    if (knet_channel_ref_check_state(channel_ref, channel_state_connect)) {
+        if (socket_check_send_ready(knet_channel_ref_get_socket_fd(channel_ref))) {
+            knet_impl_event_rearm(channel_ref, channel_event_send);
+        }
+        if (knet_channel_ref_check_connect_timeout(channel_ref, ts)) {
+            /* ӳʱ */            
+            if (knet_channel_ref_get_cb(channel_ref)) {
+                log_error("connect timeout, channel[%llu]", knet_channel_ref_get_uuid(channel_ref));
+                knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_connect_timeout);
+            }
+            /* Զ */
+            if (knet_channel_ref_check_auto_reconnect(channel_ref)) {
+                knet_channel_ref_reconnect(channel_ref, 0);
+            }
+        }
+    }
+    if (knet_channel_ref_check_state(channel_ref, channel_state_close)) {
+        return;
+    }
+    knet_channel_ref_check_recv_shrink(channel_ref, ts);
+    if (knet_channel_ref_check_timeout(channel_ref, ts) && !knet_channel_ref_check_state(channel_ref, channel_state_accept)) {
+        /* ʱ */
+        knet_channel_ref_invoke_cb(channel_ref, channel_cb_event_timeout);
+    }
+}
+
 void knet_loop_check_timeout(kloop_t* loop, time_t ts) {
     kdlist_node_t*  node        = 0;
     kdlist_node_t*  temp        = 0;
     kchannel_ref_t* channel_ref = 0;
+    time_t          tick        = 0;
+    time_t          current     = 0;
+    time_t          deadline    = 0;
     verify(loop);
-    dlist_for_each_safe(knet_loop_get_active_list(loop), node, temp) {
+    current = ts / LOOP_TIMEOUT_WHEEL_TICK;
+    if (current <= loop->timeout_tick) {
+        /* δһ̶ */
+        return;
+    }
+    /* ȡоĲλ, תһȦ */
+    tick = loop->timeout_tick + 1;
+    if (current - loop->timeout_tick > LOOP_TIMEOUT_WHEEL_SLOT) {
+        tick = current - LOOP_TIMEOUT_WHEEL_SLOT + 1;
+    }
+    for (; tick <= current; tick++) {
+        dlist_for_each_safe(loop->timeout_wheel[tick % LOOP_TIMEOUT_WHEEL_SLOT], node, temp) {
+            channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
+            /* ʱ,  */
+            dlist_remove(loop->timeout_wheel[tick % LOOP_TIMEOUT_WHEEL_SLOT], node);
+            dlist_add_tail(loop->timeout_list_swap, node);
+            knet_channel_ref_set_timeout_list(channel_ref, loop->timeout_list_swap);
+        }
+    }
+    loop->timeout_tick = current;
+    if (loop->timeout_next_tick <= current) {
+        loop->timeout_next_tick = current + 1;
+    }
+    /* صڿܹرܵ, ÿֻȡͷ */
+    while (!dlist_empty(loop->timeout_list_swap)) {
+        node = dlist_get_front(loop->timeout_list_swap);
         channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
-        if (knet_channel_ref_check_state(channel_ref, channel_state_connect)) {
-            if (socket_check_send_ready(knet_channel_ref_get_socket_fd(channel_ref))) {
-                knet_impl_event_add(channel_ref, channel_event_send);
-            }
-            if (knet_channel_ref_check_connect_timeout(channel_ref, ts)) {
-                /* ӳʱ */            
-                if (knet_channel_ref_get_cb(channel_ref)) {
-                    log_error("connect timeout, channel[%llu]", knet_channel_ref_get_uuid(channel_ref));
-                    knet_channel_ref_get_cb(channel_ref)(channel_ref, channel_cb_event_connect_timeout);
-                }
-                /* Զ */
-                if (knet_channel_ref_check_auto_reconnect(channel_ref)) {
-                    knet_channel_ref_reconnect(channel_ref, 0);
-                }
-            }
+        knet_loop_remove_timeout(loop, channel_ref);
+        deadline = knet_channel_ref_get_timeout_deadline(channel_ref, ts);
+        if (!deadline) {
+            /* Ҫ, 뿪ʱ */
+            continue;
         }
-        if (knet_channel_ref_check_timeout(channel_ref, ts) && !knet_channel_ref_check_state(channel_ref, channel_state_accept)) {
-            /* ʱ */
-            if (knet_channel_ref_get_cb(channel_ref)) {
-                knet_channel_ref_get_cb(channel_ref)(channel_ref, channel_cb_event_timeout);
+        if (deadline <= ts) {
+            _loop_check_channel_timeout(loop, channel_ref, ts);
+            if (knet_channel_ref_get_timeout_list(channel_ref)) {
+                /* صѾ¼ */
+                continue;
+            }
+            deadline = knet_channel_ref_get_timeout_deadline(channel_ref, ts);
+            if (!deadline) {
+                continue;
             }
         }
+        knet_loop_add_timeout(loop, channel_ref, deadline);
     }
 }
 
@@ -409,9 +1053,9 @@ void knet_loop_check_close(kloop_t* loop) {
     verify(loop);
     dlist_for_each_safe(knet_loop_get_close_list(loop), node, temp) {
         channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
+        /* ʱƳ */
         if (error_ok == knet_channel_ref_destroy(channel_ref)) {
             knet_loop_profile_decrease_close_channel_count(loop->profile);
-            dlist_delete(knet_loop_get_close_list(loop), node);
         }
     }
 }
@@ -460,3 +1104,27 @@ kloop_profile_t* knet_loop_get_profile(kloop_t* loop) {
     verify(loop);
     return loop->profile;
 }
+
+time_t knet_loop_get_clock_ms(kloop_t* loop) {
+    verify(loop);
+    return loop->clock_ms;
+}
+
+time_t knet_loop_update_clock_ms(kloop_t* loop) {
+    verify(loop);
+    loop->clock_ms = (time_t)time_get_monotonic_milliseconds();
+    return loop->clock_ms;
+}
+
+time_t knet_loop_wakeup(kloop_t* loop, int events) {
+    verify(loop);
+    loop->wakeup_us = time_get_microseconds();
+    knet_loop_profile_add_wakeup(loop->profile, (loop->wakeup_us > loop->select_us) ?
+        loop->wakeup_us - loop->select_us : 0, events);
+    return knet_loop_update_clock_ms(loop);
+}
+
+int knet_loop_get_accept_pending(kloop_t* loop) {
+    verify(loop);
+    return (int)loop->accept_pending;
+}
@@ -42,6 +42,27 @@ void knet_loop_add_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
  */
 void knet_loop_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
 
+/**
+ * ܵǨ, 뿪ѡȡ/Ծ/ʱ, ׽ֱִ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_loop_migrate_out_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * ܵǨ, Ծ/ѡȡ/ʱ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_loop_migrate_in_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * ӵȴǨĹܵ, ڱѭʱ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_loop_add_migrate(kloop_t* loop, kchannel_ref_t* channel_ref);
+
 /**
  * ӵԾɾkchannel_ref_tʵر
  * @param loop kloop_tʵ
@@ -127,6 +148,68 @@ void knet_loop_notify_connect(kloop_t* loop, kchannel_ref_t* channel_ref);
  */
 void knet_loop_notify_send(kloop_t* loop, kchannel_ref_t* channel_ref, kbuffer_t* send_buffer);
 
+/**
+ * ¼֪ͨ - ܵ¼ʱ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_loop_notify_timeout(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * ¼֪ͨ - ⷢˮλ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_loop_notify_send_drained(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * ¼֪ͨ - ̷߳ͬһloopڶܵ, ֻͶһ¼
+ *
+ * úloop
+ * @param loop kloop_tʵ
+ * @param batch kloop_send_batch_tʵ
+ */
+void knet_loop_notify_send_batch(kloop_t* loop, kloop_send_batch_t* batch);
+
+/**
+ * 㲥¼֪ͨ - ɷloopڹܵ͹
+ *
+ * ¼й㲥һüһ, loopͷ
+ * @param loop kloop_tʵ
+ * @param partition kbroadcast_partition_tʵ
+ * @param shared , Ϊ0ʱֻշ滻ĳԱ
+ */
+void knet_loop_notify_broadcast(kloop_t* loop, kbroadcast_partition_t* partition, kshared_buffer_t* shared);
+
+/**
+ * ܵǨ¼֪ͨ - ĿloopӹѾǨĹܵ
+ * @param loop Ŀkloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_loop_notify_migrate(kloop_t* loop, kchannel_ref_t* channel_ref);
+
+/**
+ * 
+ * @param shared , һ
+ * @return kloop_send_batch_tʵ
+ */
+kloop_send_batch_t* knet_loop_send_batch_create(kshared_buffer_t* shared);
+
+/**
+ * , ͷųеĹܵü
+ * @param batch kloop_send_batch_tʵ
+ */
+void knet_loop_send_batch_destroy(kloop_send_batch_t* batch);
+
+/**
+ * Ŀܵ, ӹܵüֱ
+ * @param batch kloop_send_batch_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_loop_send_batch_add(kloop_send_batch_t* batch, kchannel_ref_t* channel_ref);
+
 /**
  * ¼֪ͨ - رչܵ
  * @param loop kloop_tʵ
@@ -135,17 +218,18 @@ void knet_loop_notify_send(kloop_t* loop, kchannel_ref_t* channel_ref, kbuffer_t
 void knet_loop_notify_close(kloop_t* loop, kchannel_ref_t* channel_ref);
 
 /**
- * ֪ͨܵص
- * @param channel kchannel_ref_tʵ
- * @param e ܵ¼
+ * kloop_t¼
+ *
+ * ֻһλѱĵһεòŻknet_impl_notify
+ * @param loop kloop_tʵ
  */
-void knet_loop_queue_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e);
+void knet_loop_notify(kloop_t* loop);
 
 /**
- * ¼صknet_loop_queue_cb
+ * ѡȡѺ, ѱ־¼
  * @param loop kloop_tʵ
  */
-void knet_loop_notify(kloop_t* loop);
+void knet_loop_notify_process(kloop_t* loop);
 
 /**
  * ¼
@@ -154,12 +238,83 @@ void knet_loop_notify(kloop_t* loop);
 void knet_loop_event_process(kloop_t* loop);
 
 /**
- * Ծܵгʱ
+ * ʱڵڹܵӳʱгʱ
  * @param loop kloop_tʵ
- * @param ts ǰʱ룩
+ * @param ts ǰʱ룩
  */
 void knet_loop_check_timeout(kloop_t* loop, time_t ts);
 
+/**
+ * ܵ, loop߳ʹٹܵĻ
+ * @param loop kloop_tʵ
+ * @param size ܵ󳤶, йܵ󳤶ͬ
+ * @return жڴַ
+ */
+void* knet_loop_alloc_channel_object(kloop_t* loop, uint32_t size);
+
+/**
+ * ͷŹܵ, loop߳һδʱ뻺
+ * @param loop kloop_tʵ
+ * @param object ܵ
+ */
+void knet_loop_free_channel_object(kloop_t* loop, void* object);
+
+/**
+ * »ĵʱ
+ * @param loop kloop_tʵ
+ * @return ǰʱӣ룩
+ */
+time_t knet_loop_update_clock_ms(kloop_t* loop);
+
+/**
+ * ѡȡȴ, ¼ʱ䲢»ĵʱ
+ *
+ * ѡȡѵĺʱȴʱ, ѵѭĺʱæµʱ
+ * @param loop kloop_tʵ
+ * @param events λʱ¼
+ * @return ǰʱӣ룩
+ */
+time_t knet_loop_wakeup(kloop_t* loop, int events);
+
+/**
+ * ȡͶݻδĽ¼
+ * @param loop kloop_tʵ
+ * @return ¼
+ */
+int knet_loop_get_accept_pending(kloop_t* loop);
+
+/**
+ * ѡȡʱ
+ *
+ * ȡʱĵڿ̶, ͬ߳ѭ, ԼLOOP_WAIT_TIMEOUT_MAXеСֵ,
+ * ߳¼ͨknet_loop_notify
+ * @param loop kloop_tʵ
+ * @return ȴʱ䣨룩
+ */
+int knet_loop_get_wait_timeout(kloop_t* loop);
+
+/**
+ * ѡȡȴʱ, ͬ߳еѭ(ktimer_loop_t)
+ * @param loop kloop_tʵ
+ * @param ms ȴʱ䣨룩, -1Ϊ
+ */
+void knet_loop_set_wait_limit(kloop_t* loop, int ms);
+
+/**
+ * ܵ볬ʱʱ, Ѿʱλ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ * @param deadline Ҫʱ룩, Ѿһ̶ȼ
+ */
+void knet_loop_add_timeout(kloop_t* loop, kchannel_ref_t* channel_ref, time_t deadline);
+
+/**
+ * ܵӳʱʱȡ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ */
+void knet_loop_remove_timeout(kloop_t* loop, kchannel_ref_t* channel_ref);
+
 /**
  * رչܵǷ
  * @param loop kloop_tʵ
@@ -236,6 +391,17 @@ int knet_impl_event_add(kchannel_ref_t* channel_ref, knet_channel_event_e e);
  */
 int knet_impl_event_remove(kchannel_ref_t* channel_ref, knet_channel_event_e e);
 
+/* 
+ * ѡȡҪʵֵĺ - ¼Ͷ¼ľ״̬
+ *
+ * شѡȡδ()Ͼͷʱ, ֤ʣ()ٴδ¼
+ * @param channel_ref kchannel_ref_tʵ
+ * @param e ¼
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_impl_event_rearm(kchannel_ref_t* channel_ref, knet_channel_event_e e);
+
 /* 
  * ѡȡҪʵֵĺ - ֪ͨµĹܵ˻Ծ
  * @param loop kloop_tʵ
@@ -254,6 +420,15 @@ int knet_impl_add_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
  */
 int knet_impl_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
 
+/* 
+ * ѡȡҪʵֵĺ - ܵǨ, ѡȡɾ, ׽ֱִ
+ * @param loop kloop_tʵ
+ * @param channel_ref kchannel_ref_tʵ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int knet_impl_migrate_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
+
 /* 
  * ѡȡҪʵֵĺ - ӵʱѡȡԶʵ
  * @param channel_ref kchannel_ref_tʵ
@@ -261,6 +436,14 @@ int knet_impl_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref);
  */
 socket_t knet_impl_channel_accept(kchannel_ref_t* channel_ref);
 
+/* 
+ * ѡȡҪʵֵĺ - ̻߳ѡȡ
+ *
+ * ѡȡѺҪknet_loop_notify_process
+ * @param loop kloop_tʵ
+ */
+void knet_impl_notify(kloop_t* loop);
+
 /**
  * ȡûָ
  * @param loop kloop_tʵ
@@ -275,4 +458,11 @@ void* knet_loop_get_data(kloop_t* loop);
  */
 void knet_loop_set_data(kloop_t* loop, void* data);
 
+/**
+ * ȡRPCڴ, ״εʱ
+ * @param loop kloop_tʵ
+ * @return krpc_arena_tʵ
+ */
+krpc_arena_t* knet_loop_get_rpc_arena(kloop_t* loop);
+
 #endif /* LOOP_H */
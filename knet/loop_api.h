@@ -78,6 +78,21 @@ extern void knet_loop_destroy(kloop_t* loop);
  */
 extern kchannel_ref_t* knet_loop_create_channel(kloop_t* loop, uint32_t max_send_list_len, uint32_t recv_ring_len);
 
+/**
+ * ܵ, ָܵ־
+ *
+ * channel_flag_mirror_recv_buffer: ջӳβ, knet_stream_peek_ptrǿ
+ * ȡָ, ȡΪҳС. ͨһӳʼȱڿʱ,
+ * ÿε½ӳ䲢, ȡĳռýջԤ. ɼܵĹ̳ܵмı־.
+ * @param loop kloop_tʵ
+ * @param max_send_list_len ͻ󳤶
+ * @param recv_ring_len ܻλ󳤶
+ * @param flag ܵ־, knet_channel_flag_e
+ * @return kchannel_ref_tʵ
+ */
+extern kchannel_ref_t* knet_loop_create_channel_with_flag(kloop_t* loop, uint32_t max_send_list_len,
+    uint32_t recv_ring_len, int flag);
+
 /**
  * ʹѴڵ׽ִܵ
  * @param loop kloop_tʵ
@@ -134,6 +149,15 @@ extern int knet_loop_get_close_channel_count(kloop_t* loop);
  */
 extern kloop_profile_t* knet_loop_get_profile(kloop_t* loop);
 
+/**
+ * ȡkloop_tĵʱӣ룩
+ *
+ * ÿknet_loop_run_onceʼʱһ, ܵʱʱⶼʹʱ
+ * @param loop kloop_tʵ
+ * @return ʱӣ룩
+ */
+extern time_t knet_loop_get_clock_ms(kloop_t* loop);
+
 /** @} */
 
 #endif /* LOOP_API_H */
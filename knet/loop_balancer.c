@@ -23,133 +23,485 @@
  */
 
 #include "loop_balancer.h"
-#include "list.h"
+#include "loop_profile.h"
 #include "misc.h"
 #include "loop.h"
 #include "logger.h"
 
 
-typedef struct _loop_info_t {
-    kloop_t*  loop;    /* kloop_tʵ */
-    uint64_t choose;  /* ѡȡ */
-} loop_info_t;
+typedef struct _loop_balancer_point_t {
+    uint32_t hash; /* ڵϣֵ */
+    kloop_t* loop; /* kloop_tʵ */
+} loop_balancer_point_t;
+
+typedef struct _loop_balancer_snapshot_t loop_balancer_snapshot_t;
+
+/*
+ * ѹkloop_t, ޸, ѡȡʱȡ. 滻Ŀû̶߳ȡʱͷ
+ */
+struct _loop_balancer_snapshot_t {
+    loop_balancer_snapshot_t* next;        /* 滻 */
+    int                       count;       /* kloop_t */
+    kloop_t**                 loops;       /* kloop_t */
+    int                       point_count; /* һԹϣڵ */
+    loop_balancer_point_t*    points;      /* һԹϣ, ϣֵ */
+};
 
 struct _loop_balancer_t {
-    kdlist_t* loop_info_list; /* kloop_tʵ */
-    klock_t*  lock;           /*  - , kloop_tʵɾ */
-    void*    data;           /* û */
+    loop_balancer_snapshot_t* volatile snapshot; /* ǰ */
+    loop_balancer_snapshot_t*          retired;  /* 滻 */
+    atomic_counter_t                   readers;  /* ȡյ߳, Ϊʱ滻 */
+    klock_t*                           lock;     /*  - kloop_tʵɾ滻ջ */
+    knet_loop_balancer_strategy_e      strategy; /* ؾ */
+    atomic_counter_t                   seed;     /* ѡȡ */
+    volatile int                       skew;     /* ܵǨֵ, æµֵǧֱȣ, 0ΪǨ */
+    void*                              data;     /* û */
 };
 
+/**
+ * رȽϺ, ֵԽСԽ
+ */
+typedef uint64_t (*loop_balancer_load_t)(kloop_t*);
+
+/**
+ * , һηkloop_t鼰һԹϣ
+ */
+loop_balancer_snapshot_t* _loop_balancer_snapshot_create(int count);
+
+/**
+ * ¿, ɿշ滻
+ */
+void _loop_balancer_publish(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot);
+
+/**
+ * ʼȡ, صǰ
+ */
+loop_balancer_snapshot_t* _loop_balancer_acquire(kloop_balancer_t* balancer);
+
+/**
+ * ȡ, һȡ߻滻
+ */
+void _loop_balancer_release(kloop_balancer_t* balancer);
+
+/**
+ * ͷ滻, ߳û̶߳ȡ
+ */
+void _loop_balancer_reclaim(kloop_balancer_t* balancer);
+
+/**
+ * ؾѡȡ
+ */
+kloop_t* _loop_balancer_choose(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot, const char* ip);
+
+/**
+ * ѡȡǨĿ
+ */
+kloop_t* _loop_balancer_choose_migrate(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot, kloop_t* loop);
+
+/**
+ * ĸλ
+ */
+uint32_t _loop_balancer_hash(uint32_t key);
+
+/**
+ * ڵȽϺ
+ */
+int _loop_balancer_point_compare(const void* a, const void* b);
+
+/**
+ * ܵ - ѽ, ӼͶݻδĽ¼
+ */
+uint64_t _loop_balancer_channel_load(kloop_t* loop);
+
+/**
+ * շ, ͬʱȽϹܵ
+ */
+uint64_t _loop_balancer_bandwidth_load(kloop_t* loop);
+
+/**
+ * æµ, ͬʱȽϹܵ
+ */
+uint64_t _loop_balancer_busy_load(kloop_t* loop);
+
+/**
+ * ѡȡ͵kloop_t
+ */
+kloop_t* _loop_balancer_choose_least(loop_balancer_snapshot_t* snapshot, loop_balancer_load_t load);
+
+/**
+ * ѡȡkloop_t, ȡܵ
+ */
+kloop_t* _loop_balancer_choose_power_of_two(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot);
+
+/**
+ * ԶIPһԹϣѡȡ
+ */
+kloop_t* _loop_balancer_choose_hash(loop_balancer_snapshot_t* snapshot, const char* ip);
+
 kloop_balancer_t* knet_loop_balancer_create() {
     kloop_balancer_t* balancer = create(kloop_balancer_t);
     verify(balancer);
     memset(balancer, 0, sizeof(kloop_balancer_t));
-    balancer->loop_info_list = dlist_create();
-    verify(balancer->loop_info_list);
     balancer->lock = lock_create();
     verify(balancer->lock);
+    balancer->strategy = loop_balancer_strategy_least_channel;
+    balancer->skew     = LOOP_BALANCER_MIGRATE_SKEW;
     return balancer;
 }
 
 void knet_loop_balancer_destroy(kloop_balancer_t* balancer) {
-    kdlist_node_t* node = 0;
-    kdlist_node_t* temp = 0;
     verify(balancer);
     lock_destroy(balancer->lock);
-    dlist_for_each_safe(balancer->loop_info_list, node, temp) {
-        destroy(dlist_node_get_data(node));
+    if (balancer->snapshot) {
+        destroy(balancer->snapshot);
     }
-    dlist_destroy(balancer->loop_info_list);
+    _loop_balancer_reclaim(balancer);
     destroy(balancer);
 }
 
+loop_balancer_snapshot_t* _loop_balancer_acquire(kloop_balancer_t* balancer) {
+    /* Ӷȡٶȡ, ߿ȡΪʱû̳߳оɿ */
+    atomic_counter_inc(&balancer->readers);
+    return balancer->snapshot;
+}
+
+void _loop_balancer_release(kloop_balancer_t* balancer) {
+    if (atomic_counter_dec(&balancer->readers) || !balancer->retired) {
+        return;
+    }
+    lock_lock(balancer->lock);
+    /* ڼµĶȡֻȡǰ */
+    if (!atomic_counter_cas(&balancer->readers, 0, 0)) {
+        _loop_balancer_reclaim(balancer);
+    }
+    lock_unlock(balancer->lock);
+}
+
+void _loop_balancer_reclaim(kloop_balancer_t* balancer) {
+    loop_balancer_snapshot_t* snapshot = 0;
+    while (balancer->retired) {
+        snapshot = balancer->retired;
+        balancer->retired = snapshot->next;
+        destroy(snapshot);
+    }
+}
+
+loop_balancer_snapshot_t* _loop_balancer_snapshot_create(int count) {
+    loop_balancer_snapshot_t* snapshot = 0;
+    int                       points   = count * LOOP_BALANCER_VIRTUAL_NODE;
+    snapshot = (loop_balancer_snapshot_t*)create_raw(sizeof(loop_balancer_snapshot_t) +
+        sizeof(loop_balancer_point_t) * points + sizeof(kloop_t*) * count);
+    verify(snapshot);
+    if (!snapshot) {
+        return 0;
+    }
+    memset(snapshot, 0, sizeof(loop_balancer_snapshot_t));
+    snapshot->count       = count;
+    snapshot->point_count = points;
+    snapshot->points      = (loop_balancer_point_t*)(snapshot + 1);
+    snapshot->loops       = (kloop_t**)(snapshot->points + points);
+    return snapshot;
+}
+
+uint32_t _loop_balancer_hash(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85ebca6b;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35;
+    key ^= key >> 16;
+    return key;
+}
+
+int _loop_balancer_point_compare(const void* a, const void* b) {
+    uint32_t ha = ((const loop_balancer_point_t*)a)->hash;
+    uint32_t hb = ((const loop_balancer_point_t*)b)->hash;
+    return (ha < hb) ? -1 : ((ha > hb) ? 1 : 0);
+}
+
+void _loop_balancer_publish(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot) {
+    int i = 0;
+    int j = 0;
+    /* һԹϣ, ڵֻkloop_tַ, ɾkloop_tӰkloop_tĽڵ */
+    for (i = 0; i < snapshot->count; i++) {
+        for (j = 0; j < LOOP_BALANCER_VIRTUAL_NODE; j++) {
+            snapshot->points[i * LOOP_BALANCER_VIRTUAL_NODE + j].hash =
+                _loop_balancer_hash((uint32_t)(size_t)snapshot->loops[i] ^ _loop_balancer_hash((uint32_t)j));
+            snapshot->points[i * LOOP_BALANCER_VIRTUAL_NODE + j].loop = snapshot->loops[i];
+        }
+    }
+    qsort(snapshot->points, snapshot->point_count, sizeof(loop_balancer_point_t), _loop_balancer_point_compare);
+    /* ճʼɺٷ, CASͬʱΪڴ */
+    atomic_counter_cas(&balancer->seed, 0, 0);
+    if (balancer->snapshot) {
+        /* ѡȡʱڷʾɿ */
+        balancer->snapshot->next = balancer->retired;
+        balancer->retired = balancer->snapshot;
+    }
+    balancer->snapshot = snapshot;
+    /* CASͬʱΪڴ, ֮Ķȡֻȡ¿ */
+    if (!atomic_counter_cas(&balancer->readers, 0, 0)) {
+        _loop_balancer_reclaim(balancer);
+    }
+}
+
 int knet_loop_balancer_attach(kloop_balancer_t* balancer, kloop_t* loop) {
-    kdlist_node_t* node      = 0;
-    kdlist_node_t* temp      = 0;
-    loop_info_t*  loop_info = 0;
-    int           error     = error_ok;
+    loop_balancer_snapshot_t* old      = 0;
+    loop_balancer_snapshot_t* snapshot = 0;
+    int                       count    = 0;
+    int                       i        = 0;
     verify(balancer);
     verify(loop);
     lock_lock(balancer->lock);
-    dlist_for_each_safe(balancer->loop_info_list, node, temp) {
-        loop_info = (loop_info_t*)dlist_node_get_data(node);
-        if (loop_info->loop == loop) {
-            error = error_loop_attached;
-            goto unlock_return;
+    old = balancer->snapshot;
+    count = old ? old->count : 0;
+    for (i = 0; i < count; i++) {
+        if (old->loops[i] == loop) {
+            lock_unlock(balancer->lock);
+            return error_loop_attached;
         }
     }
-    loop_info = create(loop_info_t);
-    verify(loop_info);
-    memset(loop_info, 0, sizeof(loop_info_t));
-    loop_info->loop = loop;
-    dlist_add_tail_node(balancer->loop_info_list, loop_info);
+    snapshot = _loop_balancer_snapshot_create(count + 1);
+    if (!snapshot) {
+        lock_unlock(balancer->lock);
+        return error_no_memory;
+    }
+    for (i = 0; i < count; i++) {
+        snapshot->loops[i] = old->loops[i];
+    }
+    snapshot->loops[count] = loop;
+    _loop_balancer_publish(balancer, snapshot);
     knet_loop_set_balancer(loop, balancer);
-unlock_return:
     lock_unlock(balancer->lock);
-    return error;
+    return error_ok;
 }
 
 int knet_loop_balancer_detach(kloop_balancer_t* balancer, kloop_t* loop) {
-    kdlist_node_t* node      = 0;
-    kdlist_node_t* found     = 0;
-    kdlist_node_t* temp      = 0;
-    loop_info_t*  loop_info = 0;
-    int           error     = error_ok;
+    loop_balancer_snapshot_t* old      = 0;
+    loop_balancer_snapshot_t* snapshot = 0;
+    int                       found    = 0;
+    int                       i        = 0;
+    int                       j        = 0;
     verify(balancer);
     verify(loop);
     lock_lock(balancer->lock);
-    dlist_for_each_safe(balancer->loop_info_list, node, temp) {
-        loop_info = (loop_info_t*)dlist_node_get_data(node);
-        if (loop_info->loop == loop) {
-            found = node;
+    old = balancer->snapshot;
+    for (i = 0; old && (i < old->count); i++) {
+        if (old->loops[i] == loop) {
+            found = 1;
             break;
         }
     }
-    if (found) {
-        knet_loop_set_balancer(loop_info->loop, 0);
-        destroy(loop_info);
-        dlist_delete(balancer->loop_info_list, found);
-    } else {
-        error = error_loop_not_found;
+    if (!found) {
+        lock_unlock(balancer->lock);
+        return error_loop_not_found;
+    }
+    snapshot = _loop_balancer_snapshot_create(old->count - 1);
+    if (!snapshot) {
+        lock_unlock(balancer->lock);
+        return error_no_memory;
     }
+    for (i = 0; i < old->count; i++) {
+        if (old->loops[i] != loop) {
+            snapshot->loops[j++] = old->loops[i];
+        }
+    }
+    _loop_balancer_publish(balancer, snapshot);
+    knet_loop_set_balancer(loop, 0);
     lock_unlock(balancer->lock);
-    return error;
+    return error_ok;
 }
 
-kloop_t* knet_loop_balancer_choose(kloop_balancer_t* balancer) {
-    kdlist_node_t* node          = 0;
-    kdlist_node_t* temp          = 0;
-    kdlist_t*      channel_list  = 0;
-    loop_info_t*  found         = 0;
-    loop_info_t*  loop_info     = 0;
-    int           channel_count = INT_MAX;
-    int           count         = 0;
-    verify(balancer);
-    lock_lock(balancer->lock);
-    /* ѡȡǰԾܵٵkloop_t */
-    dlist_for_each_safe(balancer->loop_info_list, node, temp) {
-        loop_info = (loop_info_t*)dlist_node_get_data(node);
+uint64_t _loop_balancer_channel_load(kloop_t* loop) {
+    kloop_profile_t* profile = knet_loop_get_profile(loop);
+    /* Ϊԭӱ, ߳̽ܵʱҲ޸ */
+    return (uint64_t)knet_loop_profile_get_established_channel_count(profile) +
+        (uint64_t)knet_loop_profile_get_active_channel_count(profile) +
+        (uint64_t)knet_loop_get_accept_pending(loop);
+}
+
+uint64_t _loop_balancer_bandwidth_load(kloop_t* loop) {
+    return ((uint64_t)knet_loop_profile_get_load_bandwidth(knet_loop_get_profile(loop)) << 32) +
+        _loop_balancer_channel_load(loop);
+}
+
+uint64_t _loop_balancer_busy_load(kloop_t* loop) {
+    return ((uint64_t)knet_loop_profile_get_load_busy(knet_loop_get_profile(loop)) << 32) +
+        _loop_balancer_channel_load(loop);
+}
+
+kloop_t* _loop_balancer_choose_least(loop_balancer_snapshot_t* snapshot, loop_balancer_load_t load) {
+    kloop_t* found     = 0;
+    uint64_t min_load  = 0;
+    uint64_t loop_load = 0;
+    int      i         = 0;
+    for (; i < snapshot->count; i++) {
         /* Ƿloop_balancer_in */
-        if (knet_loop_check_balance_options(loop_info->loop, loop_balancer_in)) {
-            channel_list = knet_loop_get_active_list(loop_info->loop);
-            count = dlist_get_count(channel_list);
-            if (count < channel_count) {
-                found = loop_info;
-                channel_count = count;
-            }
+        if (!knet_loop_check_balance_options(snapshot->loops[i], loop_balancer_in)) {
+            continue;
+        }
+        loop_load = load(snapshot->loops[i]);
+        if (!found || (loop_load < min_load)) {
+            found    = snapshot->loops[i];
+            min_load = loop_load;
         }
     }
-    if (found) {
-        /* ¼ѡȡ */
-        found->choose++;
+    return found;
+}
+
+kloop_t* _loop_balancer_choose_power_of_two(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot) {
+    uint32_t random = 0;
+    kloop_t* first  = 0;
+    kloop_t* second = 0;
+    int      i      = 0;
+    if (snapshot->count < 2) {
+        return _loop_balancer_choose_least(snapshot, _loop_balancer_channel_load);
     }
-    lock_unlock(balancer->lock);
-    if (found) {
-        return found->loop;
+    random = _loop_balancer_hash((uint32_t)atomic_counter_inc(&balancer->seed));
+    i      = (int)((random >> 16) % (uint32_t)snapshot->count);
+    first  = snapshot->loops[i];
+    /* ڶһͬ */
+    second = snapshot->loops[(i + 1 + (int)((random & 0xffff) % (uint32_t)(snapshot->count - 1))) %
+        snapshot->count];
+    if (!knet_loop_check_balance_options(first, loop_balancer_in)) {
+        first = 0;
+    }
+    if (!knet_loop_check_balance_options(second, loop_balancer_in)) {
+        second = 0;
+    }
+    if (!first && !second) {
+        return _loop_balancer_choose_least(snapshot, _loop_balancer_channel_load);
+    } else if (!first || !second) {
+        return first ? first : second;
+    }
+    return (_loop_balancer_channel_load(second) < _loop_balancer_channel_load(first)) ? second : first;
+}
+
+kloop_t* _loop_balancer_choose_hash(loop_balancer_snapshot_t* snapshot, const char* ip) {
+    uint32_t hash  = 0;
+    int      low   = 0;
+    int      high  = snapshot->point_count;
+    int      mid   = 0;
+    int      i     = 0;
+    kloop_t* loop  = 0;
+    if (!ip || !*ip || !snapshot->point_count) {
+        return _loop_balancer_choose_least(snapshot, _loop_balancer_channel_load);
+    }
+    for (; *ip; ip++) {
+        hash = *ip + hash * 31;
+    }
+    hash = _loop_balancer_hash(hash);
+    /* һϣֵСhashڵ */
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (snapshot->points[mid].hash < hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    /* ˳ʱҿloop_balancer_inõkloop_t */
+    for (i = 0; i < snapshot->point_count; i++) {
+        loop = snapshot->points[(low + i) % snapshot->point_count].loop;
+        if (knet_loop_check_balance_options(loop, loop_balancer_in)) {
+            return loop;
+        }
     }
     return 0;
 }
 
+kloop_t* knet_loop_balancer_choose(kloop_balancer_t* balancer, const char* ip) {
+    loop_balancer_snapshot_t* snapshot = 0;
+    kloop_t*                  loop     = 0;
+    verify(balancer); /* ipΪ0 */
+    /* ȡǰ, ȡڼղᱻͷ */
+    snapshot = _loop_balancer_acquire(balancer);
+    loop = _loop_balancer_choose(balancer, snapshot, ip);
+    _loop_balancer_release(balancer);
+    return loop;
+}
+
+kloop_t* _loop_balancer_choose(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot, const char* ip) {
+    if (!snapshot || !snapshot->count) {
+        return 0;
+    }
+    switch (balancer->strategy) {
+    case loop_balancer_strategy_least_bandwidth:
+        return _loop_balancer_choose_least(snapshot, _loop_balancer_bandwidth_load);
+    case loop_balancer_strategy_least_busy:
+        return _loop_balancer_choose_least(snapshot, _loop_balancer_busy_load);
+    case loop_balancer_strategy_power_of_two:
+        return _loop_balancer_choose_power_of_two(balancer, snapshot);
+    case loop_balancer_strategy_consistent_hash:
+        return _loop_balancer_choose_hash(snapshot, ip);
+    default:
+        break;
+    }
+    return _loop_balancer_choose_least(snapshot, _loop_balancer_channel_load);
+}
+
+kloop_t* knet_loop_balancer_choose_migrate(kloop_balancer_t* balancer, kloop_t* loop) {
+    loop_balancer_snapshot_t* snapshot = 0;
+    kloop_t*                  found    = 0;
+    verify(balancer);
+    verify(loop);
+    if (!balancer->skew || !knet_loop_check_balance_options(loop, loop_balancer_out)) {
+        return 0;
+    }
+    snapshot = _loop_balancer_acquire(balancer);
+    found = _loop_balancer_choose_migrate(balancer, snapshot, loop);
+    _loop_balancer_release(balancer);
+    return found;
+}
+
+kloop_t* _loop_balancer_choose_migrate(kloop_balancer_t* balancer, loop_balancer_snapshot_t* snapshot, kloop_t* loop) {
+    kloop_t*                  found    = 0;
+    uint32_t                  min_busy = 0;
+    uint32_t                  busy     = 0;
+    int                       i        = 0;
+    if (!snapshot) {
+        return 0;
+    }
+    for (; i < snapshot->count; i++) {
+        if ((snapshot->loops[i] == loop) || !knet_loop_check_balance_options(snapshot->loops[i], loop_balancer_in)) {
+            continue;
+        }
+        busy = knet_loop_profile_get_load_busy(knet_loop_get_profile(snapshot->loops[i]));
+        if (!found || (busy < min_busy)) {
+            found    = snapshot->loops[i];
+            min_busy = busy;
+        }
+    }
+    if (!found) {
+        return 0;
+    }
+    busy = knet_loop_profile_get_load_busy(knet_loop_get_profile(loop));
+    if (busy <= min_busy + (uint32_t)balancer->skew) {
+        return 0;
+    }
+    return found;
+}
+
+void knet_loop_balancer_set_strategy(kloop_balancer_t* balancer, knet_loop_balancer_strategy_e strategy) {
+    verify(balancer);
+    balancer->strategy = strategy;
+}
+
+knet_loop_balancer_strategy_e knet_loop_balancer_get_strategy(kloop_balancer_t* balancer) {
+    verify(balancer);
+    return balancer->strategy;
+}
+
+void knet_loop_balancer_set_migrate_skew(kloop_balancer_t* balancer, int skew) {
+    verify(balancer);
+    verify(skew >= 0);
+    balancer->skew = skew;
+}
+
+int knet_loop_balancer_get_migrate_skew(kloop_balancer_t* balancer) {
+    verify(balancer);
+    return balancer->skew;
+}
+
 void knet_loop_balancer_set_data(kloop_balancer_t* balancer, void* data) {
     verify(balancer);
     verify(data);
@@ -30,10 +30,24 @@
 
 /**
  * ؾ - ѡȡһkloop_tʵ
+ *
+ * , kloop_t߳ڵ
  * @param balancer kloop_balancer_tʵ
+ * @param ip ԶIP, ֻһԹϣ, Ϊ0
  * @return kloop_tʵ
  */
-kloop_t* knet_loop_balancer_choose(kloop_balancer_t* balancer);
+kloop_t* knet_loop_balancer_choose(kloop_balancer_t* balancer, const char* ip);
+
+/**
+ * ؾ - ѡȡܵǨƵĿkloop_tʵ
+ *
+ * , loopе߳ڲغ
+ * @param balancer kloop_balancer_tʵ
+ * @param loop ǰkloop_tʵ
+ * @retval 0 ҪǨ
+ * @retval kloop_tʵ æµ͵kloop_t
+ */
+kloop_t* knet_loop_balancer_choose_migrate(kloop_balancer_t* balancer, kloop_t* loop);
 
 /**
  * û
@@ -29,15 +29,20 @@
 #include "channel_ref.h"
 #include "channel.h"
 #include "logger.h"
+#include "misc.h"
+
+#include <sys/eventfd.h>
 
 typedef struct _loop_epoll_t {
-    int                 epoll_fd; /* epoll */
-    struct epoll_event* events;   /* epoll¼ */
+    int                 epoll_fd;  /* epoll */
+    int                 notify_fd; /* ¼֪ͨ(eventfd) */
+    struct epoll_event* events;    /* epoll¼ */
 } loop_epoll_t;
 
 #define MAXEVENTS 8192 /* epoll_create */
 
 int knet_impl_create(kloop_t* loop) {
+    struct epoll_event event;
     loop_epoll_t* impl = create(loop_epoll_t);
     knet_loop_set_impl(loop, impl);
     impl->epoll_fd = epoll_create(MAXEVENTS);
@@ -45,6 +50,22 @@ int knet_impl_create(kloop_t* loop) {
         destroy(impl);
         return 1;
     }
+    impl->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (impl->notify_fd < 0) {
+        close(impl->epoll_fd);
+        destroy(impl);
+        return 1;
+    }
+    /* ˮƽ, data.ptrΪ0ʾ¼֪ͨ */
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = 0;
+    if (epoll_ctl(impl->epoll_fd, EPOLL_CTL_ADD, impl->notify_fd, &event)) {
+        close(impl->notify_fd);
+        close(impl->epoll_fd);
+        destroy(impl);
+        return 1;
+    }
     impl->events = create_type(struct epoll_event, sizeof(struct epoll_event) * MAXEVENTS);
     assert(impl->events);
     return error_ok;
@@ -52,6 +73,7 @@ int knet_impl_create(kloop_t* loop) {
 
 void knet_impl_destroy(kloop_t* loop) {
     loop_epoll_t* impl = (loop_epoll_t*)knet_loop_get_impl(loop);
+    close(impl->notify_fd);
     close(impl->epoll_fd);
     destroy(impl->events);
     destroy(impl);
@@ -59,7 +81,8 @@ void knet_impl_destroy(kloop_t* loop) {
 
 int _select(kloop_t* loop, int* count) {
     loop_epoll_t* impl = (loop_epoll_t*)knet_loop_get_impl(loop);
-    *count = epoll_wait(impl->epoll_fd, impl->events, MAXEVENTS, 1);
+    /* ȴĳʱ̶, ߳¼ͨeventfd */
+    *count = epoll_wait(impl->epoll_fd, impl->events, MAXEVENTS, knet_loop_get_wait_timeout(loop));
     if (*count < 0) {
         return error_loop_fail;
     }
@@ -69,18 +92,28 @@ int _select(kloop_t* loop, int* count) {
 int knet_impl_run_once(kloop_t* loop) {
     int count = 0;
     int i = 0;
+    uint64_t value = 0;
+    knet_channel_event_e e = 0;
     kchannel_ref_t* channel_ref = 0;
     struct epoll_event event;
-    time_t ts = time(0);
+    time_t ts = 0;
     struct epoll_event* events = 0;
     loop_epoll_t* impl = (loop_epoll_t*)knet_loop_get_impl(loop);
     int error = _select(loop, &count);
     if (error != error_ok) {
         return error;
     }
+    /* ˽ϳʱ, ȴʱ */
+    ts = knet_loop_wakeup(loop, count);
     events = impl->events;
     for (; i < count; i++) {
         channel_ref = (kchannel_ref_t*)events[i].data.ptr;
+        if (!channel_ref) {
+            /* ¼֪ͨ, ռ¼ */
+            while (read(impl->notify_fd, &value, sizeof(value)) > 0);
+            knet_loop_notify_process(loop);
+            continue;
+        }
         if ((events[i].events & EPOLLERR) || (events[i].events & EPOLLHUP)) {
            /* ManPage: In kernel versions before 2.6.9, the EPOLL_CTL_DEL operation required a non-NULL pointer
               in event, even though this argument is ignored. Since Linux 2.6.9, event can be specified
@@ -88,11 +121,16 @@ int knet_impl_run_once(kloop_t* loop) {
               2.6.9 should specify a non-NULL pointer in event.
             */
             epoll_ctl(impl->epoll_fd, EPOLL_CTL_DEL, knet_channel_ref_get_socket_fd(channel_ref), &event);
-        } else if (events[i].events & EPOLLIN) {
-            knet_channel_ref_update(channel_ref, channel_event_recv, ts);
-        } else if (events[i].events & EPOLLOUT) {
-            knet_channel_ref_update(channel_ref, channel_event_send, ts);
         } else {
+            /* д¼ͬʱ */
+            e = 0;
+            if (events[i].events & EPOLLIN) {
+                e |= channel_event_recv;
+            }
+            if (events[i].events & EPOLLOUT) {
+                e |= channel_event_send;
+            }
+            knet_channel_ref_update(channel_ref, e, ts);
         }
     }
     knet_loop_check_timeout(loop, ts);
@@ -104,22 +142,16 @@ int knet_impl_event_add(kchannel_ref_t* channel_ref, knet_channel_event_e e) {
     struct epoll_event event;
     loop_epoll_t* impl = (loop_epoll_t*)knet_loop_get_impl(knet_channel_ref_get_loop(channel_ref));
     knet_channel_event_e old_event = knet_channel_ref_get_event(channel_ref);
+    if (knet_channel_ref_get_flag(channel_ref) && ((old_event & e) == e)) {
+        /* ѾͶݹ, ش²Ҫע */
+        return error_ok;
+    }
+    /* д¼һע, ǷɹܵͶݵ¼ */
     memset(&event, 0, sizeof(event));
     event.data.ptr = channel_ref;
-    event.events |= EPOLLET;
-    if (e & channel_event_recv) {
-        if (old_event & channel_event_send) { /* Ѿעд¼ */
-            event.events |= EPOLLOUT;
-        }
-        event.events |= EPOLLIN;
-    }
-    if (e & channel_event_send) {
-        if (old_event & channel_event_recv) { /* Ѿע¼ */
-            event.events |= EPOLLIN;
-        }
-        event.events |= EPOLLOUT;
-    }
+    event.events = EPOLLIN | EPOLLOUT | EPOLLET;
     if (knet_channel_ref_get_flag(channel_ref)) {
+        /* Ͷݵ¼, עԼ⵱ǰ״̬, ֹ֮ǰıر */
         epoll_ctl(impl->epoll_fd, EPOLL_CTL_MOD, knet_channel_ref_get_socket_fd(channel_ref), &event);
     } else {
         knet_channel_ref_set_flag(channel_ref, 1);
@@ -129,28 +161,20 @@ int knet_impl_event_add(kchannel_ref_t* channel_ref, knet_channel_event_e e) {
 }
 
 int knet_impl_event_remove(kchannel_ref_t* channel_ref, knet_channel_event_e e) {
+    /* עĶд¼, ܵٴȡ¼, ر׽ʱԶepollɾ */
+    return error_ok;
+}
+
+int knet_impl_event_rearm(kchannel_ref_t* channel_ref, knet_channel_event_e e) {
     struct epoll_event event;
     loop_epoll_t* impl = (loop_epoll_t*)knet_loop_get_impl(knet_channel_ref_get_loop(channel_ref));
-    knet_channel_event_e old_event = knet_channel_ref_get_event(channel_ref);
+    if (!knet_channel_ref_get_flag(channel_ref)) {
+        return error_ok;
+    }
     memset(&event, 0, sizeof(event));
     event.data.ptr = channel_ref;
-    event.events |= EPOLLET;
-    if (e & channel_event_recv) {
-        if (old_event & channel_event_send) { /* Ѿעд¼ */
-            event.events |= EPOLLOUT;
-        }
-    } 
-    if (e & channel_event_send) {
-        if (old_event & channel_event_recv) { /* Ѿע¼ */
-            event.events |= EPOLLIN;
-        }
-    }
-    if (knet_channel_ref_get_flag(channel_ref)) {
-        epoll_ctl(impl->epoll_fd, EPOLL_CTL_MOD, knet_channel_ref_get_socket_fd(channel_ref), &event);
-    } else {
-        knet_channel_ref_set_flag(channel_ref, 1);
-        epoll_ctl(impl->epoll_fd, EPOLL_CTL_ADD, knet_channel_ref_get_socket_fd(channel_ref), &event);
-    }
+    event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+    epoll_ctl(impl->epoll_fd, EPOLL_CTL_MOD, knet_channel_ref_get_socket_fd(channel_ref), &event);
     return error_ok;
 }
 
@@ -164,8 +188,29 @@ int knet_impl_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
     return error_ok;
 }
 
+int knet_impl_migrate_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    struct epoll_event event;
+    loop_epoll_t* impl = (loop_epoll_t*)knet_loop_get_impl(loop);
+    if (knet_channel_ref_get_flag(channel_ref)) {
+        /* ׽ûйر, Ҫʽɾ */
+        memset(&event, 0, sizeof(event));
+        epoll_ctl(impl->epoll_fd, EPOLL_CTL_DEL, knet_channel_ref_get_socket_fd(channel_ref), &event);
+    }
+    /* ӱ, Ŀkloop_t */
+    knet_channel_ref_set_flag(channel_ref, 0);
+    return error_ok;
+}
+
 socket_t knet_impl_channel_accept(kchannel_ref_t* channel_ref) {
     return 0;
 }
 
+void knet_impl_notify(kloop_t* loop) {
+    uint64_t value = 1;
+    loop_epoll_t* impl = (loop_epoll_t*)knet_loop_get_impl(loop);
+    if (write(impl->notify_fd, &value, sizeof(value)) < 0) {
+        log_error("knet_impl_notify() failed, system error: %d", sys_get_errno());
+    }
+}
+
 #endif
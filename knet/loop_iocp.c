@@ -211,8 +211,12 @@ int _select(kloop_t* loop, time_t ts) {
     per_sock_t*    per_sock    = 0;
     kchannel_ref_t* channel_ref = 0;
     loop_iocp_t*   impl        = get_impl(loop);
-    error = GetQueuedCompletionStatus(impl->iocp, &bytes, (PULONG_PTR)&per_sock, (LPOVERLAPPED*)&per_io, 1);
+    /* ȴĳʱ̶, ߳¼ͨɰ */
+    error = GetQueuedCompletionStatus(impl->iocp, &bytes, (PULONG_PTR)&per_sock, (LPOVERLAPPED*)&per_io,
+        (DWORD)knet_loop_get_wait_timeout(loop));
     last_error = GetLastError();
+    /* ˽ϳʱ, ȴʱ, ÿλֻȡһɰ */
+    ts = knet_loop_wakeup(loop, ((FALSE == error) && (last_error == WAIT_TIMEOUT)) ? 0 : 1);
     if (FALSE == error) {
         if (last_error == WAIT_TIMEOUT) {
             return error_ok;
@@ -223,6 +227,10 @@ int _select(kloop_t* loop, time_t ts) {
             knet_channel_ref_decref(per_sock->channel_ref);
             return error_ok;
         }
+    } else if (!per_sock) {
+        /* ¼֪ͨ */
+        knet_loop_notify_process(loop);
+        return error_ok;
     }
     verify(per_sock);
     verify(per_io);
@@ -242,13 +250,14 @@ int _select(kloop_t* loop, time_t ts) {
 
 int knet_impl_run_once(kloop_t* loop) {
     int    error = 0;
-    time_t ts    = time(0);
+    time_t ts    = 0;
     verify(loop);
+    ts = knet_loop_update_clock_ms(loop);
     error = _select(loop, ts);
     if (error != error_ok) {
         return error;
     }
-    knet_loop_check_timeout(loop, ts);
+    knet_loop_check_timeout(loop, knet_loop_get_clock_ms(loop));
     knet_loop_check_close(loop);
     return error_ok;
 }
@@ -270,6 +279,8 @@ socket_t knet_impl_channel_accept(kchannel_ref_t* channel_ref) {
        socket can be retrieved using the getpeername function.
      */
     setsockopt(client, SOL_SOCKET, SO_UPDATE_ACCEPT_CONTEXT, (char*)&acceptor, sizeof(socket_t));
+    /* socket_accept()һ, ط׽ */
+    socket_set_non_blocking_on(client);
     return client;
 }
 
@@ -411,6 +422,13 @@ int knet_impl_event_remove(kchannel_ref_t* channel_ref, knet_channel_event_e e)
     return error_ok;
 }
 
+int knet_impl_event_rearm(kchannel_ref_t* channel_ref, knet_channel_event_e e) {
+    /* ÿɺ󶼻Ͷݲ, Ҫ */
+    verify(channel_ref);
+    e;
+    return error_ok;
+}
+
 int knet_impl_add_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
     loop_iocp_t* impl      = 0;
     socket_t     socket_fd = 0;
@@ -445,4 +463,19 @@ int knet_impl_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
     return error_ok;
 }
 
+int knet_impl_migrate_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    verify(loop);
+    verify(channel_ref);
+    /* ׽Ѿɶ˿, ¹ɶ˿ */
+    return error_migrate_fail;
+}
+
+void knet_impl_notify(kloop_t* loop) {
+    verify(loop);
+    /* ͶɼΪ0ɰ */
+    if (!PostQueuedCompletionStatus(get_impl(loop)->iocp, 0, 0, 0)) {
+        log_error("knet_impl_notify() failed, system error: %d", sys_get_errno());
+    }
+}
+
 #endif
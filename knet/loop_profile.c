@@ -22,35 +22,138 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stdarg.h>
+#include <stddef.h>
 #include "loop_profile.h"
 #include "loop.h"
 #include "list.h"
 #include "stream.h"
 #include "logger.h"
+#include "allocator.h"
+#include "misc.h"
+
+#define LOOP_PROFILE_HISTOGRAM_SUB_BITS 3 /* ÿ2ڵλ, 1/8 */
+#define LOOP_PROFILE_HISTOGRAM_SUB      (1 << LOOP_PROFILE_HISTOGRAM_SUB_BITS)
+#define LOOP_PROFILE_HISTOGRAM_SIZE     ((32 - LOOP_PROFILE_HISTOGRAM_SUB_BITS + 1) * LOOP_PROFILE_HISTOGRAM_SUB) /* 32λʱ΢룩 */
+
+/* ʱֱͼ΢룩, 2ݷֶ, ڵȷΪLOOP_PROFILE_HISTOGRAM_SUB */
+typedef struct _loop_profile_histogram_t {
+    uint64_t count;                                 /*  */
+    uint64_t total;                                 /* ʱܺ */
+    uint32_t max;                                   /* ʱ */
+    uint64_t bucket[LOOP_PROFILE_HISTOGRAM_SIZE];   /*  */
+} loop_profile_histogram_t;
+
+/* kloop_t̶߳ڷͳƿ, ̶߳ȡʱ޸κ״̬ */
+typedef struct _loop_profile_snapshot_t {
+    uint64_t wait_us;             /* ѡȡڵȴۼƺʱ΢룩 */
+    uint64_t busy_us;             /* ¼ۼƺʱ΢룩 */
+    uint64_t wakeup_count;        /* ѡȡѴ */
+    uint64_t wakeup_events;       /* ʱ¼ۼ */
+    uint32_t wakeup_events_max;   /* λѾ¼ */
+    uint64_t queue_count;         /* ǿտ߳¼еĴ */
+    uint64_t queue_events;        /* ѴĿ߳¼ */
+    uint32_t queue_depth_max;     /* δʱ߳¼е */
+    uint32_t send_bandwidth;      /* ϸķʣֽ/룩 */
+    uint32_t recv_bandwidth;      /* ϸĽʣֽ/룩 */
+    uint32_t alloc_rate[ALLOCATOR_CLASS_COUNT + 1]; /* ϸķʣ/룩 */
+    uint32_t slowest_cb_us;       /* ϸĻصʱ΢룩 */
+    uint64_t slowest_cb_uuid;     /* ϸĻصܵUUID */
+    loop_profile_histogram_t callback;   /* صʱֱͼ */
+    loop_profile_histogram_t queue_wait; /* ߳¼Ŷӳֱͼ */
+} loop_profile_snapshot_t;
+
+/* ڲֱͼĲ, ֻȡĽӿڲֱͼ */
+#define LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE offsetof(loop_profile_snapshot_t, slowest_cb_us)
 
 struct _loop_profile_t {
     kloop_t*  loop;                /* ¼ѭ */
+    volatile int latency;         /* ͳƿ߳¼ŶӳټܵصʱĿ, ߳޸ */
     uint64_t recv_bytes;          /* ѽյֽ */
     uint64_t send_bytes;          /* ѷ͵ֽ */
-    uint32_t established_channel; /* ѾӵĹܵ */
-    uint32_t active_channel;      /* δӵĹܵ */
-    uint32_t close_channel;       /* ѹرյĹܵ */
-    uint32_t __padding;           /*  */
-    uint64_t last_send_bytes;     /* ϴεknet_loop_profile_get_sent_bandwidthʱķֽ */
-    uint64_t last_recv_bytes;     /* ϴεknet_loop_profile_get_recv_bandwidthʱĽֽ */
-    time_t   last_send_tick;      /* ϴεknet_loop_profile_get_sent_bandwidthʱʱ룩 */
-    time_t   last_recv_tick;      /* ϴεknet_loop_profile_get_recv_bandwidthʱʱ룩 */
+    atomic_counter_t established_channel; /* ѾӵĹܵ */
+    atomic_counter_t active_channel;      /* δӵĹܵ, ߳̽ʱ޸ */
+    atomic_counter_t close_channel;       /* ѹرյĹܵ */
+    uint32_t idle_channel;        /* ջеĹܵ */
+    uint64_t recv_buffer_bytes;   /* йܵջռõֽ */
+    uint64_t idle_buffer_bytes;   /* йܵջռõֽ */
+    uint64_t publish_us;          /* ϴηյʱ΢룩 */
+    uint64_t publish_send_bytes;  /* ϴηʱķֽ */
+    uint64_t publish_recv_bytes;  /* ϴηʱĽֽ */
+    uint64_t publish_alloc_count[ALLOCATOR_CLASS_COUNT + 1]; /* ϴηʱķ */
+    uint64_t busy_us;             /* ¼ۼƺʱ΢룩, ѡȡڵȴʱ */
+    uint64_t load_sample_us;      /* ϴθزʱ΢룩 */
+    uint64_t load_sample_bytes;   /* ϴθزʱշֽ */
+    uint64_t load_sample_busy_us; /* ϴθزʱ¼ۼƺʱ΢룩 */
+    volatile uint32_t load_bandwidth; /* շʣֽ/룩, ֻkloop_t߳д */
+    volatile uint32_t load_busy;      /* æµǧֱȣ, ֻkloop_t߳д */
+    loop_profile_snapshot_t current;  /* ǰͳ, ֻkloop_t̶߳д */
+    loop_profile_snapshot_t snapshot; /* ѷĿ */
+    atomic_counter_t snapshot_seq;    /* , ʱд */
 };
 
+/**
+ * ʽдܵ, streamΪ0ʱдfp
+ */
+int _loop_profile_dump_varg(FILE* fp, kstream_t* stream, const char* format, ...);
+
+/**
+ * ȵȼڴͳ
+ */
+int _loop_profile_dump_allocator(loop_profile_snapshot_t* snapshot, FILE* fp, kstream_t* stream);
+
+/**
+ * ͳϢ, streamΪ0ʱдfp
+ */
+int _loop_profile_dump(kloop_profile_t* profile, FILE* fp, kstream_t* stream);
+
+/**
+ * ȡѷյǰsizeֽ, ȡпձд¶ȡ
+ */
+void _loop_profile_read(kloop_profile_t* profile, loop_profile_snapshot_t* snapshot, size_t size);
+
+/**
+ * kloop_t߳ڷ, ϴη
+ */
+void _loop_profile_publish(kloop_profile_t* profile, uint64_t ts);
+
+/**
+ * ϴηʣ/룩
+ */
+uint32_t _loop_profile_rate(uint64_t count, uint64_t intval);
+
+/**
+ * ʱڵֱͼ
+ */
+int _loop_profile_histogram_index(uint32_t us);
+
+/**
+ * ȡֱͼޣ΢룩
+ */
+uint64_t _loop_profile_histogram_lower(int index);
+
+/**
+ * ¼һʱ
+ */
+void _loop_profile_histogram_add(loop_profile_histogram_t* histogram, uint64_t us);
+
+/**
+ * ֱͼİٷλʱ
+ */
+uint32_t _loop_profile_histogram_percentile(loop_profile_histogram_t* histogram, int permille);
+
 kloop_profile_t* knet_loop_profile_create(kloop_t* loop) {
+    int              i       = 0;
     kloop_profile_t* profile = 0;
     verify(loop);
     profile = create(kloop_profile_t);
     verify(profile);
     memset(profile, 0, sizeof(kloop_profile_t));
-    profile->loop           = loop;
-    profile->last_send_tick = time(0);
-    profile->last_recv_tick = profile->last_send_tick;
+    profile->loop       = loop;
+    profile->publish_us = time_get_microseconds();
+    for (i = 0; i <= ALLOCATOR_CLASS_COUNT; i++) {
+        profile->publish_alloc_count[i] = knet_allocator_get_alloc_count(i);
+    }
     return profile;
 }
 
@@ -60,47 +163,47 @@ void knet_loop_profile_destroy(kloop_profile_t* profile) {
 
 uint32_t knet_loop_profile_increase_established_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return ++profile->established_channel;
+    return (uint32_t)atomic_counter_inc(&profile->established_channel);
 }
 
 uint32_t knet_loop_profile_decrease_established_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return --profile->established_channel;
+    return (uint32_t)atomic_counter_dec(&profile->established_channel);
 }
 
 uint32_t knet_loop_profile_get_established_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return profile->established_channel - 2; /* ¼֪ͨܵͳ */
+    return (uint32_t)profile->established_channel;
 }
 
 uint32_t knet_loop_profile_increase_active_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return ++profile->active_channel;
+    return (uint32_t)atomic_counter_inc(&profile->active_channel);
 }
 
 uint32_t knet_loop_profile_decrease_active_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return --profile->active_channel;
+    return (uint32_t)atomic_counter_dec(&profile->active_channel);
 }
 
 uint32_t knet_loop_profile_get_active_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return profile->active_channel;
+    return (uint32_t)profile->active_channel;
 }
 
 uint32_t knet_loop_profile_increase_close_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return ++profile->close_channel;
+    return (uint32_t)atomic_counter_inc(&profile->close_channel);
 }
 
 uint32_t knet_loop_profile_decrease_close_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return --profile->close_channel;
+    return (uint32_t)atomic_counter_dec(&profile->close_channel);
 }
 
 uint32_t knet_loop_profile_get_close_channel_count(kloop_profile_t* profile) {
     verify(profile);
-    return profile->close_channel;
+    return (uint32_t)profile->close_channel;
 }
 
 uint64_t knet_loop_profile_add_send_bytes(kloop_profile_t* profile, uint64_t send_bytes) {
@@ -123,112 +226,495 @@ uint64_t knet_loop_profile_get_recv_bytes(kloop_profile_t* profile) {
     return profile->recv_bytes;
 }
 
-uint32_t knet_loop_profile_get_sent_bandwidth(kloop_profile_t* profile) {
-    time_t   tick      = time(0);
-    uint64_t bandwidth = 0;
-    uint64_t intval    = 0;
-    uint64_t bytes     = 0;
+void knet_loop_profile_add_busy_time(kloop_profile_t* profile, uint64_t busy_us) {
+    verify(profile);
+    profile->busy_us += busy_us;
+}
+
+void knet_loop_profile_add_wakeup(kloop_profile_t* profile, uint64_t wait_us, int events) {
     verify(profile);
-    bytes = profile->send_bytes - profile->last_send_bytes;
-    if (tick == profile->last_send_tick) {
-        /* СΪ1 */
-        intval = 1;
-    } else {
-        intval = tick - profile->last_send_tick;
+    profile->current.wait_us += wait_us;
+    profile->current.wakeup_count++;
+    if (events > 0) {
+        profile->current.wakeup_events += events;
+        if ((uint32_t)events > profile->current.wakeup_events_max) {
+            profile->current.wakeup_events_max = (uint32_t)events;
+        }
     }
-    bandwidth = bytes / intval;
-    profile->last_send_tick  = tick;
-    profile->last_send_bytes = profile->send_bytes;
-    return (uint32_t)bandwidth;
 }
 
-uint32_t knet_loop_profile_get_recv_bandwidth(kloop_profile_t* profile) {
-    time_t   tick      = time(0);
-    uint64_t bandwidth = 0;
+void knet_loop_profile_add_queue(kloop_profile_t* profile, int depth) {
+    verify(profile);
+    if (depth <= 0) {
+        return;
+    }
+    profile->current.queue_count++;
+    profile->current.queue_events += depth;
+    if ((uint32_t)depth > profile->current.queue_depth_max) {
+        profile->current.queue_depth_max = (uint32_t)depth;
+    }
+}
+
+void knet_loop_profile_add_queue_wait(kloop_profile_t* profile, uint64_t wait_us) {
+    verify(profile);
+    _loop_profile_histogram_add(&profile->current.queue_wait, wait_us);
+}
+
+void knet_loop_profile_add_callback(kloop_profile_t* profile, uint64_t cb_us, uint64_t uuid) {
+    verify(profile);
+    _loop_profile_histogram_add(&profile->current.callback, cb_us);
+    if ((cb_us >= profile->current.slowest_cb_us) && uuid) {
+        profile->current.slowest_cb_us   = (cb_us > UINT_MAX) ? UINT_MAX : (uint32_t)cb_us;
+        profile->current.slowest_cb_uuid = uuid;
+    }
+}
+
+int knet_loop_profile_sample_load(kloop_profile_t* profile, uint64_t ts) {
     uint64_t intval    = 0;
     uint64_t bytes     = 0;
+    uint64_t bandwidth = 0;
+    uint64_t busy      = 0;
+    verify(profile);
+    if (!profile->load_sample_us || (ts < profile->load_sample_us)) {
+        /* һβʱӻ, ֻ¼ */
+        profile->load_sample_us      = ts;
+        profile->load_sample_bytes   = profile->send_bytes + profile->recv_bytes;
+        profile->load_sample_busy_us = profile->busy_us;
+        return 0;
+    }
+    intval = ts - profile->load_sample_us;
+    if (intval < LOOP_LOAD_SAMPLE_INTERVAL * 1000) {
+        return 0;
+    }
+    bytes     = profile->send_bytes + profile->recv_bytes;
+    bandwidth = (bytes - profile->load_sample_bytes) * 1000000 / intval;
+    busy      = (profile->busy_us - profile->load_sample_busy_us) * 1000 / intval;
+    if (bandwidth > UINT_MAX) {
+        bandwidth = UINT_MAX;
+    }
+    if (busy > 1000) {
+        busy = 1000;
+    }
+    /* ϴβֵƽ, ƽͻ */
+    profile->load_bandwidth      = (uint32_t)(((uint64_t)profile->load_bandwidth + bandwidth) / 2);
+    profile->load_busy           = (uint32_t)((profile->load_busy + busy) / 2);
+    profile->load_sample_us      = ts;
+    profile->load_sample_bytes   = bytes;
+    profile->load_sample_busy_us = profile->busy_us;
+    _loop_profile_publish(profile, ts);
+    return 1;
+}
+
+void knet_loop_profile_publish(kloop_profile_t* profile) {
     verify(profile);
-    bytes = profile->recv_bytes - profile->last_recv_bytes;
-    if (tick == profile->last_recv_tick) {
-        /* СΪ1 */
-        intval = 1;
-    } else {
-        intval = tick - profile->last_recv_tick;
+    _loop_profile_publish(profile, time_get_microseconds());
+}
+
+void _loop_profile_publish(kloop_profile_t* profile, uint64_t ts) {
+    int      i      = 0;
+    uint64_t intval = 0;
+    uint64_t count  = 0;
+    if (ts > profile->publish_us) {
+        intval = ts - profile->publish_us;
     }
-    bandwidth = bytes / intval;
-    profile->last_recv_tick  = tick;
-    profile->last_recv_bytes = profile->recv_bytes;
-    return (uint32_t)bandwidth;
+    if (intval < 1000) {
+        /* ̣ʱӻˣʱ, С1 */
+        intval = 1000;
+    }
+    profile->current.busy_us        = profile->busy_us;
+    profile->current.send_bandwidth = _loop_profile_rate(profile->send_bytes - profile->publish_send_bytes, intval);
+    profile->current.recv_bandwidth = _loop_profile_rate(profile->recv_bytes - profile->publish_recv_bytes, intval);
+    profile->publish_send_bytes     = profile->send_bytes;
+    profile->publish_recv_bytes     = profile->recv_bytes;
+    for (i = 0; i <= ALLOCATOR_CLASS_COUNT; i++) {
+        count = knet_allocator_get_alloc_count(i);
+        profile->current.alloc_rate[i]  = _loop_profile_rate(count - profile->publish_alloc_count[i], intval);
+        profile->publish_alloc_count[i] = count;
+    }
+    profile->publish_us = ts;
+    /* Ϊʱȡ, ͬʱΪڴ */
+    atomic_counter_inc(&profile->snapshot_seq);
+    memcpy(&profile->snapshot, &profile->current, sizeof(loop_profile_snapshot_t));
+    atomic_counter_inc(&profile->snapshot_seq);
+    /* صֻͳһ */
+    profile->current.slowest_cb_us   = 0;
+    profile->current.slowest_cb_uuid = 0;
 }
 
-int knet_loop_profile_dump_file(kloop_profile_t* profile, FILE* fp) {
-    int len = 0;
+void _loop_profile_read(kloop_profile_t* profile, loop_profile_snapshot_t* snapshot, size_t size) {
+    atomic_counter_t seq = 0;
+    for (;;) {
+        /* CASֻڶȡΪڴ, ޸ */
+        seq = atomic_counter_cas(&profile->snapshot_seq, -1, -1);
+        if (seq & 1) {
+            thread_sleep_ms(0);
+            continue;
+        }
+        memcpy(snapshot, &profile->snapshot, size);
+        if (seq == atomic_counter_cas(&profile->snapshot_seq, -1, -1)) {
+            break;
+        }
+    }
+}
+
+uint32_t _loop_profile_rate(uint64_t count, uint64_t intval) {
+    uint64_t rate = count * 1000000 / intval;
+    if (rate > UINT_MAX) {
+        rate = UINT_MAX;
+    }
+    return (uint32_t)rate;
+}
+
+int _loop_profile_histogram_index(uint32_t us) {
+    int      msb = 0;
+    uint32_t v   = us;
+    if (us < LOOP_PROFILE_HISTOGRAM_SUB) {
+        return (int)us;
+    }
+    /* λ */
+    if (v >= 0x10000) { msb += 16; v >>= 16; }
+    if (v >= 0x100)   { msb += 8;  v >>= 8;  }
+    if (v >= 0x10)    { msb += 4;  v >>= 4;  }
+    if (v >= 0x4)     { msb += 2;  v >>= 2;  }
+    if (v >= 0x2)     { msb += 1; }
+    /* λ֮LOOP_PROFILE_HISTOGRAM_SUB_BITSλΪ */
+    return (msb - LOOP_PROFILE_HISTOGRAM_SUB_BITS + 1) * LOOP_PROFILE_HISTOGRAM_SUB +
+        (int)(us >> (msb - LOOP_PROFILE_HISTOGRAM_SUB_BITS)) - LOOP_PROFILE_HISTOGRAM_SUB;
+}
+
+uint64_t _loop_profile_histogram_lower(int index) {
+    if (index < LOOP_PROFILE_HISTOGRAM_SUB) {
+        return (uint64_t)index;
+    }
+    return (uint64_t)(LOOP_PROFILE_HISTOGRAM_SUB + index % LOOP_PROFILE_HISTOGRAM_SUB) <<
+        (index / LOOP_PROFILE_HISTOGRAM_SUB - 1);
+}
+
+void _loop_profile_histogram_add(loop_profile_histogram_t* histogram, uint64_t us) {
+    if (us > UINT_MAX) {
+        us = UINT_MAX;
+    }
+    histogram->bucket[_loop_profile_histogram_index((uint32_t)us)]++;
+    histogram->count++;
+    histogram->total += us;
+    if (us > histogram->max) {
+        histogram->max = (uint32_t)us;
+    }
+}
+
+uint32_t _loop_profile_histogram_percentile(loop_profile_histogram_t* histogram, int permille) {
+    int      i      = 0;
+    uint64_t target = 0;
+    uint64_t count  = 0;
+    uint64_t upper  = 0;
+    if (!histogram->count) {
+        return 0;
+    }
+    target = (histogram->count * permille + 999) / 1000;
+    if (!target) {
+        target = 1;
+    }
+    for (; i < LOOP_PROFILE_HISTOGRAM_SIZE; i++) {
+        count += histogram->bucket[i];
+        if (count >= target) {
+            break;
+        }
+    }
+    /* ȡ, ֵ */
+    upper = _loop_profile_histogram_lower(i + 1) - 1;
+    if (upper > histogram->max) {
+        upper = histogram->max;
+    }
+    return (uint32_t)upper;
+}
+
+uint64_t knet_loop_profile_get_wait_time(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
     verify(profile);
-    verify(fp);
-    len = fprintf(
-        fp,
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.wait_us;
+}
+
+uint64_t knet_loop_profile_get_busy_time(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.busy_us;
+}
+
+uint64_t knet_loop_profile_get_wakeup_count(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.wakeup_count;
+}
+
+uint64_t knet_loop_profile_get_wakeup_events(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.wakeup_events;
+}
+
+uint32_t knet_loop_profile_get_wakeup_events_max(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.wakeup_events_max;
+}
+
+uint64_t knet_loop_profile_get_queue_events(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.queue_events;
+}
+
+uint32_t knet_loop_profile_get_queue_depth_max(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.queue_depth_max;
+}
+
+void knet_loop_profile_set_latency(kloop_profile_t* profile, int on) {
+    verify(profile);
+    profile->latency = on;
+}
+
+int knet_loop_profile_check_latency(kloop_profile_t* profile) {
+    verify(profile);
+    return profile->latency;
+}
+
+uint32_t knet_loop_profile_get_queue_wait_percentile(kloop_profile_t* profile, int permille) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    verify((permille >= 0) && (permille <= 1000));
+    _loop_profile_read(profile, &snapshot, sizeof(loop_profile_snapshot_t));
+    return _loop_profile_histogram_percentile(&snapshot.queue_wait, permille);
+}
+
+uint64_t knet_loop_profile_get_callback_count(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, sizeof(loop_profile_snapshot_t));
+    return snapshot.callback.count;
+}
+
+uint32_t knet_loop_profile_get_callback_percentile(kloop_profile_t* profile, int permille) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    verify((permille >= 0) && (permille <= 1000));
+    _loop_profile_read(profile, &snapshot, sizeof(loop_profile_snapshot_t));
+    return _loop_profile_histogram_percentile(&snapshot.callback, permille);
+}
+
+uint32_t knet_loop_profile_get_slowest_callback(kloop_profile_t* profile, uint64_t* uuid) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, offsetof(loop_profile_snapshot_t, callback));
+    if (uuid) {
+        *uuid = snapshot.slowest_cb_uuid;
+    }
+    return snapshot.slowest_cb_us;
+}
+
+uint32_t knet_loop_profile_get_load_bandwidth(kloop_profile_t* profile) {
+    verify(profile);
+    return profile->load_bandwidth;
+}
+
+uint32_t knet_loop_profile_get_load_busy(kloop_profile_t* profile) {
+    verify(profile);
+    return profile->load_busy;
+}
+
+void knet_loop_profile_update_recv_buffer(kloop_profile_t* profile, uint32_t old_len, uint32_t new_len, int idle) {
+    verify(profile);
+    profile->recv_buffer_bytes = profile->recv_buffer_bytes - old_len + new_len;
+    if (idle) {
+        profile->idle_buffer_bytes = profile->idle_buffer_bytes - old_len + new_len;
+    }
+}
+
+void knet_loop_profile_increase_idle_channel_count(kloop_profile_t* profile, uint32_t recv_buffer_len) {
+    verify(profile);
+    profile->idle_channel++;
+    profile->idle_buffer_bytes += recv_buffer_len;
+}
+
+void knet_loop_profile_decrease_idle_channel_count(kloop_profile_t* profile, uint32_t recv_buffer_len) {
+    verify(profile);
+    profile->idle_channel--;
+    profile->idle_buffer_bytes -= recv_buffer_len;
+}
+
+uint64_t knet_loop_profile_get_recv_buffer_bytes(kloop_profile_t* profile) {
+    verify(profile);
+    return profile->recv_buffer_bytes;
+}
+
+uint32_t knet_loop_profile_get_idle_channel_count(kloop_profile_t* profile) {
+    verify(profile);
+    return profile->idle_channel;
+}
+
+uint32_t knet_loop_profile_get_idle_recv_buffer_len(kloop_profile_t* profile) {
+    verify(profile);
+    if (!profile->idle_channel) {
+        return 0;
+    }
+    return (uint32_t)(profile->idle_buffer_bytes / profile->idle_channel);
+}
+
+uint32_t knet_loop_profile_get_sent_bandwidth(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.send_bandwidth;
+}
+
+uint32_t knet_loop_profile_get_recv_bandwidth(kloop_profile_t* profile) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.recv_bandwidth;
+}
+
+uint64_t knet_loop_profile_get_alloc_live_bytes(kloop_profile_t* profile, int index) {
+    verify(profile);
+    return knet_allocator_get_live_bytes(index);
+}
+
+uint32_t knet_loop_profile_get_alloc_rate(kloop_profile_t* profile, int index) {
+    loop_profile_snapshot_t snapshot;
+    verify(profile);
+    verify((index >= 0) && (index <= ALLOCATOR_CLASS_COUNT));
+    _loop_profile_read(profile, &snapshot, LOOP_PROFILE_SNAPSHOT_COUNTER_SIZE);
+    return snapshot.alloc_rate[index];
+}
+
+int _loop_profile_dump_varg(FILE* fp, kstream_t* stream, const char* format, ...) {
+    char    buffer[1024] = {0};
+    int     len          = 0;
+    va_list arg_ptr;
+    va_start(arg_ptr, format);
+    len = vsnprintf(buffer, sizeof(buffer), format, arg_ptr);
+    va_end(arg_ptr);
+    if ((len <= 0) || (len >= (int)sizeof(buffer))) {
+        return error_stream_buffer_overflow;
+    }
+    if (stream) {
+        return knet_stream_push(stream, buffer, len);
+    }
+    if (fwrite(buffer, 1, len, fp) != (size_t)len) {
+        return error_fail;
+    }
+    return error_ok;
+}
+
+int _loop_profile_dump_allocator(loop_profile_snapshot_t* snapshot, FILE* fp, kstream_t* stream) {
+    int error = error_ok;
+    int i     = 0;
+    for (; i <= ALLOCATOR_CLASS_COUNT; i++) {
+        /* һΪslabڴ */
+        error = _loop_profile_dump_varg(fp, stream, (i < ALLOCATOR_CLASS_COUNT) ?
+            "Alloc class <=%-6ld live: %lld, rate: %ld(/s)\n" :
+            "Alloc class large%.0ld live: %lld, rate: %ld(/s)\n",
+            (long)knet_allocator_get_class_size(i),
+            (long long)knet_allocator_get_live_bytes(i),
+            (long)snapshot->alloc_rate[i]);
+        if (error != error_ok) {
+            return error;
+        }
+    }
+    return error_ok;
+}
+
+int _loop_profile_dump(kloop_profile_t* profile, FILE* fp, kstream_t* stream) {
+    int                      error    = error_ok;
+    loop_profile_snapshot_t* snapshot = create(loop_profile_snapshot_t);
+    verify(snapshot);
+    /* ֻȡһο, ĸͳͬһη */
+    _loop_profile_read(profile, snapshot, sizeof(loop_profile_snapshot_t));
+    error = _loop_profile_dump_varg(fp, stream,
         "Established channel: %ld\n"
         "Active channel:      %ld\n"
         "Close channel:       %ld\n"
         "Received bytes:      %lld\n"
         "Sent bytes:          %lld\n"
         "Received bandwidth:  %ld(B/s)\n"
-        "Sent bandwidth:      %ld(B/s)\n",
-        (long)knet_loop_profile_get_established_channel_count(profile),
-        (long)knet_loop_profile_get_active_channel_count(profile),
-        (long)knet_loop_profile_get_close_channel_count(profile),
-        (long long)knet_loop_profile_get_recv_bytes(profile),
-        (long long)knet_loop_profile_get_sent_bytes(profile),
-        (long)knet_loop_profile_get_recv_bandwidth(profile),
-        (long)knet_loop_profile_get_sent_bandwidth(profile));
-    if (len <= 0) {
-        return error_fail;
+        "Sent bandwidth:      %ld(B/s)\n"
+        "Recv buffer:         %lld\n"
+        "Idle channel:        %ld\n"
+        "Idle recv buffer:    %ld(B/channel)\n"
+        "Load bandwidth:      %ld(B/s)\n"
+        "Load busy:           %ld(1/1000)\n",
+        (long)profile->established_channel,
+        (long)profile->active_channel,
+        (long)profile->close_channel,
+        (long long)profile->recv_bytes,
+        (long long)profile->send_bytes,
+        (long)snapshot->recv_bandwidth,
+        (long)snapshot->send_bandwidth,
+        (long long)profile->recv_buffer_bytes,
+        (long)profile->idle_channel,
+        (long)(profile->idle_channel ? profile->idle_buffer_bytes / profile->idle_channel : 0),
+        (long)profile->load_bandwidth,
+        (long)profile->load_busy);
+    if (error == error_ok) {
+        error = _loop_profile_dump_varg(fp, stream,
+            "Wait/busy time:      %lld/%lld(us)\n"
+            "Wakeup:              %lld, events avg/max: %lld/%ld\n"
+            "Event queue:         %lld, depth avg/max: %lld/%ld\n",
+            (long long)snapshot->wait_us,
+            (long long)snapshot->busy_us,
+            (long long)snapshot->wakeup_count,
+            (long long)(snapshot->wakeup_count ? snapshot->wakeup_events / snapshot->wakeup_count : 0),
+            (long)snapshot->wakeup_events_max,
+            (long long)snapshot->queue_events,
+            (long long)(snapshot->queue_count ? snapshot->queue_events / snapshot->queue_count : 0),
+            (long)snapshot->queue_depth_max);
     }
-    return error_ok;
+    if ((error == error_ok) && (snapshot->queue_wait.count || snapshot->callback.count)) {
+        /* ӳͳʱ */
+        error = _loop_profile_dump_varg(fp, stream,
+            "Queue wait:          p50/p99/p999/max: %ld/%ld/%ld/%ld(us)\n"
+            "Callback:            %lld, p50/p99/p999/max: %ld/%ld/%ld/%ld(us)\n"
+            "Slowest callback:    %ld(us), channel[%llu]\n",
+            (long)_loop_profile_histogram_percentile(&snapshot->queue_wait, 500),
+            (long)_loop_profile_histogram_percentile(&snapshot->queue_wait, 990),
+            (long)_loop_profile_histogram_percentile(&snapshot->queue_wait, 999),
+            (long)snapshot->queue_wait.max,
+            (long long)snapshot->callback.count,
+            (long)_loop_profile_histogram_percentile(&snapshot->callback, 500),
+            (long)_loop_profile_histogram_percentile(&snapshot->callback, 990),
+            (long)_loop_profile_histogram_percentile(&snapshot->callback, 999),
+            (long)snapshot->callback.max,
+            (long)snapshot->slowest_cb_us,
+            (unsigned long long)snapshot->slowest_cb_uuid);
+    }
+    if (error == error_ok) {
+        error = _loop_profile_dump_allocator(snapshot, fp, stream);
+    }
+    destroy(snapshot);
+    return error;
+}
+
+int knet_loop_profile_dump_file(kloop_profile_t* profile, FILE* fp) {
+    verify(profile);
+    verify(fp);
+    return _loop_profile_dump(profile, fp, 0);
 }
 
 int knet_loop_profile_dump_stream(kloop_profile_t* profile, kstream_t* stream) {
     verify(profile);
     verify(stream);
-    return knet_stream_push_varg(
-        stream,
-        "Established channel: %ld\n"
-        "Active channel:      %ld\n"
-        "Close channel:       %ld\n"
-        "Received bytes:      %lld\n"
-        "Sent bytes:          %lld\n"
-        "Received bandwidth:  %ld(B/s)\n"
-        "Sent bandwidth:      %ld(B/s)\n",
-        (long)knet_loop_profile_get_established_channel_count(profile),
-        (long)knet_loop_profile_get_active_channel_count(profile),
-        (long)knet_loop_profile_get_close_channel_count(profile),
-        (long long)knet_loop_profile_get_recv_bytes(profile),
-        (long long)knet_loop_profile_get_sent_bytes(profile),
-        (long)knet_loop_profile_get_recv_bandwidth(profile),
-        (long)knet_loop_profile_get_sent_bandwidth(profile));
+    return _loop_profile_dump(profile, 0, stream);
 }
 
 int knet_loop_profile_dump_stdout(kloop_profile_t* profile) {
-    int len = 0;
     verify(profile);
-    len = fprintf(
-        stdout,
-        "Established channel: %ld\n"
-        "Active channel:      %ld\n"
-        "Close channel:       %ld\n"
-        "Received bytes:      %lld\n"
-        "Sent bytes:          %lld\n"
-        "Received bandwidth:  %ld(B/s)\n"
-        "Sent bandwidth:      %ld(B/s)\n",
-        (long)knet_loop_profile_get_established_channel_count(profile),
-        (long)knet_loop_profile_get_active_channel_count(profile),
-        (long)knet_loop_profile_get_close_channel_count(profile),
-        (long long)knet_loop_profile_get_recv_bytes(profile),
-        (long long)knet_loop_profile_get_sent_bytes(profile),
-        (long)knet_loop_profile_get_recv_bandwidth(profile),
-        (long)knet_loop_profile_get_sent_bandwidth(profile));
-    if (len <= 0) {
-        return error_fail;
-    }
-    return error_ok;
+    return _loop_profile_dump(profile, stdout, 0);
 }
@@ -99,4 +99,81 @@ uint64_t knet_loop_profile_add_send_bytes(kloop_profile_t* profile, uint64_t sen
  */
 uint64_t knet_loop_profile_add_recv_bytes(kloop_profile_t* profile, uint64_t recv_bytes);
 
+/**
+ * ܵջȱ仯, ܵʱԭΪ0, 뿪ʱ³Ϊ0
+ * @param profile kloop_profile_tʵ
+ * @param old_len ԭ
+ * @param new_len ³
+ * @param idle ܵǷΪйܵ
+ */
+void knet_loop_profile_update_recv_buffer(kloop_profile_t* profile, uint32_t old_len, uint32_t new_len, int idle);
+
+/**
+ * ӿйܵ
+ * @param profile kloop_profile_tʵ
+ * @param recv_buffer_len йܵջ
+ */
+void knet_loop_profile_increase_idle_channel_count(kloop_profile_t* profile, uint32_t recv_buffer_len);
+
+/**
+ * ٿйܵ
+ * @param profile kloop_profile_tʵ
+ * @param recv_buffer_len йܵջ
+ */
+void knet_loop_profile_decrease_idle_channel_count(kloop_profile_t* profile, uint32_t recv_buffer_len);
+
+/**
+ * ¼ʱ
+ * @param profile kloop_profile_tʵ
+ * @param busy_us ѡȡغ¼ĺʱ΢룩
+ */
+void knet_loop_profile_add_busy_time(kloop_profile_t* profile, uint64_t busy_us);
+
+/**
+ * ¼һѡȡ
+ * @param profile kloop_profile_tʵ
+ * @param wait_us ѡȡڵȴĺʱ΢룩
+ * @param events λʱ¼
+ */
+void knet_loop_profile_add_wakeup(kloop_profile_t* profile, uint64_t wait_us, int events);
+
+/**
+ * ¼һο߳¼д
+ * @param profile kloop_profile_tʵ
+ * @param depth δ¼
+ */
+void knet_loop_profile_add_queue(kloop_profile_t* profile, int depth);
+
+/**
+ * ¼һ߳¼ͶݵŶӳ
+ * @param profile kloop_profile_tʵ
+ * @param wait_us Ŷӳ٣΢룩
+ */
+void knet_loop_profile_add_queue_wait(kloop_profile_t* profile, uint64_t wait_us);
+
+/**
+ * ¼һιܵصʱ
+ * @param profile kloop_profile_tʵ
+ * @param cb_us صʱ΢룩
+ * @param uuid ܵUUID
+ */
+void knet_loop_profile_add_callback(kloop_profile_t* profile, uint64_t cb_us, uint64_t uuid);
+
+/**
+ * kloop_t߳ͳƿ
+ *
+ * ͨڸزʱ, ¼ѭ˳ʱԷͳ
+ * @param profile kloop_profile_tʵ
+ */
+void knet_loop_profile_publish(kloop_profile_t* profile);
+
+/**
+ * ز, ÿѭ, ϴβLOOP_LOAD_SAMPLE_INTERVALʱշʼæµͳƿ
+ * @param profile kloop_profile_tʵ
+ * @param ts ǰʱ΢룩
+ * @retval 0 δʱ
+ * @retval 1 Ѹ²ֵ
+ */
+int knet_loop_profile_sample_load(kloop_profile_t* profile, uint64_t ts);
+
 #endif /* LOOP_PROFILE_H */
@@ -64,18 +64,187 @@ extern uint64_t knet_loop_profile_get_recv_bytes(kloop_profile_t* profile);
 
 /**
  * ȡ÷ʹ
+ *
+ * ȡһηͳƿ, ȡ޸״̬, ̵߳
  * @param profile kloop_profile_tʵ
- * @return (ֽ/)
+ * @return ϸĴ(ֽ/)
  */
 extern uint32_t knet_loop_profile_get_sent_bandwidth(kloop_profile_t* profile);
 
 /**
  * ȡýմ
+ *
+ * ȡһηͳƿ, ȡ޸״̬, ̵߳
  * @param profile kloop_profile_tʵ
- * @return (ֽ/)
+ * @return ϸĴ(ֽ/)
  */
 extern uint32_t knet_loop_profile_get_recv_bandwidth(kloop_profile_t* profile);
 
+/**
+ * ȡշ
+ *
+ * kloop_tLOOP_LOAD_SAMPLE_INTERVAL, ȡ޸״̬, ̵߳
+ * @param profile kloop_profile_tʵ
+ * @return շ(ֽ/)
+ */
+extern uint32_t knet_loop_profile_get_load_bandwidth(kloop_profile_t* profile);
+
+/**
+ * ȡæµ
+ *
+ * ѡȡغ¼ĺʱռı, ȡ޸״̬, ̵߳
+ * @param profile kloop_profile_tʵ
+ * @return æµ(ǧֱ)
+ */
+extern uint32_t knet_loop_profile_get_load_busy(kloop_profile_t* profile);
+
+/**
+ * ȡйܵջռõֽ
+ *
+ * ջʱ
+ * @param profile kloop_profile_tʵ
+ * @return ջռõֽ
+ */
+extern uint64_t knet_loop_profile_get_recv_buffer_bytes(kloop_profile_t* profile);
+
+/**
+ * ȡÿйܵ
+ *
+ * ջ󳬹CHANNEL_RECV_BUFFER_IDLEδյݵĹܵ, ٴյݺٿ
+ * @param profile kloop_profile_tʵ
+ * @return йܵ
+ */
+extern uint32_t knet_loop_profile_get_idle_channel_count(kloop_profile_t* profile);
+
+/**
+ * ȡƽÿйܵջռõֽ
+ * @param profile kloop_profile_tʵ
+ * @return ÿйܵջռõֽ
+ */
+extern uint32_t knet_loop_profile_get_idle_recv_buffer_len(kloop_profile_t* profile);
+
+/**
+ * ȡڴȵȼǰδͷŵֽ
+ *
+ * ͳΪ̵߳ܺ, ÿkloop_tȡõֵͬ
+ * @param profile kloop_profile_tʵ
+ * @param index ȵȼ, μknet_allocator_get_class_count()
+ * @return δͷŵֽ
+ */
+extern uint64_t knet_loop_profile_get_alloc_live_bytes(kloop_profile_t* profile, int index);
+
+/**
+ * ȡڴȵȼķ
+ *
+ * ȡһηͳƿ, ȡ޸״̬, ̵߳
+ * @param profile kloop_profile_tʵ
+ * @param index ȵȼ, μknet_allocator_get_class_count()
+ * @return ϸķ(/)
+ */
+extern uint32_t knet_loop_profile_get_alloc_rate(kloop_profile_t* profile, int index);
+
+/*
+ * ͳkloop_t߳ÿLOOP_LOAD_SAMPLE_INTERVAL뷢һο(¼ѭ˳ʱҲᷢ),
+ * ߳ȡ, ȡ޸״̬Ҳkloop_t߳
+ */
+
+/**
+ * ȡѡȡڵȴۼƺʱ
+ * @param profile kloop_profile_tʵ
+ * @return ۼƺʱ΢룩
+ */
+extern uint64_t knet_loop_profile_get_wait_time(kloop_profile_t* profile);
+
+/**
+ * ȡѡȡغ¼صۼƺʱ
+ * @param profile kloop_profile_tʵ
+ * @return ۼƺʱ΢룩
+ */
+extern uint64_t knet_loop_profile_get_busy_time(kloop_profile_t* profile);
+
+/**
+ * ȡѡȡѴ
+ * @param profile kloop_profile_tʵ
+ * @return Ѵ
+ */
+extern uint64_t knet_loop_profile_get_wakeup_count(kloop_profile_t* profile);
+
+/**
+ * ȡûʱ¼ۼ, ԻѴΪƽÿλѴ¼
+ * @param profile kloop_profile_tʵ
+ * @return ¼ۼ
+ */
+extern uint64_t knet_loop_profile_get_wakeup_events(kloop_profile_t* profile);
+
+/**
+ * ȡõλѾ¼
+ * @param profile kloop_profile_tʵ
+ * @return ¼
+ */
+extern uint32_t knet_loop_profile_get_wakeup_events_max(kloop_profile_t* profile);
+
+/**
+ * ȡѴĿ߳¼
+ * @param profile kloop_profile_tʵ
+ * @return ߳¼
+ */
+extern uint64_t knet_loop_profile_get_queue_events(kloop_profile_t* profile);
+
+/**
+ * ȡõδʱ߳¼е
+ * @param profile kloop_profile_tʵ
+ * @return 
+ */
+extern uint32_t knet_loop_profile_get_queue_depth_max(kloop_profile_t* profile);
+
+/**
+ * رտ߳¼Ŷӳټܵصʱͳ, ĬϹر
+ *
+ * ÿͶ¼ûصʱҪȡʱ, رʱֻһж, ߳ڵ
+ * @param profile kloop_profile_tʵ
+ * @param on 㿪, 0ر
+ */
+extern void knet_loop_profile_set_latency(kloop_profile_t* profile, int on);
+
+/**
+ * Ƿӳͳ
+ * @param profile kloop_profile_tʵ
+ * @retval 0 ر
+ * @retval  
+ */
+extern int knet_loop_profile_check_latency(kloop_profile_t* profile);
+
+/**
+ * ȡÿ߳¼ͶݵʼŶӳٰٷλ, ֻͳƿӳͳڼ¼
+ * @param profile kloop_profile_tʵ
+ * @param permille ٷλǧֱȣ, 990Ϊp99, 1000Ϊֵ
+ * @return Ŷӳ٣΢룩, 1/8
+ */
+extern uint32_t knet_loop_profile_get_queue_wait_percentile(kloop_profile_t* profile, int permille);
+
+/**
+ * ȡùܵص, ֻͳƿӳͳڼĻص
+ * @param profile kloop_profile_tʵ
+ * @return ص
+ */
+extern uint64_t knet_loop_profile_get_callback_count(kloop_profile_t* profile);
+
+/**
+ * ȡùܵصʱٷλ, ֻͳƿӳͳڼĻص
+ * @param profile kloop_profile_tʵ
+ * @param permille ٷλǧֱȣ, 990Ϊp99, 1000Ϊֵ
+ * @return صʱ΢룩, 1/8
+ */
+extern uint32_t knet_loop_profile_get_callback_percentile(kloop_profile_t* profile, int permille);
+
+/**
+ * ȡϸĹܵص, ֻͳƿӳͳڼĻص
+ * @param profile kloop_profile_tʵ
+ * @param uuid صܵUUID, Ϊ0
+ * @return صʱ΢룩
+ */
+extern uint32_t knet_loop_profile_get_slowest_callback(kloop_profile_t* profile, uint64_t* uuid);
+
 /**
  * ͳϢдļ
  * @param profile kloop_profile_tʵ
@@ -28,10 +28,12 @@
 #include "list.h"
 #include "channel_ref.h"
 #include "logger.h"
+#include "misc.h"
 
 typedef struct _loop_select_t {
-    fd_set read_fds[FD_SETSIZE]; /* select */
-    fd_set send_fds[FD_SETSIZE]; /* selectд */
+    fd_set   read_fds[FD_SETSIZE]; /* select */
+    fd_set   send_fds[FD_SETSIZE]; /* selectд */
+    socket_t notify_pair[2];       /* ¼֪ͨܵ, 0д, 1˶ */
 } loop_select_t;
 
 int knet_impl_create(kloop_t* loop) {
@@ -43,27 +45,44 @@ int knet_impl_create(kloop_t* loop) {
 #if defined(WIN32) || defined(WIN64)
     WSAStartup(MAKEWORD(2, 2), &wsa);
 #endif /* defined(WIN32) || defined(WIN64) */
+    if (socket_pair(impl->notify_pair)) {
+        destroy(impl);
+        return error_loop_fail;
+    }
+    socket_set_non_blocking_on(impl->notify_pair[0]);
+    socket_set_non_blocking_on(impl->notify_pair[1]);
     return error_ok;
 }
 
 void knet_impl_destroy(kloop_t* loop) {
-    destroy(knet_loop_get_impl(loop));
+    loop_select_t* impl = (loop_select_t*)knet_loop_get_impl(loop);
+    socket_close(impl->notify_pair[0]);
+    socket_close(impl->notify_pair[1]);
+    destroy(impl);
 #if defined(WIN32) || defined(WIN64)
     WSACleanup();
 #endif /* defined(WIN32) || defined(WIN64) */
 }
 
-int _select(kloop_t* loop) {
+int _select(kloop_t* loop, int* count) {
     socket_t max_fd = 0;
     socket_t fd = 0;
     int error = 0;
     dlist_node_t* node = 0;
     dlist_node_t* temp = 0;
     kchannel_ref_t* channel_ref = 0;
-    struct timeval tv = {0, 100}; /* תʱȴ1ms */
+    int wait = 0;
+    struct timeval tv = {0, 0};
     loop_select_t* impl = (loop_select_t*)knet_loop_get_impl(loop);
+    /* ȴĳʱ̶, ߳¼ͨܵ */
+    wait = knet_loop_get_wait_timeout(loop);
+    tv.tv_sec = wait / 1000;
+    tv.tv_usec = (wait % 1000) * 1000;
     FD_ZERO(impl->read_fds);
     FD_ZERO(impl->send_fds);
+    /* ¼֪ͨ */
+    FD_SET(impl->notify_pair[1], impl->read_fds);
+    max_fd = impl->notify_pair[1];
     dlist_for_each_safe(knet_loop_get_active_list(loop), node, temp) {
         channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
         fd = knet_channel_ref_get_socket_fd(channel_ref);
@@ -82,6 +101,7 @@ int _select(kloop_t* loop) {
     if (0 > error) {
         return error_loop_fail;
     }
+    *count = error;
     return error_ok;
 }
 
@@ -90,12 +110,21 @@ int knet_impl_run_once(kloop_t* loop) {
     dlist_node_t* temp = 0;
     kchannel_ref_t* channel_ref = 0;
     socket_t fd = 0;
-    time_t ts = time(0);
+    char buffer[64] = {0};
+    time_t ts = 0;
     loop_select_t* impl = (loop_select_t*)knet_loop_get_impl(loop);
-    int error = _select(loop);
+    int count = 0;
+    int error = _select(loop, &count);
     if (error != error_ok) {
         return error;
     }
+    /* ˽ϳʱ, ȴʱ */
+    ts = knet_loop_wakeup(loop, count);
+    if (FD_ISSET(impl->notify_pair[1], impl->read_fds)) {
+        /* չܵ¼ */
+        while (socket_recv(impl->notify_pair[1], buffer, sizeof(buffer)) > 0);
+        knet_loop_notify_process(loop);
+    }
     dlist_for_each_safe(knet_loop_get_active_list(loop), node, temp) {
         channel_ref = (kchannel_ref_t*)dlist_node_get_data(node);
         fd = knet_channel_ref_get_socket_fd(channel_ref);
@@ -128,6 +157,13 @@ int knet_impl_event_remove(kchannel_ref_t* channel_ref, knet_channel_event_e e)
     return error_ok;
 }
 
+int knet_impl_event_rearm(kchannel_ref_t* channel_ref, knet_channel_event_e e) {
+    /* ˮƽ, Ҫ */
+    channel_ref;
+    e;
+    return error_ok;
+}
+
 int knet_impl_add_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
     loop;
     channel_ref;
@@ -140,4 +176,17 @@ int knet_impl_remove_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
     return error_ok;
 }
 
+int knet_impl_migrate_channel_ref(kloop_t* loop, kchannel_ref_t* channel_ref) {
+    /* ÿѭԾ, 뿪ѡȡ */
+    loop;
+    channel_ref;
+    return error_ok;
+}
+
+void knet_impl_notify(kloop_t* loop) {
+    char c = 0;
+    loop_select_t* impl = (loop_select_t*)knet_loop_get_impl(loop);
+    socket_send(impl->notify_pair[0], &c, sizeof(c));
+}
+
 #endif
@@ -22,6 +22,10 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE /* accept4 */
+#endif /* defined(__linux__) && !defined(_GNU_SOURCE) */
+
 #include <stdarg.h>
 #if !defined(WIN32)
     #include <linux/tcp.h> /* TCP_NODELAY */
@@ -29,20 +33,24 @@
 
 #include "misc.h"
 #include "loop.h"
+#include "loop_profile.h"
 #include "channel_ref.h"
 #include "address.h"
 #include "timer.h"
 #include "list.h"
 #include "logger.h"
+#include "allocator.h"
 
 
 struct _thread_runner_t {
     knet_thread_func_t func;         /* ̺߳ */
     void*              params;       /*  */
     kdlist_t*          multi_params; /*  */
+    kloop_t*           loop;         /* ߳еkloop_t, ֹͣʱ */
     volatile int       running;      /* б־ */
     volatile int       stop;         /* ˳־ */
     thread_id_t        thread_id;    /* ߳ID */
+    int                tls_init;     /* TLSǷѽ, 0ҲЧļ */
 #if defined(WIN32)
     HANDLE thread_handle;            /* WIN32߳̾ */
     DWORD  tls_key;                  /* WIN32 TLS */
@@ -62,9 +70,7 @@ typedef struct _thread_param_t {
 } thread_param_t;
 
 void destroy(void* ptr) {
-    if (ptr) {
-        free(ptr);
-    }
+    knet_free(ptr);
 }
 
 socket_t socket_create() {
@@ -164,20 +170,42 @@ socket_t socket_accept(socket_t socket_fd) {
     socket_t     client_fd = 0; /* ͻ׽ */
     socket_len_t addr_len  = sizeof(struct sockaddr_in);
     struct sockaddr_in sa;
-    memset(&sa, 0, sizeof(sa));
-    /* ܿͻ */
-    client_fd = accept(socket_fd, (struct sockaddr*)&sa, &addr_len);
+    for (;;) {
+        memset(&sa, 0, sizeof(sa));
+        addr_len = sizeof(struct sockaddr_in);
+        /* ܿͻ */
+#if defined(__linux__) && defined(SOCK_NONBLOCK)
+        /* һϵͳɷ */
+        client_fd = accept4(socket_fd, (struct sockaddr*)&sa, &addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        client_fd = accept(socket_fd, (struct sockaddr*)&sa, &addr_len);
+#endif /* defined(__linux__) && defined(SOCK_NONBLOCK) */
 #if defined(WIN32)
-    if (INVALID_SOCKET == client_fd) {
-        log_error("accept() failed, system error: %d", sys_get_errno());
-        return 0;
-    }
+        if (INVALID_SOCKET == client_fd) {
+            if (WSAEWOULDBLOCK != sys_get_errno()) {
+                log_error("accept() failed, system error: %d", sys_get_errno());
+            }
+            return 0;
+        }
 #else
-    if (client_fd < 0) {
-        log_error("accept() failed, system error: %d", sys_get_errno());
-        return 0;
+        if (client_fd < 0) {
+            if ((EINTR == errno) || (ECONNABORTED == errno)) {
+                /* źжϻԶaccept֮ǰѹر, һ */
+                continue;
+            }
+            if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+                log_error("accept() failed, system error: %d", sys_get_errno());
+            }
+            /* ûеȴܵ */
+            return 0;
+        }
+#endif /* defined(WIN32) */
+        break;
     }
-#endif /* defined(WIN32) */    
+#if !defined(__linux__) || !defined(SOCK_NONBLOCK)
+    /* Ϊ */
+    socket_set_non_blocking_on(client_fd);
+#endif /* !defined(__linux__) || !defined(SOCK_NONBLOCK) */
     return client_fd;
 }
 
@@ -186,6 +214,16 @@ int socket_set_reuse_addr_on(socket_t socket_fd) {
     return setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&reuse_addr , sizeof(reuse_addr));
 }
 
+int socket_set_reuse_port_on(socket_t socket_fd) {
+#if defined(SO_REUSEPORT)
+    int reuse_port = 1;
+    return setsockopt(socket_fd, SOL_SOCKET, SO_REUSEPORT, (char*)&reuse_port , sizeof(reuse_port));
+#else
+    (void)socket_fd;
+    return -1;
+#endif /* defined(SO_REUSEPORT) */
+}
+
 int socket_set_non_blocking_on(socket_t socket_fd) {
 #if defined(WIN32)
     u_long nonblocking = 1;
@@ -299,6 +337,69 @@ int socket_send(socket_t socket_fd, const char* data, uint32_t size) {
     return send_bytes;
 }
 
+int socket_sendv(socket_t socket_fd, const kiovec_t* iov, int count) {
+    int      i          = 0;
+    int      send_bytes = 0;
+    uint32_t size       = 0;
+#if defined(WIN32)
+    DWORD  error = 0;
+    DWORD  bytes = 0;
+    WSABUF buffers[CHANNEL_SEND_IOV_MAX];
+#else
+    struct msghdr msg;
+    struct iovec  buffers[CHANNEL_SEND_IOV_MAX];
+#endif /* defined(WIN32) */
+    verify(iov);
+    if (count > CHANNEL_SEND_IOV_MAX) {
+        count = CHANNEL_SEND_IOV_MAX;
+    }
+    for (; i < count; i++) {
+    #if defined(WIN32)
+        buffers[i].buf = (char*)iov[i].buffer;
+        buffers[i].len = (ULONG)iov[i].size;
+    #else
+        buffers[i].iov_base = (void*)iov[i].buffer;
+        buffers[i].iov_len  = (size_t)iov[i].size;
+    #endif /* defined(WIN32) */
+        size += (uint32_t)iov[i].size;
+    }
+#if defined(WIN32)
+    if (SOCKET_ERROR == WSASend(socket_fd, buffers, (DWORD)count, &bytes, 0, 0, 0)) {
+        send_bytes = -1;
+    } else {
+        send_bytes = (int)bytes;
+    }
+#else
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = buffers;
+    msg.msg_iovlen = count;
+    /* writev()ڶԶ˹رʱᴥSIGPIPE, ʹsendmsg() */
+    send_bytes = (int)sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+#endif /* defined(WIN32) */
+    if (send_bytes < 0) {
+    #if defined(WIN32)
+        error = GetLastError();
+        if ((error == 0) || (error == WSAEINTR) || (error == WSAEINPROGRESS) || (error == WSAEWOULDBLOCK)) {
+            return 0;
+        } else {
+            log_error("WSASend() failed, system error: %d", sys_get_errno());
+            send_bytes = -1;
+        }
+    #else
+        if ((errno == 0) || (errno == EAGAIN ) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+            return 0;
+        } else {
+            log_error("sendmsg() failed, system error: %d", sys_get_errno());
+            send_bytes = -1;
+        }
+    #endif /* defined(WIN32) */
+    } else if (!send_bytes && size) {
+        log_error("sendmsg() failed, system error: %d", sys_get_errno());
+        return -1;
+    }
+    return send_bytes;
+}
+
 int socket_recv(socket_t socket_fd, char* data, uint32_t size) {
     int recv_bytes = 0;
 #if defined(WIN32)
@@ -461,6 +562,24 @@ int socket_getpeername(kchannel_ref_t* channel_ref, kaddress_t* address) {
     return error_ok;
 }
 
+int socket_get_peer_ip(socket_t socket_fd, char* ip, int size) {
+    struct sockaddr_in addr;
+    socket_len_t len = sizeof(struct sockaddr);
+    verify(ip);
+    verify(size > 0);
+    if (getpeername(socket_fd, (struct sockaddr*)&addr, &len) < 0) {
+        log_error("getpeername() failed, system error: %d", sys_get_errno());
+        return error_getpeername;
+    }
+#if defined(WIN32)
+    strncpy(ip, inet_ntoa(addr.sin_addr), size - 1);
+    ip[size - 1] = 0;
+#else
+    inet_ntop(AF_INET, &addr.sin_addr.s_addr, ip, size);
+#endif /* defined(WIN32) */
+    return error_ok;
+}
+
 int socket_getsockname(kchannel_ref_t* channel_ref,kaddress_t* address) {
 #if defined(WIN32)
     char* ip;
@@ -601,7 +720,7 @@ void thread_runner_destroy(kthread_runner_t* runner) {
         thread_runner_stop(runner);
     }
     thread_runner_join(runner);
-    if (runner->tls_key) {
+    if (runner->tls_init) {
 #if defined(WIN32)
         TlsFree(runner->tls_key);
 #else
@@ -621,6 +740,7 @@ void _thread_func(void* params) {
     verify(params);
     runner = (kthread_runner_t*)params;
     runner->func(runner);
+    knet_allocator_thread_flush();
 }
 
 void _thread_loop_func(void* params) {
@@ -634,6 +754,9 @@ void _thread_loop_func(void* params) {
             verify(0);
         }
     }
+    /* ͳ, ߳˳߳ԿԶȡ */
+    knet_loop_profile_publish(knet_loop_get_profile(loop));
+    knet_allocator_thread_flush();
     runner->stop = 1;
 }
 
@@ -645,14 +768,45 @@ void _thread_timer_loop_func(void* params) {
         thread_sleep_ms(tick);
         ktimer_loop_run_once(loop);
     }
+    knet_allocator_thread_flush();
     runner->stop = 1;
 }
 
 void _thread_multi_loop_func(void* params) {
-    kthread_runner_t* runner = (kthread_runner_t*)params;
-    kdlist_node_t*    node   = 0;
-    thread_param_t*  param  = 0;
+    kthread_runner_t* runner     = (kthread_runner_t*)params;
+    kdlist_node_t*    node       = 0;
+    thread_param_t*  param      = 0;
+    int               loop_count = 0;
+    int               wait       = 0;
+    int               timer_wait = 0;
+    dlist_for_each(runner->multi_params, node) {
+        param = (thread_param_t*)dlist_node_get_data(node);
+        if (param->type == loop_type_loop) {
+            loop_count++;
+        }
+    }
     while (thread_runner_check_start(runner)) {
+        /* kloop_tʱ䲻ܳĶʱ̶ */
+        wait = -1;
+        dlist_for_each(runner->multi_params, node) {
+            param = (thread_param_t*)dlist_node_get_data(node);
+            if (param->type == loop_type_timer) {
+                timer_wait = ktimer_loop_get_wait_timeout((ktimer_loop_t*)param->loop);
+                if ((timer_wait >= 0) && ((wait < 0) || (timer_wait < wait))) {
+                    wait = timer_wait;
+                }
+            }
+        }
+        if ((loop_count > 1) && ((wait < 0) || (wait > 1))) {
+            /* kloop_t, ܳʱһ */
+            wait = 1;
+        }
+        dlist_for_each(runner->multi_params, node) {
+            param = (thread_param_t*)dlist_node_get_data(node);
+            if (param->type == loop_type_loop) {
+                knet_loop_set_wait_limit((kloop_t*)param->loop, wait);
+            }
+        }
         dlist_for_each(runner->multi_params, node) {
             param = (thread_param_t*)dlist_node_get_data(node);
             if (param->type == loop_type_loop) {
@@ -662,6 +816,14 @@ void _thread_multi_loop_func(void* params) {
             }
         }
     }
+    /* ͳ, ߳˳߳ԿԶȡ */
+    dlist_for_each(runner->multi_params, node) {
+        param = (thread_param_t*)dlist_node_get_data(node);
+        if (param->type == loop_type_loop) {
+            knet_loop_profile_publish(knet_loop_get_profile((kloop_t*)param->loop));
+        }
+    }
+    knet_allocator_thread_flush();
     runner->stop = 1;
 }
 
@@ -755,6 +917,7 @@ int thread_runner_start_loop(kthread_runner_t* runner, kloop_t* loop, int stack_
     verify(runner);
     verify(loop);
     runner->params = loop;
+    runner->loop = loop;
     runner->running = 1;
 #if defined(WIN32)
     retval = _beginthread(thread_loop_func_win, stack_size, runner);
@@ -874,8 +1037,20 @@ int thread_runner_start_multi_loop_varg(kthread_runner_t* runner, int stack_size
 }
 
 void thread_runner_stop(kthread_runner_t* runner) {
+    kdlist_node_t*   node  = 0;
+    thread_param_t* param = 0;
     verify(runner);
     runner->running = 0;
+    /* ѡȡڵkloop_t */
+    if (runner->loop) {
+        knet_loop_notify(runner->loop);
+    }
+    dlist_for_each(runner->multi_params, node) {
+        param = (thread_param_t*)dlist_node_get_data(node);
+        if (param->type == loop_type_loop) {
+            knet_loop_notify((kloop_t*)param->loop);
+        }
+    }
 }
 
 thread_id_t thread_runner_get_id(kthread_runner_t* runner) {
@@ -929,7 +1104,7 @@ void thread_sleep_ms(int ms) {
 
 int thread_set_tls_data(kthread_runner_t* runner, void* data) {
     verify(runner);
-    if (!runner->tls_key) {
+    if (!runner->tls_init) {
 #if defined(WIN32)
         runner->tls_key = TlsAlloc();
         if (runner->tls_key == TLS_OUT_OF_INDEXES) {
@@ -942,6 +1117,7 @@ int thread_set_tls_data(kthread_runner_t* runner, void* data) {
             return error_set_tls_fail;
         }
 #endif /* defined(WIN32) */
+        runner->tls_init = 1;
     }
 #if defined(WIN32)
     if (FALSE == TlsSetValue(runner->tls_key, data)) {
@@ -959,6 +1135,9 @@ int thread_set_tls_data(kthread_runner_t* runner, void* data) {
 
 void* thread_get_tls_data(kthread_runner_t* runner) {
     verify(runner);
+    if (!runner->tls_init) {
+        return 0;
+    }
 #if defined(WIN32)
     return TlsGetValue(runner->tls_key);
 #else
@@ -1046,6 +1225,23 @@ uint64_t time_get_microseconds() {
 #endif /* defined(WIN32) */
 }
 
+uint64_t time_get_monotonic_milliseconds() {
+#if defined(WIN32)
+    return GetTickCount64();
+#else
+    struct timespec ts;
+    uint64_t ms;
+#if defined(CLOCK_MONOTONIC_COARSE)
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif /* defined(CLOCK_MONOTONIC_COARSE) */
+    ms = (uint64_t)ts.tv_sec * 1000;
+    ms += ts.tv_nsec / 1000000;
+    return ms;
+#endif /* defined(WIN32) */
+}
+
 uint64_t uuid_create() {
     static atomic_counter_t fack_uuid_low  = 0;
     static atomic_counter_t fack_uuid_high = 1;
@@ -1111,6 +1307,8 @@ const char* get_channel_cb_event_string(knet_channel_cb_event_e e) {
         return "channel idle timeout because there is no bytes received according to the idle timeout setting";
     case channel_cb_event_connect_timeout:
         return "channel try to connect remote host failed because the connect timeout setting reached";
+    case channel_cb_event_send_drained:
+        return "channel send list drained to the low watermark after writes were refused";
     }
     return "unknown channel callback event";
 }
@@ -1131,6 +1329,8 @@ const char* get_channel_cb_event_name(knet_channel_cb_event_e e) {
         return "channel_cb_event_timeout";
     case channel_cb_event_connect_timeout:
         return "channel_cb_event_connect_timeout";
+    case channel_cb_event_send_drained:
+        return "channel_cb_event_send_drained";
     }
     return "unknown channel callback event";
 }
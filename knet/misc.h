@@ -59,8 +59,10 @@ int socket_bind_and_listen(socket_t socket_fd, const char* ip, int port, int bac
 
 /**
  * accept
+ *
+ * ص׽ѱΪ, Linuxʹaccept4һ
  * @param socket_fd ׽
- * @retval 0 ʧ
+ * @retval 0 ʧܻûеȴܵ
  * @retval Ч׽
  */
 socket_t socket_accept(socket_t socket_fd);
@@ -81,6 +83,16 @@ int socket_close(socket_t socket_fd);
  */
 int socket_set_reuse_addr_on(socket_t socket_fd);
 
+/**
+ * ˿(SO_REUSEPORT)
+ *
+ * ׽ֿԼͬһIP:˿, ں˷
+ * @param socket_fd
+ * @retval 0 ɹ
+ * @retval  ʧܻϵͳ֧
+ */
+int socket_set_reuse_port_on(socket_t socket_fd);
+
 /**
  * ׽ַ
  * @param socket_fd
@@ -153,6 +165,16 @@ int socket_set_send_buffer_size(socket_t socket_fd, int size);
  */
 int socket_send(socket_t socket_fd, const char* data, uint32_t size);
 
+/**
+ * ۼ, һϵͳ÷Ͷݿ
+ * @param socket_fd
+ * @param iov ݿ
+ * @param count ݿ, CHANNEL_SEND_IOV_MAXĲֱβ
+ * @retval >=0 ͵ֽ
+ * @retval  ʧ
+ */
+int socket_sendv(socket_t socket_fd, const kiovec_t* iov, int count);
+
 /**
  * 
  * @param socket_fd
@@ -175,6 +197,16 @@ int socket_pair(socket_t pair[2]);
  */
 int socket_getpeername(kchannel_ref_t* channel_ref, kaddress_t* address);
 
+/**
+ * ȡ׽ֶԶIP
+ * @param socket_fd ׽
+ * @param ip ԶIP
+ * @param size 
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int socket_get_peer_ip(socket_t socket_fd, char* ip, int size);
+
 /**
  * getsockname
  * @sa getsockname
@@ -32,6 +32,7 @@
 #include "misc.h"
 #include "channel_ref.h"
 #include "stream.h"
+#include "buffer.h"
 #include "address.h"
 #include "logger.h"
 
@@ -313,58 +314,18 @@ void knet_node_wait_for_stop(knode_t* node) {
 }
 
 int knet_node_broadcast(knode_t* node, const void* msg, int size) {
-    int            error = error_ok;
-    int            ret   = error_ok;
-    khash_value_t* value = 0;
-    knode_proxy_t* proxy = 0;
     verify(node);
     verify(msg);
     verify(size);
-    rwlock_rdlock(node->rwlock_node_hash);
-    hash_for_each_safe(node->hash_node_id, value) {
-        proxy = (knode_proxy_t*)hash_value_get_value(value);
-        verify(proxy);
-        verify(proxy->channel);
-        ret = node_send(proxy->channel, msg, (uint32_t)size);
-        if (error_ok != ret) { /* ֻǸߵ߷˴ */
-            log_error("sent bytes to node failed node-ID[%d], node-type[%d]",
-                proxy->id, proxy->type);
-            /* رսڵܵ */
-            knet_channel_ref_close(proxy->channel);
-            error = ret;
-        }
-    }
-    rwlock_rdunlock(node->rwlock_node_hash);
-    return error;
+    return node_broadcast(node, 0, msg, (uint32_t)size);
 }
 
 int knet_node_broadcast_by_type(knode_t* node, uint32_t type, const void* msg, int size) {
-    int            error = error_ok;
-    int            ret   = error_ok;
-    khash_value_t* value = 0;
-    knode_proxy_t* proxy = 0;
     verify(node);
     verify(msg);
     verify(size);
     verify(type);
-    rwlock_rdlock(node->rwlock_node_hash);
-    hash_for_each_safe(node->hash_node_id, value) {
-        proxy = (knode_proxy_t*)hash_value_get_value(value);
-        if (proxy->type == type) {
-            verify(proxy);
-            verify(proxy->channel);
-            ret = node_send(proxy->channel, msg, (uint32_t)size);
-            if (error_ok != ret) { /* ֻǸߵ߷˴ */
-                log_error("sent bytes to node failed node-ID[%d], node-type[%d]",
-                    proxy->id, proxy->type);
-                /* رսڵܵ */
-                knet_channel_ref_close(proxy->channel);
-                error = ret;
-            }
-        }
-    }
-    rwlock_rdunlock(node->rwlock_node_hash);
-    return error;
+    return node_broadcast(node, type, msg, (uint32_t)size);
 }
 
 int knet_node_write(knode_t* node, uint32_t id, const void* msg, int size) {
@@ -655,7 +616,7 @@ int node_local_start(knode_t* node) {
         knet_node_config_get_ip(node->c), knet_node_config_get_port(node->c));
     framework_acceptor_config_set_user_data(acceptor, node);
     knet_framework_acceptor_config_set_backlog(acceptor, 5000);
-    knet_framework_acceptor_config_set_client_heartbeat_timeout(acceptor,
+    knet_framework_acceptor_config_set_client_heartbeat_timeout_ms(acceptor,
         knet_node_config_get_node_channel_idle_timeout(node->c));
     knet_framework_acceptor_config_set_client_max_send_list_count(acceptor,
         knet_node_config_get_node_channel_max_send_list_count(node->c));
@@ -724,7 +685,7 @@ int node_connect_root(knode_t* node) {
     knet_framework_connector_config_set_remote_address(connector,
         knet_node_config_get_root_ip(node->c), knet_node_config_get_root_port(node->c));
     framework_connector_config_set_user_data(connector, node);
-    knet_framework_connector_config_set_heartbeat_timeout(connector,
+    knet_framework_connector_config_set_heartbeat_timeout_ms(connector,
         knet_node_config_get_node_channel_idle_timeout(node->c));
     knet_framework_connector_config_set_client_max_send_list_count(connector,
         knet_node_config_get_node_channel_max_send_list_count(node->c));
@@ -1036,18 +997,24 @@ void node_manage_channel_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e)
 }
 
 uint32_t copy_msg_id(kchannel_ref_t* channel) {
-    kstream_t* stream = 0;
-    knode_msg_t msg;
+    kstream_t*   stream = 0;
+    knode_msg_t* msg    = 0;
+    knode_msg_t  holder;
     verify(channel);
     stream = knet_channel_ref_get_stream(channel);
     verify(stream);
-    if (error_ok != knet_stream_copy(stream, &msg, sizeof(knode_msg_t))) {
-        return 0;
+    /* ЭͷʱֱӶȡ, 򿽱 */
+    msg = (knode_msg_t*)knet_stream_peek_ptr(stream, sizeof(knode_msg_t));
+    if (!msg) {
+        if (error_ok != knet_stream_copy(stream, &holder, sizeof(knode_msg_t))) {
+            return 0;
+        }
+        msg = &holder;
     }
-    if (msg.header.length > (uint32_t)knet_stream_available(stream)) {
+    if (msg->header.length > (uint32_t)knet_stream_available(stream)) {
         return 0;
     }
-    return msg.header.msg_id;
+    return msg->header.msg_id;
 }
 
 int node_login_req(kchannel_ref_t* channel) {
@@ -1209,6 +1176,7 @@ int on_node_data(kchannel_ref_t* channel) {
     knode_proxy_t* proxy   = 0;
     uint64_t       uuid    = 0;
     knet_node_cb_t node_cb = 0;
+    char*          ptr     = 0;
     knode_send_t send_req;
     knode_msg_t  msg;
     verify(channel);
@@ -1216,13 +1184,23 @@ int on_node_data(kchannel_ref_t* channel) {
     node = knet_channel_ref_get_user_data(channel);
     verify(node);
     stream = knet_channel_ref_get_stream(channel);
-    error = knet_stream_pop(stream, &msg, sizeof(knode_msg_t));
-    if (error_ok != error) {
-        return error;
-    }
-    error = knet_stream_pop(stream, &send_req, sizeof(knode_send_t));
-    if (error_ok != error) {
-        return error;
+    ptr = (char*)knet_stream_peek_ptr(stream, sizeof(knode_msg_t) + sizeof(knode_send_t));
+    if (ptr) {
+        /* Эͷ, ֱӶȡ */
+        send_req.length = ((knode_send_t*)(ptr + sizeof(knode_msg_t)))->length;
+        error = knet_stream_eat(stream, sizeof(knode_msg_t) + sizeof(knode_send_t));
+        if (error_ok != error) {
+            return error;
+        }
+    } else {
+        error = knet_stream_pop(stream, &msg, sizeof(knode_msg_t));
+        if (error_ok != error) {
+            return error;
+        }
+        error = knet_stream_pop(stream, &send_req, sizeof(knode_send_t));
+        if (error_ok != error) {
+            return error;
+        }
     }
     rwlock_rdlock(node->rwlock_node_hash);
     proxy = (knode_proxy_t*)hash_get(node->hash_node_channel_id, uuid_get_high32(uuid));
@@ -1247,9 +1225,9 @@ error_return:
 int node_send(kchannel_ref_t* channel, const void* data, uint32_t size) {
     kstream_t*                     stream    = 0;
     knode_t*                       node      = 0;
-    int                            error     = error_ok;
     knode_send_t send_req;
     knode_msg_t msg;
+    kiovec_t    iov[3];
     verify(channel);
     node = knet_channel_ref_get_user_data(channel);
     verify(node);
@@ -1257,15 +1235,73 @@ int node_send(kchannel_ref_t* channel, const void* data, uint32_t size) {
     msg.header.length = sizeof(knode_msg_t) + sizeof(knode_send_t) + size;
     msg.header.msg_id = node_msg_send;
     send_req.length = size;
-    error = knet_stream_push(stream, &msg, sizeof(msg));
-    if (error_ok != error) {
-        return error;
+    /* Эͷ, һд */
+    iov[0].buffer = &msg;
+    iov[0].size   = sizeof(msg);
+    iov[1].buffer = &send_req;
+    iov[1].size   = sizeof(send_req);
+    iov[2].buffer = data;
+    iov[2].size   = (int)size;
+    return knet_stream_pushv(stream, iov, 3);
+}
+
+kshared_buffer_t* node_create_send_buffer(const void* data, uint32_t size) {
+    knode_send_t send_req;
+    knode_msg_t  msg;
+    kiovec_t     iov[3];
+    msg.header.length = sizeof(knode_msg_t) + sizeof(knode_send_t) + size;
+    msg.header.msg_id = node_msg_send;
+    send_req.length = size;
+    iov[0].buffer = &msg;
+    iov[0].size   = sizeof(msg);
+    iov[1].buffer = &send_req;
+    iov[1].size   = sizeof(send_req);
+    iov[2].buffer = data;
+    iov[2].size   = (int)size;
+    return knet_shared_buffer_createv(iov, 3);
+}
+
+int node_broadcast(knode_t* node, uint32_t type, const void* data, uint32_t size) {
+    int                    error  = error_ok;
+    int                    ret    = error_ok;
+    khash_value_t*         value  = 0;
+    knode_proxy_t*         proxy  = 0;
+    kshared_buffer_t*      shared = 0;
+    kchannel_ref_fanout_t* fanout = 0;
+    verify(node);
+    verify(data);
+    verify(size);
+    /* Эͷֻһ, нڵܵͬһ */
+    shared = node_create_send_buffer(data, size);
+    if (!shared) {
+        return error_no_memory;
     }
-    error = knet_stream_push(stream, &send_req, sizeof(send_req));
-    if (error_ok != error) {
-        return error;
+    fanout = knet_channel_ref_fanout_create(shared);
+    knet_shared_buffer_decref(shared);
+    if (!fanout) {
+        return error_no_memory;
+    }
+    rwlock_rdlock(node->rwlock_node_hash);
+    hash_for_each_safe(node->hash_node_id, value) {
+        proxy = (knode_proxy_t*)hash_value_get_value(value);
+        verify(proxy);
+        if (type && (proxy->type != type)) {
+            continue;
+        }
+        verify(proxy->channel);
+        ret = knet_channel_ref_fanout_write(fanout, proxy->channel);
+        if (error_ok != ret) { /* ֻǸߵ߷˴ */
+            log_error("sent bytes to node failed node-ID[%d], node-type[%d]",
+                proxy->id, proxy->type);
+            /* رսڵܵ */
+            knet_channel_ref_close(proxy->channel);
+            error = ret;
+        }
     }
-    return knet_stream_push(stream, data, size);
+    rwlock_rdunlock(node->rwlock_node_hash);
+    /* Ͷݿ߳д, ÿkloop_tһ¼ */
+    knet_channel_ref_fanout_finish(fanout);
+    return error;
 }
 
 int node_broadcast_join(knode_t* node, const char* ip, int port, uint32_t type, uint32_t id) {
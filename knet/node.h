@@ -191,6 +191,25 @@ int node_login_ack(kchannel_ref_t* channel);
  */
 int node_send(kchannel_ref_t* channel, const void* data, uint32_t size);
 
+/**
+ * ͵ڵĹ, Эͷֻһ, ڹ㲥
+ * @param data ݿָ
+ * @param size ݳ
+ * @return kshared_buffer_tʵ
+ */
+kshared_buffer_t* node_create_send_buffer(const void* data, uint32_t size);
+
+/**
+ * 㲥ڵ, typeΪ0ʱ㲥нڵ
+ * @param node knode_tʵ
+ * @param type ڵ
+ * @param data ݿָ
+ * @param size ݳ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int node_broadcast(knode_t* node, uint32_t type, const void* data, uint32_t size);
+
 /**
  * ڵ֪ͨڵ½ڵ뼯Ⱥ
  * @param node knode_tʵ
@@ -53,7 +53,7 @@ struct _node_config_t {
     char                   black_ip_filter_path[PATH_MAX]; /* IPļ· */
     int                    white_ip_filter_auto_save;      /* ǷԶIP */
     char                   white_ip_filter_path[PATH_MAX]; /* IPļ· */
-    int                    idle_timeout;                   /* ڵܵ */
+    int                    idle_timeout;                   /* ڵܵУ룩 */
     int                    max_recv_buffer_length;         /* ڵܵջ󳤶 */
     int                    max_send_list_count;            /* ڵܵ󳤶 */
     int                    max_output_buffer_length;       /* 󳤶 */
@@ -81,6 +81,11 @@ int knet_node_config_get_node_channel_max_send_list_count(knode_config_t* c) {
 }
 
 void knet_node_config_set_node_channel_idle_timeout(knode_config_t* c, int timeout) {
+    verify(c);
+    c->idle_timeout = timeout * 1000;
+}
+
+void knet_node_config_set_node_channel_idle_timeout_ms(knode_config_t* c, int timeout) {
     verify(c);
     c->idle_timeout = timeout;
 }
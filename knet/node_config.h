@@ -191,9 +191,9 @@ int knet_node_config_get_node_channel_max_recv_buffer_length(knode_config_t* c);
 int knet_node_config_get_node_channel_max_send_list_count(knode_config_t* c);
 
 /**
- * ȡýڵܵгʱ룩
+ * ȡýڵܵгʱ룩
  * @param c knode_config_tʵ
- * @return ڵܵгʱ룩
+ * @return ڵܵгʱ룩
  */
 int knet_node_config_get_node_channel_idle_timeout(knode_config_t* c);
 
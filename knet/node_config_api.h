@@ -215,6 +215,15 @@ extern void knet_node_config_set_node_channel_max_send_list_count(knode_config_t
  */
 extern void knet_node_config_set_node_channel_idle_timeout(knode_config_t* c, int timeout);
 
+/**
+ * ýڵܵгʱ룩
+ *
+ * ڵܵгʱ, Ҫ뼶ʱʹ
+ * @param c knode_config_tʵ
+ * @param timeout ܵгʱ룩
+ */
+extern void knet_node_config_set_node_channel_idle_timeout_ms(knode_config_t* c, int timeout);
+
 /**
  * ȡÿ
  * @param c knode_config_tʵ
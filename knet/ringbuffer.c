@@ -40,12 +40,179 @@ struct _ringbuffer_t {
     uint32_t count;                 /* ɶݳ */
     uint32_t window_read_lock_size; /* ڶ */
     uint32_t window_read_pos;       /* ڶλ */
+    uint32_t mask;                  /* 󳤶Ϊ2ʱ, Ϊ0 */
+    int      mirror;                /* Ƿӳβ */
 };
 
+/**
+ * βӳεĻ, sizeҳС
+ * @retval error_ok ɹ
+ * @retval error_fail ʧܻƽ̨֧
+ */
+int _ringbuffer_map_mirror(kringbuffer_t* rb, uint32_t size);
+
+/**
+ * ӳ䳤ȡΪҳС
+ */
+uint32_t _ringbuffer_round_page(uint32_t size);
+
+/**
+ * ³ȵӳ䲢ɶ, 滻ԭӳ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int _ringbuffer_resize_mirror(kringbuffer_t* rb, uint32_t size);
+
+/**
+ * , posС2󳤶
+ */
+uint32_t _ringbuffer_wrap(kringbuffer_t* rb, uint32_t pos);
+
+/**
+ * posʼsizeֽ, memcpy
+ */
+void _ringbuffer_copy_out(kringbuffer_t* rb, uint32_t pos, char* buffer, uint32_t size);
+
+/**
+ * posʼдsizeֽ, memcpy
+ */
+void _ringbuffer_copy_in(kringbuffer_t* rb, uint32_t pos, const char* buffer, uint32_t size);
+
+uint32_t _ringbuffer_wrap(kringbuffer_t* rb, uint32_t pos) {
+    if (rb->mask) {
+        return pos & rb->mask;
+    }
+    return (pos >= rb->max_size) ? (pos - rb->max_size) : pos;
+}
+
+void _ringbuffer_copy_out(kringbuffer_t* rb, uint32_t pos, char* buffer, uint32_t size) {
+    uint32_t first = rb->mirror ? size : min(size, rb->max_size - pos);
+    memcpy(buffer, rb->ptr + pos, first);
+    if (size > first) {
+        /* Ƶͷ */
+        memcpy(buffer + first, rb->ptr, size - first);
+    }
+}
+
+void _ringbuffer_copy_in(kringbuffer_t* rb, uint32_t pos, const char* buffer, uint32_t size) {
+    uint32_t first = rb->mirror ? size : min(size, rb->max_size - pos);
+    memcpy(rb->ptr + pos, buffer, first);
+    if (size > first) {
+        /* Ƶͷ */
+        memcpy(rb->ptr, buffer + first, size - first);
+    }
+}
+
+int _ringbuffer_map_mirror(kringbuffer_t* rb, uint32_t size) {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    int   fd   = -1;
+    char* base = 0;
+    fd = (int)syscall(SYS_memfd_create, "knet_ringbuffer", 0);
+    if (fd < 0) {
+        return error_fail;
+    }
+    if (ftruncate(fd, size)) {
+        close(fd);
+        return error_fail;
+    }
+    /* ȱȵĵַռ, ٽͬһڴӳ䵽ǰ */
+    base = (char*)mmap(0, (size_t)size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return error_fail;
+    }
+    if ((MAP_FAILED == mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)) ||
+        (MAP_FAILED == mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0))) {
+        munmap(base, (size_t)size * 2);
+        close(fd);
+        return error_fail;
+    }
+    /* ӳ佨Ҫļ */
+    close(fd);
+    rb->ptr    = base;
+    rb->mirror = 1;
+    return error_ok;
+#else
+    rb;
+    size;
+    return error_fail;
+#endif /* defined(__linux__) && defined(SYS_memfd_create) */
+}
+
+uint32_t _ringbuffer_round_page(uint32_t size) {
+#if defined(__linux__)
+    uint32_t page = (uint32_t)sysconf(_SC_PAGESIZE);
+    return ((size + page - 1) / page) * page;
+#else
+    return size;
+#endif /* defined(__linux__) */
+}
+
+int _ringbuffer_resize_mirror(kringbuffer_t* rb, uint32_t size) {
+#if defined(__linux__)
+    kringbuffer_t mirror;
+    size = _ringbuffer_round_page(size);
+    if (size == rb->max_size) {
+        return error_ok;
+    }
+    memset(&mirror, 0, sizeof(kringbuffer_t));
+    if (error_ok != _ringbuffer_map_mirror(&mirror, size)) {
+        return error_no_memory;
+    }
+    /* ӳεĻڿɶ, Ƶӳͷ */
+    memcpy(mirror.ptr, rb->ptr + rb->read_pos, rb->count);
+    munmap(rb->ptr, (size_t)rb->max_size * 2);
+    rb->ptr       = mirror.ptr;
+    rb->max_size  = size;
+    rb->mask      = (size & (size - 1)) ? 0 : size - 1;
+    rb->read_pos  = 0;
+    rb->write_pos = _ringbuffer_wrap(rb, rb->count);
+    return error_ok;
+#else
+    rb;
+    size;
+    return error_fail;
+#endif /* defined(__linux__) */
+}
+
+kringbuffer_t* ringbuffer_create_mirror(uint32_t size) {
+    kringbuffer_t* rb = 0;
+#if defined(__linux__)
+    /* ӳ䳤ȱҳС */
+    size = _ringbuffer_round_page(size);
+    rb = create(kringbuffer_t);
+    verify(rb);
+    memset(rb, 0, sizeof(kringbuffer_t));
+    if (error_ok == _ringbuffer_map_mirror(rb, size)) {
+        rb->max_size = size;
+        if (!(size & (size - 1))) {
+            rb->mask = size - 1;
+        }
+        return rb;
+    }
+    destroy(rb);
+#endif /* defined(__linux__) */
+    /* ֧ʱʹͨ */
+    return ringbuffer_create(size);
+}
+
 kringbuffer_t* ringbuffer_create(uint32_t size) {
-    kringbuffer_t* rb = create(kringbuffer_t);
+#if RINGBUFFER_ROUND_POW2
+    uint32_t       pow2 = 1;
+#endif /* RINGBUFFER_ROUND_POW2 */
+    kringbuffer_t* rb   = create(kringbuffer_t);
     verify(rb);
     memset(rb, 0, sizeof(kringbuffer_t));
+#if RINGBUFFER_ROUND_POW2
+    /* ȡΪ2, ʹȡģ */
+    while ((pow2 < size) && (pow2 < 0x80000000)) {
+        pow2 <<= 1;
+    }
+    size = pow2;
+#endif /* RINGBUFFER_ROUND_POW2 */
+    if (size && !(size & (size - 1))) {
+        rb->mask = size - 1;
+    }
     rb->lock_type = 0;
     rb->max_size  = size;
     rb->ptr       = create_raw(size);
@@ -78,98 +245,69 @@ int ringbuffer_eat(kringbuffer_t* rb, uint32_t size) {
         return error_recvbuffer_not_enough;
     }
     rb->count -= size;
-    rb->read_pos = (rb->read_pos + size) % rb->max_size;
+    rb->read_pos = _ringbuffer_wrap(rb, rb->read_pos + size);
     return error_ok;
 }
 
 uint32_t ringbuffer_read(kringbuffer_t* rb, char* buffer, uint32_t size) {
-    uint32_t i = 0;
     verify(rb);
     verify(buffer);
     verify(size);
     size = min(rb->count, size);
-    for (; i < size; i++) {
-        buffer[i] = rb->ptr[rb->read_pos];
-        rb->read_pos = (rb->read_pos + 1) % rb->max_size;
-    }
+    _ringbuffer_copy_out(rb, rb->read_pos, buffer, size);
+    rb->read_pos = _ringbuffer_wrap(rb, rb->read_pos + size);
     rb->count -= size;
     return size;
 }
 
 uint32_t ringbuffer_remove(kringbuffer_t* rb, uint32_t size) {
-    uint32_t i = 0;
     verify(rb);
     verify(size);
     size = min(rb->count, size);
-    for (; i < size; i++) {
-        rb->read_pos = (rb->read_pos + 1) % rb->max_size;
-    }
+    rb->read_pos = _ringbuffer_wrap(rb, rb->read_pos + size);
     rb->count -= size;
     return size;
 }
 
 uint32_t ringbuffer_write(kringbuffer_t* rb, const char* buffer, uint32_t size) {
-    uint32_t i = 0;
     verify(rb);
     verify(buffer);
     verify(size);
     size = (((rb->max_size - rb->count) > size) ? size : rb->max_size - rb->count);
-    for (; i < size; i++) {
-        rb->ptr[rb->write_pos] = buffer[i];
-        rb->write_pos = (rb->write_pos + 1) % rb->max_size;
-    }
+    _ringbuffer_copy_in(rb, rb->write_pos, buffer, size);
+    rb->write_pos = _ringbuffer_wrap(rb, rb->write_pos + size);
     rb->count += size;
     return size;
 }
 
 uint32_t ringbuffer_replace(kringbuffer_t* rb, uint32_t pos, const char* buffer, uint32_t size) {
-    uint32_t i         = 0;
-    uint32_t write_pos = 0;
     verify(rb);
     verify(buffer);
     verify(size);
-    if (size > rb->max_size) {
+    if ((size > rb->max_size) || (pos >= rb->max_size)) {
         return 0;
     }
-    write_pos = (rb->read_pos + pos) % rb->max_size;
-    for (; i < size; i++) {
-        rb->ptr[write_pos] = buffer[i];
-        write_pos = (write_pos + 1) % rb->max_size;
-    }
+    _ringbuffer_copy_in(rb, _ringbuffer_wrap(rb, rb->read_pos + pos), buffer, size);
     return size;
 }
 
 uint32_t ringbuffer_copy(kringbuffer_t* rb, char* buffer, uint32_t size) {
-    uint32_t i        = 0;
-    uint32_t read_pos = 0;
     verify(rb);
     verify(buffer);
     verify(size);
-    read_pos = rb->read_pos;
     size = min(rb->count, size);
-    for (; i < size; i++) {
-        buffer[i] = rb->ptr[read_pos];
-        read_pos = (read_pos + 1) % rb->max_size;
-    }
+    _ringbuffer_copy_out(rb, rb->read_pos, buffer, size);
     return size;
 }
 
 uint32_t ringbuffer_copy_random(kringbuffer_t* rb, uint32_t pos, char* buffer, uint32_t size) {
-    uint32_t i = 0;
-    uint32_t read_pos = 0;
     verify(rb);
-    verify(pos >= 0);
     verify(size);
     verify(buffer);
     if (pos + size > rb->count) {
         return 0;
     }
-    size = min(rb->count - pos, size);
-    read_pos = (rb->read_pos + pos) % rb->max_size;
-    for (; i < size; i++) {
-        buffer[i] = rb->ptr[read_pos];
-        read_pos = (read_pos + 1) % rb->max_size;
-    }
+    _ringbuffer_copy_out(rb, _ringbuffer_wrap(rb, rb->read_pos + pos), buffer, size);
     return size;
 }
 
@@ -182,13 +320,13 @@ uint32_t ringbuffer_find(kringbuffer_t* rb, const char* target, uint32_t* size)
     verify(target);
     verify(size);
     length = strlen(target);
-    pos    = rb->read_pos % rb->max_size;
+    pos    = rb->read_pos;
     for (; (i < rb->count) && (index < length); i++) {
         if (rb->ptr[pos] == target[index]) { /* ƥ */
             index += 1;                        /* ǰλõ */
-            pos    = (pos + 1) % rb->max_size; /* rbλõ */
+            pos    = _ringbuffer_wrap(rb, pos + 1); /* rbλõ */
         } else { /* ʧ */
-            pos   = (rb->read_pos + i + 1) % rb->max_size; /* rbƥλ */
+            pos   = _ringbuffer_wrap(rb, rb->read_pos + i + 1); /* rbƥλ */
             index = 0;                                 /* Ŀַ± */
         }
     }
@@ -206,10 +344,66 @@ uint32_t ringbuffer_available(kringbuffer_t* rb) {
 
 void ringbuffer_destroy(kringbuffer_t* rb) {
     verify(rb);
+#if defined(__linux__)
+    if (rb->mirror) {
+        munmap(rb->ptr, (size_t)rb->max_size * 2);
+        destroy(rb);
+        return;
+    }
+#endif /* defined(__linux__) */
     destroy(rb->ptr);
     destroy(rb);
 }
 
+int ringbuffer_resize(kringbuffer_t* rb, uint32_t size) {
+    char* ptr = 0;
+    verify(rb);
+    verify(size);
+    if (rb->lock_size || rb->lock_type) {
+        return error_recvbuffer_locked;
+    }
+    if (size < rb->count) {
+        return error_recvbuffer_not_enough;
+    }
+    if (rb->mirror) {
+        /* ӳεĻ½ӳ */
+        return _ringbuffer_resize_mirror(rb, size);
+    }
+    if (size == rb->max_size) {
+        return error_ok;
+    }
+    ptr = create_raw(size);
+    if (!ptr) {
+        return error_no_memory;
+    }
+    /* ɶݰƵ»ͷ */
+    _ringbuffer_copy_out(rb, rb->read_pos, ptr, rb->count);
+    destroy(rb->ptr);
+    rb->ptr       = ptr;
+    rb->max_size  = size;
+    rb->mask      = (size & (size - 1)) ? 0 : size - 1;
+    rb->read_pos  = 0;
+    rb->write_pos = _ringbuffer_wrap(rb, rb->count);
+    return error_ok;
+}
+
+int ringbuffer_is_mirror(kringbuffer_t* rb) {
+    verify(rb);
+    return rb->mirror;
+}
+
+char* ringbuffer_peek_ptr(kringbuffer_t* rb, uint32_t size) {
+    verify(rb);
+    if (!size || (size > rb->count)) {
+        return 0;
+    }
+    if (!rb->mirror && (rb->read_pos + size > rb->max_size)) {
+        /* ݿԽ˻ĩβ */
+        return 0;
+    }
+    return rb->ptr + rb->read_pos;
+}
+
 uint32_t ringbuffer_read_lock_size(kringbuffer_t* rb) {
     verify(rb);
     if (ringbuffer_empty(rb)) {
@@ -217,7 +411,10 @@ uint32_t ringbuffer_read_lock_size(kringbuffer_t* rb) {
     }
     rb->lock_type = 1;
     rb->lock_size = 0;
-    if (rb->write_pos > rb->read_pos) {
+    if (rb->mirror) {
+        /* ɶ */
+        rb->lock_size = rb->count;
+    } else if (rb->write_pos > rb->read_pos) {
         rb->lock_size = rb->write_pos - rb->read_pos;
     } else {
         rb->lock_size = rb->max_size - rb->read_pos;
@@ -241,7 +438,7 @@ void ringbuffer_read_commit(kringbuffer_t* rb, uint32_t size) {
     if (rb->lock_size < size) {
         return;
     }
-    rb->read_pos = (rb->read_pos + size) % rb->max_size;
+    rb->read_pos = _ringbuffer_wrap(rb, rb->read_pos + size);
     rb->lock_size = 0;
     rb->lock_type = 0;
     rb->count -= size;
@@ -285,7 +482,7 @@ void ringbuffer_window_read_commit(kringbuffer_t* rb, uint32_t size) {
     if (rb->window_read_lock_size < size) {
         return;
     }
-    rb->window_read_pos = (rb->window_read_pos + size) % rb->max_size;
+    rb->window_read_pos = _ringbuffer_wrap(rb, rb->window_read_pos + size);
 }
 
 uint32_t ringbuffer_write_lock_size(kringbuffer_t* rb) {
@@ -295,7 +492,10 @@ uint32_t ringbuffer_write_lock_size(kringbuffer_t* rb) {
     }
     rb->lock_type = 2;
     rb->lock_size = 0;
-    if (rb->write_pos >= rb->read_pos) {
+    if (rb->mirror) {
+        /* дռ */
+        rb->lock_size = rb->max_size - rb->count;
+    } else if (rb->write_pos >= rb->read_pos) {
         rb->lock_size = rb->max_size - rb->write_pos;
     } else {
         rb->lock_size = rb->read_pos - rb->write_pos;
@@ -319,7 +519,7 @@ void ringbuffer_write_commit(kringbuffer_t* rb, uint32_t size) {
     if (rb->lock_size < size) {
         return;
     }
-    rb->write_pos = (rb->write_pos + size) % rb->max_size;
+    rb->write_pos = _ringbuffer_wrap(rb, rb->write_pos + size);
     rb->lock_size = 0;
     rb->lock_type = 0;
     rb->count += size;
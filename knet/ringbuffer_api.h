@@ -41,6 +41,45 @@ extern kringbuffer_t* ringbuffer_create(uint32_t size);
  */
 extern void ringbuffer_destroy(kringbuffer_t* rb);
 
+/**
+ * λ, ɶ
+ *
+ * ӳεĻλµӳ󿽱ɶ, ȡΪҳС
+ * @param rb kringbuffer_tʵ
+ * @param size ³, Сڿɶݳ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+extern int ringbuffer_resize(kringbuffer_t* rb, uint32_t size);
+
+/**
+ * βӳεĻλ, κοɶݶ
+ *
+ * ȡΪҳС, ƽ̨֧ʱͨλ
+ * @param size 󳤶
+ * @return kringbuffer_tʵ
+ */
+extern kringbuffer_t* ringbuffer_create_mirror(uint32_t size);
+
+/**
+ * ǷΪβӳεĻλ
+ * @param rb kringbuffer_tʵ
+ * @retval 0 
+ * @retval  
+ */
+extern int ringbuffer_is_mirror(kringbuffer_t* rb);
+
+/**
+ * ȡָsizeɶֽڵָ, Ҳ
+ *
+ * ָһζȡ/ǰЧ
+ * @param rb kringbuffer_tʵ
+ * @param size Ҫֽ
+ * @retval 0 ɶֽ, ͨλݿԽ˻ĩβ
+ * @retval  ָ
+ */
+extern char* ringbuffer_peek_ptr(kringbuffer_t* rb, uint32_t size);
+
 /**
  * ȡ
  * @param rb kringbuffer_tʵ
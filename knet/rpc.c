@@ -29,6 +29,8 @@
 #include "channel_ref.h"
 #include "stream.h"
 #include "rpc_object.h"
+#include "loop.h"
+#include "misc.h"
 #include "logger.h"
 
 
@@ -43,9 +45,15 @@ typedef struct krpc_header_t {
     uint16_t length;       /* ȣṹ峤 */
     uint16_t rpcid;        /* ҪõķID/÷طID */
     uint8_t  type;         /* ͣ/) */
-    uint8_t  padding__[3]; /* 3ֽ䣬ܳΪ8ֽ */
+    uint8_t  flag;         /* ־, krpc_header_flag_e */
+    uint8_t  padding__[2]; /* 2ֽ䣬ܳΪ8ֽ */
 } krpc_header_t;
 
+typedef struct krpc_long_header_t {
+    krpc_header_t header;  /* Эͷ, lengthΪ0 */
+    uint32_t      length;  /* ȣṹ峤 */
+} krpc_long_header_t;
+
 #if defined(_MSC_VER )
     #pragma pack(pop)
 #else
@@ -57,15 +65,26 @@ typedef enum _krpc_call_type_e {
     krpc_call_type_call   = 2, /*  */
 } krpc_call_type_e;
 
+typedef enum _krpc_header_flag_e {
+    krpc_header_flag_long = 1, /* , ЭͷΪ32λ, ʹ32λ */
+} krpc_header_flag_e;
+
 struct _krpc_t {
-    khash_t*        cb_table;
-    krpc_encrypt_t encrypt; /* ǩ */
-    krpc_decrypt_t decrypt; /* ֤ǩ */
+    khash_t*         cb_table;
+    krpc_encrypt_t   encrypt;      /* ǩ */
+    krpc_decrypt_t   decrypt;      /* ֤ǩ */
+    char*            scratch;      /* ܵõЭͷܺ建, һμܵʱ */
+    atomic_counter_t scratch_busy; /* Ƿռ, ߳ռʱʱ */
 };
 
 int _krpc_call_encrypt(krpc_t* rpc, kstream_t* stream, uint16_t rpcid, krpc_object_t* o);
 int _krpc_call(krpc_t* rpc, kstream_t* stream, uint16_t rpcid, krpc_object_t* o);
 
+/**
+ * RPCصתֵ
+ */
+int _krpc_proc_cb(krpc_t* rpc, krpc_header_t* header, krpc_object_t* o);
+
 krpc_t* krpc_create() {
     krpc_t* rpc = create(krpc_t);
     verify(rpc);
@@ -78,6 +97,9 @@ krpc_t* krpc_create() {
 void krpc_destroy(krpc_t* rpc) {
     verify(rpc);
     hash_destroy(rpc->cb_table);
+    if (rpc->scratch) {
+        destroy(rpc->scratch);
+    }
     destroy(rpc);
 }
 
@@ -103,227 +125,256 @@ krpc_cb_t krpc_get_cb(krpc_t* rpc, uint16_t rpcid) {
     return (krpc_cb_t)hash_get(rpc->cb_table, rpcid);
 }
 
-int _krpc_proc_decrypt(krpc_t* rpc, kstream_t* stream) {
+int _krpc_proc_cb(krpc_t* rpc, krpc_header_t* header, krpc_object_t* o) {
+    krpc_cb_t cb       = 0; /* ص */
+    int       error_cb = 0; /* صֵ */
+    if ((header->type != krpc_call_type_call) && (header->type != krpc_call_type_result)) {
+        /*  */
+        return error_rpc_unknown_type;
+    }
+    /* / */
+    cb = krpc_get_cb(rpc, header->rpcid);
+    if (cb == 0) {
+        return error_rpc_unknown_id;
+    }
+    error_cb = cb(o);
+    if (error_cb == rpc_error) {
+        /*  */
+        return error_rpc_cb_fail;
+    } else if (error_cb == rpc_error_close) {
+        /* 󲢹ر */
+        return error_rpc_cb_fail_close;
+    } else if (error_cb == rpc_close) {
+        /* Ҫر */
+        return error_rpc_cb_close;
+    }
+    /* okδֵ֪ */
+    return error_ok;
+}
+
+int krpc_proc(krpc_t* rpc, kstream_t* stream) {
     static const uint16_t BUFFER_LENGTH = 1024 * 64 - sizeof(krpc_header_t) - 1;
     int            available = 0;        /* ܵڿɶֽ */
-    uint16_t       length    = 0;        /* unmarshalֽ*/
-    uint16_t       decrypt_size = 0;
+    uint32_t       length    = 0;        /* unmarshalֽ*/
+    uint32_t       total     = 0;        /*  */
+    uint32_t       head_size = sizeof(krpc_header_t); /* Эͷ */
+    uint32_t       size      = 0;        /* 峤 */
+    char*          body      = 0;        /*  */
+    char*          ptr       = 0;        /* ָ */
+    char*          plain     = 0;        /* ܻ */
     krpc_object_t* o         = 0;        /* unmarshalõĶ */
-    char*          buffer    = 0;
-    krpc_cb_t      cb        = 0;        /* ص */
-    int            error_cb  = 0;        /* صֵ */
+    krpc_arena_t*  arena     = 0;        /* ǰloopĽڴ */
+    krpc_format_e  format    = krpc_format_short; /* лʽ */
     int            error     = error_ok; /* ֵ */
-    krpc_header_t  header; /* RPCЭͷ */
+    krpc_long_header_t long_header; /* RPCЭͷ */
+    krpc_header_t*     header = &long_header.header;
     verify(rpc);
     verify(stream);
-    memset(&header, 0, sizeof(krpc_header_t));
+    memset(&long_header, 0, sizeof(krpc_long_header_t));
     available = knet_stream_available(stream);
     if (available < sizeof(krpc_header_t)) {
         /* ֽ */
         return error_rpc_not_enough_bytes;
     }
-    if (error_ok != knet_stream_copy(stream, &header, sizeof(header))) {
+    /* ЭͷʱֱӶȡ, 򿽱 */
+    ptr = (char*)knet_stream_peek_ptr(stream, sizeof(krpc_header_t));
+    if (ptr) {
+        memcpy(header, ptr, sizeof(krpc_header_t));
+    } else if (error_ok != knet_stream_copy(stream, header, sizeof(krpc_header_t))) {
         return error_rpc_unmarshal_fail;
     }
-    if (header.length > available) {
-        /* ֽ */
-        return error_rpc_not_enough_bytes;
-    } else {
-        if (error_ok != knet_stream_eat(stream, sizeof(header))) {
+    if (header->flag & krpc_header_flag_long) {
+        /* , ЭͷΪ32λ */
+        if (rpc->decrypt) {
             return error_rpc_unmarshal_fail;
         }
-    }
-    buffer = create_type(char, BUFFER_LENGTH * 2);
-    verify(buffer);
-    /* ȡ */
-    if (error_ok != knet_stream_pop(stream, buffer, header.length - sizeof(krpc_header_t))) {
-        error = error_rpc_unmarshal_fail;
-        goto error_return;
-    }
-    /*  */
-    decrypt_size = rpc->decrypt(buffer, header.length - sizeof(krpc_header_t),
-        buffer + BUFFER_LENGTH, BUFFER_LENGTH);
-    if (decrypt_size <= 0) {
-        error = error_rpc_unmarshal_fail;
-        goto error_return;
-    }
-    /* unmarshal */
-    error = krpc_object_unmarshal_buffer(buffer + BUFFER_LENGTH, decrypt_size, &o, &length);
-    if (error_ok != error) {
-        error = error_rpc_unmarshal_fail;
-        goto error_return;
-    }
-    /* ûص */
-    if ((header.type == krpc_call_type_call) || (header.type == krpc_call_type_result)) {
-        /* / */
-        cb = krpc_get_cb(rpc, header.rpcid);
-        if (cb == 0) {
-            error = error_rpc_unknown_id;
-            goto error_return;
+        head_size = sizeof(krpc_long_header_t);
+        if ((uint32_t)available < head_size) {
+            return error_rpc_not_enough_bytes;
         }
-        error_cb = cb(o);
-        if (error_cb == rpc_error) {
-            /*  */
-            error = error_rpc_cb_fail;
-            goto error_return;
-        } else if (error_cb == rpc_error_close) {
-            /* 󲢹ر */
-            error = error_rpc_cb_fail_close;
-            goto error_return;
-        } else if (error_cb == rpc_close) {
-            /* Ҫر */
-            error = error_rpc_cb_close;
-            goto error_return;
-        } else if (error_cb == rpc_ok) {
-            /* ok */
-            goto error_return;
-        } else {
-            /* δֵ֪ */
+        if (error_ok != knet_stream_copy(stream, &long_header, sizeof(krpc_long_header_t))) {
+            return error_rpc_unmarshal_fail;
         }
+        total  = long_header.length;
+        format = krpc_format_long;
     } else {
-        /*  */
-        error = error_rpc_unknown_type;
-    }
-error_return:
-    if (o) {
-        krpc_object_destroy(o);
+        total = header->length;
     }
-    destroy(buffer);
-    return error;
-}
-
-int _krpc_proc(krpc_t* rpc, kstream_t* stream) {
-    int            available = 0;        /* ܵڿɶֽ */
-    uint16_t       length    = 0;        /* unmarshalֽ*/
-    krpc_object_t* o         = 0;        /* unmarshalõĶ */
-    krpc_cb_t      cb        = 0;        /* ص */
-    int            error_cb  = 0;        /* صֵ */
-    int            error     = error_ok; /* ֵ */
-    krpc_header_t  header; /* RPCЭͷ */
-    verify(rpc);
-    verify(stream);
-    memset(&header, 0, sizeof(krpc_header_t));
-    available = knet_stream_available(stream);
-    if (available < sizeof(krpc_header_t)) {
-        /* ֽ */
-        return error_rpc_not_enough_bytes;
-    }
-    if (error_ok != knet_stream_copy(stream, &header, sizeof(header))) {
+    if (total < head_size) {
         return error_rpc_unmarshal_fail;
     }
-    if (header.length > available) {
+    if (total > (uint32_t)available) {
         /* ֽ */
         return error_rpc_not_enough_bytes;
-    } else {
-        if (error_ok != knet_stream_eat(stream, sizeof(header))) {
-            return error_rpc_unmarshal_fail;
-        }
     }
-    /* unmarshal */
-    error = krpc_object_unmarshal(stream, &o, &length);
-    if (error_ok != error) {
-        error = error_rpc_unmarshal_fail;
-        goto error_return;
+    arena = knet_loop_get_rpc_arena(knet_channel_ref_get_loop(stream_get_channel_ref(stream)));
+    if (!arena) {
+        return error_no_memory;
     }
-    /* ûص */
-    if ((header.type == krpc_call_type_call) || (header.type == krpc_call_type_result)) {
-        /* / */
-        cb = krpc_get_cb(rpc, header.rpcid);
-        if (cb == 0) {
-            error = error_rpc_unknown_id;
+    size = total - head_size;
+    /* ʱֱڽջڽ, 򿽱ʱ */
+    ptr = (char*)knet_stream_peek_ptr(stream, (int)total);
+    if (!ptr) {
+        ptr = krpc_arena_get_scratch(arena, 0, total);
+        if (!ptr || (error_ok != knet_stream_copy(stream, ptr, (int)total))) {
+            error = error_rpc_unmarshal_fail;
             goto error_return;
         }
-        error_cb = cb(o);
-        if (error_cb == rpc_error) {
-            /*  */
-            error = error_rpc_cb_fail;
-            goto error_return;
-        } else if (error_cb == rpc_error_close) {
-            /* 󲢹ر */
-            error = error_rpc_cb_fail_close;
-            goto error_return;
-        } else if (error_cb == rpc_close) {
-            /* Ҫر */
-            error = error_rpc_cb_close;
+    }
+    body = ptr + head_size;
+    if (rpc->decrypt) {
+        /*  */
+        plain = krpc_arena_get_scratch(arena, 1, BUFFER_LENGTH);
+        if (!plain) {
+            error = error_rpc_unmarshal_fail;
             goto error_return;
-        } else if (error_cb == rpc_ok) {
-            /* ok */
+        }
+        size = rpc->decrypt(body, (uint16_t)size, plain, BUFFER_LENGTH);
+        if (!size) {
+            error = error_rpc_unmarshal_fail;
             goto error_return;
-        } else {
-            /* δֵ֪ */
         }
-    } else {
-        /*  */
-        error = error_rpc_unknown_type;
+        body = plain;
     }
-error_return:
-    if (o) {
-        krpc_object_destroy(o);
+    /* unmarshal, ڴڷ */
+    if (error_ok != krpc_object_unmarshal_arena(arena, body, size, format, &o, &length)) {
+        error = error_rpc_unmarshal_fail;
+        goto error_return;
     }
+    /* ûص */
+    error = _krpc_proc_cb(rpc, header, o);
+error_return:
+    /* صغŶ, ڵַָջ */
+    knet_stream_eat(stream, (int)total);
+    /* εõжһͷ */
+    krpc_arena_reset(arena);
     return error;
 }
 
-int krpc_proc(krpc_t* rpc, kstream_t* stream) {
-    return ((rpc->decrypt) ? _krpc_proc_decrypt(rpc, stream) : _krpc_proc(rpc, stream));
-}
-
 int _krpc_call_encrypt(krpc_t* rpc, kstream_t* stream, uint16_t rpcid, krpc_object_t* o) {
     static const uint16_t BUFFER_LENGTH = 1024 * 64 - sizeof(krpc_header_t) - 1;
+    char     stack_buffer[RPC_MARSHAL_STACK_SIZE];
+    char*    plain        = stack_buffer; /* л */
+    char*    buffer       = 0;            /* Эͷܺİ */
+    uint32_t length       = 0;
     uint16_t bytes        = 0;
     uint16_t encrypt_size = 0;
-    char*    buffer       = 0;
+    int      error        = error_rpc_marshal_fail;
     krpc_header_t header; /* RPCЭͷ */
     verify(rpc);
     verify(stream);
     verify(rpcid);
     verify(o);
-    memset(&header, 0, sizeof(krpc_header_t));
-    header.rpcid  = rpcid;
-    header.type   = krpc_call_type_call;
-    buffer        = create_type(char, BUFFER_LENGTH * 2);
-    verify(buffer);
-    /*  */
-    if (error_ok != krpc_object_marshal_buffer(o, buffer, BUFFER_LENGTH, &bytes)) {
-        goto error_return;
+    length = krpc_object_get_marshal_length(o, krpc_format_short);
+    if (!length || (length > BUFFER_LENGTH)) {
+        return error_rpc_marshal_fail;
+    }
+    if (length > sizeof(stack_buffer)) {
+        plain = create_raw(length);
+        if (!plain) {
+            return error_no_memory;
+        }
+    }
+    /* ܺĳδ֪, ׼, ȸkrpc_tĻ */
+    if (0 == atomic_counter_cas(&rpc->scratch_busy, 0, 1)) {
+        if (!rpc->scratch) {
+            rpc->scratch = create_raw(sizeof(krpc_header_t) + BUFFER_LENGTH);
+        }
+        buffer = rpc->scratch;
+        if (!buffer) {
+            atomic_counter_set(&rpc->scratch_busy, 0);
+        }
+    }
+    if (!buffer) {
+        buffer = create_raw(sizeof(krpc_header_t) + BUFFER_LENGTH);
     }
-    /*  */
-    encrypt_size = rpc->encrypt(buffer, bytes, buffer + BUFFER_LENGTH, BUFFER_LENGTH);
-    if (encrypt_size <= 0) {
+    if (!buffer) {
+        error = error_no_memory;
         goto error_return;
     }
-    /* ܺܳ */
-    header.length = sizeof(krpc_header_t) + encrypt_size;
-    /* Эͷ */
-    if (error_ok != knet_stream_push(stream, &header, sizeof(header))) {
+    /*  */
+    if (error_ok != krpc_object_marshal_buffer(o, plain, (uint16_t)length, &bytes)) {
         goto error_return;
     }
-    /* Э */
-    if (error_ok != knet_stream_push(stream, buffer + BUFFER_LENGTH, encrypt_size)) {
+    /* ܵЭͷ֮ */
+    encrypt_size = rpc->encrypt(plain, bytes, buffer + sizeof(krpc_header_t), BUFFER_LENGTH);
+    if (!encrypt_size) {
         goto error_return;
     }
-    destroy(buffer);
-    return error_ok;
+    memset(&header, 0, sizeof(krpc_header_t));
+    header.rpcid  = rpcid;
+    header.type   = krpc_call_type_call;
+    header.length = sizeof(krpc_header_t) + encrypt_size;
+    memcpy(buffer, &header, sizeof(header));
+    /* ЭͷЭһη */
+    if (error_ok == knet_stream_push(stream, buffer, header.length)) {
+        error = error_ok;
+    }
 error_return:
-    destroy(buffer);
-    return error_rpc_marshal_fail;
+    if (plain != stack_buffer) {
+        destroy(plain);
+    }
+    if (buffer && (buffer == rpc->scratch)) {
+        atomic_counter_set(&rpc->scratch_busy, 0);
+    } else if (buffer) {
+        destroy(buffer);
+    }
+    return error;
 }
 
 int _krpc_call(krpc_t* rpc, kstream_t* stream, uint16_t rpcid, krpc_object_t* o) {
-    krpc_header_t header; /* RPCЭͷ */
+    char          stack_buffer[RPC_MARSHAL_STACK_SIZE];
+    char*         buffer    = stack_buffer;
+    uint32_t      length    = 0;
+    uint32_t      head_size = sizeof(krpc_header_t); /* Эͷ */
+    krpc_format_e format    = krpc_format_short;     /* лʽ */
+    int           error     = error_rpc_marshal_fail;
+    krpc_long_header_t long_header; /* RPCЭͷ */
     verify(rpc);
     verify(stream);
     verify(rpcid);
     verify(o);
-    memset(&header, 0, sizeof(krpc_header_t));
-    header.rpcid  = rpcid;
-    header.type   = krpc_call_type_call;
-    header.length = sizeof(krpc_header_t) + krpc_object_get_marshal_size(o);
-    /* Эͷ */
-    if (error_ok != knet_stream_push(stream, &header, sizeof(header))) {
+    /* ֻһγ, Эͷлͬһ */
+    length = krpc_object_get_marshal_length(o, krpc_format_short);
+    if (!length) {
         return error_rpc_marshal_fail;
     }
-    /* marshal */
-    return krpc_object_marshal(o, stream, 0);    
+    if (head_size + length > 0xffff) {
+        /* 16λ, ʹó, ̰ʽֲԼݾɰ汾 */
+        head_size = sizeof(krpc_long_header_t);
+        format    = krpc_format_long;
+        length    = krpc_object_get_marshal_length(o, krpc_format_long);
+        if (length > (uint32_t)INT_MAX - head_size) {
+            return error_rpc_marshal_fail;
+        }
+    }
+    length += head_size;
+    if (length > sizeof(stack_buffer)) {
+        buffer = create_raw(length);
+        if (!buffer) {
+            return error_no_memory;
+        }
+    }
+    memset(&long_header, 0, sizeof(krpc_long_header_t));
+    long_header.header.rpcid = rpcid;
+    long_header.header.type  = krpc_call_type_call;
+    if (format == krpc_format_long) {
+        long_header.header.flag = krpc_header_flag_long;
+        long_header.length      = length;
+    } else {
+        long_header.header.length = (uint16_t)length;
+    }
+    memcpy(buffer, &long_header, head_size);
+    if (length - head_size == krpc_object_marshal_format(o, buffer + head_size, length - head_size, format)) {
+        /* һд */
+        if (error_ok == knet_stream_push(stream, buffer, (int)length)) {
+            error = error_ok;
+        }
+    }
+    if (buffer != stack_buffer) {
+        destroy(buffer);
+    }
+    return error;
 }
 
 int krpc_call(krpc_t* rpc, kstream_t* stream, uint16_t rpcid, krpc_object_t* o) {
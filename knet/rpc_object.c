@@ -41,6 +41,11 @@ typedef struct krpc_object_header_t {
     uint16_t  length; /* ȣṹ */
 } krpc_object_header_t;
 
+typedef struct krpc_object_long_header_t {
+    uint16_t  type;   /*  */
+    uint32_t  length; /* ȣṹ */
+} krpc_object_long_header_t;
+
 #if defined(_MSC_VER )
     #pragma pack(pop)
 #else
@@ -63,13 +68,13 @@ struct _krpc_number_t {
 };
 
 struct _krpc_string_t {
-    uint16_t size; /* ַ */
+    uint32_t size; /* ַ */
     char*    str;  /* ַָ */
 };
 
 struct _krpc_vector_t {
-    uint16_t        max_size; /* Ԫظ */
-    uint16_t        size;     /* ǰԪظ */
+    uint32_t        max_size; /* Ԫظ */
+    uint32_t        size;     /* ǰԪظ */
     krpc_object_t** objects;  /* ָ */
 };
 
@@ -84,8 +89,13 @@ struct _krpc_map_t {
     khash_t*  hash;
 };
 
+typedef enum _krpc_object_flag_e {
+    krpc_object_flag_arena = 1, /* ڽڴڷ, ڴһͷ */
+} krpc_object_flag_e;
+
 struct _krpc_object_t {
     uint16_t type;
+    uint16_t flag;
     union {
         krpc_number_t number; /*  */
         krpc_string_t string; /* ַ */
@@ -94,6 +104,159 @@ struct _krpc_object_t {
     };
 };
 
+typedef struct _krpc_arena_chunk_t {
+    struct _krpc_arena_chunk_t* next; /* һڴ */
+    uint32_t                    size; /* ó */
+    uint32_t                    pos;  /* ʹó */
+} krpc_arena_chunk_t;
+
+struct _krpc_arena_t {
+    krpc_arena_chunk_t* first;           /* һڴ */
+    krpc_arena_chunk_t* current;         /* ǰڴ */
+    khash_t**           maps;            /* ʹõĹϣ, ʱպ */
+    uint32_t            map_count;       /* νʹõĹϣ */
+    uint32_t            max_maps;        /* ѽĹϣ */
+    char*               scratch[2];      /* ʱ */
+    uint32_t            scratch_size[2]; /* ʱ */
+};
+
+/**
+ * ȡöЭͷ
+ */
+uint32_t _krpc_object_header_size(krpc_format_e format);
+
+/**
+ * ȡЭͷ鳤
+ */
+int _krpc_object_read_header(char* buffer, uint32_t size, krpc_format_e format, uint16_t* type, uint32_t* length);
+
+/**
+ * ǷΪڴڽֻ
+ */
+int _krpc_object_check_arena(krpc_object_t* o);
+
+/**
+ * ڴط, 8ֽڶ
+ */
+void* _krpc_arena_alloc(krpc_arena_t* arena, uint32_t size);
+
+/**
+ * ڴȡһյĹϣ
+ */
+khash_t* _krpc_arena_get_hash(krpc_arena_t* arena);
+
+krpc_arena_t* krpc_arena_create() {
+    krpc_arena_t* arena = create(krpc_arena_t);
+    verify(arena);
+    memset(arena, 0, sizeof(krpc_arena_t));
+    return arena;
+}
+
+void krpc_arena_destroy(krpc_arena_t* arena) {
+    krpc_arena_chunk_t* chunk = 0;
+    uint32_t            i     = 0;
+    verify(arena);
+    while (arena->first) {
+        chunk        = arena->first;
+        arena->first = chunk->next;
+        destroy(chunk);
+    }
+    for (; i < arena->max_maps; i++) {
+        hash_destroy(arena->maps[i]);
+    }
+    if (arena->maps) {
+        destroy(arena->maps);
+    }
+    for (i = 0; i < 2; i++) {
+        if (arena->scratch[i]) {
+            destroy(arena->scratch[i]);
+        }
+    }
+    destroy(arena);
+}
+
+void krpc_arena_reset(krpc_arena_t* arena) {
+    uint32_t i = 0;
+    verify(arena);
+    for (; i < arena->map_count; i++) {
+        hash_clear(arena->maps[i]);
+    }
+    arena->map_count = 0;
+    arena->current   = arena->first;
+    if (arena->current) {
+        arena->current->pos = 0;
+    }
+}
+
+char* krpc_arena_get_scratch(krpc_arena_t* arena, int index, uint32_t size) {
+    char* buffer = 0;
+    verify(arena);
+    verify((index >= 0) && (index < 2));
+    if (arena->scratch_size[index] < size) {
+        buffer = rcreate_raw(arena->scratch[index], size);
+        if (!buffer) {
+            return 0;
+        }
+        arena->scratch[index]      = buffer;
+        arena->scratch_size[index] = size;
+    }
+    return arena->scratch[index];
+}
+
+void* _krpc_arena_alloc(krpc_arena_t* arena, uint32_t size) {
+    krpc_arena_chunk_t* chunk = arena->current;
+    void*               ptr   = 0;
+    size = (size + 7) & ~7;
+    while (chunk && (chunk->size - chunk->pos < size)) {
+        /* еĺڴúδʹ */
+        chunk = chunk->next;
+        if (chunk) {
+            chunk->pos = 0;
+        }
+    }
+    if (!chunk) {
+        chunk = (krpc_arena_chunk_t*)create_raw(sizeof(krpc_arena_chunk_t) +
+            ((size > RPC_ARENA_CHUNK_SIZE) ? size : RPC_ARENA_CHUNK_SIZE));
+        if (!chunk) {
+            return 0;
+        }
+        chunk->size = (size > RPC_ARENA_CHUNK_SIZE) ? size : RPC_ARENA_CHUNK_SIZE;
+        chunk->pos  = 0;
+        chunk->next = 0;
+        if (arena->current) {
+            /* 뵽ǰڴ֮, ֮ǰڴ鱣 */
+            chunk->next          = arena->current->next;
+            arena->current->next = chunk;
+        } else {
+            chunk->next  = arena->first;
+            arena->first = chunk;
+        }
+    }
+    arena->current = chunk;
+    ptr = (char*)(chunk + 1) + chunk->pos;
+    chunk->pos += size;
+    return ptr;
+}
+
+khash_t* _krpc_arena_get_hash(krpc_arena_t* arena) {
+    khash_t** maps = 0;
+    if (arena->map_count < arena->max_maps) {
+        return arena->maps[arena->map_count++];
+    }
+    maps = (khash_t**)rcreate_type_ptr_array(khash_t, arena->maps, arena->max_maps + 1);
+    if (!maps) {
+        return 0;
+    }
+    arena->maps = maps;
+    /* ֵڴڷ, Ҫٺ */
+    arena->maps[arena->max_maps] = hash_create(0, 0);
+    if (!arena->maps[arena->max_maps]) {
+        return 0;
+    }
+    arena->max_maps++;
+    return arena->maps[arena->map_count++];
+}
+
 krpc_object_t* krpc_object_create() {
     krpc_object_t* o = create(krpc_object_t);
     verify(o);
@@ -104,6 +267,10 @@ krpc_object_t* krpc_object_create() {
 void krpc_object_destroy(krpc_object_t* o) {
     int i = 0;
     verify(o);
+    if (o->flag & krpc_object_flag_arena) {
+        /* ڴһͷ */
+        return;
+    }
     if (o->type & krpc_type_string) {
         /* ַ */
         if (o->string.str) {
@@ -128,6 +295,10 @@ void krpc_object_destroy(krpc_object_t* o) {
     destroy(o);
 }
 
+int _krpc_object_check_arena(krpc_object_t* o) {
+    return (o->flag & krpc_object_flag_arena);
+}
+
 int krpc_object_check_type(krpc_object_t* o, knet_rpc_type_e type) {
     verify(o);
     if (!o->type) {
@@ -161,9 +332,34 @@ uint16_t krpc_number_get_marshal_size(krpc_object_t* o) {
     return 0;
 }
 
-uint16_t krpc_object_get_marshal_size(krpc_object_t* o) {
-    uint16_t       size = sizeof(krpc_object_header_t);
-    uint16_t       i    = 0;
+uint32_t _krpc_object_header_size(krpc_format_e format) {
+    return (format == krpc_format_long) ? sizeof(krpc_object_long_header_t) : sizeof(krpc_object_header_t);
+}
+
+int _krpc_object_read_header(char* buffer, uint32_t size, krpc_format_e format, uint16_t* type, uint32_t* length) {
+    krpc_object_header_t      header;
+    krpc_object_long_header_t long_header;
+    if (size < _krpc_object_header_size(format)) {
+        return error_rpc_unmarshal_fail;
+    }
+    if (format == krpc_format_long) {
+        memcpy(&long_header, buffer, sizeof(long_header));
+        *type   = long_header.type;
+        *length = long_header.length;
+    } else {
+        memcpy(&header, buffer, sizeof(header));
+        *type   = header.type;
+        *length = header.length;
+    }
+    if ((*length < _krpc_object_header_size(format)) || (*length > size)) {
+        return error_rpc_unmarshal_fail;
+    }
+    return error_ok;
+}
+
+uint32_t krpc_object_get_marshal_length(krpc_object_t* o, krpc_format_e format) {
+    uint32_t       size = _krpc_object_header_size(format);
+    uint32_t       i    = 0;
     krpc_object_t* k    = 0;
     krpc_object_t* v    = 0;
     verify(o);
@@ -173,7 +369,7 @@ uint16_t krpc_object_get_marshal_size(krpc_object_t* o) {
     } else if (o->type & krpc_type_vector) {
         /*  */
         for (; i < o->vector.size; i++) {
-            size += krpc_object_get_marshal_size(o->vector.objects[i]);
+            size += krpc_object_get_marshal_length(o->vector.objects[i], format);
         }
     } else if (o->type & krpc_type_number) {
         /*  */
@@ -181,12 +377,10 @@ uint16_t krpc_object_get_marshal_size(krpc_object_t* o) {
     } else if (o->type & krpc_type_map) {
         /*  */
         if (krpc_map_get_first(o, &k, &v)) {
-            size += krpc_object_get_marshal_size(k);
-            size += krpc_object_get_marshal_size(v);
-            while (krpc_map_next(o, &k, &v)) {
-                size += krpc_object_get_marshal_size(k);
-                size += krpc_object_get_marshal_size(v);
-            }
+            do {
+                size += krpc_object_get_marshal_length(k, format);
+                size += krpc_object_get_marshal_length(v, format);
+            } while (krpc_map_next(o, &k, &v));
         }
     } else {
         return 0;
@@ -194,160 +388,140 @@ uint16_t krpc_object_get_marshal_size(krpc_object_t* o) {
     return size;
 }
 
-int krpc_object_marshal(krpc_object_t* o, kstream_t* stream, uint16_t* bytes) {
-    uint16_t       size = 0;
-    int            i    = 0;
+uint16_t krpc_object_get_marshal_size(krpc_object_t* o) {
+    uint32_t size = krpc_object_get_marshal_length(o, krpc_format_short);
+    /* Э鳤 */
+    return (size > 0xffff) ? 0 : (uint16_t)size;
+}
+
+uint32_t krpc_object_marshal_format(krpc_object_t* o, char* buffer, uint32_t length, krpc_format_e format) {
+    uint32_t       pos  = _krpc_object_header_size(format);
+    uint32_t       size = 0;
+    uint32_t       i    = 0;
     krpc_object_t* k    = 0;
     krpc_object_t* v    = 0;
-    krpc_object_header_t header;
+    uint16_t       ui16 = 0;
+    uint32_t       ui32 = 0;
+    uint64_t       ui64 = 0;
+    krpc_object_header_t      header;
+    krpc_object_long_header_t long_header;
     verify(o);
-    verify(stream);
-    memset(&header, 0, sizeof(krpc_object_header_t));
-    header.type   = o->type;
-    header.length += krpc_object_get_marshal_size(o);
-    if (error_ok != knet_stream_push(stream, &header, sizeof(krpc_object_header_t))) {
-        return error_rpc_marshal_fail;
+    verify(buffer);
+    if (length < pos) {
+        return 0;
     }
     if (o->type & krpc_type_string) {
         /* ַ */
-        if (error_ok != knet_stream_push(stream, o->string.str, o->string.size)) {
-            return error_rpc_marshal_fail;
+        if (length - pos < o->string.size) {
+            return 0;
         }
+        memcpy(buffer + pos, o->string.str, o->string.size);
+        pos += o->string.size;
     } else if (o->type & krpc_type_vector) {
         /*  */
-        for (; i < o->vector.size; i++) {
-            /* ݹ */
-            if (error_ok != krpc_object_marshal(o->vector.objects[i], stream, &size)) {
-                return error_rpc_marshal_fail;
+        for (; i < o->vector.size; i++, pos += size) {
+            size = krpc_object_marshal_format(o->vector.objects[i], buffer + pos, length - pos, format);
+            if (!size) {
+                return 0;
             }
         }
     } else if (o->type & krpc_type_map) {
         /*  */
         if (krpc_map_get_first(o, &k, &v)) {
-            if (error_ok != krpc_object_marshal(k, stream, &size)) {
-                return error_rpc_marshal_fail;
-            }
-            if (error_ok != krpc_object_marshal(v, stream, &size)) {
-                return error_rpc_marshal_fail;
-            }
-            while (krpc_map_next(o, &k, &v)) {
-                if (error_ok != krpc_object_marshal(k, stream, &size)) {
-                    return error_rpc_marshal_fail;
+            do {
+                size = krpc_object_marshal_format(k, buffer + pos, length - pos, format);
+                if (!size) {
+                    return 0;
                 }
-                if (error_ok != krpc_object_marshal(v, stream, &size)) {
-                    return error_rpc_marshal_fail;
+                pos += size;
+                size = krpc_object_marshal_format(v, buffer + pos, length - pos, format);
+                if (!size) {
+                    return 0;
                 }
-            }
+                pos += size;
+            } while (krpc_map_next(o, &k, &v));
         }
     } else if (o->type & krpc_type_number) {
         /*  */
-        if (krpc_object_check_type(o, krpc_type_i16) || krpc_object_check_type(o, krpc_type_ui16)) {
-            uint16_t ui16 = htons(o->number.ui16);
-            if (error_ok != knet_stream_push(stream, &ui16, krpc_number_get_marshal_size(o))) {
-                return error_rpc_marshal_fail;
-            }
-        } else if (krpc_object_check_type(o, krpc_type_i32) || krpc_object_check_type(o, krpc_type_ui32)) {
-            uint32_t ui32 = htonl(o->number.ui32);
-            if (error_ok != knet_stream_push(stream, &ui32, krpc_number_get_marshal_size(o))) {
-                return error_rpc_marshal_fail;
-            }
-        } else if (krpc_object_check_type(o, krpc_type_i64) || krpc_object_check_type(o, krpc_type_ui64)) {
-            uint64_t ui64 = htonll(o->number.ui64);
-            if (error_ok != knet_stream_push(stream, &ui64, krpc_number_get_marshal_size(o))) {
-                return error_rpc_marshal_fail;
-            }
+        size = krpc_number_get_marshal_size(o);
+        if (length - pos < size) {
+            return 0;
+        }
+        if ((o->type & krpc_type_i16) || (o->type & krpc_type_ui16)) {
+            ui16 = htons(o->number.ui16);
+            memcpy(buffer + pos, &ui16, size);
+        } else if ((o->type & krpc_type_i32) || (o->type & krpc_type_ui32)) {
+            ui32 = htonl(o->number.ui32);
+            memcpy(buffer + pos, &ui32, size);
+        } else if ((o->type & krpc_type_i64) || (o->type & krpc_type_ui64)) {
+            ui64 = htonll(o->number.ui64);
+            memcpy(buffer + pos, &ui64, size);
         } else {
-            if (error_ok != knet_stream_push(stream, &o->number, krpc_number_get_marshal_size(o))) {
-                return error_rpc_marshal_fail;
-            }
+            memcpy(buffer + pos, &o->number, size);
         }
+        pos += size;
     } else {
+        return 0;
+    }
+    /* ӶдЭͷ */
+    if (format == krpc_format_long) {
+        long_header.type   = o->type;
+        long_header.length = pos;
+        memcpy(buffer, &long_header, sizeof(long_header));
+    } else {
+        if (pos > 0xffff) {
+            /* Э鳤 */
+            return 0;
+        }
+        header.type   = o->type;
+        header.length = (uint16_t)pos;
+        memcpy(buffer, &header, sizeof(header));
+    }
+    return pos;
+}
+
+int krpc_object_marshal(krpc_object_t* o, kstream_t* stream, uint16_t* bytes) {
+    char     stack_buffer[RPC_MARSHAL_STACK_SIZE];
+    char*    buffer = stack_buffer;
+    uint32_t length = 0;
+    int      error  = error_ok;
+    verify(o);
+    verify(stream);
+    /* ֻһγ, лһд */
+    length = krpc_object_get_marshal_length(o, krpc_format_short);
+    if (!length || (length > 0xffff)) {
         return error_rpc_marshal_fail;
     }
-    if (bytes) {
-        *bytes = header.length;
+    if (length > sizeof(stack_buffer)) {
+        buffer = create_raw(length);
+        if (!buffer) {
+            return error_no_memory;
+        }
     }
-    return error_ok;
+    if (length != krpc_object_marshal_format(o, buffer, length, krpc_format_short)) {
+        error = error_rpc_marshal_fail;
+    } else if (error_ok != knet_stream_push(stream, buffer, (int)length)) {
+        error = error_rpc_marshal_fail;
+    } else if (bytes) {
+        *bytes = (uint16_t)length;
+    }
+    if (buffer != stack_buffer) {
+        destroy(buffer);
+    }
+    return error;
 }
 
 int krpc_object_marshal_buffer(krpc_object_t* o, char* buffer, uint16_t length, uint16_t* bytes) {
-    uint16_t       size = 0;
-    uint16_t       pos  = 0;
-    int            i    = 0;
-    krpc_object_t* k    = 0;
-    krpc_object_t* v    = 0;
-    krpc_object_header_t header;
+    uint32_t size = 0;
     verify(o);
     verify(buffer);
     verify(length);
     verify(bytes);
-    memset(&header, 0, sizeof(krpc_object_header_t));
-    header.type   = o->type;
-    header.length += krpc_object_get_marshal_size(o);
-    if (length < header.length + sizeof(krpc_object_header_t)) {
-        return error_rpc_marshal_fail;
-    }
-    memcpy(buffer, &header, sizeof(header));
-    pos += sizeof(header);
-    if (o->type & krpc_type_string) {
-        /* ַ */
-        memcpy(buffer + pos, o->string.str, o->string.size);
-        pos += o->string.size;
-    } else if (o->type & krpc_type_vector) {
-        /*  */
-        for (; i < o->vector.size; i++) {
-            /* ݹ */
-            if (error_ok != krpc_object_marshal_buffer(o->vector.objects[i], buffer + pos, length - pos, &size)) {
-                return error_rpc_marshal_fail;
-            }
-            pos += krpc_object_get_marshal_size(o->vector.objects[i]);
-        }
-    } else if (o->type & krpc_type_map) {
-        /*  */
-        if (krpc_map_get_first(o, &k, &v)) {
-            if (error_ok != krpc_object_marshal_buffer(k, buffer + pos, length - pos, &size)) {
-                return error_rpc_marshal_fail;
-            }
-            pos += krpc_object_get_marshal_size(k);
-            if (error_ok != krpc_object_marshal_buffer(v, buffer + pos, length - pos, &size)) {
-                return error_rpc_marshal_fail;
-            }
-            pos += krpc_object_get_marshal_size(v);
-            while (krpc_map_next(o, &k, &v)) {
-                if (error_ok != krpc_object_marshal_buffer(k, buffer + pos, length - pos, &size)) {
-                    return error_rpc_marshal_fail;
-                }
-                pos += krpc_object_get_marshal_size(k);
-                if (error_ok != krpc_object_marshal_buffer(v, buffer + pos, length - pos, &size)) {
-                    return error_rpc_marshal_fail;
-                }
-                pos += krpc_object_get_marshal_size(v);
-            }
-        }
-    } else if (o->type & krpc_type_number) {
-        /*  */
-        if (krpc_object_check_type(o, krpc_type_i16) || krpc_object_check_type(o, krpc_type_ui16)) {
-            uint16_t ui16 = htons(o->number.ui16);
-            memcpy(buffer + pos, &ui16, sizeof(ui16));
-            pos += sizeof(uint16_t);
-        } else if (krpc_object_check_type(o, krpc_type_i32) || krpc_object_check_type(o, krpc_type_ui32)) {
-            uint32_t ui32 = htonl(o->number.ui32);
-            memcpy(buffer + pos, &ui32, sizeof(ui32));
-            pos += sizeof(uint32_t);
-        } else if (krpc_object_check_type(o, krpc_type_i64) || krpc_object_check_type(o, krpc_type_ui64)) {
-            uint64_t ui64 = htonll(o->number.ui64);
-            memcpy(buffer + pos, &ui64, sizeof(ui64));
-            pos += sizeof(uint64_t);
-        } else {
-            memcpy(buffer + pos, &o->number, krpc_number_get_marshal_size(o));
-            pos += krpc_number_get_marshal_size(o);
-        }
-    } else {
+    size = krpc_object_marshal_format(o, buffer, length, krpc_format_short);
+    if (!size) {
         return error_rpc_marshal_fail;
     }
-    if (bytes) {
-        *bytes = header.length;
-    }
+    *bytes = (uint16_t)size;
     return error_ok;
 }
 
@@ -499,7 +673,7 @@ int krpc_object_unmarshal_buffer(char* buffer, uint16_t size, krpc_object_t** o,
         if (error_ok != krpc_string_set_size(*o, header.length - sizeof(krpc_object_header_t))) {
             goto error_return;
         }
-        memcpy(buffer + pos, (*o)->string.str, header.length - sizeof(krpc_object_header_t));
+        memcpy((*o)->string.str, buffer + pos, header.length - sizeof(krpc_object_header_t));
         pos += header.length - sizeof(krpc_object_header_t);
         (*o)->string.size = header.length - sizeof(krpc_object_header_t);
     } else if (header.type & krpc_type_vector) {
@@ -519,7 +693,6 @@ int krpc_object_unmarshal_buffer(char* buffer, uint16_t size, krpc_object_t** o,
     } else if (header.type & krpc_type_map) {
         /*  */
         length = header.length - sizeof(krpc_object_header_t);
-        pos += header.length - sizeof(krpc_object_header_t);
         for (; length; ) {
             /* ݹ - key*/
             if (error_ok != krpc_object_unmarshal_buffer(buffer + pos, size - pos, &k, &consume)) {
@@ -561,8 +734,136 @@ error_return:
     return error_rpc_unmarshal_fail;
 }
 
+int krpc_object_unmarshal_arena(krpc_arena_t* arena, char* buffer, uint32_t size, krpc_format_e format,
+    krpc_object_t** o, uint32_t* bytes) {
+    uint16_t       type    = 0; /*  */
+    uint32_t       total   = 0; /* 󳤶, Эͷ */
+    uint32_t       length  = 0; /* 峤 */
+    uint32_t       consume = 0; /* unmarshalֽ */
+    uint32_t       pos     = _krpc_object_header_size(format); /* ǰλ */
+    uint32_t       count   = 0; /* Ԫظ */
+    uint16_t       child   = 0; /* Ӷ */
+    krpc_object_t* k       = 0; /* key -  */
+    krpc_object_t* v       = 0; /* value -  */
+    krpc_value_t*  kvalue  = 0; /* Ԫ */
+    verify(arena);
+    verify(buffer);
+    verify(o);
+    verify(bytes);
+    *o = 0;
+    if (error_ok != _krpc_object_read_header(buffer, size, format, &type, &total)) {
+        return error_rpc_unmarshal_fail;
+    }
+    length = total - pos;
+    *o = (krpc_object_t*)_krpc_arena_alloc(arena, sizeof(krpc_object_t));
+    if (!*o) {
+        return error_rpc_unmarshal_fail;
+    }
+    memset(*o, 0, sizeof(krpc_object_t));
+    (*o)->flag = krpc_object_flag_arena;
+    if (type & krpc_type_number) {
+        /*  */
+        if (length > sizeof(krpc_number_t)) {
+            return error_rpc_unmarshal_fail;
+        }
+        memcpy(&(*o)->number, buffer + pos, length);
+        if ((type & krpc_type_i16) || (type & krpc_type_ui16)) {
+            (*o)->number.ui16 = ntohs((*o)->number.ui16);
+        } else if ((type & krpc_type_i32) || (type & krpc_type_ui32)) {
+            (*o)->number.ui32 = ntohl((*o)->number.ui32);
+        } else if ((type & krpc_type_i64) || (type & krpc_type_ui64)) {
+            (*o)->number.ui64 = ntohll((*o)->number.ui64);
+        }
+    } else if (type & krpc_type_string) {
+        /* ַ, 0βʱֱָ򻺳 */
+        if (!length) {
+            return error_rpc_unmarshal_fail;
+        }
+        if (buffer[pos + length - 1]) {
+            (*o)->string.str = (char*)_krpc_arena_alloc(arena, length + 1);
+            if (!(*o)->string.str) {
+                return error_rpc_unmarshal_fail;
+            }
+            memcpy((*o)->string.str, buffer + pos, length);
+            (*o)->string.str[length] = 0;
+        } else {
+            (*o)->string.str = buffer + pos;
+        }
+        (*o)->string.size = length;
+    } else if (type & krpc_type_vector) {
+        /* , ȱӶЭͷõԪظ, һηָ */
+        for (; pos < total; pos += consume, count++) {
+            if (error_ok != _krpc_object_read_header(buffer + pos, total - pos, format, &child, &consume)) {
+                return error_rpc_unmarshal_fail;
+            }
+        }
+        if (count) {
+            (*o)->vector.objects = (krpc_object_t**)_krpc_arena_alloc(arena, sizeof(krpc_object_t*) * count);
+            if (!(*o)->vector.objects) {
+                return error_rpc_unmarshal_fail;
+            }
+        }
+        for (pos = _krpc_object_header_size(format); pos < total; pos += consume) {
+            /* ݹ */
+            if (error_ok != krpc_object_unmarshal_arena(arena, buffer + pos, total - pos, format,
+                (*o)->vector.objects + (*o)->vector.size, &consume)) {
+                return error_rpc_unmarshal_fail;
+            }
+            (*o)->vector.size++;
+        }
+        (*o)->vector.max_size = (*o)->vector.size;
+    } else if (type & krpc_type_map) {
+        /*  */
+        if (length) {
+            (*o)->map.hash = _krpc_arena_get_hash(arena);
+            if (!(*o)->map.hash) {
+                return error_rpc_unmarshal_fail;
+            }
+        }
+        while (pos < total) {
+            if (error_ok != krpc_object_unmarshal_arena(arena, buffer + pos, total - pos, format, &k, &consume)) {
+                return error_rpc_unmarshal_fail;
+            }
+            pos += consume;
+            if (error_ok != krpc_object_unmarshal_arena(arena, buffer + pos, total - pos, format, &v, &consume)) {
+                return error_rpc_unmarshal_fail;
+            }
+            pos += consume;
+            if (!(k->type & (krpc_type_number | krpc_type_string))) {
+                /* ַֻ֧ */
+                return error_rpc_unmarshal_fail;
+            }
+            if (!(*o)->map.key_type) {
+                (*o)->map.key_type   = k->type;
+                (*o)->map.value_type = v->type;
+            }
+            kvalue = (krpc_value_t*)_krpc_arena_alloc(arena, sizeof(krpc_value_t));
+            if (!kvalue) {
+                return error_rpc_unmarshal_fail;
+            }
+            kvalue->key   = k;
+            kvalue->value = v;
+            if (k->type & krpc_type_number) {
+                if (error_ok != hash_add((*o)->map.hash, k->number.ui32, kvalue)) {
+                    return error_rpc_unmarshal_fail;
+                }
+            } else if (error_ok != hash_add_string_key((*o)->map.hash, k->string.str, kvalue)) {
+                return error_rpc_unmarshal_fail;
+            }
+        }
+    } else {
+        /* δ֪ */
+        return error_rpc_unmarshal_fail;
+    }
+    (*o)->type = type;  /*  */
+    *bytes     = total; /* ֽ */
+    return error_ok;
+}
+
 void krpc_number_set_i8(krpc_object_t* o, int8_t i8) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -580,6 +881,8 @@ int8_t krpc_number_get_i8(krpc_object_t* o) {
 
 void krpc_number_set_i16(krpc_object_t* o, int16_t i16) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -597,6 +900,8 @@ int16_t krpc_number_get_i16(krpc_object_t* o) {
 
 void krpc_number_set_i32(krpc_object_t* o, int32_t i32) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -614,6 +919,8 @@ int32_t krpc_number_get_i32(krpc_object_t* o) {
 
 void krpc_number_set_i64(krpc_object_t* o, int64_t i64) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -631,6 +938,8 @@ int64_t krpc_number_get_i64(krpc_object_t* o) {
 
 void krpc_number_set_ui8(krpc_object_t* o, uint8_t ui8) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -648,6 +957,8 @@ uint8_t krpc_number_get_ui8(krpc_object_t* o) {
 
 void krpc_number_set_ui16(krpc_object_t* o, uint16_t ui16) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -665,6 +976,8 @@ uint16_t krpc_number_get_ui16(krpc_object_t* o) {
 
 void krpc_number_set_ui32(krpc_object_t* o, uint32_t ui32) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -682,6 +995,8 @@ uint32_t krpc_number_get_ui32(krpc_object_t* o) {
 
 void krpc_number_set_ui64(krpc_object_t* o, uint64_t ui64) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -699,6 +1014,8 @@ uint64_t krpc_number_get_ui64(krpc_object_t* o) {
 
 void krpc_number_set_f32(krpc_object_t* o, float32_t f32) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -716,6 +1033,8 @@ float32_t krpc_number_get_f32(krpc_object_t* o) {
 
 void krpc_number_set_f64(krpc_object_t* o, float64_t f64) {
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_number)) {
         verify(0);
     }
@@ -732,13 +1051,15 @@ float64_t krpc_number_get_f64(krpc_object_t* o) {
 }
 
 void krpc_string_set(krpc_object_t* o, const char* s) {
-    uint16_t size = 0;
+    uint32_t size = 0;
     verify(o);
     verify(s);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_string)) {
         verify(0);
     }
-    size = (uint16_t)strlen(s) + 1;
+    size = (uint32_t)strlen(s) + 1;
     if (!o->string.str) {
         o->string.str = create_type(char, size);
     }
@@ -755,9 +1076,11 @@ void krpc_string_set(krpc_object_t* o, const char* s) {
     o->type = krpc_type_string;
 }
 
-void krpc_string_set_s(krpc_object_t* o, const char* s, uint16_t size) {
+void krpc_string_set_s(krpc_object_t* o, const char* s, uint32_t size) {
     verify(o);
     verify(s);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!krpc_object_check_type(o, krpc_type_string)) {
         verify(0);
     }
@@ -777,9 +1100,13 @@ void krpc_string_set_s(krpc_object_t* o, const char* s, uint16_t size) {
     o->type = krpc_type_string;
 }
 
-int krpc_string_set_size(krpc_object_t* o, uint16_t size) {
+int krpc_string_set_size(krpc_object_t* o, uint32_t size) {
     verify(o);
     verify(size);
+    if (_krpc_object_check_arena(o)) {
+        /* õĶֻ */
+        return error_invalid_parameters;
+    }
     if (!krpc_object_check_type(o, krpc_type_string)) {
         verify(0);
     }
@@ -798,7 +1125,7 @@ const char* krpc_string_get(krpc_object_t* o) {
     return o->string.str;
 }
 
-uint16_t krpc_string_get_size(krpc_object_t* o) {
+uint32_t krpc_string_get_size(krpc_object_t* o) {
     verify(o);
     if (!(o->type & krpc_type_string)) {
         verify(0);
@@ -807,8 +1134,11 @@ uint16_t krpc_string_get_size(krpc_object_t* o) {
 }
 
 void krpc_vector_enlarge(krpc_object_t* o) {
-    static const uint16_t DEFAULT_SIZE = 8;
+    static const uint32_t DEFAULT_SIZE = 8;
+    uint32_t              old_size     = 0;
     verify(o);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(o));
     if (!o->vector.objects) { /* һν */
         o->vector.max_size = DEFAULT_SIZE;
         o->vector.objects = (krpc_object_t**)create_type(krpc_object_t,
@@ -816,18 +1146,23 @@ void krpc_vector_enlarge(krpc_object_t* o) {
         verify(o->vector.objects);
         memset(o->vector.objects, 0, sizeof(krpc_object_t*) * o->vector.max_size);
     }
-    if (o->vector.size >= o->vector.max_size) { /*  */
-        o->vector.max_size += DEFAULT_SIZE;
+    if (o->vector.size >= o->vector.max_size) { /* ,  */
+        old_size = o->vector.max_size;
+        o->vector.max_size *= 2;
         o->vector.objects = (krpc_object_t**)rcreate_type(krpc_object_t,
             o->vector.objects, sizeof(krpc_object_t*) * o->vector.max_size);
         verify(o->vector.objects);
-        memset(o->vector.objects + (o->vector.max_size - DEFAULT_SIZE), 0, sizeof(krpc_object_t*) * DEFAULT_SIZE);
+        memset(o->vector.objects + old_size, 0, sizeof(krpc_object_t*) * (o->vector.max_size - old_size));
     }
 }
 
 int krpc_vector_push_back(krpc_object_t* v, krpc_object_t* o) {
     verify(v);
     verify(o);
+    if (_krpc_object_check_arena(v)) {
+        /* õĶֻ */
+        return error_invalid_parameters;
+    }
     if (!krpc_object_check_type(v, krpc_type_vector)) {
         verify(0);
     }
@@ -851,7 +1186,7 @@ krpc_object_t* krpc_vector_get(krpc_object_t* v, int index) {
     if (!(v->type & krpc_type_vector)) {
         verify(0);
     }
-    if (index >= v->vector.size) {
+    if ((uint32_t)index >= v->vector.size) {
         return 0;
     }
     return v->vector.objects[index];
@@ -861,10 +1196,14 @@ int krpc_vector_set(krpc_object_t* v, krpc_object_t* o, int index) {
     verify(v);
     verify(o);
     verify(index >= 0);
+    if (_krpc_object_check_arena(v)) {
+        /* õĶֻ */
+        return error_invalid_parameters;
+    }
     if (!krpc_object_check_type(v, krpc_type_vector)) {
         verify(0);
     }
-    if (index >= v->vector.size) {
+    if ((uint32_t)index >= v->vector.size) {
         return error_rpc_vector_out_of_bound;
     }
     if (v->vector.objects[index]) {
@@ -876,8 +1215,10 @@ int krpc_vector_set(krpc_object_t* v, krpc_object_t* o, int index) {
 }
 
 void krpc_vector_clear(krpc_object_t* v) {
-    uint16_t i = 0;
+    uint32_t i = 0;
     verify(v);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(v));
     if (!krpc_object_check_type(v, krpc_type_vector)) {
         verify(0);
     }
@@ -908,6 +1249,10 @@ int krpc_map_insert(krpc_object_t* m, krpc_object_t* k, krpc_object_t* v) {
     verify(m);
     verify(k);
     verify(v);
+    if (_krpc_object_check_arena(m)) {
+        /* õĶֻ */
+        return error_invalid_parameters;
+    }
     if (!krpc_object_check_type(m, krpc_type_map)) {
         verify(0);
     }
@@ -972,6 +1317,10 @@ int krpc_map_update(krpc_object_t* m, krpc_object_t* k, krpc_object_t* v) {
     verify(m);
     verify(k);
     verify(v);
+    if (_krpc_object_check_arena(m)) {
+        /* õĶֻ */
+        return error_invalid_parameters;
+    }
     if (!m->map.hash) {
         m->map.hash = hash_create(0, hash_value_dtor);
     }
@@ -1064,6 +1413,8 @@ int krpc_map_next(krpc_object_t* m, krpc_object_t** k, krpc_object_t** v) {
 
 void krpc_map_clear(krpc_object_t* m) {
     verify(m);
+    /* õĶֻ */
+    verify(!_krpc_object_check_arena(m));
     if (!krpc_object_check_type(m, krpc_type_map)) {
         verify(0);
     }
@@ -28,6 +28,14 @@
 #include "config.h"
 #include "rpc_object_api.h"
 
+/**
+ * лʽ
+ */
+typedef enum _krpc_format_e {
+    krpc_format_short = 0, /* 16λ, 󲻳64KB */
+    krpc_format_long,      /* 32λ */
+} krpc_format_e;
+
 /**
  * ȡֶл
  * @param o krpc_object_tʵ
@@ -35,6 +43,24 @@
  */
 uint16_t krpc_number_get_marshal_size(krpc_object_t* o);
 
+/**
+ * ȡл, ضΪ16λ, Э鳤ʱɵߴ
+ * @param o krpc_object_tʵ
+ * @param format лʽ
+ * @return л
+ */
+uint32_t krpc_object_get_marshal_length(krpc_object_t* o, krpc_format_e format);
+
+/**
+ * ָʽл, дӶٻЭͷ
+ * @param o krpc_object_tʵ
+ * @param buffer 
+ * @param length 
+ * @param format лʽ
+ * @return дֽ, 0ʾ򳬳Э鳤
+ */
+uint32_t krpc_object_marshal_format(krpc_object_t* o, char* buffer, uint32_t length, krpc_format_e format);
+
 /**
  * ַ
  * @param o krpc_object_tʵ
@@ -42,7 +68,7 @@ uint16_t krpc_number_get_marshal_size(krpc_object_t* o);
  * @retval error_ok ɹ
  * @retval  ʧ
  */
-int krpc_string_set_size(krpc_object_t* o, uint16_t size);
+int krpc_string_set_size(krpc_object_t* o, uint32_t size);
 
 /**
  * չ
@@ -55,4 +81,49 @@ void krpc_vector_enlarge(krpc_object_t* o);
  */
 void hash_value_dtor(void* v);
 
+/**
+ * RPCڴ
+ * @return krpc_arena_tʵ
+ */
+krpc_arena_t* krpc_arena_create();
+
+/**
+ * RPCڴ
+ * @param arena krpc_arena_tʵ
+ */
+void krpc_arena_destroy(krpc_arena_t* arena);
+
+/**
+ * ڴ, νõжһͷ, ѷڴ汣һν
+ * @param arena krpc_arena_tʵ
+ */
+void krpc_arena_reset(krpc_arena_t* arena);
+
+/**
+ * ȡڴڵʱ, Ȳʱչ
+ * @param arena krpc_arena_tʵ
+ * @param index (01)
+ * @param size Ҫĳ
+ * @retval 0 ʧ
+ * @retval Чָ 
+ */
+char* krpc_arena_get_scratch(krpc_arena_t* arena, int index, uint32_t size);
+
+/**
+ * ӻunmarshal, ڴڷ
+ *
+ * 0βֱַָ򻺳, krpc_arena_reset()ǰЧ.
+ * õĶֻ, krpc_object_destroy()Ч
+ * @param arena krpc_arena_tʵ
+ * @param buffer 
+ * @param size 
+ * @param format лʽ
+ * @param o õĶ
+ * @param bytes ĵֽ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+int krpc_object_unmarshal_arena(krpc_arena_t* arena, char* buffer, uint32_t size, krpc_format_e format,
+    krpc_object_t** o, uint32_t* bytes);
+
 #endif /* RPC_OBJECT_H */
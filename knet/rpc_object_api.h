@@ -62,6 +62,9 @@
  *  Ϊ֣8λз. Ͳûṩǳḻķ
  * Ϊ׿ܱRPCͨõ⣬ʹõĶλ봫ͳбʵĲͬ.
  *
+ * krpc_proc()ûصʱĶkloop_tڴڽ룬ֻģش޸
+ * ䷵error_invalid_parameters޸ķverify.
+ *
  * </pre>
  * @{
  */
@@ -119,12 +122,13 @@ extern int krpc_object_check_type(krpc_object_t* o, knet_rpc_type_e type);
 /**
  * ȡлĳ
  * @param o krpc_object_tʵ
- * @return ȡлĳ
+ * @retval 0 Э鳤
+ * @retval  лĳ
  */
 extern uint16_t krpc_object_get_marshal_size(krpc_object_t* o);
 
 /**
- * л
+ * л, лһд
  * @param o krpc_object_tʵ
  * @param stream kstream_tʵ
  * @param bytes дֽ
@@ -318,7 +322,7 @@ extern void krpc_string_set(krpc_object_t* o, const char* s);
  * @param size ַȣβ
  * @param s ַָ
  */
-extern void krpc_string_set_s(krpc_object_t* o, const char* s, uint16_t size);
+extern void krpc_string_set_s(krpc_object_t* o, const char* s, uint32_t size);
 
 /**
  * ȡַָ
@@ -332,10 +336,10 @@ extern const char* krpc_string_get(krpc_object_t* o);
  * @param o krpc_object_tʵ
  * @return ַ
  */
-extern uint16_t krpc_string_get_size(krpc_object_t* o);
+extern uint32_t krpc_string_get_size(krpc_object_t* o);
 
 /**
- * ӵβĬϳΪ8ÿε8
+ * ӵβĬϳΪ8ʱ
  * @param v krpc_object_tʵ
  * @param o Ԫ
  * @retval error_ok ɹ
@@ -34,19 +34,21 @@ struct _stream_t {
     kchannel_ref_t* channel_ref;
 };
 
-kstream_t* stream_create(kchannel_ref_t* channel_ref) {
-    kstream_t* stream = 0;
-    verify(channel_ref);
-    stream = create(kstream_t);
-    memset(stream, 0, sizeof(kstream_t));
+uint32_t stream_get_object_size() {
+    return sizeof(kstream_t);
+}
+
+kchannel_ref_t* stream_get_channel_ref(kstream_t* stream) {
     verify(stream);
-    stream->channel_ref = channel_ref;
-    return stream;
+    return stream->channel_ref;
 }
 
-void stream_destroy(kstream_t* stream) {
+kstream_t* stream_init(void* ptr, kchannel_ref_t* channel_ref) {
+    kstream_t* stream = (kstream_t*)ptr;
     verify(stream);
-    destroy(stream);
+    verify(channel_ref);
+    stream->channel_ref = channel_ref;
+    return stream;
 }
 
 int knet_stream_available(kstream_t* stream) {
@@ -64,6 +66,12 @@ int knet_stream_pop(kstream_t* stream, void* buffer, int size) {
     return error_recv_fail;
 }
 
+void* knet_stream_peek_ptr(kstream_t* stream, int size) {
+    verify(stream);
+    verify(size > 0);
+    return ringbuffer_peek_ptr(knet_channel_ref_get_ringbuffer(stream->channel_ref), (uint32_t)size);
+}
+
 int knet_stream_pop_until(kstream_t* stream, const char* end, void* buffer, int* size) {
     uint32_t max_size = 0;
     int      error    = error_ok;
@@ -102,6 +110,13 @@ int knet_stream_push(kstream_t* stream, const void* buffer, int size) {
     return knet_channel_ref_write(stream->channel_ref, (char*)buffer, size);
 }
 
+int knet_stream_pushv(kstream_t* stream, const kiovec_t* iov, int count) {
+    verify(stream);
+    verify(iov);
+    verify(count);
+    return knet_channel_ref_writev(stream->channel_ref, iov, count);
+}
+
 int knet_stream_push_varg(kstream_t* stream, const char* format, ...) {
     char buffer[1024] = {0};
     int len           = 0;
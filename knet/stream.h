@@ -29,16 +29,24 @@
 #include "stream_api.h"
 
 /**
- * ܵ
+ * ȡkstream_tʵ, Ƕ
+ * @return kstream_tʵ
+ */
+uint32_t stream_get_object_size();
+
+/**
+ * ڵṩڴڽܵ
+ * @param ptr ڴַ, Ϊstream_get_object_size()
  * @param channel_ref kchannel_ref_tʵ
  * @return kstream_tʵ
  */
-kstream_t* stream_create(kchannel_ref_t* channel_ref);
+kstream_t* stream_init(void* ptr, kchannel_ref_t* channel_ref);
 
 /**
- * ٹܵ
+ * ȡܵ
  * @param stream kstream_tʵ
+ * @return kchannel_ref_tʵ
  */
-void stream_destroy(kstream_t* stream);
+kchannel_ref_t* stream_get_channel_ref(kstream_t* stream);
 
 #endif /* STREAM_H */
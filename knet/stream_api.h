@@ -41,7 +41,7 @@
  * 2. knet_stream_eat_all     пɶֽ
  * 3. knet_stream_eat         ָֽ
  * 4. knet_stream_pop         ڶȡ
- * 5. knet_stream_push        д
+ * 5. knet_stream_push        д, knet_stream_pushvһдݿ
  * 6. knet_stream_copy        ڿָĿɶֽڣЩֽڣͨЭ
  * 7. knet_stream_push_stream пɶֽдһҪ⿽, صת
  * 8. knet_stream_copy_stream пɶֽдһҪ⿽, Щֽڣڹ㲥
@@ -86,6 +86,18 @@ extern int knet_stream_eat(kstream_t* stream, int size);
  */
 extern int knet_stream_pop(kstream_t* stream, void* buffer, int size);
 
+/**
+ * ȡָsizeɶֽڵָ, Ҳ, 㿽
+ *
+ * ָһζȡ/ǰЧ. ʹchannel_flag_mirror_recv_bufferĹֻܵҪ
+ * ɶֽ㹻Ƿָ, ͨܵݿԽĩβʱ0, Ҫ˻صknet_stream_copy.
+ * @param stream kstream_tʵ
+ * @param size Ҫֽ
+ * @retval 0 ɶֽݲ
+ * @retval  ָ
+ */
+extern void* knet_stream_peek_ptr(kstream_t* stream, int size);
+
 /**
  * ڲָĽȡݣ
  * @param stream kstream_tʵ
@@ -103,10 +115,23 @@ extern int knet_stream_pop_until(kstream_t* stream, const char* end, void* buffe
  * @param buffer 
  * @param size С
  * @retval error_ok ɹ
+ * @retval error_send_watermark ͸ˮλ, ܵδر, ȴchannel_cb_event_send_drainedд
  * @retval  ʧ
  */
 extern int knet_stream_push(kstream_t* stream, const void* buffer, int size);
 
+/**
+ * ھۼдݿ
+ *
+ * ݿΪһд, Ҫƴ, ЭͷЭ
+ * @param stream kstream_tʵ
+ * @param iov ݿ
+ * @param count ݿ
+ * @retval error_ok ɹ
+ * @retval  ʧ
+ */
+extern int knet_stream_pushv(kstream_t* stream, const kiovec_t* iov, int count);
+
 /**
  * дݣɱַ
  *
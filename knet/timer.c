@@ -30,7 +30,7 @@
 
 struct _ktimer_t {
     kdlist_t*       current_list;  /*  */
-    kdlist_node_t*  list_node;     /* ڵ */
+    kdlist_node_t   list_node;     /* Ƕڵ, /ֹͣڴ */
     ktimer_loop_t* ktimer_loop;   /* ʱѭ */
     ktimer_type_e  type;          /* ʱ */
     ktimer_cb_t    cb;            /* ʱص */
@@ -50,6 +50,7 @@ struct _ktimer_loop_t {
     time_t    last_tick;     /* һεѭʱ䣨룩 */
     time_t    tick_intval;   /* λ̶ȼ룩 */
     time_t    deviation;     /*  */
+    int       timer_count;   /* ʱڶʱ */
 };
 
 int _ktimer_loop_select_slot(ktimer_loop_t* ktimer_loop, time_t ms);
@@ -119,12 +120,11 @@ int _ktimer_loop_select_slot(ktimer_loop_t* ktimer_loop, time_t ms) {
 
 void _ktimer_loop_add_timer(ktimer_loop_t* ktimer_loop, ktimer_t* timer) {
     /* timer뵽´еĲλδڻᱻλ */
-    kdlist_node_t* node = 0;
     verify(ktimer_loop);
     verify(timer);
-    node = dlist_add_tail_node(ktimer_loop->ktimer_wheels[ktimer_loop->slot], timer);
+    dlist_add_tail(ktimer_loop->ktimer_wheels[ktimer_loop->slot], &timer->list_node);
     ktimer_set_current_list(timer, ktimer_loop->ktimer_wheels[ktimer_loop->slot]);
-    ktimer_set_current_list_node(timer, node);
+    ktimer_loop->timer_count++;
 }
 
 void _ktimer_loop_add_ktimer_node(ktimer_loop_t* ktimer_loop, kdlist_node_t* node, time_t ms) {
@@ -198,12 +198,6 @@ void ktimer_set_current_list(ktimer_t* timer, kdlist_t* list) {
     timer->current_list = list;
 }
 
-void ktimer_set_current_list_node(ktimer_t* timer, kdlist_node_t* node) {
-    verify(timer);
-    verify(node);
-    timer->list_node = node;
-}
-
 kdlist_t* ktimer_get_current_list(ktimer_t* timer) {
     verify(timer);
     return timer->current_list;
@@ -211,7 +205,7 @@ kdlist_t* ktimer_get_current_list(ktimer_t* timer) {
 
 kdlist_node_t* ktimer_get_current_list_node(ktimer_t* timer) {
     verify(timer);
-    return timer->list_node;
+    return &timer->list_node;
 }
 
 ktimer_t* ktimer_create(ktimer_loop_t* ktimer_loop) {
@@ -220,16 +214,18 @@ ktimer_t* ktimer_create(ktimer_loop_t* ktimer_loop) {
     timer = create(ktimer_t);
     verify(timer);
     memset(timer, 0, sizeof(ktimer_t));
+    dlist_node_set_data(dlist_node_init(&timer->list_node), timer);
     timer->ktimer_loop = ktimer_loop;
     return timer;
 }
 
 void ktimer_destroy(ktimer_t* timer) {
     verify(timer);
-    if (timer->current_list && timer->list_node) {
-        dlist_delete(timer->current_list, timer->list_node);
+    if (timer->current_list) {
+        dlist_remove(timer->current_list, &timer->list_node);
+        timer->ktimer_loop->timer_count--;
     }
-    free(timer);
+    destroy(timer);
 }
 
 int ktimer_check_dead(ktimer_t* timer) {
@@ -247,6 +243,21 @@ time_t ktimer_loop_get_tick_intval(ktimer_loop_t* ktimer_loop) {
     return ktimer_loop->tick_intval;
 }
 
+int ktimer_loop_get_wait_timeout(ktimer_loop_t* ktimer_loop) {
+    time_t wait = 0;
+    verify(ktimer_loop);
+    if (!ktimer_loop->timer_count) {
+        /* ûжʱ, Ҫ */
+        return -1;
+    }
+    /* һ̶ȵʱ, ktimer_loop_run_onceжһ */
+    wait = ktimer_loop->last_tick + ktimer_loop->tick_intval - ktimer_loop->deviation - (time_t)time_get_milliseconds();
+    if (wait < 0) {
+        return 0;
+    }
+    return (int)wait;
+}
+
 int ktimer_check_timeout(ktimer_t* timer, time_t ms) {
     kdlist_node_t* node         = 0;
     time_t        tick_intval  = 0;
@@ -58,17 +58,18 @@ void ktimer_set_current_list(ktimer_t* timer, kdlist_t* list);
 kdlist_t* ktimer_get_current_list(ktimer_t* timer);
 
 /**
- * öʱڵĵǰڵ
+ * ȡöʱǶڵ
  * @param timer ktimer_tʵ
- * @param node ڵ
+ * @return kdlist_node_tʵ
  */
-void ktimer_set_current_list_node(ktimer_t* timer, kdlist_node_t* node);
+kdlist_node_t* ktimer_get_current_list_node(ktimer_t* timer);
 
 /**
- * ȡõǰڵ
- * @param timer ktimer_tʵ
- * @return kdlist_node_tʵ
+ * ȡþһҪktimer_loop_run_onceʱ
+ * @param ktimer_loop ktimer_loop_tʵ
+ * @retval -1 ûжʱ
+ * @retval  ȴʱ䣨룩
  */
-kdlist_node_t* ktimer_get_current_list_node(ktimer_t* timer);
+int ktimer_loop_get_wait_timeout(ktimer_loop_t* ktimer_loop);
 
 #endif /* TIMER_H */
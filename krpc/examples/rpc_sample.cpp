@@ -29,16 +29,22 @@ void insert_all(std::map<K, V>& m, typename std::map<K, V>::const_iterator begin
 
 /////////////////////////////////////////////////////////
 void	krpc_member_set(krpc_object_t* t, const std::string& node){
-	krpc_string_set_s(t, node.c_str(), node.length());
+	krpc_string_set_s(t, node.c_str(), (uint32_t)node.length() + 1);
 }
 void	krpc_member_set(krpc_object_t* t, const char* node){
 	krpc_string_set(t, node);
 }
-void	krpc_member_set(krpc_object_t* t, const char* node, uint16_t size){
+void	krpc_member_set(krpc_object_t* t, const char* node, uint32_t size){
 	krpc_string_set_s(t, node, size);
 }
 void	krpc_member_get(krpc_object_t* t, std::string& node){
-	node = std::string(krpc_string_get(t), krpc_string_get_size(t));
+	const char* str = krpc_string_get(t);
+	uint32_t size = krpc_string_get_size(t);
+	// drop one trailing terminator if present, strings may arrive without it
+	if (size && !str[size - 1]) {
+		size--;
+	}
+	node = std::string(str, size);
 }
 void	krpc_member_get(krpc_object_t* t, const char*& node){
 	node = krpc_string_get(t);
@@ -0,0 +1,145 @@
+#include "knet.h"
+
+#define LOOP_MAX 16 /* kloop_t */
+
+int               channel_n  = 1000;  /* 㲥ڹܵ */
+int               write_n    = 200;   /* 㲥 */
+int               size       = 4096;  /* ÿι㲥ֽ */
+int               loop_n     = 4;     /* kloop_t */
+int               port       = 8500;
+kbroadcast_t*     broadcast  = 0;
+volatile uint64_t recv_bytes[LOOP_MAX] = {0}; /* ÿkloop_tյֽ, ֻkloop_t߳д */
+kloop_t*          loops[LOOP_MAX]      = {0};
+
+uint64_t get_alloc_count() {
+    int      i     = 0;
+    uint64_t count = 0;
+    for (; i <= knet_allocator_get_class_count(); i++) {
+        count += knet_allocator_get_alloc_count(i);
+    }
+    return count;
+}
+
+uint64_t get_recv_bytes() {
+    int      i     = 0;
+    uint64_t bytes = 0;
+    for (; i < loop_n; i++) {
+        bytes += recv_bytes[i];
+    }
+    return bytes;
+}
+
+void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    int        i      = 0;
+    kstream_t* stream = knet_channel_ref_get_stream(channel);
+    if (e & channel_cb_event_recv) {
+        for (; i < loop_n; i++) {
+            if (loops[i] == knet_channel_ref_get_loop(channel)) {
+                recv_bytes[i] += knet_stream_available(stream);
+                break;
+            }
+        }
+        knet_stream_eat_all(stream);
+    }
+}
+
+void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    if (e & channel_cb_event_accept) {
+        knet_broadcast_join(broadcast, channel);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int               i        = 0;
+    int               j        = 0;
+    int               count    = 0;
+    char*             buffer   = 0;
+    uint64_t          start    = 0;
+    uint64_t          us       = 0;
+    uint64_t          allocs   = 0;
+    uint64_t          total    = 0;
+    kchannel_ref_t*   acceptor = 0;
+    kchannel_ref_t*   connector = 0;
+    kthread_runner_t* runners[LOOP_MAX] = {0};
+    static const char* helper_string =
+        "-n    channel count\n"
+        "-c    broadcast count\n"
+        "-s    broadcast size\n"
+        "-l    loop count\n"
+        "-port first local port\n";
+
+    if (argc > 2) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp("-n", argv[i])) {
+                channel_n = atoi(argv[i+1]);
+            } else if (!strcmp("-c", argv[i])) {
+                write_n = atoi(argv[i+1]);
+            } else if (!strcmp("-s", argv[i])) {
+                size = atoi(argv[i+1]);
+            } else if (!strcmp("-l", argv[i])) {
+                loop_n = atoi(argv[i+1]);
+            } else if (!strcmp("-port", argv[i])) {
+                port = atoi(argv[i+1]);
+            }
+        }
+    } else {
+        printf(helper_string);
+        exit(0);
+    }
+    if (loop_n > LOOP_MAX) {
+        loop_n = LOOP_MAX;
+    }
+
+    broadcast = knet_broadcast_create();
+    buffer    = (char*)malloc(size);
+    memset(buffer, 'a', size);
+    /* ÿkloop_tһ, 뱻ܵĹܵλͬһkloop_t */
+    for (i = 0; i < loop_n; i++) {
+        loops[i] = knet_loop_create();
+        acceptor = knet_loop_create_channel(loops[i], INT_MAX, 1024 * 64);
+        knet_channel_ref_set_cb(acceptor, acceptor_cb);
+        if (error_ok != knet_channel_ref_accept(acceptor, "127.0.0.1", port + i, 1024)) {
+            return 0;
+        }
+        for (j = i; j < channel_n; j += loop_n) {
+            connector = knet_loop_create_channel(loops[i], 8, 1024 * 64);
+            knet_channel_ref_set_cb(connector, connector_cb);
+            knet_channel_ref_connect(connector, "127.0.0.1", port + i, 5);
+        }
+        runners[i] = thread_runner_create(0, 0);
+        thread_runner_start_loop(runners[i], loops[i], 0);
+    }
+    while (knet_broadcast_get_count(broadcast) < channel_n) {
+        thread_sleep_ms(10);
+    }
+
+    /* 㲥̲߳κkloop_t߳, д붼ǿ߳д */
+    total  = (uint64_t)channel_n * write_n * size;
+    allocs = get_alloc_count();
+    start  = time_get_microseconds();
+    for (i = 0; i < write_n; i++) {
+        count += knet_broadcast_write(broadcast, buffer, (uint32_t)size);
+    }
+    us = time_get_microseconds() - start;
+    printf("Channel: %d, Loop: %d, Size: %d, Broadcast: %d, Write: %.0f/s, Allocations/broadcast: %.2f\n",
+        channel_n, loop_n, size, write_n, (double)write_n * 1000000.0 / (double)(us ? us : 1),
+        (double)(get_alloc_count() - allocs) / (double)write_n);
+    while (get_recv_bytes() < (uint64_t)count * size) {
+        thread_sleep_ms(1);
+    }
+    us = time_get_microseconds() - start;
+    printf("Delivered: %.0fMB, Elapsed: %.3fs, Fan-out: %.1fMB/s\n", (double)total / 1048576.0,
+        (double)us / 1000000.0, (double)total / 1048576.0 * 1000000.0 / (double)(us ? us : 1));
+
+    for (i = 0; i < loop_n; i++) {
+        thread_runner_stop(runners[i]);
+        thread_runner_join(runners[i]);
+        thread_runner_destroy(runners[i]);
+    }
+    knet_broadcast_destroy(broadcast);
+    for (i = 0; i < loop_n; i++) {
+        knet_loop_destroy(loops[i]);
+    }
+    free(buffer);
+    return 0;
+}
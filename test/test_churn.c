@@ -0,0 +1,106 @@
+#include "knet.h"
+
+int      concurrent_n = 64;     /* ͬʱ */
+int      connect_n    = 100000; /* Ӵ */
+int      port         = 0;
+int      started      = 0;      /* ѷ */
+int      closed       = 0;      /* ѹرյ */
+uint64_t start_us     = 0;
+uint64_t start_alloc  = 0;      /* ʼʱķ */
+
+uint64_t get_alloc_count() {
+    int      i     = 0;
+    uint64_t count = 0;
+    for (; i <= knet_allocator_get_class_count(); i++) {
+        count += knet_allocator_get_alloc_count(i);
+    }
+    return count;
+}
+
+void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e);
+
+void start_connector(kloop_t* loop) {
+    kchannel_ref_t* connector = 0;
+    /* loop߳ڽ, ԸٵĹܵ */
+    connector = knet_loop_create_channel(loop, 8, 1024);
+    knet_channel_ref_set_cb(connector, connector_cb);
+    if (error_ok != knet_channel_ref_connect(connector, "127.0.0.1", port, 5)) {
+        knet_loop_exit(loop);
+        return;
+    }
+    started++;
+}
+
+void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    uint64_t us   = 0;
+    kloop_t* loop = knet_channel_ref_get_loop(channel);
+    if (e & channel_cb_event_connect) {
+        knet_channel_ref_close(channel);
+    } else if (e & channel_cb_event_close) {
+        if (++closed >= connect_n) {
+            us = time_get_microseconds() - start_us;
+            printf("Concurrent: %d, Connect: %d, Elapsed: %.3fs, Connect/close: %.0f/s, Allocations/connect: %.2f\n",
+                concurrent_n, connect_n, (double)us / 1000000.0,
+                (double)connect_n * 1000000.0 / (double)us,
+                (double)(get_alloc_count() - start_alloc) / (double)connect_n);
+            knet_loop_exit(loop);
+        } else if (started < connect_n) {
+            start_connector(loop);
+        }
+    }
+}
+
+void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    if (e & channel_cb_event_close) {
+        return;
+    }
+}
+
+void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    if (e & channel_cb_event_accept) {
+        knet_channel_ref_set_cb(channel, client_cb);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int             i        = 0;
+    kloop_t*        loop     = 0;
+    kchannel_ref_t* acceptor = 0;
+    static const char* helper_string =
+        "-n    concurrent connection count\n"
+        "-c    total connect count\n"
+        "-port local port\n";
+
+    if (argc > 2) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp("-n", argv[i])) {
+                concurrent_n = atoi(argv[i+1]);
+            } else if (!strcmp("-c", argv[i])) {
+                connect_n = atoi(argv[i+1]);
+            } else if (!strcmp("-port", argv[i])) {
+                port = atoi(argv[i+1]);
+            }
+        }
+    } else {
+        printf(helper_string);
+        exit(0);
+    }
+
+    loop = knet_loop_create();
+    acceptor = knet_loop_create_channel(loop, 8, 1024);
+    knet_channel_ref_set_cb(acceptor, acceptor_cb);
+    if (error_ok != knet_channel_ref_accept(acceptor, "127.0.0.1", port, 1024)) {
+        return 0;
+    }
+    /* һ, ֮Ӷloop߳ڽ */
+    knet_loop_run_once(loop);
+    start_us    = time_get_microseconds();
+    start_alloc = get_alloc_count();
+    for (i = 0; (i < concurrent_n) && (i < connect_n); i++) {
+        start_connector(loop);
+    }
+
+    knet_loop_run(loop);
+    knet_loop_destroy(loop);
+    return 0;
+}
@@ -4,6 +4,7 @@ uint32_t active_channel = 0;
 uint32_t recv_bytes = 0;
 uint32_t send_bytes = 0;
 uint32_t client_n   = 50;
+int      burst      = 0; /* Ƿһη */
 char*    ip         = 0;
 int      port       = 0;
 ktimer_loop_t* timer_loop = 0;
@@ -25,7 +26,7 @@ void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
         /* д */
         send_bytes += 12;
         knet_stream_push(stream, hello, 12);
-        if (active_channel < client_n) {
+        if (!burst && (active_channel < client_n)) {
             connector = knet_loop_create_channel(knet_channel_ref_get_loop(channel), 8, 121);
             knet_channel_ref_set_cb(connector, connector_cb);
             knet_channel_ref_set_timeout(connector, 1);
@@ -58,6 +59,7 @@ int main(int argc, char* argv[]) {
     kthread_runner_t*   timer_thread = 0;
     static const char* helper_string =
         "-n    client count\n"
+        "-b    connect all clients at once\n"
         "-ip   remote host IP\n"
         "-port remote host port\n";
 
@@ -65,6 +67,8 @@ int main(int argc, char* argv[]) {
         for (i = 1; i < argc; i++) {
             if (!strcmp("-n", argv[i])) {
                 client_n = atoi(argv[i+1]);
+            } else if (!strcmp("-b", argv[i])) {
+                burst = 1;
             } else if (!strcmp("-ip", argv[i])) {
                 ip = argv[i+1];
             } else if (!strcmp("-port", argv[i])) {
@@ -84,11 +88,14 @@ int main(int argc, char* argv[]) {
     timer_thread = thread_runner_create(0, 0);
     thread_runner_start_timer_loop(timer_thread, timer_loop, 0);
 
-    connector = knet_loop_create_channel(loop, 8, 121);
-    knet_channel_ref_set_cb(connector, connector_cb);
-    knet_channel_ref_set_timeout(connector, 1);
-    if (error_ok != knet_channel_ref_connect(connector, ip, port, 5)) {
-        return 0;
+    /* ͻģʽͬʱ */
+    for (i = 0; i < (burst ? (int)client_n : 1); i++) {
+        connector = knet_loop_create_channel(loop, 8, 121);
+        knet_channel_ref_set_cb(connector, connector_cb);
+        knet_channel_ref_set_timeout(connector, 1);
+        if (error_ok != knet_channel_ref_connect(connector, ip, port, 5)) {
+            return 0;
+        }
     }
 
     knet_loop_run(loop);
@@ -0,0 +1,55 @@
+#include "knet.h"
+
+int round_n = 10; /*  */
+
+void run(uint32_t entry_n) {
+    uint32_t i     = 0;
+    int      j     = 0;
+    uint64_t start = 0;
+    uint64_t insert_us = 0;
+    uint64_t lookup_us = 0;
+    uint64_t found = 0;
+    khash_t* hash  = hash_create(0, 0);
+    start = time_get_microseconds();
+    for (i = 0; i < entry_n; i++) {
+        /* ֵΪ0 */
+        hash_add(hash, i * 7, (void*)(size_t)(i + 1));
+    }
+    insert_us = time_get_microseconds() - start;
+    start = time_get_microseconds();
+    for (j = 0; j < round_n; j++) {
+        for (i = 0; i < entry_n; i++) {
+            if (hash_get(hash, i * 7)) {
+                found++;
+            }
+        }
+    }
+    lookup_us = time_get_microseconds() - start;
+    printf("Entry: %u, Insert: %.0f/s, Lookup: %.0f/s, Found: %s\n", entry_n,
+        (double)entry_n * 1000000.0 / (double)(insert_us ? insert_us : 1),
+        (double)entry_n * round_n * 1000000.0 / (double)(lookup_us ? lookup_us : 1),
+        (found == (uint64_t)entry_n * round_n) ? "all" : "missing");
+    hash_destroy(hash);
+}
+
+int main(int argc, char* argv[]) {
+    int i = 0;
+    static const char* helper_string =
+        "-r    lookup round count\n";
+
+    if (argc > 2) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp("-r", argv[i])) {
+                round_n = atoi(argv[i+1]);
+            }
+        }
+    } else {
+        printf(helper_string);
+        exit(0);
+    }
+
+    run(1000);
+    run(100000);
+    run(1000000);
+    return 0;
+}
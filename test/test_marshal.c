@@ -0,0 +1,105 @@
+#include "knet.h"
+
+int round_n = 100000; /* ÿָصл */
+
+krpc_object_t* number(knet_rpc_type_e type, int64_t n) {
+    krpc_object_t* o = krpc_object_create();
+    switch (type) {
+    case krpc_type_i8:   krpc_number_set_i8(o, (int8_t)n); break;
+    case krpc_type_i16:  krpc_number_set_i16(o, (int16_t)n); break;
+    case krpc_type_i32:  krpc_number_set_i32(o, (int32_t)n); break;
+    case krpc_type_i64:  krpc_number_set_i64(o, n); break;
+    case krpc_type_ui8:  krpc_number_set_ui8(o, (uint8_t)n); break;
+    case krpc_type_ui16: krpc_number_set_ui16(o, (uint16_t)n); break;
+    case krpc_type_ui32: krpc_number_set_ui32(o, (uint32_t)n); break;
+    case krpc_type_ui64: krpc_number_set_ui64(o, (uint64_t)n); break;
+    case krpc_type_f32:  krpc_number_set_f32(o, (float32_t)n); break;
+    default:             krpc_number_set_f64(o, (float64_t)n); break;
+    }
+    return o;
+}
+
+krpc_object_t* string(const char* s) {
+    krpc_object_t* o = krpc_object_create();
+    krpc_string_set(o, s);
+    return o;
+}
+
+/* krpc/examples/rpc_sample.cppmarshal(my_object_t&)ɵĶṹͬ */
+krpc_object_t* my_object() {
+    krpc_object_t* v     = krpc_object_create();
+    krpc_object_t* table = krpc_object_create();
+    krpc_object_t* other = krpc_object_create();
+    krpc_object_t* ss    = krpc_object_create();
+    krpc_vector_push_back(v, number(krpc_type_i8, 1));
+    krpc_vector_push_back(v, number(krpc_type_i16, 2));
+    krpc_vector_push_back(v, number(krpc_type_i32, 3));
+    krpc_vector_push_back(v, number(krpc_type_i64, 4));
+    krpc_vector_push_back(v, number(krpc_type_ui8, 5));
+    krpc_vector_push_back(v, number(krpc_type_ui16, 6));
+    krpc_vector_push_back(v, number(krpc_type_ui32, 7));
+    krpc_vector_push_back(v, number(krpc_type_ui64, 8));
+    krpc_vector_push_back(v, number(krpc_type_f32, 9));
+    krpc_vector_push_back(v, number(krpc_type_f64, 10));
+    krpc_vector_push_back(v, string("hello world!"));
+    krpc_map_insert(table, number(krpc_type_i8, 1), string("i'm a string"));
+    krpc_vector_push_back(v, table);
+    krpc_map_insert(ss, string("name"), string("i'm a string"));
+    krpc_vector_push_back(other, ss);
+    table = krpc_object_create();
+    krpc_map_insert(table, number(krpc_type_i8, 1), other);
+    krpc_vector_push_back(v, table);
+    return v;
+}
+
+void run(const char* name, krpc_object_t* o, int round) {
+    int      i     = 0;
+    uint16_t bytes = 0;
+    uint64_t start = 0;
+    uint64_t us    = 0;
+    static char buffer[65535];
+    start = time_get_microseconds();
+    for (; i < round; i++) {
+        if (error_ok != krpc_object_marshal_buffer(o, buffer, sizeof(buffer), &bytes)) {
+            printf("%s: marshal failed\n", name);
+            return;
+        }
+    }
+    us = time_get_microseconds() - start;
+    if (!us) {
+        us = 1;
+    }
+    printf("Payload: %s, Size: %u, Marshal: %.0f/s, %.1fMB/s\n", name, bytes,
+        (double)round * 1000000.0 / (double)us, (double)round * bytes / (double)us);
+}
+
+int main(int argc, char* argv[]) {
+    int            i = 0;
+    krpc_object_t* o = 0;
+    krpc_object_t* v = 0;
+    static const char* helper_string =
+        "-r    marshal count\n";
+
+    if (argc > 2) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp("-r", argv[i])) {
+                round_n = atoi(argv[i+1]);
+            }
+        }
+    } else {
+        printf(helper_string);
+        exit(0);
+    }
+
+    o = my_object();
+    run("my_object_t", o, round_n);
+    krpc_object_destroy(o);
+    /* my_rpc_func2ͬ, my_object_t */
+    v = krpc_object_create();
+    for (i = 0; i < 300; i++) {
+        krpc_vector_push_back(v, my_object());
+    }
+    run("my_object_t[300]", v, round_n / 100);
+    krpc_object_destroy(v);
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "knet.h"
+
+#define MSG_SIZE 8 /* ÿο̷߳͵ֽ */
+
+int             producer_n    = 4;      /* ߳ */
+int             send_n        = 100000; /* ÿ̷߳ʹ */
+int             port          = 0;
+uint64_t        recv_bytes    = 0;
+uint64_t        total_bytes   = 0;
+uint64_t        start_us      = 0;
+kchannel_ref_t* connector     = 0;
+kthread_runner_t** producers  = 0;
+
+void producer_func(kthread_runner_t* runner) {
+    int             i        = 0;
+    char            msg[MSG_SIZE] = {0};
+    kchannel_ref_t* shared   = (kchannel_ref_t*)thread_runner_get_params(runner);
+    kstream_t*      stream   = knet_channel_ref_get_stream(shared);
+    for (; i < send_n; i++) {
+        /* loopͬһ߳, ÿд붼һο߳¼ */
+        while (error_ok != knet_stream_push(stream, msg, sizeof(msg))) {
+            thread_sleep_ms(1);
+        }
+    }
+    knet_channel_ref_leave(shared);
+}
+
+void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    uint64_t   us     = 0;
+    kstream_t* stream = knet_channel_ref_get_stream(channel);
+    if (e & channel_cb_event_recv) {
+        recv_bytes += knet_stream_available(stream);
+        knet_stream_eat_all(stream);
+        if (recv_bytes >= total_bytes) {
+            us = time_get_microseconds() - start_us;
+            printf("Producer: %d, Send: %d, Elapsed: %.3fs, Cross-thread send: %.0f/s\n",
+                producer_n, producer_n * send_n, (double)us / 1000000.0,
+                (double)producer_n * send_n * 1000000.0 / (double)us);
+            knet_loop_exit(knet_channel_ref_get_loop(channel));
+        }
+    }
+}
+
+void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    if (e & channel_cb_event_accept) {
+        knet_channel_ref_set_cb(channel, client_cb);
+    }
+}
+
+void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    int i = 0;
+    if (e & channel_cb_event_connect) {
+        start_us = time_get_microseconds();
+        for (; i < producer_n; i++) {
+            producers[i] = thread_runner_create(producer_func, knet_channel_ref_share(channel));
+            thread_runner_start(producers[i], 0);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int       i        = 0;
+    kloop_t*  loop     = 0;
+    kchannel_ref_t* acceptor = 0;
+    static const char* helper_string =
+        "-n    producer thread count\n"
+        "-c    send count per producer\n"
+        "-port local port\n";
+
+    if (argc > 2) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp("-n", argv[i])) {
+                producer_n = atoi(argv[i+1]);
+            } else if (!strcmp("-c", argv[i])) {
+                send_n = atoi(argv[i+1]);
+            } else if (!strcmp("-port", argv[i])) {
+                port = atoi(argv[i+1]);
+            }
+        }
+    } else {
+        printf(helper_string);
+        exit(0);
+    }
+
+    total_bytes = (uint64_t)producer_n * send_n * MSG_SIZE;
+    producers   = (kthread_runner_t**)malloc(sizeof(kthread_runner_t*) * producer_n);
+    loop        = knet_loop_create();
+
+    acceptor = knet_loop_create_channel(loop, 8, 1024 * 1024);
+    knet_channel_ref_set_cb(acceptor, acceptor_cb);
+    if (error_ok != knet_channel_ref_accept(acceptor, "127.0.0.1", port, 10)) {
+        return 0;
+    }
+    /* 㹻, ̷߳ͱ */
+    connector = knet_loop_create_channel(loop, INT_MAX, 1024);
+    knet_channel_ref_set_cb(connector, connector_cb);
+    if (error_ok != knet_channel_ref_connect(connector, "127.0.0.1", port, 5)) {
+        return 0;
+    }
+
+    knet_loop_run(loop);
+
+    for (i = 0; i < producer_n; i++) {
+        thread_runner_join(producers[i]);
+        thread_runner_destroy(producers[i]);
+    }
+    knet_loop_destroy(loop);
+    free(producers);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "knet.h"
+
+#define RB_SIZE     (1024 * 1024) /* λ */
+#define TOTAL_BYTES (512ULL * 1024 * 1024) /* ÿԶдֽ */
+
+char buffer[64 * 1024];
+
+/* д(pop) */
+double bench_pop(kringbuffer_t* rb, uint32_t size) {
+    uint64_t i     = 0;
+    uint64_t n     = TOTAL_BYTES / size;
+    uint64_t start = time_get_microseconds();
+    for (; i < n; i++) {
+        ringbuffer_write(rb, buffer, size);
+        ringbuffer_read(rb, buffer, size);
+    }
+    return (double)(n * size) / (double)(time_get_microseconds() - start) / 1000.0;
+}
+
+/* д󿽱(copy)ٶ */
+double bench_copy(kringbuffer_t* rb, uint32_t size) {
+    uint64_t i     = 0;
+    uint64_t n     = TOTAL_BYTES / size;
+    uint64_t start = time_get_microseconds();
+    for (; i < n; i++) {
+        ringbuffer_write(rb, buffer, size);
+        ringbuffer_copy(rb, buffer, size);
+        ringbuffer_remove(rb, size);
+    }
+    return (double)(n * size) / (double)(time_get_microseconds() - start) / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    int            i       = 0;
+    int            j       = 0;
+    kringbuffer_t* rb      = 0;
+    uint32_t       sizes[] = {16, 1024, 64 * 1024};
+    /* 2ʹ, ʹñȽϻ */
+    uint32_t       rb_sizes[] = {RB_SIZE, RB_SIZE - 1};
+    (void)argc;
+    (void)argv;
+    memset(buffer, 'x', sizeof(buffer));
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < 3; i++) {
+            rb = ringbuffer_create(rb_sizes[j]);
+            /* дλ, ֤ᷢ */
+            ringbuffer_write(rb, buffer, 7);
+            ringbuffer_remove(rb, 7);
+            printf("RingBuffer: %u, Message: %6u, Pop: %6.2f GB/s, Copy: %6.2f GB/s\n",
+                rb_sizes[j], sizes[i], bench_pop(rb, sizes[i]), bench_copy(rb, sizes[i]));
+            ringbuffer_destroy(rb);
+        }
+    }
+    return 0;
+}
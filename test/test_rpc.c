@@ -0,0 +1,160 @@
+#include "knet.h"
+
+int       call_n     = 100000; /* ô */
+int       encrypt    = 0;      /* Ƿ */
+int       port       = 0;
+int       recv_n     = 0;
+uint64_t  start_us   = 0;
+uint64_t  start_allocs = 0;
+krpc_t*   rpc        = 0;
+kloop_t*  loop       = 0;
+
+uint64_t get_alloc_count() {
+    int      i     = 0;
+    uint64_t count = 0;
+    for (; i <= knet_allocator_get_class_count(); i++) {
+        count += knet_allocator_get_alloc_count(i);
+    }
+    return count;
+}
+
+uint16_t xor_cb(void* in, uint16_t size, void* out, uint16_t out_size) {
+    uint16_t i = 0;
+    if (size > out_size) {
+        return 0;
+    }
+    for (; i < size; i++) {
+        ((char*)out)[i] = ((char*)in)[i] ^ 0x5a;
+    }
+    return size;
+}
+
+krpc_object_t* build_object() {
+    int            i = 0;
+    krpc_object_t* v = krpc_object_create();
+    krpc_object_t* m = krpc_object_create();
+    krpc_object_t* o = 0;
+    krpc_object_t* k = 0;
+    static const char* keys[] = {"alpha", "beta", "gamma", "delta"};
+    for (i = 0; i < 10; i++) {
+        o = krpc_object_create();
+        krpc_string_set(o, "hello world");
+        krpc_vector_push_back(v, o);
+    }
+    o = krpc_object_create();
+    krpc_number_set_i64(o, 9238948959);
+    krpc_vector_push_back(v, o);
+    for (i = 0; i < 4; i++) {
+        k = krpc_object_create();
+        krpc_string_set(k, keys[i]);
+        o = krpc_object_create();
+        krpc_number_set_i32(o, i);
+        krpc_map_insert(m, k, o);
+    }
+    krpc_vector_push_back(v, m);
+    return v;
+}
+
+int rpc_cb(krpc_object_t* o) {
+    uint64_t us = 0;
+    if (krpc_vector_get_size(o) != 12) {
+        return rpc_error_close;
+    }
+    if (!recv_n) {
+        /* һõʱͻѾȫ, ֮ķ䶼Խ */
+        start_us     = time_get_microseconds();
+        start_allocs = get_alloc_count();
+    }
+    recv_n++;
+    if (recv_n == call_n) {
+        us = time_get_microseconds() - start_us;
+        printf("Call: %d, Elapsed: %.3fs, Decode: %.0f/s, Allocations/call: %.4f\n",
+            call_n, (double)us / 1000000.0, (double)(call_n - 1) * 1000000.0 / (double)(us ? us : 1),
+            (double)(get_alloc_count() - start_allocs) / (double)(call_n - 1));
+        knet_loop_exit(loop);
+    }
+    return rpc_ok;
+}
+
+void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    kstream_t* stream = knet_channel_ref_get_stream(channel);
+    if (e & channel_cb_event_recv) {
+        while (error_ok == krpc_proc(rpc, stream)) {
+        }
+    }
+}
+
+void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    if (e & channel_cb_event_accept) {
+        knet_channel_ref_set_cb(channel, client_cb);
+    }
+}
+
+void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+    int            i      = 0;
+    uint64_t       start  = 0;
+    uint64_t       us     = 0;
+    krpc_object_t* o      = 0;
+    kstream_t*     stream = knet_channel_ref_get_stream(channel);
+    if (e & channel_cb_event_connect) {
+        o = build_object();
+        start = time_get_microseconds();
+        for (; i < call_n; i++) {
+            krpc_call(rpc, stream, 1, o);
+        }
+        us = time_get_microseconds() - start;
+        printf("Call: %d, Elapsed: %.3fs, Marshal and send: %.0f/s\n", call_n, (double)us / 1000000.0,
+            (double)call_n * 1000000.0 / (double)(us ? us : 1));
+        krpc_object_destroy(o);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int             i         = 0;
+    kchannel_ref_t* acceptor  = 0;
+    kchannel_ref_t* connector = 0;
+    static const char* helper_string =
+        "-c    call count\n"
+        "-e    encrypt (1/0)\n"
+        "-port local port\n";
+
+    if (argc > 2) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp("-c", argv[i])) {
+                call_n = atoi(argv[i+1]);
+            } else if (!strcmp("-e", argv[i])) {
+                encrypt = atoi(argv[i+1]);
+            } else if (!strcmp("-port", argv[i])) {
+                port = atoi(argv[i+1]);
+            }
+        }
+    } else {
+        printf(helper_string);
+        exit(0);
+    }
+
+    rpc  = krpc_create();
+    krpc_add_cb(rpc, 1, rpc_cb);
+    if (encrypt) {
+        krpc_set_encrypt_cb(rpc, xor_cb);
+        krpc_set_decrypt_cb(rpc, xor_cb);
+    }
+    loop = knet_loop_create();
+
+    acceptor = knet_loop_create_channel(loop, 8, 1024 * 64);
+    knet_channel_ref_set_cb(acceptor, acceptor_cb);
+    if (error_ok != knet_channel_ref_accept(acceptor, "127.0.0.1", port, 10)) {
+        return 0;
+    }
+    /* 㹻, еһд */
+    connector = knet_loop_create_channel(loop, INT_MAX, 1024 * 64);
+    knet_channel_ref_set_cb(connector, connector_cb);
+    if (error_ok != knet_channel_ref_connect(connector, "127.0.0.1", port, 5)) {
+        return 0;
+    }
+
+    knet_loop_run(loop);
+    knet_loop_destroy(loop);
+    krpc_destroy(rpc);
+    return 0;
+}
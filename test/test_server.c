@@ -1,5 +1,14 @@
 #include "knet.h"
 
+atomic_counter_t accept_count = 0; /* һڽܵ */
+
+void timer_cb(ktimer_t* timer, void* data) {
+    (void)data;
+    assert(timer);
+    /* ÿһӽ */
+    printf("Accept: %d/s\n", atomic_counter_set(&accept_count, 0));
+}
+
 void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
     char      buffer[1024] = {0};
     int       bytes      = 0;
@@ -24,10 +33,7 @@ void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
 
 void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
     if (e & channel_cb_event_accept) {
-        printf("accept fd: %d, active channel count: %d, close channel count: %d\n",
-            knet_channel_ref_get_socket_fd(channel),
-            knet_loop_get_active_channel_count(knet_channel_ref_get_loop(channel)),
-            knet_loop_get_close_channel_count(knet_channel_ref_get_loop(channel)));
+        atomic_counter_inc(&accept_count);
         knet_channel_ref_set_timeout(channel, 5);
         knet_channel_ref_set_cb(channel, client_cb);
     }
@@ -43,6 +49,9 @@ int main(int argc, char* argv[]) {
     kloop_balancer_t*  balancer = 0;
     kchannel_ref_t*    acceptor = 0;
     kthread_runner_t** threads  = 0;
+    ktimer_loop_t*     timer_loop   = 0;
+    ktimer_t*          timer        = 0;
+    kthread_runner_t*  timer_thread = 0;
 
     static const char* helper_string =
         "-w    loop worker count\n"
@@ -71,6 +80,12 @@ int main(int argc, char* argv[]) {
 
     knet_loop_balancer_attach(balancer, loop);
 
+    timer_loop = ktimer_loop_create(1000, 1000);
+    timer      = ktimer_create(timer_loop);
+    ktimer_start(timer, timer_cb, 0, 1000);
+    timer_thread = thread_runner_create(0, 0);
+    thread_runner_start_timer_loop(timer_thread, timer_loop, 0);
+
     acceptor = knet_loop_create_channel(loop, 8, 1024);
     knet_channel_ref_set_cb(acceptor, acceptor_cb);
     knet_channel_ref_accept(acceptor, ip, port, 500);
@@ -85,6 +100,7 @@ int main(int argc, char* argv[]) {
 
     knet_loop_run(loop);
 
+    thread_runner_destroy(timer_thread);
     for (i = 0; i < worker; i++) {
         thread_runner_destroy(threads[i]);        
     }
@@ -93,6 +109,7 @@ int main(int argc, char* argv[]) {
     }
     knet_loop_destroy(loop);
     knet_loop_balancer_destroy(balancer);
+    ktimer_loop_destroy(timer_loop);
     if (loops) {
         free(loops);
     }
@@ -0,0 +1,66 @@
+#include "knet.h"
+
+int round_n = 1000; /*  */
+int timer_n = 1000; /* ÿֹͣĶʱ */
+
+uint64_t get_alloc_count() {
+    int      i     = 0;
+    uint64_t count = 0;
+    for (; i <= knet_allocator_get_class_count(); i++) {
+        count += knet_allocator_get_alloc_count(i);
+    }
+    return count;
+}
+
+void timer_cb(ktimer_t* timer, void* data) {
+    (void)timer;
+    (void)data;
+}
+
+int main(int argc, char* argv[]) {
+    int            i      = 0;
+    int            j      = 0;
+    uint64_t       start  = 0;
+    uint64_t       us     = 0;
+    uint64_t       allocs = 0;
+    ktimer_t*      timer  = 0;
+    ktimer_loop_t* loop   = 0;
+    static const char* helper_string =
+        "-r    round count\n"
+        "-n    timer count per round\n";
+
+    if (argc > 2) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp("-r", argv[i])) {
+                round_n = atoi(argv[i+1]);
+            } else if (!strcmp("-n", argv[i])) {
+                timer_n = atoi(argv[i+1]);
+            }
+        }
+    } else {
+        printf(helper_string);
+        exit(0);
+    }
+
+    loop   = ktimer_loop_create(1, 100);
+    start  = time_get_microseconds();
+    allocs = get_alloc_count();
+    for (i = 0; i < round_n; i++) {
+        for (j = 0; j < timer_n; j++) {
+            timer = ktimer_create(loop);
+            ktimer_start(timer, timer_cb, 0, 1000);
+            ktimer_stop(timer);
+        }
+        /* ֹͣĶʱڲλʱ */
+        thread_sleep_ms(1);
+        ktimer_loop_run_once(loop);
+    }
+    us     = time_get_microseconds() - start;
+    allocs = get_alloc_count() - allocs;
+    printf("Timer: %d, Elapsed: %.3fs, Start/stop: %.0f/s, Allocations/timer: %.2f\n",
+        round_n * timer_n, (double)us / 1000000.0,
+        (double)round_n * timer_n * 1000000.0 / (double)us,
+        (double)allocs / ((double)round_n * timer_n));
+    ktimer_loop_destroy(loop);
+    return 0;
+}
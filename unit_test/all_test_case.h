@@ -38,5 +38,8 @@
 #include "vrouter_case.h"
 #include "node_case.h"
 #include "misc_case.h"
+#include "ringbuffer_case.h"
+#include "allocator_case.h"
+#include "hash_case.h"
 
 #endif // ALL_TEST_CASE_H
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2014-2015, dennis wang
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "helper.h"
+#include "knet.h"
+
+int Test_Allocator_Custom_Count = 0;
+
+CASE(Test_Allocator_Slab) {
+    int      large     = knet_allocator_get_class_count();
+    uint64_t count     = knet_allocator_get_alloc_count(0);
+    uint64_t big_count = knet_allocator_get_alloc_count(large);
+    char*    ptr       = 0;
+    char*    big       = 0;
+    EXPECT_TRUE(allocator_type_slab == knet_allocator_get_type());
+    EXPECT_TRUE(0 == knet_allocator_get_class_size(large));
+    ptr = create_raw(8);
+    memcpy(ptr, "abcdefgh", 8);
+    EXPECT_TRUE(knet_allocator_get_alloc_count(0) >= count + 1);
+    EXPECT_TRUE(knet_allocator_get_live_bytes(0) >= 8);
+    // ͬһȼ·䲻ƶ
+    EXPECT_TRUE(ptr == rcreate_raw(ptr, knet_allocator_get_class_size(0)));
+    // ȼ·䱣
+    ptr = rcreate_raw(ptr, 1000);
+    EXPECT_TRUE(!memcmp(ptr, "abcdefgh", 8));
+    // ȼϵͳ
+    big = create_raw(knet_allocator_get_class_size(large - 1) + 1);
+    EXPECT_TRUE(knet_allocator_get_alloc_count(large) >= big_count + 1);
+    // лڴԭͷ
+    EXPECT_TRUE(error_ok == knet_allocator_set_type(allocator_type_system));
+    ptr = rcreate_raw(ptr, 2000);
+    EXPECT_TRUE(!memcmp(ptr, "abcdefgh", 8));
+    destroy(big);
+    destroy(ptr);
+    EXPECT_TRUE(error_ok == knet_allocator_set_type(allocator_type_slab));
+}
+
+CASE(Test_Allocator_Custom) {
+    struct holder {
+        static void* custom_malloc(size_t size) {
+            Test_Allocator_Custom_Count++;
+            return malloc(size);
+        }
+        static void* custom_realloc(void* ptr, size_t size) {
+            return realloc(ptr, size);
+        }
+        static void custom_free(void* ptr) {
+            Test_Allocator_Custom_Count--;
+            free(ptr);
+        }
+    };
+    char* ptr = 0;
+    char* old = create_raw(16);
+    // δԶ亯
+    EXPECT_TRUE(error_invalid_parameters == knet_allocator_set_type(allocator_type_custom));
+    EXPECT_TRUE(error_ok == knet_allocator_set_custom(&holder::custom_malloc,
+        &holder::custom_realloc, &holder::custom_free));
+    EXPECT_TRUE(error_ok == knet_allocator_set_type(allocator_type_custom));
+    ptr = create_raw(16);
+    EXPECT_TRUE(Test_Allocator_Custom_Count >= 1);
+    // Զ亯ڴܸ
+    EXPECT_TRUE(error_fail == knet_allocator_set_custom(&holder::custom_malloc,
+        &holder::custom_realloc, &holder::custom_free));
+    ptr = rcreate_raw(ptr, 4096);
+    destroy(old);
+    destroy(ptr);
+    EXPECT_TRUE(error_ok == knet_allocator_set_type(allocator_type_slab));
+    EXPECT_TRUE(Test_Allocator_Custom_Count >= 0);
+}
+
+CASE(Test_Allocator_Thread_Cache) {
+    struct holder {
+        static void thread_func(kthread_runner_t* runner) {
+            int    i    = 0;
+            char** ptrs = (char**)thread_runner_get_params(runner);
+            for (; i < 1000; i++) {
+                ptrs[i] = create_raw(100);
+            }
+        }
+    };
+    int      i     = 0;
+    int      index = 2; // 128ֽڵȼ
+    uint64_t count = knet_allocator_get_alloc_count(index);
+    char*    ptrs[1000];
+    kthread_runner_t* runner = thread_runner_create(&holder::thread_func, ptrs);
+    thread_runner_start(runner, 0);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    EXPECT_TRUE(knet_allocator_get_alloc_count(index) >= count + 1000);
+    // ̷߳ڴڵǰ߳ͷ
+    for (; i < 1000; i++) {
+        EXPECT_TRUE(ptrs[i] != 0);
+        destroy(ptrs[i]);
+    }
+}
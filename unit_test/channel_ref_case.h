@@ -230,6 +230,270 @@ CASE(Test_Channel_Idle_Timeout) {
     knet_loop_destroy(loop);
 }
 
+uint64_t Test_Channel_Idle_Timeout_Ms_Start = 0;
+
+CASE(Test_Channel_Idle_Timeout_Ms) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_timeout) {
+                // 뼶ʱ
+                uint64_t elapsed = time_get_monotonic_milliseconds() - Test_Channel_Idle_Timeout_Ms_Start;
+                EXPECT_TRUE(elapsed >= 200);
+                EXPECT_TRUE(elapsed < 1000);
+                knet_loop_exit(knet_channel_ref_get_loop(channel));
+            } else if (e & channel_cb_event_close) {
+            } else {
+                CASE_FAIL();
+            }
+        }
+    };
+
+    kloop_t* loop = knet_loop_create();
+
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024);
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+    knet_channel_ref_set_timeout_ms(connector, 250); /* öʱ룩 */
+    Test_Channel_Idle_Timeout_Ms_Start = time_get_monotonic_milliseconds();
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 0);
+
+    knet_loop_run(loop);
+    knet_loop_destroy(loop);
+}
+
+int Test_Channel_Idle_Timeout_Repeat_Count = 0;
+
+CASE(Test_Channel_Idle_Timeout_Repeat) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_connect) {
+                // ӽöʱ, ܵ¼ʱ
+                knet_channel_ref_set_timeout(channel, 1);
+            } else if (e & channel_cb_event_timeout) {
+                // , ÿʱһ
+                if (++Test_Channel_Idle_Timeout_Repeat_Count == 2) {
+                    knet_loop_exit(knet_channel_ref_get_loop(channel));
+                }
+            }
+        }
+    };
+
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 1024);
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+
+    knet_loop_run(loop);
+    EXPECT_TRUE(Test_Channel_Idle_Timeout_Repeat_Count == 2);
+    knet_loop_destroy(loop);
+}
+
+kchannel_ref_t* Test_Channel_Idle_Timeout_Foreign_Connector = 0;
+volatile int    Test_Channel_Idle_Timeout_Foreign_Fired     = 0;
+
+CASE(Test_Channel_Idle_Timeout_Foreign_Thread) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_connect) {
+                Test_Channel_Idle_Timeout_Foreign_Connector = knet_channel_ref_share(channel);
+            } else if (e & channel_cb_event_timeout) {
+                Test_Channel_Idle_Timeout_Foreign_Fired = 1;
+            }
+        }
+    };
+
+    int i = 0;
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 1024);
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    kthread_runner_t* runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(runner, loop, 0);
+    while (!Test_Channel_Idle_Timeout_Foreign_Connector) {
+        thread_sleep_ms(1);
+    }
+    // ӽ߳öʱ, kloop_t̼߳ʱ
+    knet_channel_ref_set_timeout_ms(Test_Channel_Idle_Timeout_Foreign_Connector, 200);
+    for (i = 0; (i < 2000) && !Test_Channel_Idle_Timeout_Foreign_Fired; i++) {
+        thread_sleep_ms(1);
+    }
+    thread_runner_stop(runner);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    EXPECT_TRUE(Test_Channel_Idle_Timeout_Foreign_Fired);
+    knet_channel_ref_leave(Test_Channel_Idle_Timeout_Foreign_Connector);
+    knet_loop_destroy(loop);
+}
+
+int Test_Channel_Send_Watermark_Refused = 0;
+
+CASE(Test_Channel_Send_Watermark) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_recv) {
+                knet_stream_eat_all(knet_channel_ref_get_stream(channel));
+            }
+        }
+
+        static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            static char block[16 * 1024];
+            int i = 0;
+            if (e & channel_cb_event_accept) {
+                knet_channel_ref_set_send_watermark(channel, 256 * 1024, 64 * 1024);
+                // Զͬһ߳, дֱˮλ
+                for (; i < 10000; i++) {
+                    if (error_send_watermark == knet_stream_push(knet_channel_ref_get_stream(channel), block, sizeof(block))) {
+                        Test_Channel_Send_Watermark_Refused = 1;
+                        break;
+                    }
+                }
+                EXPECT_TRUE(Test_Channel_Send_Watermark_Refused);
+                // ܾд벻رչܵ
+                EXPECT_TRUE(knet_channel_ref_check_state(channel, channel_state_active));
+                EXPECT_TRUE(knet_channel_ref_get_send_list_bytes(channel) > 64 * 1024);
+            } else if (e & channel_cb_event_send_drained) {
+                EXPECT_TRUE(knet_channel_ref_get_send_list_bytes(channel) <= 64 * 1024);
+                EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(channel), block, sizeof(block)));
+                knet_loop_exit(knet_channel_ref_get_loop(channel));
+            }
+        }
+    };
+
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, INT_MAX, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::client_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024 * 1024);
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+
+    knet_loop_run(loop);
+    knet_loop_destroy(loop);
+}
+
+kchannel_ref_t* Test_Channel_Send_Watermark_Foreign_Client = 0;
+int Test_Channel_Send_Watermark_Foreign_Drained = 0;
+
+CASE(Test_Channel_Send_Watermark_Foreign_Thread) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_recv) {
+                knet_stream_eat_all(knet_channel_ref_get_stream(channel));
+            }
+        }
+
+        static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_accept) {
+                knet_channel_ref_set_send_watermark(channel, 256 * 1024, 64 * 1024);
+                Test_Channel_Send_Watermark_Foreign_Client = knet_channel_ref_share(channel);
+            } else if (e & channel_cb_event_send_drained) {
+                Test_Channel_Send_Watermark_Foreign_Drained = 1;
+            }
+        }
+    };
+
+    static char block[16 * 1024];
+    int i = 0;
+    int refused = 0;
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, INT_MAX, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::client_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024 * 1024);
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    kthread_runner_t* runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(runner, loop, 0);
+    while (!Test_Channel_Send_Watermark_Foreign_Client) {
+        thread_sleep_ms(1);
+    }
+    // ߳д, Ͷݵkloop_tδݼˮλ
+    for (; i < 10000; i++) {
+        if (error_send_watermark == knet_stream_push(knet_channel_ref_get_stream(Test_Channel_Send_Watermark_Foreign_Client), block, sizeof(block))) {
+            refused = 1;
+            break;
+        }
+    }
+    EXPECT_TRUE(refused);
+    // ܾдkloop_tʱ֪ͨ
+    for (i = 0; (i < 2000) && !Test_Channel_Send_Watermark_Foreign_Drained; i++) {
+        thread_sleep_ms(1);
+    }
+    thread_runner_stop(runner);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    EXPECT_TRUE(Test_Channel_Send_Watermark_Foreign_Drained);
+    knet_channel_ref_leave(Test_Channel_Send_Watermark_Foreign_Client);
+    knet_loop_destroy(loop);
+}
+
+kchannel_ref_t* case_Test_Channel_Recv_Buffer_Grow_channel = 0;
+
+CASE(Test_Channel_Recv_Buffer_Grow) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            static char block[32 * 1024];
+            if (e & channel_cb_event_connect) {
+                EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(channel), block, sizeof(block)));
+            }
+        }
+
+        static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kstream_t* stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_accept) {
+                // ջӳʼȿʼ
+                EXPECT_TRUE(CHANNEL_RECV_BUFFER_INIT_SIZE == knet_channel_ref_get_recv_buffer_len(channel));
+            } else if (e & channel_cb_event_recv) {
+                // ȡ, ջֱ
+                if (knet_stream_available(stream) < 32 * 1024) {
+                    return;
+                }
+                EXPECT_TRUE(knet_channel_ref_get_recv_buffer_len(channel) >= 32 * 1024);
+                EXPECT_TRUE(knet_channel_ref_get_recv_buffer_len(channel) <= 64 * 1024);
+                EXPECT_TRUE(knet_channel_ref_get_recv_buffer_total() >= 32 * 1024);
+                // ܵռóʼ
+                EXPECT_TRUE(knet_loop_profile_get_recv_buffer_bytes(knet_loop_get_profile(knet_channel_ref_get_loop(channel))) ==
+                    (uint64_t)(CHANNEL_RECV_BUFFER_INIT_SIZE + 1024 + knet_channel_ref_get_recv_buffer_len(channel)));
+                knet_stream_eat_all(stream);
+                case_Test_Channel_Recv_Buffer_Grow_channel = channel;
+                knet_loop_exit(knet_channel_ref_get_loop(channel));
+            }
+        }
+    };
+
+    // ܻδٵĹܵ
+    uint64_t total = knet_channel_ref_get_recv_buffer_total();
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 64 * 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::client_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024);
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+
+    knet_loop_run(loop);
+    // гCHANNEL_RECV_BUFFER_IDLEسʼ
+    kloop_profile_t* profile = knet_loop_get_profile(loop);
+    time_t start = knet_loop_get_clock_ms(loop);
+    EXPECT_TRUE(case_Test_Channel_Recv_Buffer_Grow_channel);
+    EXPECT_TRUE(!knet_loop_profile_get_idle_channel_count(profile));
+    while (knet_loop_get_clock_ms(loop) - start < CHANNEL_RECV_BUFFER_IDLE + 2000) {
+        if (CHANNEL_RECV_BUFFER_INIT_SIZE == knet_channel_ref_get_recv_buffer_len(case_Test_Channel_Recv_Buffer_Grow_channel)) {
+            break;
+        }
+        knet_loop_run_once(loop);
+    }
+    EXPECT_TRUE(CHANNEL_RECV_BUFFER_INIT_SIZE == knet_channel_ref_get_recv_buffer_len(case_Test_Channel_Recv_Buffer_Grow_channel));
+    EXPECT_TRUE(knet_loop_profile_get_recv_buffer_bytes(profile) == (uint64_t)(CHANNEL_RECV_BUFFER_INIT_SIZE * 2 + 1024));
+    EXPECT_TRUE(1 == knet_loop_profile_get_idle_channel_count(profile));
+    EXPECT_TRUE(CHANNEL_RECV_BUFFER_INIT_SIZE == knet_loop_profile_get_idle_recv_buffer_len(profile));
+    knet_loop_destroy(loop);
+    EXPECT_TRUE(total == knet_channel_ref_get_recv_buffer_total());
+}
+
 kchannel_ref_t* case_Test_Channel_Share_Leave_channel = 0;
 
 CASE(Test_Channel_Share_Leave) {
@@ -273,3 +537,443 @@ CASE(Test_Channel_Share_Leave) {
     // ʣ3ܵﱻ
     knet_loop_destroy(loop);
 }
+
+kbroadcast_t*    case_Test_Broadcast_Partition_broadcast = 0;
+kchannel_ref_t*  case_Test_Broadcast_Partition_shares[4] = {0};
+volatile int     case_Test_Broadcast_Partition_count     = 0;
+volatile int     case_Test_Broadcast_Partition_bytes     = 0;
+
+CASE(Test_Broadcast_Partition) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kstream_t* stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_recv) {
+                case_Test_Broadcast_Partition_bytes += knet_stream_available(stream);
+                knet_stream_eat_all(stream);
+            }
+        }
+
+        static void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kchannel_ref_t* shared = 0;
+            if (e & channel_cb_event_accept) {
+                shared = knet_channel_ref_share(channel);
+                EXPECT_TRUE(error_ok == knet_broadcast_join(case_Test_Broadcast_Partition_broadcast, shared));
+                // ظʧ
+                EXPECT_TRUE(error_broadcast_joined == knet_broadcast_join(case_Test_Broadcast_Partition_broadcast, shared));
+                case_Test_Broadcast_Partition_shares[case_Test_Broadcast_Partition_count++] = shared;
+            }
+        }
+    };
+
+    static char block[100];
+    int i = 0;
+    case_Test_Broadcast_Partition_broadcast = knet_broadcast_create();
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::acceptor_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 4));
+    for (i = 0; i < 4; i++) {
+        kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024);
+        knet_channel_ref_set_cb(connector, &holder::connector_cb);
+        knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    }
+    kthread_runner_t* runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(runner, loop, 0);
+    while (case_Test_Broadcast_Partition_count < 4) {
+        thread_sleep_ms(1);
+    }
+    // 㲥̲߳kloop_t߳, ÿι㲥ֻͶһ¼
+    for (i = 0; i < 10; i++) {
+        EXPECT_TRUE(4 == knet_broadcast_write(case_Test_Broadcast_Partition_broadcast, block, sizeof(block)));
+    }
+    while (case_Test_Broadcast_Partition_bytes < 4 * 10 * (int)sizeof(block)) {
+        thread_sleep_ms(1);
+    }
+    // ߳뿪, kloop_t߳ڻ
+    EXPECT_TRUE(error_ok == knet_broadcast_leave(case_Test_Broadcast_Partition_broadcast,
+        case_Test_Broadcast_Partition_shares[0]));
+    EXPECT_TRUE(error_ok == knet_broadcast_leave(case_Test_Broadcast_Partition_broadcast,
+        case_Test_Broadcast_Partition_shares[1]));
+    EXPECT_TRUE(2 == knet_broadcast_get_count(case_Test_Broadcast_Partition_broadcast));
+    EXPECT_TRUE(2 == knet_broadcast_write(case_Test_Broadcast_Partition_broadcast, block, sizeof(block)));
+    while (case_Test_Broadcast_Partition_bytes < 4 * 10 * (int)sizeof(block) + 2 * (int)sizeof(block)) {
+        thread_sleep_ms(1);
+    }
+    thread_runner_stop(runner);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    EXPECT_TRUE(4 * 10 * (int)sizeof(block) + 2 * (int)sizeof(block) == case_Test_Broadcast_Partition_bytes);
+    // ʣ㲥
+    knet_broadcast_destroy(case_Test_Broadcast_Partition_broadcast);
+    knet_loop_destroy(loop);
+}
+
+kbroadcast_t*    case_Test_Broadcast_Join_Grow_broadcast  = 0;
+kchannel_ref_t*  case_Test_Broadcast_Join_Grow_shares[40] = {0};
+volatile int     case_Test_Broadcast_Join_Grow_count      = 0;
+volatile int     case_Test_Broadcast_Join_Grow_bytes      = 0;
+
+CASE(Test_Broadcast_Join_Grow) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kstream_t* stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_recv) {
+                case_Test_Broadcast_Join_Grow_bytes += knet_stream_available(stream);
+                knet_stream_eat_all(stream);
+            }
+        }
+
+        static void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_accept) {
+                case_Test_Broadcast_Join_Grow_shares[case_Test_Broadcast_Join_Grow_count++] = knet_channel_ref_share(channel);
+            }
+        }
+    };
+
+    static char block[100];
+    int i = 0;
+    case_Test_Broadcast_Join_Grow_broadcast = knet_broadcast_create();
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::acceptor_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 40));
+    for (i = 0; i < 40; i++) {
+        kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024);
+        knet_channel_ref_set_cb(connector, &holder::connector_cb);
+        knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    }
+    kthread_runner_t* runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(runner, loop, 0);
+    while (case_Test_Broadcast_Join_Grow_count < 40) {
+        thread_sleep_ms(1);
+    }
+    // ̼߳, Աʼ, ÿμ֮㲥ȴгԱյ
+    for (i = 0; i < 40; i++) {
+        EXPECT_TRUE(error_ok == knet_broadcast_join(case_Test_Broadcast_Join_Grow_broadcast,
+            case_Test_Broadcast_Join_Grow_shares[i]));
+        EXPECT_TRUE(i + 1 == knet_broadcast_write(case_Test_Broadcast_Join_Grow_broadcast, block, sizeof(block)));
+        while (case_Test_Broadcast_Join_Grow_bytes < (i + 1) * (i + 2) / 2 * (int)sizeof(block)) {
+            thread_sleep_ms(1);
+        }
+    }
+    for (i = 0; i < 40; i += 2) {
+        EXPECT_TRUE(error_ok == knet_broadcast_leave(case_Test_Broadcast_Join_Grow_broadcast,
+            case_Test_Broadcast_Join_Grow_shares[i]));
+    }
+    EXPECT_TRUE(20 == knet_broadcast_get_count(case_Test_Broadcast_Join_Grow_broadcast));
+    EXPECT_TRUE(20 == knet_broadcast_write(case_Test_Broadcast_Join_Grow_broadcast, block, sizeof(block)));
+    while (case_Test_Broadcast_Join_Grow_bytes < 840 * (int)sizeof(block)) {
+        thread_sleep_ms(1);
+    }
+    thread_runner_stop(runner);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    EXPECT_TRUE(840 * (int)sizeof(block) == case_Test_Broadcast_Join_Grow_bytes);
+    // ʣĳԱ㲥
+    knet_broadcast_destroy(case_Test_Broadcast_Join_Grow_broadcast);
+    for (i = 0; i < 40; i++) {
+        knet_channel_ref_leave(case_Test_Broadcast_Join_Grow_shares[i]);
+    }
+    knet_loop_destroy(loop);
+}
+
+kloop_t*         case_Test_Channel_Migrate_Write_loops[2] = {0};
+kchannel_ref_t*  case_Test_Channel_Migrate_Write_server   = 0;
+kchannel_ref_t*  case_Test_Channel_Migrate_Write_client   = 0;
+volatile int     case_Test_Channel_Migrate_Write_recv     = 0;
+volatile int     case_Test_Channel_Migrate_Write_order    = 1;
+atomic_counter_t case_Test_Channel_Migrate_Write_count    = 0;
+
+CASE(Test_Channel_Migrate_Foreign_Write) {
+    struct holder {
+        static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            static char buffer[4096];
+            int         size   = 0;
+            int         i      = 0;
+            kstream_t*  stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_connect) {
+                case_Test_Channel_Migrate_Write_client = knet_channel_ref_share(channel);
+            } else if (e & channel_cb_event_recv) {
+                while (knet_stream_available(stream)) {
+                    size = knet_stream_available(stream);
+                    size = (size > (int)sizeof(buffer)) ? (int)sizeof(buffer) : size;
+                    knet_stream_pop(stream, buffer, size);
+                    // Ǩ;߳дݲ
+                    for (i = 0; i < size; i++) {
+                        if ((char)((case_Test_Channel_Migrate_Write_recv + i) % 251) != buffer[i]) {
+                            case_Test_Channel_Migrate_Write_order = 0;
+                        }
+                    }
+                    case_Test_Channel_Migrate_Write_recv += size;
+                }
+            }
+        }
+
+        static void server_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kloop_t* target = 0;
+            if (e & channel_cb_event_accept) {
+                case_Test_Channel_Migrate_Write_server = knet_channel_ref_share(channel);
+            } else if (e & channel_cb_event_recv) {
+                knet_stream_eat_all(knet_channel_ref_get_stream(channel));
+                // kloop_t֮Ǩ, ϴǨδʱʧ
+                target = (knet_channel_ref_get_loop(channel) == case_Test_Channel_Migrate_Write_loops[0]) ?
+                    case_Test_Channel_Migrate_Write_loops[1] : case_Test_Channel_Migrate_Write_loops[0];
+                if (error_ok == knet_channel_ref_migrate(channel, target)) {
+                    atomic_counter_inc(&case_Test_Channel_Migrate_Write_count);
+                }
+            }
+        }
+    };
+
+    static char block[100];
+    int i = 0;
+    int j = 0;
+    kthread_runner_t* runners[2] = {0};
+    for (i = 0; i < 2; i++) {
+        case_Test_Channel_Migrate_Write_loops[i] = knet_loop_create();
+    }
+    kloop_t* client_loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(case_Test_Channel_Migrate_Write_loops[0], 0, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::server_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    kchannel_ref_t* connector = knet_loop_create_channel(client_loop, INT_MAX, 64 * 1024);
+    knet_channel_ref_set_cb(connector, &holder::client_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    for (i = 0; i < 2; i++) {
+        runners[i] = thread_runner_create(0, 0);
+        thread_runner_start_loop(runners[i], case_Test_Channel_Migrate_Write_loops[i], 0);
+    }
+    kthread_runner_t* client_runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(client_runner, client_loop, 0);
+    while (!case_Test_Channel_Migrate_Write_server || !case_Test_Channel_Migrate_Write_client) {
+        thread_sleep_ms(1);
+    }
+    // ǰ̲߳κkloop_t߳, Ǩڼд
+    for (i = 0; i < 5000; i++) {
+        if (!(i % 10)) {
+            EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(case_Test_Channel_Migrate_Write_client), "m", 1));
+        }
+        for (j = 0; j < (int)sizeof(block); j++) {
+            block[j] = (char)((i * (int)sizeof(block) + j) % 251);
+        }
+        EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(case_Test_Channel_Migrate_Write_server), block, sizeof(block)));
+    }
+    while (case_Test_Channel_Migrate_Write_recv < 5000 * (int)sizeof(block)) {
+        thread_sleep_ms(1);
+    }
+    for (i = 0; i < 2; i++) {
+        thread_runner_stop(runners[i]);
+        thread_runner_join(runners[i]);
+        thread_runner_destroy(runners[i]);
+    }
+    thread_runner_stop(client_runner);
+    thread_runner_join(client_runner);
+    thread_runner_destroy(client_runner);
+    EXPECT_TRUE(case_Test_Channel_Migrate_Write_order);
+    EXPECT_TRUE(5000 * (int)sizeof(block) == case_Test_Channel_Migrate_Write_recv);
+    EXPECT_TRUE(case_Test_Channel_Migrate_Write_count > 0);
+    knet_channel_ref_leave(case_Test_Channel_Migrate_Write_server);
+    knet_channel_ref_leave(case_Test_Channel_Migrate_Write_client);
+    knet_loop_destroy(client_loop);
+    for (i = 0; i < 2; i++) {
+        knet_loop_destroy(case_Test_Channel_Migrate_Write_loops[i]);
+    }
+}
+
+kbroadcast_t*    case_Test_Broadcast_Migrate_broadcast = 0;
+kloop_t*         case_Test_Broadcast_Migrate_target    = 0;
+kchannel_ref_t*  case_Test_Broadcast_Migrate_server    = 0;
+volatile int     case_Test_Broadcast_Migrate_connected = 0;
+volatile int     case_Test_Broadcast_Migrate_in_target = 0;
+volatile int     case_Test_Broadcast_Migrate_bytes     = 0;
+
+CASE(Test_Broadcast_Migrate) {
+    struct holder {
+        static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kstream_t* stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_connect) {
+                EXPECT_TRUE(error_ok == knet_stream_push(stream, "m", 1));
+            } else if (e & channel_cb_event_recv) {
+                case_Test_Broadcast_Migrate_bytes += knet_stream_available(stream);
+                knet_stream_eat_all(stream);
+            }
+        }
+
+        static void server_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kchannel_ref_t* shared = 0;
+            if (e & channel_cb_event_accept) {
+                shared = knet_channel_ref_share(channel);
+                EXPECT_TRUE(error_ok == knet_broadcast_join(case_Test_Broadcast_Migrate_broadcast, shared));
+                case_Test_Broadcast_Migrate_server = shared;
+            } else if (e & channel_cb_event_recv) {
+                knet_stream_eat_all(knet_channel_ref_get_stream(channel));
+                // 㲥Ǩ
+                EXPECT_TRUE(error_ok == knet_channel_ref_migrate(channel, case_Test_Broadcast_Migrate_target));
+            } else if (e & channel_cb_event_send) {
+                if (knet_channel_ref_get_loop(channel) == case_Test_Broadcast_Migrate_target) {
+                    case_Test_Broadcast_Migrate_in_target = 1;
+                }
+            }
+        }
+    };
+
+    static char block[100];
+    int i = 0;
+    case_Test_Broadcast_Migrate_broadcast = knet_broadcast_create();
+    kloop_t* loop = knet_loop_create();
+    kloop_t* client_loop = knet_loop_create();
+    case_Test_Broadcast_Migrate_target = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 0, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::server_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    kchannel_ref_t* connector = knet_loop_create_channel(client_loop, 0, 64 * 1024);
+    knet_channel_ref_set_cb(connector, &holder::client_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    kthread_runner_t* runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(runner, loop, 0);
+    kthread_runner_t* client_runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(client_runner, client_loop, 0);
+    kthread_runner_t* target_runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(target_runner, case_Test_Broadcast_Migrate_target, 0);
+    while (!case_Test_Broadcast_Migrate_server ||
+        (knet_channel_ref_get_loop(case_Test_Broadcast_Migrate_server) != case_Test_Broadcast_Migrate_target)) {
+        thread_sleep_ms(1);
+    }
+    // ȷǨѾ
+    EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(case_Test_Broadcast_Migrate_server), "m", 1));
+    while (!case_Test_Broadcast_Migrate_in_target) {
+        thread_sleep_ms(1);
+    }
+    // ԭkloop_tֹͣ㲥Ȼ, ܵѾƶĿkloop_tķ
+    thread_runner_stop(runner);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    for (i = 0; i < 10; i++) {
+        EXPECT_TRUE(1 == knet_broadcast_write(case_Test_Broadcast_Migrate_broadcast, block, sizeof(block)));
+    }
+    while (case_Test_Broadcast_Migrate_bytes < 1 + 10 * (int)sizeof(block)) {
+        thread_sleep_ms(1);
+    }
+    EXPECT_TRUE(error_ok == knet_broadcast_leave(case_Test_Broadcast_Migrate_broadcast,
+        case_Test_Broadcast_Migrate_server));
+    EXPECT_TRUE(0 == knet_broadcast_get_count(case_Test_Broadcast_Migrate_broadcast));
+    thread_runner_stop(client_runner);
+    thread_runner_join(client_runner);
+    thread_runner_destroy(client_runner);
+    thread_runner_stop(target_runner);
+    thread_runner_join(target_runner);
+    thread_runner_destroy(target_runner);
+    knet_channel_ref_leave(case_Test_Broadcast_Migrate_server);
+    // ԭkloop_tδĿջ¼ͷŹ㲥
+    knet_broadcast_destroy(case_Test_Broadcast_Migrate_broadcast);
+    knet_loop_destroy(case_Test_Broadcast_Migrate_target);
+    knet_loop_destroy(client_loop);
+    knet_loop_destroy(loop);
+}
+
+kloop_t*         case_Test_Channel_Migrate_target    = 0;
+kchannel_ref_t*  case_Test_Channel_Migrate_server    = 0;
+kchannel_ref_t*  case_Test_Channel_Migrate_client    = 0;
+volatile int     case_Test_Channel_Migrate_recv      = 0;
+volatile int     case_Test_Channel_Migrate_order     = 1;
+volatile int     case_Test_Channel_Migrate_request   = 0;
+volatile int     case_Test_Channel_Migrate_in_target = 0;
+
+CASE(Test_Channel_Migrate) {
+    struct holder {
+        static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            static char buffer[4096];
+            int         size   = 0;
+            int         i      = 0;
+            kstream_t*  stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_connect) {
+                case_Test_Channel_Migrate_client = knet_channel_ref_share(channel);
+            } else if (e & channel_cb_event_recv) {
+                while (knet_stream_available(stream)) {
+                    size = knet_stream_available(stream);
+                    size = (size > (int)sizeof(buffer)) ? (int)sizeof(buffer) : size;
+                    knet_stream_pop(stream, buffer, size);
+                    // Ǩǰ͵ݲܶʧ
+                    for (i = 0; i < size; i++) {
+                        if ((char)((case_Test_Channel_Migrate_recv + i) % 251) != buffer[i]) {
+                            case_Test_Channel_Migrate_order = 0;
+                        }
+                    }
+                    case_Test_Channel_Migrate_recv += size;
+                }
+            }
+        }
+
+        static void server_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kstream_t* stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_accept) {
+                case_Test_Channel_Migrate_server = knet_channel_ref_share(channel);
+            } else if (e & channel_cb_event_recv) {
+                knet_stream_eat_all(stream);
+                if (knet_channel_ref_get_loop(channel) == case_Test_Channel_Migrate_target) {
+                    case_Test_Channel_Migrate_in_target = 1;
+                } else if (!case_Test_Channel_Migrate_request) {
+                    // ֻڹܵ߳ڷǨ
+                    EXPECT_TRUE(error_ok == knet_channel_ref_migrate(channel, case_Test_Channel_Migrate_target));
+                    // ǨǰٴǨ
+                    EXPECT_TRUE(error_migrate_fail == knet_channel_ref_migrate(channel, case_Test_Channel_Migrate_target));
+                    case_Test_Channel_Migrate_request = 1;
+                }
+            }
+        }
+    };
+
+    static char block[100];
+    int i = 0;
+    int j = 0;
+    kloop_t* loop = knet_loop_create();
+    case_Test_Channel_Migrate_target = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 0, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::server_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, INT_MAX, 64 * 1024);
+    knet_channel_ref_set_cb(connector, &holder::client_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    kthread_runner_t* runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(runner, loop, 0);
+    kthread_runner_t* target_runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(target_runner, case_Test_Channel_Migrate_target, 0);
+    while (!case_Test_Channel_Migrate_server || !case_Test_Channel_Migrate_client) {
+        thread_sleep_ms(1);
+    }
+    // ڹܵ߳
+    EXPECT_TRUE(error_migrate_fail == knet_channel_ref_migrate(case_Test_Channel_Migrate_server,
+        case_Test_Channel_Migrate_target));
+    for (i = 0; i < 1000; i++) {
+        if (i == 500) {
+            // ˹ܵյݺǨ, Ǩ;еĿ̷߳ԭkloop_tת
+            EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(case_Test_Channel_Migrate_client), "m", 1));
+        }
+        for (j = 0; j < (int)sizeof(block); j++) {
+            block[j] = (char)((i * (int)sizeof(block) + j) % 251);
+        }
+        EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(case_Test_Channel_Migrate_server), block, sizeof(block)));
+    }
+    while (case_Test_Channel_Migrate_recv < 1000 * (int)sizeof(block)) {
+        thread_sleep_ms(1);
+    }
+    // ǨƺĿkloop_t߳ڻص
+    EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(case_Test_Channel_Migrate_client), "m", 1));
+    while (!case_Test_Channel_Migrate_in_target) {
+        thread_sleep_ms(1);
+    }
+    thread_runner_stop(runner);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    thread_runner_stop(target_runner);
+    thread_runner_join(target_runner);
+    thread_runner_destroy(target_runner);
+    EXPECT_TRUE(case_Test_Channel_Migrate_order);
+    EXPECT_TRUE(1000 * (int)sizeof(block) == case_Test_Channel_Migrate_recv);
+    EXPECT_TRUE(knet_channel_ref_get_loop(case_Test_Channel_Migrate_server) == case_Test_Channel_Migrate_target);
+    EXPECT_TRUE(1 == knet_loop_get_active_channel_count(case_Test_Channel_Migrate_target));
+    knet_channel_ref_leave(case_Test_Channel_Migrate_server);
+    knet_channel_ref_leave(case_Test_Channel_Migrate_client);
+    knet_loop_destroy(case_Test_Channel_Migrate_target);
+    knet_loop_destroy(loop);
+}
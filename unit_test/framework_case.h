@@ -124,6 +124,57 @@ CASE(Test_Framework_Async) {
     EXPECT_TRUE(Test_Framework_Accept);
 }
 
+CASE(Test_Framework_Reuse_Port) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_connect) {
+                kstream_t* stream = knet_channel_ref_get_stream(channel);
+                knet_stream_push(stream, "1234", 5);
+            } else if (e & channel_cb_event_recv) {
+                Test_Framework_Echo = true;
+                knet_channel_ref_close(channel);
+                knet_framework_stop(Test_Framework_Framework);
+            }
+        }
+
+        static void channel_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_accept) {
+                Test_Framework_Accept = true;
+            }
+            if (e & channel_cb_event_recv) {
+                kstream_t* stream = knet_channel_ref_get_stream(channel);
+                knet_stream_push(stream, "1234", 5);
+            }
+        }
+    };
+
+    Test_Framework_Echo   = false;
+    Test_Framework_Accept = false;
+
+    Test_Framework_Framework = knet_framework_create();
+    kframework_config_t* c = knet_framework_get_config(Test_Framework_Framework);
+    kframework_acceptor_config_t* ac = knet_framework_config_new_acceptor(c);
+    knet_framework_acceptor_config_set_local_address(ac, 0, 8000);
+    knet_framework_acceptor_config_set_client_cb(ac, &holder::channel_cb);
+    // ÿ̸߳Լ
+    knet_framework_acceptor_config_set_reuse_port(ac, 1);
+    knet_framework_config_set_worker_thread_count(c, 4);
+
+    // ģһⲿ
+    kframework_connector_config_t* cc = knet_framework_config_new_connector(c);
+    knet_framework_connector_config_set_remote_address(cc, "127.0.0.1", 8000);
+    knet_framework_connector_config_set_cb(cc, &holder::connector_cb);
+
+    // 
+    EXPECT_TRUE(error_ok == knet_framework_start(Test_Framework_Framework));
+
+    knet_framework_wait_for_stop(Test_Framework_Framework);
+    knet_framework_destroy(Test_Framework_Framework);
+
+    EXPECT_TRUE(Test_Framework_Echo);
+    EXPECT_TRUE(Test_Framework_Accept);
+}
+
 CASE(Test_Framework_Start_Fail) {
     kframework_t* f = knet_framework_create();
     kframework_config_t* c = knet_framework_get_config(f);
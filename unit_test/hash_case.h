@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2014-2015, dennis wang
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "helper.h"
+#include "knet.h"
+
+CASE(Test_Hash_Grow) {
+    uint32_t i = 0;
+    int ok = 1;
+    khash_t* hash = hash_create(0, 0);
+    /* , ڼ佻ɾ */
+    for (i = 1; i <= 10000; i++) {
+        EXPECT_TRUE(error_ok == hash_add(hash, i, (void*)(size_t)i));
+        if (hash_get(hash, i / 2 + 1) != (void*)(size_t)(i / 2 + 1)) {
+            ok = 0;
+        }
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(10000 == hash_get_size(hash));
+    for (i = 1; i <= 10000; i += 2) {
+        EXPECT_TRUE((void*)(size_t)i == hash_remove(hash, i));
+    }
+    EXPECT_TRUE(5000 == hash_get_size(hash));
+    for (i = 1; i <= 10000; i++) {
+        if ((i % 2) != (hash_get(hash, i) ? 0 : 1)) {
+            ok = 0;
+        }
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_FALSE(hash_remove(hash, 1));
+    hash_destroy(hash);
+}
+
+CASE(Test_Hash_Iterate_Delete) {
+    uint32_t i = 0;
+    uint32_t n = 0;
+    khash_value_t* value = 0;
+    khash_t* hash = hash_create(0, 0);
+    for (i = 1; i <= 100; i++) {
+        hash_add(hash, i, (void*)(size_t)i);
+    }
+    /* ʱɾǰԪ */
+    hash_for_each_safe(hash, value) {
+        EXPECT_TRUE(hash_value_get_value(value) == hash_remove(hash, hash_value_get_key(value)));
+        n++;
+    }
+    EXPECT_TRUE(100 == n);
+    EXPECT_TRUE(0 == hash_get_size(hash));
+    EXPECT_FALSE(hash_get_first(hash));
+    hash_destroy(hash);
+}
+
+CASE(Test_Hash_Insert_While_Iterate) {
+    uint32_t i = 0;
+    uint32_t n = 0;
+    khash_value_t* value = 0;
+    khash_value_t* first = 0;
+    khash_t* hash = hash_create(0, 0);
+    for (i = 1; i <= 4; i++) {
+        hash_add(hash, i, (void*)(size_t)i);
+    }
+    first = hash_get_first(hash);
+    /* ʱԪ, ȡõԪؼλòʧЧ */
+    hash_for_each_safe(hash, value) {
+        if (hash_value_get_key(value) <= 4) {
+            for (i = 0; i < 100; i++) {
+                hash_add(hash, hash_value_get_key(value) * 1000 + i, (void*)(size_t)(i + 1));
+            }
+        }
+        n++;
+    }
+    EXPECT_TRUE(404 == n);
+    EXPECT_TRUE(1 == hash_value_get_key(first));
+    EXPECT_TRUE((void*)(size_t)1 == hash_value_get_value(first));
+    /* ɾȫԪغԼʹ */
+    hash_for_each_safe(hash, value) {
+        hash_remove(hash, hash_value_get_key(value));
+    }
+    EXPECT_TRUE(0 == hash_get_size(hash));
+    EXPECT_TRUE(error_ok == hash_add(hash, 1, (void*)(size_t)1));
+    EXPECT_TRUE((void*)(size_t)1 == hash_get(hash, 1));
+    hash_destroy(hash);
+}
+
+CASE(Test_Hash_String_Key) {
+    int a = 1;
+    int b = 2;
+    static const char* long_key = "a string key longer than the inline key buffer";
+    khash_t* hash = hash_create(0, 0);
+    EXPECT_TRUE(error_ok == hash_add_string_key(hash, "short", &a));
+    EXPECT_TRUE(error_ok == hash_add_string_key(hash, long_key, &b));
+    EXPECT_TRUE(&a == hash_get_string_key(hash, "short"));
+    EXPECT_TRUE(&b == hash_get_string_key(hash, long_key));
+    EXPECT_FALSE(hash_get_string_key(hash, "shor"));
+    EXPECT_TRUE(error_ok == hash_replace_string_key(hash, "short", &b));
+    EXPECT_TRUE(&b == hash_get_string_key(hash, "short"));
+    EXPECT_TRUE(&b == hash_remove_string_key(hash, long_key));
+    EXPECT_TRUE(1 == hash_get_size(hash));
+    EXPECT_TRUE(!strcmp("short", hash_value_get_string_key(hash_get_first(hash))));
+    hash_destroy(hash);
+}
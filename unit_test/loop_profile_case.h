@@ -83,7 +83,7 @@ CASE(Test_Loop_Profile_Dump_Stream) {
 
         static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
             if (e & channel_cb_event_recv) {
-                char buffer[1024] = {0};
+                char buffer[4096] = {0};
                 knet_stream_pop(knet_channel_ref_get_stream(channel), buffer, sizeof(buffer));
                 if (Test_Loop_Profile_i == Test_Loop_Profile_Client_Count) {
                     std::cout << buffer << std::endl;
@@ -101,15 +101,188 @@ CASE(Test_Loop_Profile_Dump_Stream) {
     };
     Test_Loop_Profile_i = 0;
     kloop_t* loop = knet_loop_create();
-    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 1024);
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 4096);
     knet_channel_ref_set_cb(acceptor, &holder::acceptor_cb);
     knet_channel_ref_accept(acceptor, 0, 8000, 10);
     for (int i = 0; i < Test_Loop_Profile_Client_Count; i++) {
-        kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 1024);
+        kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 4096);
         knet_channel_ref_set_cb(connector, &holder::connector_cb);
         knet_channel_ref_connect(connector, 0, 8000, 0);
     }
     knet_loop_run(loop);
     EXPECT_TRUE(Test_Loop_Profile_Client_Count == Test_Loop_Profile_i);
+    // Ĭϲͳӳ
+    EXPECT_TRUE(!knet_loop_profile_check_latency(knet_loop_get_profile(loop)));
+    EXPECT_TRUE(!knet_loop_profile_get_callback_count(knet_loop_get_profile(loop)));
+    knet_loop_destroy(loop);
+}
+
+kchannel_ref_t* case_Test_Loop_Profile_Snapshot_client = 0;
+volatile int    case_Test_Loop_Profile_Snapshot_recv   = 0;
+volatile int    case_Test_Loop_Profile_Snapshot_done   = 0;
+uint64_t        case_Test_Loop_Profile_Snapshot_uuid   = 0;
+
+CASE(Test_Loop_Profile_Snapshot) {
+    struct holder {
+        static void client_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_connect) {
+                case_Test_Loop_Profile_Snapshot_client = knet_channel_ref_share(channel);
+            }
+        }
+
+        static void server_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            kstream_t* stream = knet_channel_ref_get_stream(channel);
+            if (e & channel_cb_event_recv) {
+                case_Test_Loop_Profile_Snapshot_recv += knet_stream_available(stream);
+                knet_stream_eat_all(stream);
+                if ((case_Test_Loop_Profile_Snapshot_recv == 100 * 100) && !case_Test_Loop_Profile_Snapshot_done) {
+                    // Ļص
+                    thread_sleep_ms(20);
+                    case_Test_Loop_Profile_Snapshot_uuid = knet_channel_ref_get_uuid(channel);
+                    case_Test_Loop_Profile_Snapshot_done = 1;
+                }
+            }
+        }
+    };
+
+    static char block[100] = {0};
+    int      i    = 0;
+    uint64_t uuid = 0;
+    kloop_t* loop = knet_loop_create();
+    kloop_profile_t* profile = knet_loop_get_profile(loop);
+    knet_loop_profile_set_latency(profile, 1);
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 1, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::server_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 1));
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, INT_MAX, 1024);
+    knet_channel_ref_set_cb(connector, &holder::client_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    kthread_runner_t* runner = thread_runner_create(0, 0);
+    thread_runner_start_loop(runner, loop, 0);
+    while (!case_Test_Loop_Profile_Snapshot_client) {
+        thread_sleep_ms(1);
+    }
+    // kloop_t߳д, ÿд붼ǿ߳¼
+    for (i = 0; i < 100; i++) {
+        EXPECT_TRUE(error_ok == knet_stream_push(knet_channel_ref_get_stream(case_Test_Loop_Profile_Snapshot_client), block, sizeof(block)));
+    }
+    while (!case_Test_Loop_Profile_Snapshot_done) {
+        thread_sleep_ms(1);
+    }
+    // ̶߳ȡ, صֻһ, ȴһη
+    for (i = 0; (i < 3000) && (knet_loop_profile_get_slowest_callback(profile, &uuid) < 20000); i++) {
+        thread_sleep_ms(1);
+    }
+    EXPECT_TRUE(knet_loop_profile_get_slowest_callback(profile, &uuid) >= 20000);
+    EXPECT_TRUE(case_Test_Loop_Profile_Snapshot_uuid == uuid);
+    thread_runner_stop(runner);
+    thread_runner_join(runner);
+    thread_runner_destroy(runner);
+    EXPECT_TRUE(knet_loop_profile_get_wakeup_count(profile) > 0);
+    EXPECT_TRUE(knet_loop_profile_get_wakeup_events(profile) > 0);
+    EXPECT_TRUE(knet_loop_profile_get_wakeup_events_max(profile) > 0);
+    EXPECT_TRUE(knet_loop_profile_get_wait_time(profile) > 0);
+    EXPECT_TRUE(knet_loop_profile_get_busy_time(profile) >= 20000);
+    EXPECT_TRUE(knet_loop_profile_get_queue_events(profile) > 0);
+    EXPECT_TRUE(knet_loop_profile_get_queue_depth_max(profile) > 0);
+    EXPECT_TRUE(knet_loop_profile_get_queue_wait_percentile(profile, 500) <=
+        knet_loop_profile_get_queue_wait_percentile(profile, 990));
+    EXPECT_TRUE(knet_loop_profile_get_queue_wait_percentile(profile, 990) <=
+        knet_loop_profile_get_queue_wait_percentile(profile, 1000));
+    EXPECT_TRUE(knet_loop_profile_get_callback_count(profile) >= 3);
+    EXPECT_TRUE(knet_loop_profile_get_callback_percentile(profile, 500) <=
+        knet_loop_profile_get_callback_percentile(profile, 1000));
+    EXPECT_TRUE(knet_loop_profile_get_callback_percentile(profile, 1000) >= 20000);
+    // ȡ޸״̬, ζȡͬ
+    EXPECT_TRUE(knet_loop_profile_get_recv_bandwidth(profile) == knet_loop_profile_get_recv_bandwidth(profile));
+    EXPECT_TRUE(knet_loop_profile_get_sent_bandwidth(profile) == knet_loop_profile_get_sent_bandwidth(profile));
+    EXPECT_TRUE(knet_loop_profile_get_alloc_rate(profile, 0) == knet_loop_profile_get_alloc_rate(profile, 0));
+    knet_channel_ref_leave(case_Test_Loop_Profile_Snapshot_client);
     knet_loop_destroy(loop);
 }
+
+kloop_t*         case_Test_Loop_Balancer_loops[3]  = {0};
+volatile int     case_Test_Loop_Balancer_accept[3] = {0};
+atomic_counter_t case_Test_Loop_Balancer_total     = 0;
+
+CASE(Test_Loop_Balancer_Strategy) {
+    struct holder {
+        static void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_accept) {
+                for (int i = 0; i < 3; i++) {
+                    if (knet_channel_ref_get_loop(channel) == case_Test_Loop_Balancer_loops[i]) {
+                        case_Test_Loop_Balancer_accept[i]++;
+                    }
+                }
+                atomic_counter_inc(&case_Test_Loop_Balancer_total);
+            }
+        }
+
+        static void connect(kloop_t* loop, int count) {
+            for (int i = 0; i < count; i++) {
+                kchannel_ref_t* connector = knet_loop_create_channel(loop, 1, 128);
+                knet_channel_ref_connect(connector, "127.0.0.1", 8000, 0);
+            }
+        }
+    };
+
+    kloop_balancer_t* balancer = knet_loop_balancer_create();
+    kthread_runner_t* runners[3] = {0};
+    for (int i = 0; i < 3; i++) {
+        case_Test_Loop_Balancer_loops[i] = knet_loop_create();
+        EXPECT_TRUE(error_ok == knet_loop_balancer_attach(balancer, case_Test_Loop_Balancer_loops[i]));
+    }
+    EXPECT_TRUE(error_loop_attached == knet_loop_balancer_attach(balancer, case_Test_Loop_Balancer_loops[0]));
+    EXPECT_TRUE(loop_balancer_strategy_least_channel == knet_loop_balancer_get_strategy(balancer));
+    kchannel_ref_t* acceptor = knet_loop_create_channel(case_Test_Loop_Balancer_loops[0], 1, 128);
+    knet_channel_ref_set_cb(acceptor, &holder::acceptor_cb);
+    EXPECT_TRUE(error_ok == knet_channel_ref_accept(acceptor, 0, 8000, 64));
+    for (int i = 0; i < 3; i++) {
+        runners[i] = thread_runner_create(0, 0);
+        thread_runner_start_loop(runners[i], case_Test_Loop_Balancer_loops[i], 0);
+    }
+    // ڵkloop_t븺ؾ
+    kloop_t* client_loop = knet_loop_create();
+    kthread_runner_t* client_runner = thread_runner_create(0, 0);
+    holder::connect(client_loop, 30);
+    thread_runner_start_loop(client_runner, client_loop, 0);
+    while (case_Test_Loop_Balancer_total < 30) {
+        thread_sleep_ms(1);
+    }
+    // ܵٲ, ͶݻδĽ¼Ҳܵ, ܵĹܵȷֲ
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(case_Test_Loop_Balancer_accept[i] >= 8);
+        case_Test_Loop_Balancer_accept[i] = 0;
+    }
+    // һԹϣ, ͬһԶIPѡȡͬһkloop_t
+    knet_loop_balancer_set_strategy(balancer, loop_balancer_strategy_consistent_hash);
+    thread_runner_stop(client_runner);
+    thread_runner_join(client_runner);
+    holder::connect(client_loop, 30);
+    thread_runner_start_loop(client_runner, client_loop, 0);
+    while (case_Test_Loop_Balancer_total < 60) {
+        thread_sleep_ms(1);
+    }
+    int max_accept = 0;
+    for (int i = 0; i < 3; i++) {
+        if (case_Test_Loop_Balancer_accept[i] > max_accept) {
+            max_accept = case_Test_Loop_Balancer_accept[i];
+        }
+    }
+    EXPECT_TRUE(30 == max_accept);
+    thread_runner_stop(client_runner);
+    thread_runner_join(client_runner);
+    thread_runner_destroy(client_runner);
+    for (int i = 0; i < 3; i++) {
+        thread_runner_stop(runners[i]);
+        thread_runner_join(runners[i]);
+        thread_runner_destroy(runners[i]);
+    }
+    EXPECT_TRUE(error_ok == knet_loop_balancer_detach(balancer, case_Test_Loop_Balancer_loops[2]));
+    EXPECT_TRUE(error_loop_not_found == knet_loop_balancer_detach(balancer, case_Test_Loop_Balancer_loops[2]));
+    knet_loop_destroy(client_loop);
+    for (int i = 0; i < 3; i++) {
+        knet_loop_destroy(case_Test_Loop_Balancer_loops[i]);
+    }
+    knet_loop_balancer_destroy(balancer);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2014-2015, dennis wang
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "helper.h"
+#include "knet.h"
+
+CASE(Test_Ringbuffer_Wrap) {
+    char buffer[16] = {0};
+    uint32_t size   = 0;
+    // Ȳ2
+    kringbuffer_t* rb = ringbuffer_create(10);
+    EXPECT_TRUE(6 == ringbuffer_write(rb, "abcdef", 6));
+    EXPECT_TRUE(4 == ringbuffer_remove(rb, 4));
+    // Խĩβд
+    EXPECT_TRUE(8 == ringbuffer_write(rb, "ghijklmnop", 10));
+    EXPECT_TRUE(ringbuffer_full(rb));
+    EXPECT_TRUE(10 == ringbuffer_copy(rb, buffer, sizeof(buffer)));
+    EXPECT_TRUE(!memcmp(buffer, "efghijklmn", 10));
+    EXPECT_TRUE(3 == ringbuffer_copy_random(rb, 6, buffer, 3));
+    EXPECT_TRUE(!memcmp(buffer, "klm", 3));
+    EXPECT_TRUE(0 == ringbuffer_copy_random(rb, 8, buffer, 3));
+    EXPECT_TRUE(3 == ringbuffer_replace(rb, 5, "XYZ", 3));
+    EXPECT_TRUE(error_ok == ringbuffer_find(rb, "YZ", &size));
+    EXPECT_TRUE(8 == size);
+    EXPECT_TRUE(10 == ringbuffer_read(rb, buffer, sizeof(buffer)));
+    EXPECT_TRUE(!memcmp(buffer, "efghiXYZmn", 10));
+    EXPECT_TRUE(ringbuffer_empty(rb));
+    ringbuffer_destroy(rb);
+    // Ϊ2
+    rb = ringbuffer_create(8);
+    EXPECT_TRUE(5 == ringbuffer_write(rb, "12345", 5));
+    EXPECT_TRUE(error_ok == ringbuffer_eat(rb, 5));
+    EXPECT_TRUE(6 == ringbuffer_write(rb, "abcdef", 6));
+    EXPECT_TRUE(6 == ringbuffer_read(rb, buffer, 6));
+    EXPECT_TRUE(!memcmp(buffer, "abcdef", 6));
+    ringbuffer_destroy(rb);
+}
+
+CASE(Test_Ringbuffer_Peek_Ptr) {
+    char     buffer[256] = {0};
+    char*    ptr         = 0;
+    uint32_t i           = 0;
+    uint32_t size        = 0;
+    kringbuffer_t* rb    = 0;
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (char)i;
+    }
+    // ͨ, Խĩβݲ
+    rb = ringbuffer_create(1000);
+    EXPECT_FALSE(ringbuffer_is_mirror(rb));
+    for (i = 0; i < 4; i++) {
+        EXPECT_TRUE(200 == ringbuffer_write(rb, buffer, 200));
+    }
+    EXPECT_TRUE(800 == ringbuffer_remove(rb, 800));
+    EXPECT_TRUE(256 == ringbuffer_write(rb, buffer, 256));
+    EXPECT_TRUE(!memcmp(ringbuffer_peek_ptr(rb, 200), buffer, 200));
+    EXPECT_TRUE(0 == ringbuffer_peek_ptr(rb, 201));
+    EXPECT_TRUE(0 == ringbuffer_peek_ptr(rb, 257));
+    ringbuffer_destroy(rb);
+    // 񻺳, Ȱҳ, 
+    rb = ringbuffer_create_mirror(1000);
+    EXPECT_TRUE(ringbuffer_get_max_size(rb) >= 1000);
+    if (ringbuffer_is_mirror(rb)) {
+        for (i = 0; i < ringbuffer_get_max_size(rb) - 100; i++) {
+            EXPECT_TRUE(1 == ringbuffer_write(rb, buffer, 1));
+        }
+        EXPECT_TRUE(ringbuffer_get_max_size(rb) - 100 == ringbuffer_remove(rb, ringbuffer_get_max_size(rb) - 100));
+        EXPECT_TRUE(200 == ringbuffer_write(rb, buffer, 200));
+        ptr = ringbuffer_peek_ptr(rb, 200);
+        EXPECT_TRUE(0 != ptr);
+        EXPECT_TRUE(!memcmp(ptr, buffer, 200));
+        // ʱ½ӳ, ԽĩβݰƵӳͷ
+        size = ringbuffer_get_max_size(rb);
+        EXPECT_TRUE(error_ok == ringbuffer_resize(rb, size + 1));
+        EXPECT_TRUE(ringbuffer_is_mirror(rb));
+        EXPECT_TRUE(ringbuffer_get_max_size(rb) >= size * 2);
+        EXPECT_TRUE(200 == ringbuffer_available(rb));
+        EXPECT_TRUE(!memcmp(ringbuffer_peek_ptr(rb, 200), buffer, 200));
+        EXPECT_TRUE(error_ok == ringbuffer_resize(rb, size));
+        EXPECT_TRUE(size == ringbuffer_get_max_size(rb));
+        EXPECT_TRUE(!memcmp(ringbuffer_peek_ptr(rb, 200), buffer, 200));
+        EXPECT_TRUE(200 == ringbuffer_read(rb, buffer, 200));
+        EXPECT_TRUE(ringbuffer_empty(rb));
+    }
+    ringbuffer_destroy(rb);
+}
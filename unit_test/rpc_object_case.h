@@ -245,3 +245,182 @@ CASE(Test_Rpc_Marshal_Unmarshal_Buffer) {
     krpc_object_destroy(v);
     krpc_object_destroy(v1);
 }
+
+CASE(Test_Rpc_Object_Marshal_Nested) {
+    krpc_object_t* v = krpc_object_create();
+    krpc_object_t* m = krpc_object_create();
+    for (int i = 0; i < 100; i++) {
+        krpc_object_t* inner = krpc_object_create();
+        krpc_object_t* o = krpc_object_create();
+        krpc_number_set_i32(o, i);
+        krpc_vector_push_back(inner, o);
+        o = krpc_object_create();
+        krpc_string_set(o, "abc");
+        krpc_vector_push_back(inner, o);
+        krpc_vector_push_back(v, inner);
+    }
+    krpc_object_t* k = krpc_object_create();
+    krpc_string_set(k, "key");
+    krpc_object_t* mv = krpc_object_create();
+    krpc_number_set_ui64(mv, 12345678901ULL);
+    krpc_map_insert(m, k, mv);
+    krpc_vector_push_back(v, m);
+
+    char     buffer[4096] = {0};
+    uint16_t bytes        = 0;
+
+    EXPECT_TRUE(error_ok == krpc_object_marshal_buffer(v, buffer, sizeof(buffer), &bytes));
+    EXPECT_TRUE(bytes == krpc_object_get_marshal_size(v));
+    // 
+    EXPECT_FALSE(error_ok == krpc_object_marshal_buffer(v, buffer, bytes - 1, &bytes));
+
+    krpc_object_t* v1 = 0;
+    EXPECT_TRUE(error_ok == krpc_object_unmarshal_buffer(buffer, krpc_object_get_marshal_size(v), &v1, &bytes));
+    EXPECT_TRUE(101 == krpc_vector_get_size(v1));
+    EXPECT_TRUE(99 == krpc_number_get_i32(krpc_vector_get(krpc_vector_get(v1, 99), 0)));
+    EXPECT_TRUE(!strcmp("abc", krpc_string_get(krpc_vector_get(krpc_vector_get(v1, 99), 1))));
+    krpc_object_t* k1 = krpc_object_create();
+    krpc_string_set(k1, "key");
+    EXPECT_TRUE(12345678901ULL == krpc_number_get_ui64(krpc_map_get(krpc_vector_get(v1, 100), k1)));
+
+    krpc_object_destroy(k1);
+    krpc_object_destroy(v);
+    krpc_object_destroy(v1);
+}
+
+krpc_t* Test_Rpc_Large_Call_Rpc = 0;
+bool    Test_Rpc_Large_Call_Done = false;
+
+CASE(Test_Rpc_Large_Call) {
+    struct holder {
+        static int rpc_cb(krpc_object_t* o) {
+            // 64KB, ʹóʽ
+            EXPECT_TRUE(20001 == krpc_vector_get_size(o));
+            EXPECT_TRUE(19999 == krpc_number_get_i32(krpc_vector_get(o, 19999)));
+            EXPECT_TRUE(100001 == krpc_string_get_size(krpc_vector_get(o, 20000)));
+            EXPECT_TRUE('a' == krpc_string_get(krpc_vector_get(o, 20000))[99999]);
+            // õĶֻ
+            krpc_object_t* n = krpc_object_create();
+            krpc_number_set_i32(n, 1);
+            EXPECT_TRUE(error_invalid_parameters == krpc_vector_push_back(o, n));
+            EXPECT_TRUE(20001 == krpc_vector_get_size(o));
+            krpc_object_destroy(n);
+            Test_Rpc_Large_Call_Done = true;
+            return rpc_ok;
+        }
+
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_connect) {
+                krpc_object_t* v = krpc_object_create();
+                for (int i = 0; i < 20000; i++) {
+                    krpc_object_t* n = krpc_object_create();
+                    krpc_number_set_i32(n, i);
+                    krpc_vector_push_back(v, n);
+                }
+                std::string s(100000, 'a');
+                krpc_object_t* str = krpc_object_create();
+                krpc_string_set(str, s.c_str());
+                krpc_vector_push_back(v, str);
+                EXPECT_TRUE(0 == krpc_object_get_marshal_size(v));
+                EXPECT_TRUE(error_ok == krpc_call(Test_Rpc_Large_Call_Rpc, knet_channel_ref_get_stream(channel), 1, v));
+                krpc_object_destroy(v);
+            }
+        }
+
+        static void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_accept) {
+                knet_channel_ref_set_cb(channel, acceptor_cb);
+            } else if (e & channel_cb_event_recv) {
+                int error = krpc_proc(Test_Rpc_Large_Call_Rpc, knet_channel_ref_get_stream(channel));
+                EXPECT_TRUE((error_ok == error) || (error_rpc_not_enough_bytes == error));
+                if (Test_Rpc_Large_Call_Done) {
+                    knet_loop_exit(knet_channel_ref_get_loop(channel));
+                }
+            }
+        }
+    };
+
+    Test_Rpc_Large_Call_Rpc = krpc_create();
+    krpc_add_cb(Test_Rpc_Large_Call_Rpc, 1, &holder::rpc_cb);
+
+    kloop_t* loop = knet_loop_create();
+    // ջ
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 8, 1024);
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 8, 512 * 1024);
+    knet_channel_ref_accept(acceptor, 0, 8000, 1);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    knet_channel_ref_set_cb(acceptor, &holder::acceptor_cb);
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+
+    knet_loop_run(loop);
+    EXPECT_TRUE(Test_Rpc_Large_Call_Done);
+
+    knet_loop_destroy(loop);
+    krpc_destroy(Test_Rpc_Large_Call_Rpc);
+}
+
+krpc_t* Test_Rpc_Encrypt_Call_Rpc = 0;
+int     Test_Rpc_Encrypt_Call_Count = 0;
+
+CASE(Test_Rpc_Encrypt_Call) {
+    struct holder {
+        static uint16_t xor_cb(void* in, uint16_t size, void* out, uint16_t max_size) {
+            if (size > max_size) {
+                return 0;
+            }
+            for (uint16_t i = 0; i < size; i++) {
+                ((char*)out)[i] = ((char*)in)[i] ^ 0x5a;
+            }
+            return size;
+        }
+
+        static int rpc_cb(krpc_object_t* o) {
+            EXPECT_TRUE(Test_Rpc_Encrypt_Call_Count == krpc_number_get_i32(o));
+            Test_Rpc_Encrypt_Call_Count++;
+            return rpc_ok;
+        }
+
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_connect) {
+                // øüܻ
+                for (int i = 0; i < 3; i++) {
+                    krpc_object_t* n = krpc_object_create();
+                    krpc_number_set_i32(n, i);
+                    EXPECT_TRUE(error_ok == krpc_call(Test_Rpc_Encrypt_Call_Rpc, knet_channel_ref_get_stream(channel), 1, n));
+                    krpc_object_destroy(n);
+                }
+            }
+        }
+
+        static void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            if (e & channel_cb_event_accept) {
+                knet_channel_ref_set_cb(channel, acceptor_cb);
+            } else if (e & channel_cb_event_recv) {
+                while (error_ok == krpc_proc(Test_Rpc_Encrypt_Call_Rpc, knet_channel_ref_get_stream(channel))) {
+                }
+                if (3 == Test_Rpc_Encrypt_Call_Count) {
+                    knet_loop_exit(knet_channel_ref_get_loop(channel));
+                }
+            }
+        }
+    };
+
+    Test_Rpc_Encrypt_Call_Rpc = krpc_create();
+    krpc_add_cb(Test_Rpc_Encrypt_Call_Rpc, 1, &holder::rpc_cb);
+    krpc_set_encrypt_cb(Test_Rpc_Encrypt_Call_Rpc, &holder::xor_cb);
+    krpc_set_decrypt_cb(Test_Rpc_Encrypt_Call_Rpc, &holder::xor_cb);
+
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 8, 1024);
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 8, 1024);
+    knet_channel_ref_accept(acceptor, 0, 8000, 1);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+    knet_channel_ref_set_cb(acceptor, &holder::acceptor_cb);
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+
+    knet_loop_run(loop);
+    EXPECT_TRUE(3 == Test_Rpc_Encrypt_Call_Count);
+
+    knet_loop_destroy(loop);
+    krpc_destroy(Test_Rpc_Encrypt_Call_Rpc);
+}
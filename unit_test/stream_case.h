@@ -158,3 +158,55 @@ CASE(Test_Stream_Copy_Stream) {
     knet_loop_run(loop);
     knet_loop_destroy(loop);
 }
+
+int Test_Stream_Pushv_Total = 0;
+
+CASE(Test_Stream_Pushv) {
+    struct holder {
+        static void connector_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            static char buffer[128 * 1024 + 8] = {0};
+            if (e & channel_cb_event_recv) {
+                kstream_t* stream = knet_channel_ref_get_stream(channel);
+                // ȴݿ鵽
+                if (knet_stream_available(stream) < Test_Stream_Pushv_Total) {
+                    return;
+                }
+                EXPECT_TRUE(Test_Stream_Pushv_Total == knet_stream_available(stream));
+                EXPECT_TRUE(error_ok == knet_stream_pop(stream, buffer, Test_Stream_Pushv_Total));
+                // ݿ鰴˳
+                EXPECT_TRUE(!memcmp(buffer, "head", 4));
+                EXPECT_TRUE(buffer[4] == 'b' && buffer[4 + 128 * 1024 - 1] == 'b');
+                EXPECT_TRUE(!memcmp(buffer + 4 + 128 * 1024, "tail", 4));
+                knet_loop_exit(knet_channel_ref_get_loop(channel));
+            }
+        }
+
+        static void acceptor_cb(kchannel_ref_t* channel, knet_channel_cb_event_e e) {
+            static char body[128 * 1024];
+            if (e & channel_cb_event_accept) {
+                kiovec_t iov[3];
+                memset(body, 'b', sizeof(body));
+                iov[0].buffer = "head";
+                iov[0].size   = 4;
+                iov[1].buffer = body;
+                iov[1].size   = sizeof(body);
+                iov[2].buffer = "tail";
+                iov[2].size   = 4;
+                Test_Stream_Pushv_Total = 4 + sizeof(body) + 4;
+                // Эͷ, Э弰βһд
+                EXPECT_TRUE(error_ok == knet_stream_pushv(knet_channel_ref_get_stream(channel), iov, 3));
+            }
+        }
+    };
+
+    kloop_t* loop = knet_loop_create();
+    kchannel_ref_t* acceptor = knet_loop_create_channel(loop, 8, 1024);
+    knet_channel_ref_set_cb(acceptor, &holder::acceptor_cb);
+    knet_channel_ref_accept(acceptor, "127.0.0.1", 8000, 1);
+    kchannel_ref_t* connector = knet_loop_create_channel(loop, 8, 256 * 1024);
+    knet_channel_ref_set_cb(connector, &holder::connector_cb);
+    knet_channel_ref_connect(connector, "127.0.0.1", 8000, 1);
+
+    knet_loop_run(loop);
+    knet_loop_destroy(loop);
+}